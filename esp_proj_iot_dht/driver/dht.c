@@ -6,6 +6,8 @@
  */
 
 #include "driver/dht.h"
+#include "driver/rodata.h"
+#include "user_log.h"
 
 #include "osapi.h"
 #include "gpio.h"
@@ -13,29 +15,24 @@
 
 /******************* GPIO_PIN PARAMETERS *******************/
 
+//tables are kept in flash, read them with rodata_read_byte (uint32 entries can be read directly)
 #define NUMBER_VALID_GPIOS	12
-const uint8_t gpio_num[NUMBER_VALID_GPIOS] = {0,1,2,3,4,5,9,10,12,13,14,15};
-const uint32_t gpio_mux[NUMBER_VALID_GPIOS] = {PERIPHS_IO_MUX_GPIO0_U, PERIPHS_IO_MUX_U0TXD_U,PERIPHS_IO_MUX_GPIO2_U, PERIPHS_IO_MUX_U0RXD_U, PERIPHS_IO_MUX_GPIO4_U, PERIPHS_IO_MUX_GPIO5_U,
+static const uint8_t gpio_num[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {0,1,2,3,4,5,9,10,12,13,14,15};
+static const uint32_t gpio_mux[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {PERIPHS_IO_MUX_GPIO0_U, PERIPHS_IO_MUX_U0TXD_U,PERIPHS_IO_MUX_GPIO2_U, PERIPHS_IO_MUX_U0RXD_U, PERIPHS_IO_MUX_GPIO4_U, PERIPHS_IO_MUX_GPIO5_U,
 										PERIPHS_IO_MUX_SD_DATA2_U, PERIPHS_IO_MUX_SD_DATA3_U, PERIPHS_IO_MUX_MTDI_U, PERIPHS_IO_MUX_MTCK_U, PERIPHS_IO_MUX_MTMS_U, PERIPHS_IO_MUX_MTDO_U};
-const uint8_t gpio_func[NUMBER_VALID_GPIOS] = {FUNC_GPIO0, FUNC_GPIO1, FUNC_GPIO2, FUNC_GPIO3, FUNC_GPIO4, FUNC_GPIO5, FUNC_GPIO9, FUNC_GPIO10, FUNC_GPIO12, FUNC_GPIO13, FUNC_GPIO14, FUNC_GPIO15};
+static const uint8_t gpio_func[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {FUNC_GPIO0, FUNC_GPIO1, FUNC_GPIO2, FUNC_GPIO3, FUNC_GPIO4, FUNC_GPIO5, FUNC_GPIO9, FUNC_GPIO10, FUNC_GPIO12, FUNC_GPIO13, FUNC_GPIO14, FUNC_GPIO15};
 
 /**********************************************************/
 
 #define SENSING_TIME	2000000		//2 sec
 
-//Set-Up Debugging Macros
-#ifndef DHT_DEBUG
-	#define LOG_DEBUG(message)					do {} while(0)
-	#define LOG_DEBUG_ARGS(message, args...)	do {} while(0)
-#else
-	#define LOG_DEBUG(message)					do {os_printf("[DHT-DEBUG] %s", message); os_printf("\r\n");} while(0)
-	#define LOG_DEBUG_ARGS(message, args...)	do {os_printf("[DHT-DEBUG] "); os_printf(message, args); os_printf("\r\n");} while(0)
-#endif
-
 /*********** STATIC VARIABLES *************/
 static real32_t _maxCycles = 0;
 static uint32_t _lastSystemTime = 0;
 static int8_t _pin = -1;
+static uint8_t _gpioNum = 0;		//cached in RAM so the timed bus loop never touches flash
+static uint32_t _gpioMux = 0;
+static uint32_t _decodeTime = 0;	//duration of last successful bus read (us)
 /*****************************************/
 
 DHT_STATUS _configureGPIO(const uint8_t iGPIO_Pin);
@@ -46,11 +43,11 @@ real32_t _processTemperature(const uint8_t *iData, const TEMP_UNITS iTempUnit);
 
 DHT_STATUS dht_init(const uint8_t iGPIO_Pin){
 
-	LOG_DEBUG("DHT init.");
+	LOG_DEBUG(DHT, "DHT init.");
 
 	// configure pin (make it input with pull up enabled)
 	if(_configureGPIO(iGPIO_Pin) != DHT_OK){
-		LOG_DEBUG("Unable to configure GPIO");
+		LOG_ERROR(DHT, "Unable to configure GPIO");
 		return DHT_FAIL;
 	}
 
@@ -60,7 +57,7 @@ DHT_STATUS dht_init(const uint8_t iGPIO_Pin){
 	uint32_t integerPart = rawCpuClockPeriod >> 12;
 	real32_t decimalPart = (real32_t)(rawCpuClockPeriod & 0xFFF);
 
-	LOG_DEBUG_ARGS("RawCpuClockPeriod : %d, IntegerPart : %d , DecimalPart : %d", rawCpuClockPeriod, integerPart, decimalPart);
+	LOG_DEBUG(DHT, "RawCpuClockPeriod : %d, IntegerPart : %d , DecimalPart : %d", rawCpuClockPeriod, integerPart, decimalPart);
 
 	while (decimalPart >= 1) decimalPart = decimalPart / 10;
 	real32_t cpuClockPeriod = (real32_t)integerPart + decimalPart;
@@ -68,26 +65,26 @@ DHT_STATUS dht_init(const uint8_t iGPIO_Pin){
 	//define maxCycles (dht read fail condition)
 	_maxCycles = 1000/cpuClockPeriod;
 
-	#ifdef DHT_DEBUG
+	if(LOG_ON(DHT, DEBUG)){
 		uint32_t cpuClockDebug = cpuClockPeriod*100;
 		uint32_t maxCyclesDebug = _maxCycles;
-		LOG_DEBUG_ARGS("maxcycles : %d , ApproxCpuClock : %d", maxCyclesDebug, cpuClockDebug);
-	#endif
+		LOG_DEBUG(DHT, "maxcycles : %d , ApproxCpuClock : %d", maxCyclesDebug, cpuClockDebug);
+	}
 
 	//os_delay_us(2*1000*1000);
 
 	//note the time
 	_lastSystemTime = system_get_time();
 
-	LOG_DEBUG("DHT init end." );
+	LOG_DEBUG(DHT, "DHT init end." );
 	return DHT_OK;
 }
 
 DHT_STATUS dht_read(float* ohumidty, float* otemperature, const TEMP_UNITS iTempUnit){
-	LOG_DEBUG("DHT read.");
+	LOG_DEBUG(DHT, "DHT read.");
 
 	if(ohumidty == NULL || otemperature == NULL || iTempUnit > 2){
-		LOG_DEBUG("Invalid function parameters.");
+		LOG_ERROR(DHT, "Invalid function parameters.");
 		return DHT_FAIL;
 	}
 
@@ -95,41 +92,42 @@ DHT_STATUS dht_read(float* ohumidty, float* otemperature, const TEMP_UNITS iTemp
 
 	if (currentSystemTime - _lastSystemTime < SENSING_TIME){
 		//error
-		LOG_DEBUG_ARGS("2 Sec is required between poll times, It's been only %u ms", (currentSystemTime - _lastSystemTime)/1000 );
+		LOG_DEBUG(DHT, "2 Sec is required between poll times, It's been only %u ms", (currentSystemTime - _lastSystemTime)/1000 );
 		return DHT_POLL_ERROR;
 	}
 	_lastSystemTime = currentSystemTime;
 
 	//pulling pin high output (for statbility)
-	GPIO_OUTPUT_SET(GPIO_ID_PIN(gpio_num[_pin]), 1);
+	GPIO_OUTPUT_SET(GPIO_ID_PIN(_gpioNum), 1);
 	os_delay_us(250*1000);
 
 	//send start signal (should be atleast 1ms)
-	GPIO_OUTPUT_SET(GPIO_ID_PIN(gpio_num[_pin]), 0);
+	GPIO_OUTPUT_SET(GPIO_ID_PIN(_gpioNum), 0);
 	os_delay_us(10*1000);
 
 	//timing sensitive operation so disable all interrupts
 	ETS_GPIO_INTR_DISABLE();
 
 	/************ Critical data read start *****************/
+	uint32_t decodeStart = system_get_time();
 
 	//send high for 40us and then read for DHT start signal
-	GPIO_OUTPUT_SET(GPIO_ID_PIN(gpio_num[_pin]), 1);
+	GPIO_OUTPUT_SET(GPIO_ID_PIN(_gpioNum), 1);
 	os_delay_us(40);
 
 	//wait for DHT to start response signal
-	GPIO_DIS_OUTPUT(GPIO_ID_PIN(gpio_num[_pin]));
-	PIN_PULLUP_EN(gpio_mux[_pin]);
+	GPIO_DIS_OUTPUT(GPIO_ID_PIN(_gpioNum));
+	PIN_PULLUP_EN(_gpioMux);
 
 	//wait low for high to low response signal (DHT start signal)
 	if(_waitBusLevelChange(0, NULL) != DHT_OK ){
-		LOG_DEBUG("Timeout waiting for DHT Start response low signal");
+		LOG_WARN(DHT, "Timeout waiting for DHT Start response low signal");
 		return DHT_FAIL;
 	}
 
 	//wait for low to high response signal (DHT start signal)
 	if(_waitBusLevelChange(1, NULL) != DHT_OK ){
-		LOG_DEBUG("Timeout waiting for DHT end response high signal");
+		LOG_WARN(DHT, "Timeout waiting for DHT end response high signal");
 		return DHT_FAIL;
 	}
 
@@ -137,18 +135,19 @@ DHT_STATUS dht_read(float* ohumidty, float* otemperature, const TEMP_UNITS iTemp
 	for(uint8_t i = 0; i < 80; i+=2){
 		//will return be approx 50us equivalent of counter
 		if(_waitBusLevelChange(0, &counterArray[i]) != DHT_OK ){
-			LOG_DEBUG("Timeout waiting for DHT Data low signal");
+			LOG_WARN(DHT, "Timeout waiting for DHT Data low signal");
 			return DHT_FAIL;
 		}
 		//will return be either ~30us equivalent of counter represent 0 bit
 		//or will return be either ~70us equivalent of counter represent 1 bit
 		if(_waitBusLevelChange(1, &counterArray[i+1]) != DHT_OK ){
-			LOG_DEBUG("Timeout waiting for DHT Data high signal");
+			LOG_WARN(DHT, "Timeout waiting for DHT Data high signal");
 			return DHT_FAIL;
 		}
 	}
 
 	/************ Critical data read complete *****************/
+	uint32_t decodeEnd = system_get_time();
 
 	//timing critical operation complete so enable itnerrupts
 	ETS_GPIO_INTR_ENABLE();
@@ -156,62 +155,69 @@ DHT_STATUS dht_read(float* ohumidty, float* otemperature, const TEMP_UNITS iTemp
 	uint8_t data[4] = {0};
 	for (uint8_t i = 0; i < 80; i+=2){
 		data[i/16] <<= 1;
-		LOG_DEBUG_ARGS("%d: low : %d, high : %d",i/2, counterArray[i], counterArray[i+1]);
+		LOG_DEBUG(DHT, "%d: low : %d, high : %d",i/2, counterArray[i], counterArray[i+1]);
 		if(counterArray[i] < counterArray[i+1]){
 			data[i/16] |= 1;
 		}
 	}
 
 	if(((data[0] + data[1] + data[2] + data[3]) & 255) != data[4]){
-		LOG_DEBUG_ARGS("Checksum Error, Data : %d, %d, %d, %d, Checksum: %d ", data[0], data[1], data[2], data[3], data[4]);
+		LOG_WARN(DHT, "Checksum Error, Data : %d, %d, %d, %d, Checksum: %d ", data[0], data[1], data[2], data[3], data[4]);
 		return DHT_FAIL;
 	}
-	else LOG_DEBUG_ARGS("Data : %d, %d, %d, %d, Checksum: %d ", data[0], data[1], data[2], data[3], data[4]);
+	else LOG_DEBUG(DHT, "Data : %d, %d, %d, %d, Checksum: %d ", data[0], data[1], data[2], data[3], data[4]);
 
 	*ohumidty = _processHumidity(data);
 	*otemperature = _processTemperature(data, iTempUnit);
+	_decodeTime = decodeEnd - decodeStart;
 
 	return DHT_OK;
 }
 
+uint32_t dht_decode_time(void){
+	return _decodeTime;
+}
+
 DHT_STATUS _configureGPIO(const uint8_t iGPIO_Pin){
-	LOG_DEBUG("configure GPIO.");
+	LOG_DEBUG(DHT, "configure GPIO.");
 
 	_pin = -1;
 	//get pin
 	uint8_t index = 0;
 	for(index = 0; index < NUMBER_VALID_GPIOS; ++index){
-		if(gpio_num[index] == iGPIO_Pin){
+		if(rodata_read_byte(&gpio_num[index]) == iGPIO_Pin){
 			_pin = index;
-			LOG_DEBUG_ARGS("%d will be configured as GPIO", iGPIO_Pin);
+			_gpioNum = iGPIO_Pin;
+			_gpioMux = gpio_mux[index];
+			LOG_DEBUG(DHT, "%d will be configured as GPIO", iGPIO_Pin);
 			break;
 		}
 	}
 	if (_pin == -1){
-		LOG_DEBUG_ARGS("%d cannot be configured as GPIO", iGPIO_Pin);
+		LOG_ERROR(DHT, "%d cannot be configured as GPIO", iGPIO_Pin);
 		return DHT_FAIL;
 	}
 
 	//gpio_init();
 
 	//set GPIO Function Selection Register
-	PIN_FUNC_SELECT(gpio_mux[_pin], gpio_func[index]);
+	PIN_FUNC_SELECT(_gpioMux, rodata_read_byte(&gpio_func[index]));
 
-	LOG_DEBUG("Pin function select register is set");
+	LOG_DEBUG(DHT, "Pin function select register is set");
 
 	//set pin as input low and enable pull up resistor
-	GPIO_DIS_OUTPUT(GPIO_ID_PIN(gpio_num[_pin]));
-	PIN_PULLUP_EN(gpio_mux[_pin]);
+	GPIO_DIS_OUTPUT(GPIO_ID_PIN(_gpioNum));
+	PIN_PULLUP_EN(_gpioMux);
 
-	LOG_DEBUG("configure GPIO end.");
+	LOG_DEBUG(DHT, "configure GPIO end.");
 	return DHT_OK;
 }
 
 DHT_STATUS _waitBusLevelChange(const bool iLevel, uint8_t* oCounter){
 	uint8_t counter = 0;
-	while (GPIO_INPUT_GET(GPIO_ID_PIN(gpio_num[_pin])) == iLevel) {
+	while (GPIO_INPUT_GET(GPIO_ID_PIN(_gpioNum)) == iLevel) {
 		if(counter >= _maxCycles){
-			LOG_DEBUG_ARGS("maxCycles reached %d ", counter);
+			LOG_DEBUG(DHT, "maxCycles reached %d ", counter);
 			return DHT_FAIL;
 		}
 		counter++;
@@ -225,10 +231,10 @@ real32_t _processHumidity(const uint8_t *iData){
 	uint16_t data = ((iData[0] << 8) | iData[1]);
 	humidity = (real32_t)data/10;
 
-	#ifdef DHT_DEBUG
+	if(LOG_ON(DHT, DEBUG)){
 		uint32_t humidity_i = humidity*10;
-		LOG_DEBUG_ARGS("humidity : %d", humidity_i);
-	#endif
+		LOG_DEBUG(DHT, "humidity : %d", humidity_i);
+	}
 
 	return humidity;
 }
@@ -241,10 +247,10 @@ real32_t _processTemperature(const uint8_t *iData, const TEMP_UNITS iTempUnit){
 		temperature *= -1;
 	}
 
-	#ifdef DHT_DEBUG
+	if(LOG_ON(DHT, DEBUG)){
 		int32_t temperature_i = temperature*10;
-		LOG_DEBUG_ARGS("temperature : %d", temperature_i);
-	#endif
+		LOG_DEBUG(DHT, "temperature : %d", temperature_i);
+	}
 
 	switch (iTempUnit) {
 		case Celcius:
@@ -6,6 +6,8 @@
  */
 
 #include "../../esp_proj_wifi/include/driver/http.h"
+#include "driver/rodata.h"
+#include "user_log.h"
 
 #include "stdlib.h"
 
@@ -14,14 +16,12 @@
 #include "mem.h"
 #include "espconn.h"
 
-//Set-Up Debugging Macros
-#ifndef HTTP_DEBUG
-	#define HTTP_LOG_DEBUG(message)					do {} while(0)
-	#define HTTP_LOG_DEBUG_ARGS(message, args...)	do {} while(0)
-#else
-	#define HTTP_LOG_DEBUG(message)					do {os_printf("[HTTP-DEBUG] %s", message); os_printf("\r\n");} while(0)
-	#define HTTP_LOG_DEBUG_ARGS(message, args...)	do {os_printf("[HTTP-DEBUG] "); os_printf(message, args); os_printf("\r\n");} while(0)
-#endif
+//space reserved for response headers
+#define HTTP_HEADER_SIZE		320
+
+//chunk framing, size is rendered as fixed width hex so content can be rendered first
+#define HTTP_CHUNK_HEADER_SIZE	6		//"%04x\r\n"
+#define HTTP_CHUNK_TRAILER_SIZE	2		//"\r\n"
 
 /***********************************************************************************
  * FunctionName : _httpRoutePath
@@ -34,7 +34,7 @@
  * 						-- false if Failed
 ***********************************************************************************/
 bool _httpRoutePath(char *iRecv, uint16 iLength, char **oRoutePath, uint16 *oPathLength){
-	HTTP_LOG_DEBUG("Inside httpRoutePath");
+	LOG_DEBUG(HTTP, "Inside httpRoutePath");
 	bool result = false;
 	if(iRecv != NULL && iLength > 0){
 		char* p1 = NULL;
@@ -51,89 +51,396 @@ bool _httpRoutePath(char *iRecv, uint16 iLength, char **oRoutePath, uint16 *oPat
 	return result;
 }
 
+/***********************************************************************************
+ * FunctionName : _httpHeaderValue
+ * Description  : Find a request header (case-insensitive name) in raw data without
+ * 				  relying on it being null terminated.
+ * Parameters   : iRecv		   -- raw received data
+ *                iLength	   -- length of received data
+ *                iName		   -- header name including ':' (e.g. "Accept-Encoding:")
+ *                oValue	   -- header value
+ *                oValueLength -- header value length
+ * Returns      : bool	-- true if header is found
+ * 						-- false if not found
+***********************************************************************************/
+bool _httpHeaderValue(char *iRecv, uint16 iLength, const char *iName, char **oValue, uint16 *oValueLength){
+	uint16 nameLength = os_strlen(iName);
+	char *end = iRecv + iLength;
+	char *line = iRecv;
+
+	//skip request line
+	while(line < end && *line != '\n') ++line;
+
+	while(++line < end){
+		//empty line, end of headers
+		if(*line == '\r' || *line == '\n') break;
+
+		char *eol = line;
+		while(eol < end && *eol != '\r' && *eol != '\n') ++eol;
+
+		if(eol - line > nameLength){
+			uint16 i = 0;
+			for(i = 0; i < nameLength; ++i){
+				char c = line[i];
+				if(c >= 'A' && c <= 'Z') c += 'a' - 'A';
+				char n = iName[i];
+				if(n >= 'A' && n <= 'Z') n += 'a' - 'A';
+				if(c != n) break;
+			}
+			if(i == nameLength){
+				char *value = line + nameLength;
+				while(value < eol && *value == ' ') ++value;
+				*oValue = value;
+				*oValueLength = eol - value;
+				return true;
+			}
+		}
+
+		line = eol;
+		if(line < end && *line == '\r') ++line;
+	}
+	return false;
+}
+
+/***********************************************************************************
+ * FunctionName : _httpHeaderLength
+ * Description  : Length of request head up to and including its empty line, without
+ * 				  relying on raw data being null terminated.
+ * Parameters   : iRecv		   -- raw received data
+ *                iLength	   -- length of received data
+ * Returns      : uint16	-- head length, 0 if empty line is not in data
+***********************************************************************************/
+uint16 _httpHeaderLength(char *iRecv, uint16 iLength){
+	for(uint16 i = 3; i < iLength; ++i){
+		if(iRecv[i] == '\n' && iRecv[i - 1] == '\r' && iRecv[i - 2] == '\n' && iRecv[i - 3] == '\r')
+			return i + 1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * FunctionName : _httpContentLength
+ * Description  : Content-Length of a request head. Digits are read up to the first
+ * 				  other character, the value saturates at 0xFFFF.
+ * Parameters   : iRecv		    -- raw received data
+ *                iHeaderLength -- length of request head
+ *                oLength	    -- content length
+ * Returns      : bool	-- true if header is found
+ * 						-- false if not found
+***********************************************************************************/
+bool _httpContentLength(char *iRecv, uint16 iHeaderLength, uint16 *oLength){
+	char *value = NULL;
+	uint16 valueLength = 0;
+	if(_httpHeaderValue(iRecv, iHeaderLength, "Content-Length:", &value, &valueLength) == false) return false;
+
+	uint32 length = 0;
+	for(uint16 i = 0; i < valueLength && value[i] >= '0' && value[i] <= '9'; ++i){
+		length = length*10 + (value[i] - '0');
+		if(length > 0xFFFF) length = 0xFFFF;
+	}
+	*oLength = length;
+	return true;
+}
+
 /***********************************************************************************
  * FunctionName : _httpRequestData
  * Description  : Extract HTTP request data from raw data.
  * Parameters   : iRecv		   -- raw received data
  *                iLength	   -- length of received data
  *                oData		   -- extracted HTTP data
- *                oDataLength  -- HTTP data length
+ *                oDataLength  -- HTTP data length, at most what follows the head
  * Returns      : bool	-- true if Successful
  * 						-- false if Failed
 ***********************************************************************************/
 bool _httpRequestData(char *iRecv, uint16 iLength, char **oData, uint16 *oDataLength){
-	HTTP_LOG_DEBUG("Inside httpRequestData");
-	bool result = false;
-	if(iRecv != NULL && iLength > 0){
-		char* p1 = NULL;
-		char* p2 = NULL;
-		p1 = os_strstr(iRecv, "\r\n\r\n");
-		p2 = os_strstr(iRecv, "Content-Length:");
-		if(p1 != NULL && p2 != NULL){
-			p1 += 4;
-			*oData = p1;
-
-			p2 += 16;
-			char *p3 = os_strstr(p2, "\r\n");
-			char p4[5] = {0};
-			os_memcpy(p4, p2, p3-p2);
-			uint16 datalength = atoi(p4);
-			*oDataLength = datalength;
-			result = true;
+	LOG_DEBUG(HTTP, "Inside httpRequestData");
+	if(iRecv == NULL || iLength == 0) return false;
+
+	uint16 headerLength = _httpHeaderLength(iRecv, iLength);
+	uint16 dataLength = 0;
+	if(headerLength == 0 || _httpContentLength(iRecv, headerLength, &dataLength) == false) return false;
+
+	//Content-Length is not trusted beyond received data
+	if(dataLength > iLength - headerLength) dataLength = iLength - headerLength;
+	*oData = iRecv + headerLength;
+	*oDataLength = dataLength;
+	return true;
+}
+
+/***********************************************************************************
+ * FunctionName : _httpHeaderHasToken
+ * Description  : check if a header value contains a token (case-insensitive), e.g.
+ * 				  "gzip" in "Accept-Encoding: gzip, deflate, br"
+ * Parameters   : iValue	   -- header value
+ *                iValueLength -- header value length
+ *                iToken	   -- token to look for (lower case)
+ * Returns      : bool	-- true if token is present
+***********************************************************************************/
+bool _httpHeaderHasToken(char *iValue, uint16 iValueLength, const char *iToken){
+	uint16 tokenLength = os_strlen(iToken);
+	for(uint16 i = 0; i + tokenLength <= iValueLength; ++i){
+		uint16 j = 0;
+		for(j = 0; j < tokenLength; ++j){
+			char c = iValue[i + j];
+			if(c >= 'A' && c <= 'Z') c += 'a' - 'A';
+			if(c != iToken[j]) break;
 		}
+		if(j == tokenLength) return true;
 	}
-	return result;
+	return false;
 }
 
 /***********************************************************************************
- * FunctionName : sendHttpResponse
- * Description  : Send Http response to server.
- * Parameters   : espconn	    -- esp connection obj
+ * FunctionName : _httpFormatETag
+ * Description  : Render entity tag of response (including quotes and weak prefix)
+ * Parameters   : oETag	        -- output buffer (at least 16 bytes)
  *                iHttpResponse -- HTTP reponse obj
- * Returns      : bool	-- true if Successful
- * 						-- false if Failed
+ * Returns      : uint16	-- length of rendered etag
 ***********************************************************************************/
-bool sendHttpResponse (struct espconn *espconn, HTTP_RESPONSE_PACKET* iHttpResponse){
-	HTTP_LOG_DEBUG("inside sendHttpResponse");
+uint16 _httpFormatETag(char *oETag, HTTP_RESPONSE_PACKET *iHttpResponse){
+	if(iHttpResponse->etagType == etag_weak)
+		return os_sprintf(oETag, "W/\"%08x\"", iHttpResponse->etag);
+	//strong validators are per representation
+	return os_sprintf(oETag, "\"%08x%s\"", iHttpResponse->etag,
+			iHttpResponse->contentEncoding == encoding_gzip ? "-gz" : "");
+}
+
+/***********************************************************************************
+ * FunctionName : httpNotModified
+ * Description  : Validates request's If-None-Match against response's etag (weak
+ * 				  comparison). If it matches, response is turned into a header only
+ * 				  304 Not Modified.
+ * Parameters   : iHttpRequest  -- processed HTTP request obj
+ *                ioHttpResponse -- HTTP response obj with etag set
+ * Returns      : bool	-- true if client's copy is still valid (response is now 304)
+ * 						-- false otherwise
+***********************************************************************************/
+bool httpNotModified (HTTP_REQUEST_PACKET *iHttpRequest, HTTP_RESPONSE_PACKET *ioHttpResponse){
 	bool result = false;
-	if(iHttpResponse != NULL){
-		HTTP_LOG_DEBUG_ARGS("content : %s", iHttpResponse->content);
+	if(iHttpRequest != NULL && ioHttpResponse != NULL && iHttpRequest->ifNoneMatch != NULL &&
+			ioHttpResponse->etagType != etag_none && ioHttpResponse->httpStatusCode == HTTP_OK){
+
+		char etag[16];
+		uint16 etagLength = _httpFormatETag(etag, ioHttpResponse);
+		char *opaqueTag = etag;
+		if(ioHttpResponse->etagType == etag_weak){
+			opaqueTag += 2;
+			etagLength -= 2;
+		}
+
+		//walk comma separated list of entity tags, W/ prefix is ignored (weak comparison)
+		char *value = iHttpRequest->ifNoneMatch;
+		char *end = value + iHttpRequest->ifNoneMatchLength;
+		while(value < end && !result){
+			while(value < end && (*value == ' ' || *value == ',')) ++value;
+			if(value < end && *value == '*'){
+				result = true;
+				break;
+			}
+			if(end - value >= 2 && value[0] == 'W' && value[1] == '/') value += 2;
+
+			char *tagEnd = value;
+			while(tagEnd < end && *tagEnd != ',') ++tagEnd;
+			char *tagLast = tagEnd;
+			while(tagLast > value && *(tagLast - 1) == ' ') --tagLast;
 
-		char* responsePacket = (char*) os_zalloc(256 + iHttpResponse->contentLength);
+			if(tagLast - value == etagLength && os_strncmp(value, opaqueTag, etagLength) == 0) result = true;
+			value = tagEnd;
+		}
+
+		if(result){
+			LOG_DEBUG(HTTP, "etag %s matched, not modified", etag);
+			ioHttpResponse->httpStatusCode = HTTP_Not_Modified;
+			ioHttpResponse->content = "";
+			ioHttpResponse->contentLength = 0;
+			ioHttpResponse->contentInFlash = false;
+			ioHttpResponse->contentWriter = NULL;
+		}
+	}
+	return result;
+}
+
+/***********************************************************************************
+ * FunctionName : buildHttpResponse
+ * Description  : Render Http response (headers and content) into a new packet.
+ * Parameters   : iHttpResponse -- HTTP reponse obj
+ *                oPacket       -- rendered packet, allocated with os_zalloc, caller
+ *                                 frees it once it is sent
+ * Returns      : uint16	-- length of packet, 0 if Failed
+***********************************************************************************/
+uint16 buildHttpResponse (HTTP_RESPONSE_PACKET* iHttpResponse, char **oPacket){
+	LOG_DEBUG(HTTP, "inside buildHttpResponse");
+	uint16 packetLength = 0;
+	if(iHttpResponse != NULL && oPacket != NULL){
+		*oPacket = NULL;
+		char* responsePacket = (char*) os_zalloc(HTTP_HEADER_SIZE + iHttpResponse->contentLength);
 
 		char *httpStatusCode = NULL;
 		if(iHttpResponse->httpStatusCode == HTTP_OK) httpStatusCode = "200 OK";
+		else if(iHttpResponse->httpStatusCode == HTTP_Found) httpStatusCode = "302 Found";
+		else if(iHttpResponse->httpStatusCode == HTTP_Not_Modified) httpStatusCode = "304 Not Modified";
 		else if(iHttpResponse->httpStatusCode == HTTP_Bad_Request) httpStatusCode = "400 Bad Request";
 		else if(iHttpResponse->httpStatusCode == HTTP_Not_Found) httpStatusCode = "404 Not Found";
+		else if(iHttpResponse->httpStatusCode == HTTP_Service_Unavailable) httpStatusCode = "503 Service Unavailable";
 
 		char *contentType = NULL;
 		if(iHttpResponse->contentType == text_html) contentType = "text/html";
 		else if(iHttpResponse->contentType == text_css) contentType = "text/css";
 		else if(iHttpResponse->contentType == application_javascript) contentType = "application/javascript";
+		else if(iHttpResponse->contentType == application_json) contentType = "application/json";
+		else if(iHttpResponse->contentType == text_event_stream) contentType = "text/event-stream";
+		else if(iHttpResponse->contentType == text_prometheus) contentType = "text/plain; version=0.0.4";
 
 		char *connection = NULL;
-		if(iHttpResponse->connection == Closed) connection = "Closed";
-
-		if(responsePacket != NULL && httpStatusCode != NULL && contentType != NULL && connection !=NULL && iHttpResponse->content != NULL){
-			os_sprintf(responsePacket, "HTTP/1.1 %s\r\n\
-Server: ESP8266\r\n\
-Content-Length: %d\r\n\
-Content-Type: %s\r\n\
-Connection: %s\r\n\r\n\
-%s", httpStatusCode, iHttpResponse->contentLength, contentType, connection, iHttpResponse->content);
-
-			HTTP_LOG_DEBUG_ARGS("Content : %s",responsePacket);
-			if(espconn != NULL){
-				sint8 status = espconn_send(espconn, responsePacket, os_strlen(responsePacket));
-				HTTP_LOG_DEBUG_ARGS("espconn send, status : %d",status);
-				if(status == 0) result = true;
+		if(iHttpResponse->connection == Closed) connection = "close";
+		else if(iHttpResponse->connection == Keep_Alive) connection = "keep-alive";
+
+		if(responsePacket != NULL && httpStatusCode != NULL && contentType != NULL && connection !=NULL &&
+				(iHttpResponse->content != NULL || iHttpResponse->contentWriter != NULL ||
+				 iHttpResponse->chunkWriter != NULL)){
+			uint16 headerLength = os_sprintf(responsePacket, "HTTP/1.1 %s\r\nServer: ESP8266\r\n", httpStatusCode);
+
+			//304 carries validators only, no representation metadata or body
+			if(iHttpResponse->httpStatusCode != HTTP_Not_Modified){
+				//event stream has no length, content is only its first frames
+				if(iHttpResponse->chunkWriter != NULL)
+					headerLength += os_sprintf(responsePacket + headerLength, "Transfer-Encoding: chunked\r\n");
+				else if(iHttpResponse->contentType != text_event_stream)
+					headerLength += os_sprintf(responsePacket + headerLength, "Content-Length: %d\r\n", iHttpResponse->contentLength);
+				headerLength += os_sprintf(responsePacket + headerLength, "Content-Type: %s\r\n", contentType);
+				if(iHttpResponse->contentEncoding == encoding_gzip)
+					headerLength += os_sprintf(responsePacket + headerLength, "Content-Encoding: gzip\r\n");
+			}
+
+			if(iHttpResponse->etagType != etag_none){
+				headerLength += os_sprintf(responsePacket + headerLength, "ETag: ");
+				headerLength += _httpFormatETag(responsePacket + headerLength, iHttpResponse);
+				headerLength += os_sprintf(responsePacket + headerLength, "\r\n");
+				//etag of static assets depends on content encoding
+				if(iHttpResponse->etagType == etag_strong || iHttpResponse->contentEncoding == encoding_gzip)
+					headerLength += os_sprintf(responsePacket + headerLength, "Vary: Accept-Encoding\r\n");
 			}
+
+			if(iHttpResponse->location != NULL)
+				headerLength += os_sprintf(responsePacket + headerLength, "Location: %s\r\n", iHttpResponse->location);
+
+			if(iHttpResponse->cacheControl == cache_static)
+				headerLength += os_sprintf(responsePacket + headerLength, "Cache-Control: public, max-age=%d\r\n", HTTP_STATIC_MAX_AGE);
+			else if(iHttpResponse->cacheControl == cache_no_cache)
+				headerLength += os_sprintf(responsePacket + headerLength, "Cache-Control: no-cache\r\n");
+
+			if(iHttpResponse->connection == Keep_Alive && iHttpResponse->contentType != text_event_stream)
+				headerLength += os_sprintf(responsePacket + headerLength, "Keep-Alive: timeout=%d, max=%d\r\n",
+						HTTP_KEEPALIVE_TIMEOUT, iHttpResponse->keepAliveMax);
+
+			headerLength += os_sprintf(responsePacket + headerLength, "Connection: %s\r\n\r\n", connection);
+
+			//content may be binary (gzip) and/or flash resident, so it is copied rather than printed
+			if(iHttpResponse->chunkWriter != NULL)
+				iHttpResponse->contentLength = 0;
+			else if(iHttpResponse->contentWriter != NULL)
+				iHttpResponse->contentWriter(responsePacket + headerLength, iHttpResponse->contentLength);
+			else if(iHttpResponse->contentInFlash)
+				rodata_memcpy(responsePacket + headerLength, iHttpResponse->content, iHttpResponse->contentLength);
+			else
+				os_memcpy(responsePacket + headerLength, iHttpResponse->content, iHttpResponse->contentLength);
+
+			LOG_DEBUG(HTTP, "Header : %d bytes, content : %d bytes", headerLength, iHttpResponse->contentLength);
+			packetLength = headerLength + iHttpResponse->contentLength;
+			*oPacket = responsePacket;
+		}
+		else if(responsePacket != NULL){
+			os_free(responsePacket);
+		}
+	}
+	return packetLength;
+}
+
+/***********************************************************************************
+ * FunctionName : buildHttpChunk
+ * Description  : Render next chunk of a chunked response into a new packet.
+ * Parameters   : iWriter       -- chunk writer of response
+ *                ioCursor      -- writer position, 0 for first chunk
+ *                oPacket       -- rendered packet, allocated with os_malloc, caller
+ *                                 frees it once it is sent
+ *                oLast         -- true if this is the terminating (zero size) chunk
+ * Returns      : uint16	-- length of packet, 0 if Failed
+***********************************************************************************/
+uint16 buildHttpChunk (HTTP_CHUNK_WRITER iWriter, uint16 *ioCursor, char **oPacket, bool *oLast){
+	if(iWriter == NULL || ioCursor == NULL || oPacket == NULL || oLast == NULL) return 0;
+
+	char *packet = (char*) os_malloc(HTTP_CHUNK_HEADER_SIZE + HTTP_CHUNK_SIZE + HTTP_CHUNK_TRAILER_SIZE + 1);
+	if(packet == NULL) return 0;
+
+	uint16 length = iWriter(packet + HTTP_CHUNK_HEADER_SIZE, HTTP_CHUNK_SIZE, ioCursor);
+	if(length > HTTP_CHUNK_SIZE) length = HTTP_CHUNK_SIZE;
+
+	//last-chunk has no data, just the empty trailer
+	*oLast = (length == 0);
+	if(*oLast){
+		*oPacket = packet;
+		return os_sprintf(packet, "0\r\n\r\n");
+	}
+
+	//size is rendered aside, os_sprintf's terminator would overwrite first content byte
+	char size[HTTP_CHUNK_HEADER_SIZE + 1];
+	os_sprintf(size, "%04x\r\n", length);
+	os_memcpy(packet, size, HTTP_CHUNK_HEADER_SIZE);
+	packet[HTTP_CHUNK_HEADER_SIZE + length] = '\r';
+	packet[HTTP_CHUNK_HEADER_SIZE + length + 1] = '\n';
+
+	*oPacket = packet;
+	return HTTP_CHUNK_HEADER_SIZE + length + HTTP_CHUNK_TRAILER_SIZE;
+}
+
+/***********************************************************************************
+ * FunctionName : sendHttpResponse
+ * Description  : Send Http response to server.
+ * Parameters   : espconn	    -- esp connection obj
+ *                iHttpResponse -- HTTP reponse obj
+ * Returns      : bool	-- true if Successful
+ * 						-- false if Failed
+***********************************************************************************/
+bool sendHttpResponse (struct espconn *espconn, HTTP_RESPONSE_PACKET* iHttpResponse){
+	LOG_DEBUG(HTTP, "inside sendHttpResponse");
+	bool result = false;
+	char *responsePacket = NULL;
+	uint16 packetLength = buildHttpResponse(iHttpResponse, &responsePacket);
+	if(packetLength > 0){
+		if(espconn != NULL){
+			sint8 status = espconn_send(espconn, responsePacket, packetLength);
+			LOG_DEBUG(HTTP, "espconn send, status : %d",status);
+			if(status == 0) result = true;
 		}
 		os_free(responsePacket);
 	}
 	return result;
 }
 
+/***********************************************************************************
+ * FunctionName : httpMessageComplete
+ * Description  : check if raw data holds a complete HTTP message, i.e. headers up to
+ * 				  the empty line and Content-Length bytes of body
+ * Parameters   : iRecv	   		 -- received data
+ *                iLength  		 -- length of received data
+ *                oMessageLength -- length of first message in data
+ * Returns      : bool	-- true if message is complete
+ * 						-- false if more data is needed
+***********************************************************************************/
+bool httpMessageComplete (char *iRecv, uint16 iLength, uint16 *oMessageLength){
+	if(iRecv == NULL || oMessageLength == NULL) return false;
+
+	uint16 headerLength = _httpHeaderLength(iRecv, iLength);
+	if(headerLength == 0) return false;
+
+	uint16 contentLength = 0;
+	_httpContentLength(iRecv, headerLength, &contentLength);
+	if((uint32)headerLength + contentLength > iLength) return false;
+
+	*oMessageLength = headerLength + contentLength;
+	return true;
+}
+
 /***********************************************************************************
  * FunctionName : processHttpRequest
  * Description  : process raw received HTTP Request Data
@@ -150,14 +457,20 @@ bool processHttpRequest (char *iRecv, uint16 iLength, HTTP_REQUEST_PACKET *oHttp
 		HTTP_METHOD httpRequest = HTTP_INVALID;
 		if(os_strncmp(iRecv, "GET", 3) == 0){
 			httpRequest =  HTTP_GET;
-			HTTP_LOG_DEBUG("Request type : GET");
+			LOG_DEBUG(HTTP, "Request type : GET");
 		}
 		else if(os_strncmp(iRecv, "POST", 4) == 0){
 			httpRequest =  HTTP_POST;
-			HTTP_LOG_DEBUG("Request type : POST");
+			LOG_DEBUG(HTTP, "Request type : POST");
 		}
 
 		oHttpRequest->httpMethod = httpRequest;
+		oHttpRequest->data = NULL;
+		oHttpRequest->dataLength = 0;
+		oHttpRequest->acceptGzip = false;
+		oHttpRequest->ifNoneMatch = NULL;
+		oHttpRequest->ifNoneMatchLength = 0;
+		oHttpRequest->connection = Keep_Alive;
 
 		if(httpRequest != HTTP_INVALID){
 			char *routePath = NULL;
@@ -180,6 +493,31 @@ bool processHttpRequest (char *iRecv, uint16 iLength, HTTP_REQUEST_PACKET *oHttp
 				oHttpRequest->data = data;
 				result = true;
 			}
+
+			char *acceptEncoding = NULL;
+			uint16 acceptEncodingLength = 0;
+			if(_httpHeaderValue(iRecv, iLength, "Accept-Encoding:", &acceptEncoding, &acceptEncodingLength) == true){
+				oHttpRequest->acceptGzip = _httpHeaderHasToken(acceptEncoding, acceptEncodingLength, "gzip");
+				LOG_DEBUG(HTTP, "Accept gzip : %d", oHttpRequest->acceptGzip);
+			}
+
+			_httpHeaderValue(iRecv, iLength, "If-None-Match:", &oHttpRequest->ifNoneMatch, &oHttpRequest->ifNoneMatchLength);
+
+			//HTTP/1.1 connections are persistent unless client asks to close, HTTP/1.0 ones the other way round
+			char *requestLineEnd = iRecv;
+			while(requestLineEnd < iRecv + iLength && *requestLineEnd != '\r' && *requestLineEnd != '\n') ++requestLineEnd;
+			if(requestLineEnd - iRecv >= 8 && os_strncmp(requestLineEnd - 8, "HTTP/1.0", 8) == 0)
+				oHttpRequest->connection = Closed;
+
+			char *connection = NULL;
+			uint16 connectionLength = 0;
+			if(_httpHeaderValue(iRecv, iLength, "Connection:", &connection, &connectionLength) == true){
+				if(_httpHeaderHasToken(connection, connectionLength, "close"))
+					oHttpRequest->connection = Closed;
+				else if(_httpHeaderHasToken(connection, connectionLength, "keep-alive"))
+					oHttpRequest->connection = Keep_Alive;
+			}
+			LOG_DEBUG(HTTP, "Connection : %d", oHttpRequest->connection);
 		}
 	}
 	return result;
@@ -210,3 +548,140 @@ bool isHttp(char *iRecv, uint16 iLength, HTTP_MESSAGE_TYPE *oMsgType){
 	}
 	return result;
 }
+
+/***********************************************************************************
+ * FunctionName : _httpHexValue
+ * Description  : Value of a hex digit
+ * Parameters   : iChar -- character
+ * Returns      : sint8	-- 0 to 15, -1 if not a hex digit
+***********************************************************************************/
+sint8 _httpHexValue(char iChar){
+	if(iChar >= '0' && iChar <= '9') return iChar - '0';
+	if(iChar >= 'a' && iChar <= 'f') return iChar - 'a' + 10;
+	if(iChar >= 'A' && iChar <= 'F') return iChar - 'A' + 10;
+	return -1;
+}
+
+/***********************************************************************************
+ * FunctionName : _httpFormField
+ * Description  : Finds field whose whole name is matched and that is not decoded yet
+ * Parameters   : ioFields    -- fields
+ *                iFieldCount -- number of fields
+ *                iCandidates -- bit mask of fields whose name matches so far
+ *                iNameLength -- decoded name length
+ * Returns      : FORM_FIELD*	-- field, NULL if none
+***********************************************************************************/
+FORM_FIELD* _httpFormField(FORM_FIELD *ioFields, uint8 iFieldCount, uint32 iCandidates, uint16 iNameLength){
+	for(uint8 i = 0; i < iFieldCount; ++i){
+		if((iCandidates & (1UL << i)) && ioFields[i].name[iNameLength] == '\0' &&
+				ioFields[i].status == FORM_MISSING) return &ioFields[i];
+	}
+	return NULL;
+}
+
+/***********************************************************************************
+ * FunctionName : httpDecodeForm
+ * Description  : Decode application/x-www-form-urlencoded data into fields in one
+ * 				  pass. Data need not be null terminated.
+ * Parameters   : iData    	-- form data
+ *                iLength  	-- length of form data
+ *                ioFields 	-- fields to decode (name, value and size set)
+ *                iFieldCount -- number of fields (max HTTP_FORM_MAX_FIELDS)
+ * Returns      : FORM_STATUS	-- FORM_MALFORMED if any escape is malformed,
+ * 								   else FORM_TRUNCATED if any field is cut, else FORM_OK
+***********************************************************************************/
+FORM_STATUS httpDecodeForm (const char *iData, uint16 iLength, FORM_FIELD *ioFields, uint8 iFieldCount){
+	LOG_DEBUG(HTTP, "inside httpDecodeForm");
+	if(ioFields == NULL || iFieldCount == 0 || iFieldCount > HTTP_FORM_MAX_FIELDS) return FORM_MALFORMED;
+	if(iData == NULL) iLength = 0;
+
+	for(uint8 i = 0; i < iFieldCount; ++i){
+		ioFields[i].status = FORM_MISSING;
+		ioFields[i].length = 0;
+		if(ioFields[i].value != NULL && ioFields[i].size > 0) ioFields[i].value[0] = '\0';
+	}
+
+	FORM_STATUS result = FORM_OK;
+	uint32 allFields = (iFieldCount == 32) ? 0xFFFFFFFF : ((1UL << iFieldCount) - 1);
+	uint32 candidates = allFields;		//fields whose name matches decoded name so far
+	uint16 nameLength = 0;
+	bool inValue = false;
+	FORM_FIELD *field = NULL;			//field taking current value, NULL if value is skipped
+
+	//uint32 index, i == iLength closes last pair and would never be passed at 65535 in 16 bits
+	for(uint32 i = 0; i <= iLength; ++i){
+		//end of pair, a name without '=' has an empty value
+		if(i == iLength || iData[i] == '&'){
+			if(!inValue && nameLength > 0){
+				field = _httpFormField(ioFields, iFieldCount, candidates, nameLength);
+				if(field != NULL) field->status = FORM_OK;
+			}
+			if(field != NULL && field->value != NULL && field->size > 0) field->value[field->length] = '\0';
+
+			candidates = allFields;
+			nameLength = 0;
+			inValue = false;
+			field = NULL;
+			continue;
+		}
+		if(!inValue && iData[i] == '='){
+			field = _httpFormField(ioFields, iFieldCount, candidates, nameLength);
+			if(field != NULL) field->status = FORM_OK;
+			inValue = true;
+			continue;
+		}
+
+		//decode one character, a malformed escape is kept as is
+		char c = iData[i];
+		bool malformed = false;
+		if(c == '+') c = ' ';
+		else if(c == '%'){
+			sint8 high = (i + 2 < iLength) ? _httpHexValue(iData[i + 1]) : -1;
+			sint8 low = (i + 2 < iLength) ? _httpHexValue(iData[i + 2]) : -1;
+			if(high >= 0 && low >= 0){
+				c = (high << 4) | low;
+				i += 2;
+			}
+			else malformed = true;
+		}
+		//a null, escaped or raw, cannot be held in a null terminated value
+		if(c == '\0') malformed = true;
+		if(malformed) result = FORM_MALFORMED;
+
+		if(!inValue){
+			//names are only read up to their terminator, fields that stopped matching are left out
+			for(uint8 j = 0; j < iFieldCount; ++j){
+				if((candidates & (1UL << j)) && (malformed || ioFields[j].name[nameLength] != c))
+					candidates &= ~(1UL << j);
+			}
+			++nameLength;
+		}
+		else if(field != NULL){
+			if(malformed) field->status = FORM_MALFORMED;
+			if(field->value != NULL && field->length + 1 < field->size) field->value[field->length++] = c;
+			else if(field->status == FORM_OK) field->status = FORM_TRUNCATED;
+		}
+	}
+
+	for(uint8 i = 0; i < iFieldCount && result == FORM_OK; ++i){
+		if(ioFields[i].status == FORM_TRUNCATED) result = FORM_TRUNCATED;
+	}
+	LOG_DEBUG(HTTP, "form decoded, status : %d", result);
+	return result;
+}
+
+/***********************************************************************************
+ * FunctionName : httpPut
+ * Description  : Append data to a content writer's output, only counted past iSize
+ *                or when measuring.
+ * Parameters   : oBuffer  	-- output buffer, may be NULL
+ *                iSize    	-- size of output buffer
+ *                ioLength 	-- length written so far, advanced by iLength
+ *                iData    	-- data
+ *                iLength  	-- length of data
+***********************************************************************************/
+void httpPut (char *oBuffer, uint16 iSize, uint16 *ioLength, const char *iData, uint16 iLength){
+	for(uint16 i = 0; i < iLength; ++i, ++(*ioLength)){
+		if(oBuffer != NULL && *ioLength < iSize) oBuffer[*ioLength] = iData[i];
+	}
+}
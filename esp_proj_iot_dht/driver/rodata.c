@@ -0,0 +1,27 @@
+/*
+ * rodata.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "driver/rodata.h"
+
+//only called from task context (no ISR reads flash tables), so accessors are in flash too
+uint8 ICACHE_FLASH_ATTR rodata_read_byte(const void *iAddr){
+	uint32 addr = (uint32)iAddr;
+	uint32 word = *(const uint32*)(addr & ~3);
+	return (word >> ((addr & 3) << 3)) & 0xFF;
+}
+
+void ICACHE_FLASH_ATTR rodata_memcpy(void *oDest, const void *iSrc, uint16 iLength){
+	uint8 *dest = (uint8*)oDest;
+	uint32 addr = (uint32)iSrc;
+	uint32 word = *(const uint32*)(addr & ~3);
+
+	//one aligned load per 4 bytes
+	for(uint16 i = 0; i < iLength; ++i, ++addr){
+		if((addr & 3) == 0) word = *(const uint32*)addr;
+		dest[i] = (word >> ((addr & 3) << 3)) & 0xFF;
+	}
+}
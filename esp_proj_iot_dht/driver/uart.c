@@ -38,6 +38,8 @@ extern UartDevice    UartDev;
 
 LOCAL struct UartBuffer *pTxBuffer = NULL;
 LOCAL struct UartBuffer *pRxBuffer = NULL;
+LOCAL uint32_t tx_dropped = 0;    //messages dropped from a full tx buffer
+LOCAL uart_rx_cb_t rx_cb = NULL;  //consumer of rx buffer, see uart_set_rx_cb
 
 /*uart demo with a system task, to output what uart receives*/
 /*this is a example to process uart data from task,please change the priority to fit your application task if exists*/
@@ -161,13 +163,8 @@ LOCAL void ICACHE_FLASH_ATTR
 uart0_write_char_no_wait(char c)
 {
 #if UART_BUFF_EN    //send to uart0 fifo but do not wait 
-    uint8_t chr;
-
     if (c == '\n') {
-        chr = '\r';
-        tx_buff_enq(&chr, 1);
-        chr = '\n';
-        tx_buff_enq(&chr, 1);
+        tx_buff_enq((char *)"\r\n", 2);    //one enqueue, so a line end is never split by dropping
     } else if (c == '\r') {
 
     } else {
@@ -303,6 +300,11 @@ uart_recvTask(os_event_t *events)
     if (events->sig == 0) {
 #if  UART_BUFF_EN
         Uart_rx_buff_enq();
+
+        if (rx_cb != NULL) {
+            rx_cb();
+        }
+
 #else
         uint8_t fifo_len = (READ_PERI_REG(UART_STATUS(UART0)) >> UART_RXFIFO_CNT_S)&UART_RXFIFO_CNT;
         uint8_t d_tmp = 0;
@@ -354,7 +356,9 @@ uart_init(UartBautRate uart0_br, UartBautRate uart1_br)
     /*option 3: output from uart0 will skip current byte if fifo is full now... */
     /*see uart0_write_char_no_wait:you can output via a buffer or output directly */
     /*os_printf output uart data via uart0 or uart buffer*/
-    //os_install_putc1((void *)uart0_write_char_no_wait);  //use this to print via uart0
+#if UART_BUFF_EN
+    os_install_putc1((void *)uart0_write_char_no_wait);  //log calls only copy into tx buffer
+#endif
 
 #if UART_SELFTEST&UART_BUFF_EN
     os_timer_disarm(&buff_timer_t);
@@ -414,61 +418,57 @@ void uart1_sendStr_no_wait(const char *str)
 
 
 #if UART_BUFF_EN
+#if !UART_RING_POWER_OF_2(UART_TX_BUFFER_SIZE) || !UART_RING_POWER_OF_2(UART_RX_BUFFER_SIZE)
+#error "uart buffer sizes must be powers of 2 (driver/uart_ring.h)"
+#endif
+
 /******************************************************************************
  * FunctionName : Uart_Buf_Init
- * Description  : tx buffer enqueue: fill a first linked buffer
- * Parameters   : char *pdata - data point  to be enqueue
- * Returns      : NONE
+ * Description  : allocate an empty ring buffer (driver/uart_ring.h)
+ * Parameters   : uint32_t buf_size - buffer size, power of 2
+ * Returns      : buffer struct pointer, NULL if there is no heap for it
 *******************************************************************************/
 struct UartBuffer *ICACHE_FLASH_ATTR
 Uart_Buf_Init(uint32_t buf_size)
 {
     uint32_t heap_size = system_get_free_heap_size();
 
-    if (heap_size <= buf_size) {
+    if (heap_size <= buf_size || !UART_RING_POWER_OF_2(buf_size)) {
         DBG1("no buf for uart\n\r");
         return NULL;
     } else {
         DBG("test heap size: %d\n\r", heap_size);
         struct UartBuffer *pBuff = (struct UartBuffer *)os_malloc(sizeof(struct UartBuffer));
+
+        if (pBuff == NULL) {
+            DBG1("uart buf struct MALLOC failed\n\r");
+            return NULL;
+        }
+
         pBuff->UartBuffSize = buf_size;
         pBuff->pUartBuff = (uint8_t *)os_malloc(pBuff->UartBuffSize);
-        pBuff->pInPos = pBuff->pUartBuff;
-        pBuff->pOutPos = pBuff->pUartBuff;
-        pBuff->Space = pBuff->UartBuffSize;
-        pBuff->BuffState = OK;
-        pBuff->nextBuff = NULL;
-        pBuff->TcpControl = RUN;
+
+        if (pBuff->pUartBuff == NULL) {
+            DBG1("uart buf MALLOC failed\n\r");
+            os_free(pBuff);
+            return NULL;
+        }
+
+        pBuff->Head = 0;
+        pBuff->Tail = 0;
         return pBuff;
     }
 }
 
 
-//copy uart buffer
+//copy into uart buffer (producer), caller makes sure data fits
 LOCAL void Uart_Buf_Cpy(struct UartBuffer *pCur, char *pdata, uint16_t data_len)
 {
     if (data_len == 0) {
         return ;
     }
 
-    uint16_t tail_len = pCur->pUartBuff + pCur->UartBuffSize - pCur->pInPos ;
-
-    if (tail_len >= data_len) { //do not need to loop back  the queue
-        os_memcpy(pCur->pInPos, pdata, data_len);
-        pCur->pInPos += (data_len);
-        pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
-        pCur->Space -= data_len;
-    } else {
-        os_memcpy(pCur->pInPos, pdata, tail_len);
-        pCur->pInPos += (tail_len);
-        pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
-        pCur->Space -= tail_len;
-        os_memcpy(pCur->pInPos, pdata + tail_len, data_len - tail_len);
-        pCur->pInPos += (data_len - tail_len);
-        pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
-        pCur->Space -= (data_len - tail_len);
-    }
-
+    uart_ring_write(pCur, (uint8_t *)pdata, data_len);
 }
 
 /******************************************************************************
@@ -485,40 +485,18 @@ uart_buf_free(struct UartBuffer *pBuff)
 }
 
 
-//rx buffer dequeue
+//rx buffer dequeue (consumer)
 uint16_t ICACHE_FLASH_ATTR
 rx_buff_deq(char *pdata, uint16_t data_len)
 {
-    uint16_t buf_len = (pRxBuffer->UartBuffSize - pRxBuffer->Space);
-    uint16_t tail_len = pRxBuffer->pUartBuff + pRxBuffer->UartBuffSize - pRxBuffer->pOutPos ;
-    uint16_t len_tmp = 0;
-    len_tmp = ((data_len > buf_len) ? buf_len : data_len);
-
-    if (pRxBuffer->pOutPos <= pRxBuffer->pInPos) {
-        os_memcpy(pdata, pRxBuffer->pOutPos, len_tmp);
-        pRxBuffer->pOutPos += len_tmp;
-        pRxBuffer->Space += len_tmp;
-    } else {
-        if (len_tmp > tail_len) {
-            os_memcpy(pdata, pRxBuffer->pOutPos, tail_len);
-            pRxBuffer->pOutPos += tail_len;
-            pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
-            pRxBuffer->Space += tail_len;
-
-            os_memcpy(pdata + tail_len, pRxBuffer->pOutPos, len_tmp - tail_len);
-            pRxBuffer->pOutPos += (len_tmp - tail_len);
-            pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
-            pRxBuffer->Space += (len_tmp - tail_len);
-        } else {
-            //os_printf("case 3 in rx deq\n\r");
-            os_memcpy(pdata, pRxBuffer->pOutPos, len_tmp);
-            pRxBuffer->pOutPos += len_tmp;
-            pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
-            pRxBuffer->Space += len_tmp;
-        }
+    if (pRxBuffer == NULL) {
+        return 0;
     }
 
-    if (pRxBuffer->Space >= UART_FIFO_LEN) {
+    uint16_t len_tmp = uart_ring_read(pRxBuffer, (uint8_t *)pdata, data_len);
+
+    //rx interrupts stay off while a whole rx fifo would not fit, see Uart_rx_buff_enq
+    if (uart_ring_free(pRxBuffer) >= UART_FIFO_LEN) {
         uart_rx_intr_enable(UART0);
     }
 
@@ -526,67 +504,105 @@ rx_buff_deq(char *pdata, uint16_t data_len)
 }
 
 
-//move data from uart fifo to rx buffer
+//move data from uart fifo to rx buffer (producer), in uart task
 void Uart_rx_buff_enq()
 {
-    uint8_t fifo_len, buf_idx;
-    uint8_t fifo_data;
-#if 1
-    fifo_len = (READ_PERI_REG(UART_STATUS(UART0)) >> UART_RXFIFO_CNT_S)&UART_RXFIFO_CNT;
+    uint8_t fifo_len;
+    uint8_t *pos;
+    uint32_t run, i;
 
-    if (fifo_len >= pRxBuffer->Space) {
-        os_printf("buf full!!!\n\r");
-    } else {
-        buf_idx = 0;
+    //no rx buffer, input stays in the rx fifo with rx interrupts off
+    if (pRxBuffer == NULL) {
+        return;
+    }
 
-        while (buf_idx < fifo_len) {
-            buf_idx++;
-            fifo_data = READ_PERI_REG(UART_FIFO(UART0)) & 0xFF;
-            *(pRxBuffer->pInPos++) = fifo_data;
+    fifo_len = (READ_PERI_REG(UART_STATUS(UART0)) >> UART_RXFIFO_CNT_S)&UART_RXFIFO_CNT;
 
-            if (pRxBuffer->pInPos == (pRxBuffer->pUartBuff + pRxBuffer->UartBuffSize)) {
-                pRxBuffer->pInPos = pRxBuffer->pUartBuff;
-            }
+    //what does not fit stays in the rx fifo until rx_buff_deq makes room
+    while (fifo_len > 0) {
+        pos = uart_ring_write_ptr(pRxBuffer, &run);
+
+        if (run == 0) {
+            break;
         }
 
-        pRxBuffer->Space -= fifo_len ;
+        if (run > fifo_len) {
+            run = fifo_len;
+        }
 
-        if (pRxBuffer->Space >= UART_FIFO_LEN) {
-            //os_printf("after rx enq buf enough\n\r");
-            uart_rx_intr_enable(UART0);
+        for (i = 0; i < run; i++) {
+            pos[i] = READ_PERI_REG(UART_FIFO(UART0)) & 0xFF;
         }
+
+        uart_ring_commit(pRxBuffer, run);
+        fifo_len -= run;
     }
 
-#endif
+    if (uart_ring_free(pRxBuffer) >= UART_FIFO_LEN) {
+        uart_rx_intr_enable(UART0);
+    }
 }
 
 
-//fill the uart tx buffer
+/******************************************************************************
+ * FunctionName : tx_buff_drop_oldest
+ * Description  : make room in the tx buffer by dropping its oldest lines (messages).
+ *                Tokenised log records escape '\n' inside (user_tlog.h), so they are
+ *                dropped whole like text lines. This moves the consumer index from
+ *                producer side, so it is only called with the tx fifo empty
+ *                interrupt (the consumer) masked
+ * Parameters   : struct UartBuffer *pTxBuff - tx buffer struct pointer
+ *                uint16_t data_len - space needed
+ * Returns      : NONE
+*******************************************************************************/
+LOCAL void ICACHE_FLASH_ATTR
+tx_buff_drop_oldest(struct UartBuffer *pTxBuff, uint16_t data_len)
+{
+    uint32_t tail = pTxBuff->Tail;
+    uint32_t head = pTxBuff->Head;
+    uint32_t mask = pTxBuff->UartBuffSize - 1;
+
+    while (pTxBuff->UartBuffSize - (head - tail) < data_len && tail != head) {
+        while (tail != head && pTxBuff->pUartBuff[tail++ & mask] != '\n');
+
+        tx_dropped++;
+    }
+
+    uart_ring_consume(pTxBuff, tail - pTxBuff->Tail);
+}
+
+//fill the uart tx buffer, oldest messages are dropped (and counted) when it is full
 void ICACHE_FLASH_ATTR
 tx_buff_enq(char *pdata, uint16_t data_len)
 {
-    CLEAR_PERI_REG_MASK(UART_INT_ENA(UART0), UART_TXFIFO_EMPTY_INT_ENA);
-
     if (pTxBuffer == NULL) {
         DBG1("\n\rnull, create buffer struct\n\r");
         pTxBuffer = Uart_Buf_Init(UART_TX_BUFFER_SIZE);
 
-        if (pTxBuffer != NULL) {
-            Uart_Buf_Cpy(pTxBuffer,  pdata,  data_len);
-        } else {
+        if (pTxBuffer == NULL) {
             DBG1("uart tx MALLOC no buf \n\r");
-        }
-    } else {
-        if (data_len <= pTxBuffer->Space) {
-            Uart_Buf_Cpy(pTxBuffer,  pdata,  data_len);
-        } else {
-            DBG1("UART TX BUF FULL!!!!\n\r");
+            tx_dropped++;
+            return;
         }
     }
 
+    //a message larger than the whole buffer is dropped, not cut
+    if (data_len > pTxBuffer->UartBuffSize) {
+        tx_dropped++;
+        return;
+    }
+
+    //ring is lock free, only dropping needs the consumer stopped
+    if (data_len > uart_ring_free(pTxBuffer)) {
+        CLEAR_PERI_REG_MASK(UART_INT_ENA(UART0), UART_TXFIFO_EMPTY_INT_ENA);
+        tx_buff_drop_oldest(pTxBuffer, data_len);
+    }
+
+    Uart_Buf_Cpy(pTxBuffer,  pdata,  data_len);
+
 #if 0
 
-    if (pTxBuffer->Space <= URAT_TX_LOWER_SIZE) {
+    if (uart_ring_free(pTxBuffer) <= URAT_TX_LOWER_SIZE) {
         set_tcp_block();
     }
 
@@ -595,23 +611,66 @@ tx_buff_enq(char *pdata, uint16_t data_len)
     SET_PERI_REG_MASK(UART_INT_ENA(UART0), UART_TXFIFO_EMPTY_INT_ENA);
 }
 
+/******************************************************************************
+ * FunctionName : tx_buff_free
+ * Description  : free space of the tx buffer, lets bulk output wait instead of
+ *                dropping older messages
+ * Parameters   : NONE
+ * Returns      : free bytes
+*******************************************************************************/
+uint16_t ICACHE_FLASH_ATTR
+tx_buff_free(void)
+{
+    return (pTxBuffer != NULL) ? uart_ring_free(pTxBuffer) : 0;
+}
+
+/******************************************************************************
+ * FunctionName : uart_set_rx_cb
+ * Description  : register the consumer of uart0 rx buffer, it is called from
+ *                uart task after each batch moved from rx fifo and should drain
+ *                rx buffer with rx_buff_deq
+ * Parameters   : uart_rx_cb_t cb - callback, NULL to unregister
+ * Returns      : NONE
+*******************************************************************************/
+void ICACHE_FLASH_ATTR
+uart_set_rx_cb(uart_rx_cb_t cb)
+{
+    rx_cb = cb;
+}
 
+/******************************************************************************
+ * FunctionName : uart_get_rx_cb
+ * Description  : current consumer of uart0 rx buffer, so a temporary one can
+ *                hand rx back when it is done
+ * Parameters   : NONE
+ * Returns      : uart_rx_cb_t cb - callback, NULL if none
+*******************************************************************************/
+uart_rx_cb_t ICACHE_FLASH_ATTR
+uart_get_rx_cb(void)
+{
+    return rx_cb;
+}
 
-//--------------------------------
+//move data from tx buffer to tx fifo (consumer), in tx fifo empty interrupt
 LOCAL void tx_fifo_insert(struct UartBuffer *pTxBuff, uint8_t data_len,  uint8_t uart_no)
 {
-    uint8_t i;
+    uint8_t *pos;
+    uint32_t run, i, done = 0;
 
-    for (i = 0; i < data_len; i++) {
-        WRITE_PERI_REG(UART_FIFO(uart_no), *(pTxBuff->pOutPos++));
+    while (done < data_len) {
+        pos = uart_ring_read_ptr(pTxBuff, &run);
 
-        if (pTxBuff->pOutPos == (pTxBuff->pUartBuff + pTxBuff->UartBuffSize)) {
-            pTxBuff->pOutPos = pTxBuff->pUartBuff;
+        if (run > data_len - done) {
+            run = data_len - done;
+        }
+
+        for (i = 0; i < run; i++) {
+            WRITE_PERI_REG(UART_FIFO(uart_no), pos[i]);
         }
-    }
 
-    pTxBuff->pOutPos = (pTxBuff->pUartBuff + (pTxBuff->pOutPos - pTxBuff->pUartBuff) % pTxBuff->UartBuffSize);
-    pTxBuff->Space += data_len;
+        uart_ring_consume(pTxBuff, run);
+        done += run;
+    }
 }
 
 
@@ -626,11 +685,11 @@ void tx_start_uart_buffer(uint8_t uart_no)
     uint8_t tx_fifo_len = (READ_PERI_REG(UART_STATUS(uart_no)) >> UART_TXFIFO_CNT_S)&UART_TXFIFO_CNT;
     uint8_t fifo_remain = UART_FIFO_LEN - tx_fifo_len ;
     uint8_t len_tmp;
-    uint16_t tail_ptx_len, head_ptx_len, data_len;
+    uint32_t data_len;
     //struct UartBuffer* pTxBuff = *get_buff_prt();
 
     if (pTxBuffer) {
-        data_len = (pTxBuffer->UartBuffSize - pTxBuffer->Space);
+        data_len = uart_ring_used(pTxBuffer);
 
         if (data_len > fifo_remain) {
             len_tmp = fifo_remain;
@@ -647,6 +706,17 @@ void tx_start_uart_buffer(uint8_t uart_no)
 
 #endif
 
+/******************************************************************************
+ * FunctionName : uart_tx_dropped
+ * Description  : messages dropped because the tx buffer was full
+ * Parameters   : NONE
+ * Returns      : dropped message count since boot
+*******************************************************************************/
+uint32_t ICACHE_FLASH_ATTR
+uart_tx_dropped(void)
+{
+    return tx_dropped;
+}
 
 void uart_rx_intr_disable(uint8_t uart_no)
 {
@@ -763,7 +833,7 @@ UART_CheckOutputFinished(uint8_t uart_no, uint32_t time_out_us)
         tx_fifo_len = ((READ_PERI_REG(UART_STATUS(uart_no)) >> UART_TXFIFO_CNT_S)&UART_TXFIFO_CNT);
 
         if (pTxBuffer) {
-            tx_buff_len = ((pTxBuffer->UartBuffSize) - (pTxBuffer->Space));
+            tx_buff_len = uart_ring_used(pTxBuffer);
         } else {
             tx_buff_len = 0;
         }
@@ -10,9 +10,6 @@
 
 #include "c_types.h"
 
-//un-comment this for debugging messages
-//#define DHT_DEBUG
-
 typedef enum tempUnits{
 	Celcius,
 	Fahrenheit,
@@ -43,4 +40,11 @@ DHT_STATUS dht_init(const uint8_t iGPIO_Pin);
   */
 DHT_STATUS dht_read(float* ohumidty, float* otemperature, const TEMP_UNITS iTempUnit);
 
+/**
+  * function : duration of the timing critical bus read (start response and 40 data bits)
+  * 			of the last successful dht_read, stabilising delays are not included
+  * @return uint32_t	:	duration in microseconds, 0 if no read succeeded yet
+  */
+uint32_t dht_decode_time(void);
+
 #endif /* INCLUDE_DRIVER_DHT_H_ */
@@ -13,13 +13,13 @@
 //forward declaration
 struct espconn;
 
-//un-comment this for debugging messages
-//#define HTTP_DEBUG
-
 typedef enum httpStatusCode {
 	HTTP_OK, //200,
+	HTTP_Found, //302,
+	HTTP_Not_Modified, //304,
 	HTTP_Bad_Request, //400,
-	HTTP_Not_Found  //404
+	HTTP_Not_Found,  //404
+	HTTP_Service_Unavailable //503
 }HTTP_STATUS_CODE;
 
 typedef enum connectionState{
@@ -27,18 +27,69 @@ typedef enum connectionState{
 	Keep_Alive
 }CONNECTION;
 
+//persistent connection parameters
+#define HTTP_KEEPALIVE_TIMEOUT			5		//seconds, idle connections are closed after this
+#define HTTP_KEEPALIVE_MAX_REQUESTS		8		//requests served on one connection before closing it
+
 typedef enum contentType{
 	text_html,
 	text_css,
-	application_javascript
+	application_javascript,
+	application_json,
+	text_event_stream,		//Server-Sent Events, no Content-Length, connection stays open
+	text_prometheus			//Prometheus text exposition format (version 0.0.4)
 }CONTENT_TYPE;
 
+typedef enum contentEncoding{
+	encoding_identity,
+	encoding_gzip
+}CONTENT_ENCODING;
+
+typedef enum etagType{
+	etag_none,
+	etag_strong,		//byte-identical representation (static assets)
+	etag_weak			//semantically equivalent (dynamic resources)
+}ETAG_TYPE;
+
+typedef enum cacheControl{
+	cache_none,			//no Cache-Control header
+	cache_no_cache,		//store but always revalidate
+	cache_static		//long max-age (HTTP_STATIC_MAX_AGE)
+}CACHE_CONTROL;
+
+//max-age for static assets, in seconds (1 week)
+#define HTTP_STATIC_MAX_AGE		604800
+
+/*
+ * Renders content straight into the send buffer, instead of content being copied from
+ * an intermediate buffer. Called with oBuffer NULL it only returns the length it needs.
+ */
+typedef uint16 (*HTTP_CONTENT_WRITER)(char *oBuffer, uint16 iSize);
+
+/*
+ * Renders next part of a chunked (Transfer-Encoding: chunked) content. ioCursor is the
+ * writer's position, 0 on first call. Returns length written, 0 once content is done.
+ */
+typedef uint16 (*HTTP_CHUNK_WRITER)(char *oBuffer, uint16 iSize, uint16 *ioCursor);
+
+//max content rendered in one chunk
+#define HTTP_CHUNK_SIZE			1024
+
 typedef struct httpResponse{
 	HTTP_STATUS_CODE httpStatusCode;
 	CONNECTION connection;
 	char *content;
 	uint16 contentLength;
 	CONTENT_TYPE contentType;
+	CONTENT_ENCODING contentEncoding;
+	bool contentInFlash;		//content is ICACHE_RODATA, read only with aligned 4-byte loads
+	HTTP_CONTENT_WRITER contentWriter;	//if set, used instead of content (contentLength still required)
+	HTTP_CHUNK_WRITER chunkWriter;		//if set, response is headers only and content follows as chunks
+	char *location;				//Location header (HTTP_Found), NULL if not sent
+	uint32 etag;				//validator, rendered as "%08x" (strong etags of gzip content get "-gz")
+	ETAG_TYPE etagType;
+	CACHE_CONTROL cacheControl;
+	uint8 keepAliveMax;			//requests still allowed on a Keep_Alive connection
 } HTTP_RESPONSE_PACKET;
 
 typedef enum httpMethod {
@@ -53,8 +104,31 @@ typedef struct httpRequest{
 	uint16 routeLength;
 	char *data;
 	uint16 dataLength;
+	bool acceptGzip;			//client advertised gzip in Accept-Encoding
+	char *ifNoneMatch;			//If-None-Match header value, NULL if not present
+	uint16 ifNoneMatchLength;
+	CONNECTION connection;		//connection persistence asked by client (HTTP/1.1 defaults to Keep_Alive)
 } HTTP_REQUEST_PACKET;
 
+typedef enum formStatus{
+	FORM_OK,
+	FORM_MISSING,				//field is not in form
+	FORM_TRUNCATED,				//value did not fit field, it is cut
+	FORM_MALFORMED				//bad %xx escape or null (escaped or raw) in data
+}FORM_STATUS;
+
+//application/x-www-form-urlencoded field, decoded value is null terminated
+typedef struct formField{
+	const char *name;			//field name, as decoded
+	char *value;				//output buffer
+	uint16 size;				//size of output buffer, including terminator
+	uint16 length;				//decoded value length
+	FORM_STATUS status;
+} FORM_FIELD;
+
+//max fields decoded in one pass
+#define HTTP_FORM_MAX_FIELDS	32
+
 typedef enum httpMessageType{
 	HTTP_REQUEST,
 	HTTP_RESPONSE
@@ -82,6 +156,40 @@ bool isHttp(char *iRecv, uint16 iLength, HTTP_MESSAGE_TYPE *oMsgType);
 ***********************************************************************************/
 bool processHttpRequest (char *iRecv, uint16 iLength, HTTP_REQUEST_PACKET *oHttpRequest);
 
+/***********************************************************************************
+ * FunctionName : httpNotModified
+ * Description  : Validates request's If-None-Match against response's etag (weak
+ * 				  comparison). If it matches, response is turned into a header only
+ * 				  304 Not Modified.
+ * Parameters   : iHttpRequest  -- processed HTTP request obj
+ *                ioHttpResponse -- HTTP response obj with etag set
+ * Returns      : bool	-- true if client's copy is still valid (response is now 304)
+ * 						-- false otherwise
+***********************************************************************************/
+bool httpNotModified (HTTP_REQUEST_PACKET *iHttpRequest, HTTP_RESPONSE_PACKET *ioHttpResponse);
+
+/***********************************************************************************
+ * FunctionName : buildHttpResponse
+ * Description  : Render Http response (headers and content) into a new packet.
+ * Parameters   : iHttpResponse -- HTTP reponse obj
+ *                oPacket       -- rendered packet, allocated with os_zalloc, caller
+ *                                 frees it once it is sent
+ * Returns      : uint16	-- length of packet, 0 if Failed
+***********************************************************************************/
+uint16 buildHttpResponse (HTTP_RESPONSE_PACKET* iHttpResponse, char **oPacket);
+
+/***********************************************************************************
+ * FunctionName : buildHttpChunk
+ * Description  : Render next chunk of a chunked response into a new packet.
+ * Parameters   : iWriter       -- chunk writer of response
+ *                ioCursor      -- writer position, 0 for first chunk
+ *                oPacket       -- rendered packet, allocated with os_malloc, caller
+ *                                 frees it once it is sent
+ *                oLast         -- true if this is the terminating (zero size) chunk
+ * Returns      : uint16	-- length of packet, 0 if Failed
+***********************************************************************************/
+uint16 buildHttpChunk (HTTP_CHUNK_WRITER iWriter, uint16 *ioCursor, char **oPacket, bool *oLast);
+
 /***********************************************************************************
  * FunctionName : sendHttpResponse
  * Description  : Send Http response to server.
@@ -92,4 +200,44 @@ bool processHttpRequest (char *iRecv, uint16 iLength, HTTP_REQUEST_PACKET *oHttp
 ***********************************************************************************/
 bool sendHttpResponse (struct espconn *espconn, HTTP_RESPONSE_PACKET* iHttpResponse);
 
+/***********************************************************************************
+ * FunctionName : httpMessageComplete
+ * Description  : check if raw data holds a complete HTTP message, i.e. headers up to
+ * 				  the empty line and Content-Length bytes of body
+ * Parameters   : iRecv	   		 -- received data
+ *                iLength  		 -- length of received data
+ *                oMessageLength -- length of first message in data
+ * Returns      : bool	-- true if message is complete
+ * 						-- false if more data is needed
+***********************************************************************************/
+bool httpMessageComplete (char *iRecv, uint16 iLength, uint16 *oMessageLength);
+
+/***********************************************************************************
+ * FunctionName : httpDecodeForm
+ * Description  : Decode application/x-www-form-urlencoded data into fields in one
+ * 				  pass ('+' and %xx are decoded in names and values). Data need not be
+ * 				  null terminated. First occurrence of a field wins, unknown fields
+ * 				  are skipped.
+ * Parameters   : iData    	-- form data
+ *                iLength  	-- length of form data
+ *                ioFields 	-- fields to decode (name, value and size set)
+ *                iFieldCount -- number of fields (max HTTP_FORM_MAX_FIELDS)
+ * Returns      : FORM_STATUS	-- FORM_MALFORMED if any escape is malformed,
+ * 								   else FORM_TRUNCATED if any field is cut, else FORM_OK
+ * 								   (missing fields only show in their status)
+***********************************************************************************/
+FORM_STATUS httpDecodeForm (const char *iData, uint16 iLength, FORM_FIELD *ioFields, uint8 iFieldCount);
+
+/***********************************************************************************
+ * FunctionName : httpPut
+ * Description  : Append data to a content writer's output. Data past iSize, or all of
+ * 				  it when measuring (oBuffer NULL), is only counted.
+ * Parameters   : oBuffer  	-- output buffer, may be NULL
+ *                iSize    	-- size of output buffer
+ *                ioLength 	-- length written so far, advanced by iLength
+ *                iData    	-- data
+ *                iLength  	-- length of data
+***********************************************************************************/
+void httpPut (char *oBuffer, uint16 iSize, uint16 *ioLength, const char *iData, uint16 iLength);
+
 #endif /* INCLUDE_DRIVER_HTTP_H_ */
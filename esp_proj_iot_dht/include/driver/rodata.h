@@ -0,0 +1,38 @@
+/*
+ * rodata.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_DRIVER_RODATA_H_
+#define INCLUDE_DRIVER_RODATA_H_
+
+#include "c_types.h"
+
+/*
+ * Constant data marked ICACHE_RODATA_ATTR lives in flash (irom) instead of DRAM.
+ * irom is only accessible with aligned 32-bit loads, a byte or half-word load from it
+ * raises a LoadStoreError exception. Declare such data as
+ *
+ * 		static const uint8 table[] ICACHE_RODATA_ATTR STORE_ATTR = {...};
+ *
+ * and read it with the accessors below. uint32 tables can be read directly.
+ */
+
+/**
+  * function : reads one byte of flash resident data
+  * @param iAddr		:	address of byte (in flash)
+  * @return uint8		:	byte value
+  */
+uint8 rodata_read_byte(const void *iAddr);
+
+/**
+  * function : copies flash resident data to RAM
+  * @param oDest		:	destination (in RAM)
+  * @param iSrc			:	source (in flash), any alignment
+  * @param iLength		:	number of bytes to copy
+  */
+void rodata_memcpy(void *oDest, const void *iSrc, uint16 iLength);
+
+#endif /* INCLUDE_DRIVER_RODATA_H_ */
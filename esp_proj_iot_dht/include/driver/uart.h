@@ -28,11 +28,12 @@
 #include "../../../esp_proj_wifi/include/driver/uart_register.h"
 #include "eagle_soc.h"
 #include "c_types.h"
+#include "uart_ring.h"    //struct UartBuffer
 
-#define UART_TX_BUFFER_SIZE 256  //Ring buffer length of tx buffer
-#define UART_RX_BUFFER_SIZE 256 //Ring buffer length of rx buffer
+#define UART_TX_BUFFER_SIZE 2048  //Ring buffer length of tx buffer (power of 2), os_printf is queued here when UART_BUFF_EN
+#define UART_RX_BUFFER_SIZE 256 //Ring buffer length of rx buffer (power of 2)
 
-#define UART_BUFF_EN  0   //use uart buffer  , FOR UART0
+#define UART_BUFF_EN  1   //use uart buffer  , FOR UART0. os_printf only queues into tx buffer, TX fifo empty interrupt drains it
 #define UART_SELFTEST 0   //set 1:enable the loop test demo for uart buffer, FOR UART0
 
 #define UART_HW_RTS   0   //set 1: enable uart hw flow control RTS, PIN MTDO, FOR UART0
@@ -161,16 +162,6 @@ void uart0_sendStr(const char *str);
 #define UART_TX_EMPTY_THRESH_VAL 0x10
 
 
-struct UartBuffer {
-    uint32_t     UartBuffSize;
-    uint8_t     *pUartBuff;
-    uint8_t     *pInPos;
-    uint8_t     *pOutPos;
-    STATUS      BuffState;
-    uint16_t    Space;  //remanent space of the buffer
-    uint8_t     TcpControl;
-    struct  UartBuffer     *nextBuff;
-};
 
 struct UartRxBuff {
     uint32_t     UartRxBuffSize;
@@ -191,6 +182,7 @@ STATUS uart_tx_one_char(uint8_t uart, uint8_t TxChar);
 STATUS uart_tx_one_char_no_wait(uint8_t uart, uint8_t TxChar);
 void  uart1_sendStr_no_wait(const char *str);
 struct UartBuffer  *Uart_Buf_Init();
+typedef void (*uart_rx_cb_t)(void);    //called from uart task once received data is in rx buffer
 
 
 #if UART_BUFF_EN
@@ -201,7 +193,11 @@ LOCAL void  tx_fifo_insert(struct UartBuffer *pTxBuff, uint8_t data_len,  uint8_
 void  tx_start_uart_buffer(uint8_t uart_no);
 uint16_t  rx_buff_deq(char *pdata, uint16_t data_len);
 void  Uart_rx_buff_enq();
+uint16_t  tx_buff_free(void);
+void  uart_set_rx_cb(uart_rx_cb_t cb);
+uart_rx_cb_t  uart_get_rx_cb(void);
 #endif
+uint32_t uart_tx_dropped(void);
 void  uart_rx_intr_enable(uint8_t uart_no);
 void  uart_rx_intr_disable(uint8_t uart_no);
 void uart0_tx_buffer(uint8_t *buf, uint16_t len);
@@ -0,0 +1,155 @@
+/*
+ * uart_ring.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_DRIVER_UART_RING_H_
+#define INCLUDE_DRIVER_UART_RING_H_
+
+#include "c_types.h"
+#include "osapi.h"
+
+/*
+ * Single producer, single consumer byte ring of uart tx and rx buffers.
+ *
+ * Head and Tail are free-running byte counts: the producer only ever writes Head, the
+ * consumer only ever writes Tail, so neither side needs to mask the other. Used bytes
+ * are Head - Tail (correct across uint32 wrap), the offset in the buffer is index & (size - 1),
+ * which is why size must be a power of 2. Copies are split at the wrap point into at most
+ * two contiguous runs.
+ *
+ * Ordering: producer writes data, then publishes Head; consumer reads Head, then data, then
+ * publishes Tail. LX106 is a single in-order core, so UART_RING_BARRIER only has to keep
+ * the compiler (and the write buffer, memw) from moving buffer accesses across the index
+ * stores. On a host it is an acquire-release fence (no instruction on x86) so
+ * tools/uart_ring_bench.c can run the ring across threads.
+ *
+ * Functions here have no ICACHE_FLASH_ATTR, they are called from uart interrupt handler.
+ */
+#if defined(__XTENSA__)
+	#define UART_RING_BARRIER()		__asm__ __volatile__("memw" : : : "memory")
+#else
+	#define UART_RING_BARRIER()		__atomic_thread_fence(__ATOMIC_ACQ_REL)
+#endif
+
+#define UART_RING_POWER_OF_2(size)	((size) != 0 && ((size) & ((size) - 1)) == 0)
+
+struct UartBuffer {
+	uint32_t			UartBuffSize;	//power of 2
+	uint8_t				*pUartBuff;
+	volatile uint32_t	Head;			//bytes ever written, producer only
+	volatile uint32_t	Tail;			//bytes ever read, consumer only
+};
+
+/**
+  * function : bytes waiting in ring
+  * @param pRing		:	ring
+  * @return uint32_t	:	used bytes
+  */
+static inline uint32_t uart_ring_used(const struct UartBuffer *pRing){
+	return pRing->Head - pRing->Tail;
+}
+
+/**
+  * function : room left in ring, as seen by producer (consumer only adds to it)
+  * @param pRing		:	ring
+  * @return uint32_t	:	free bytes
+  */
+static inline uint32_t uart_ring_free(const struct UartBuffer *pRing){
+	return pRing->UartBuffSize - (pRing->Head - pRing->Tail);
+}
+
+/**
+  * function : contiguous run where producer writes next
+  * @param pRing		:	ring
+  * @param oLength		:	free bytes up to end of buffer
+  * @return uint8_t*	:	write position
+  */
+static inline uint8_t *uart_ring_write_ptr(struct UartBuffer *pRing, uint32_t *oLength){
+	uint32_t head = pRing->Head;
+	uint32_t offset = head & (pRing->UartBuffSize - 1);
+	uint32_t room = pRing->UartBuffSize - (head - pRing->Tail);
+	uint32_t run = pRing->UartBuffSize - offset;
+	*oLength = (room < run) ? room : run;
+	return pRing->pUartBuff + offset;
+}
+
+/**
+  * function : publishes bytes written at write position(s)
+  * @param pRing		:	ring
+  * @param iLength		:	bytes written, at most free bytes
+  */
+static inline void uart_ring_commit(struct UartBuffer *pRing, uint32_t iLength){
+	UART_RING_BARRIER();
+	pRing->Head += iLength;
+}
+
+/**
+  * function : contiguous run where consumer reads next
+  * @param pRing		:	ring
+  * @param oLength		:	used bytes up to end of buffer
+  * @return uint8_t*	:	read position
+  */
+static inline uint8_t *uart_ring_read_ptr(struct UartBuffer *pRing, uint32_t *oLength){
+	uint32_t tail = pRing->Tail;
+	uint32_t offset = tail & (pRing->UartBuffSize - 1);
+	uint32_t used = pRing->Head - tail;
+	uint32_t run = pRing->UartBuffSize - offset;
+	UART_RING_BARRIER();
+	*oLength = (used < run) ? used : run;
+	return pRing->pUartBuff + offset;
+}
+
+/**
+  * function : releases bytes read at read position(s) to producer
+  * @param pRing		:	ring
+  * @param iLength		:	bytes read, at most used bytes
+  */
+static inline void uart_ring_consume(struct UartBuffer *pRing, uint32_t iLength){
+	UART_RING_BARRIER();
+	pRing->Tail += iLength;
+}
+
+/**
+  * function : copies data into ring (producer), split at wrap point
+  * @param pRing		:	ring
+  * @param pData		:	data
+  * @param iLength		:	data length, caller makes sure it fits (uart_ring_free)
+  */
+static inline void uart_ring_write(struct UartBuffer *pRing, const uint8_t *pData, uint32_t iLength){
+	uint32_t head = pRing->Head;
+	uint32_t offset = head & (pRing->UartBuffSize - 1);
+	uint32_t run = pRing->UartBuffSize - offset;
+	if (run > iLength) run = iLength;
+
+	os_memcpy(pRing->pUartBuff + offset, pData, run);
+	os_memcpy(pRing->pUartBuff, pData + run, iLength - run);
+	uart_ring_commit(pRing, iLength);
+}
+
+/**
+  * function : copies data out of ring (consumer), split at wrap point
+  * @param pRing		:	ring
+  * @param pData		:	output
+  * @param iLength		:	output size
+  * @return uint32_t	:	bytes copied
+  */
+static inline uint32_t uart_ring_read(struct UartBuffer *pRing, uint8_t *pData, uint32_t iLength){
+	uint32_t tail = pRing->Tail;
+	uint32_t used = pRing->Head - tail;
+	UART_RING_BARRIER();
+	if (iLength > used) iLength = used;
+
+	uint32_t offset = tail & (pRing->UartBuffSize - 1);
+	uint32_t run = pRing->UartBuffSize - offset;
+	if (run > iLength) run = iLength;
+
+	os_memcpy(pData, pRing->pUartBuff + offset, run);
+	os_memcpy(pData + run, pRing->pUartBuff, iLength - run);
+	uart_ring_consume(pRing, iLength);
+	return iLength;
+}
+
+#endif /* INCLUDE_DRIVER_UART_RING_H_ */
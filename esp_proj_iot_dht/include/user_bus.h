@@ -0,0 +1,92 @@
+/*
+ * user_bus.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_BUS_H_
+#define INCLUDE_USER_BUS_H_
+
+#include "c_types.h"
+
+/*
+ * Event bus, the one user task. Events are queued in a ring owned by the bus and
+ * dispatched one per task run, in post order, to the callbacks subscribed to their type;
+ * the SDK task queue only holds a single wakeup. An event equal (type and param) to the
+ * newest pending event of its type is coalesced into it, so a bouncing button or a
+ * repeated SDK event takes one slot and order within a type is kept. Posts that find the
+ * ring full are counted per type and logged from the task, high-water mark of the ring
+ * is kept; both are on /metrics and the console `bus` command.
+ *
+ * The uart driver keeps its own task, it is fed from the uart ISR at its own priority.
+ */
+#define BUS_QUEUE					16			//pending events
+#define BUS_SUBSCRIBERS				8			//callbacks over all types
+
+typedef enum busEvent{
+	BUS_WIFI_INPUT,				//param: WIFI_INPUT
+	BUS_WIFI_TIMEOUT,			//param: generation of state whose timer expired
+	BUS_SERVER_DELETE,			//local server listener to be deleted
+	BUS_SERVER_CLOSE,			//param: local server connection to be disconnected
+	BUS_SERVER_DROP,			//param: drop slot of a local server connection without context, to be disconnected
+	BUS_CLIENT_CLOSE,			//collector upload connection to be disconnected
+	BUS_EVENTS
+} BUS_EVENT;
+
+//called from bus task, may post events (they are dispatched in later task runs)
+typedef void (*BUS_CB)(BUS_EVENT iEvent, uint32 iParam);
+
+typedef struct busStats{
+	uint32 posted;				//all posts, coalesced and dropped ones too
+	uint32 coalesced;			//merged into a pending event
+	uint32 dropped;				//ring was full
+} BUS_STATS;
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  BusSubscribe
+ * Description	:  Subscribes a callback to an event type, first call registers bus task.
+ * 				   Subscribing again is a no-op.
+ * Parameters	:  iEvent -- event type
+ * 				   iCallback -- callback
+ * Return		:  bool, true if subscribed,
+ * 						 false if BUS_SUBSCRIBERS are used up
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR BusSubscribe(BUS_EVENT iEvent, BUS_CB iCallback);
+
+/*******************************************************************************************
+ * FunctionName	:  BusPost
+ * Description	:  Queues an event, callable from ISR (interrupt level is restored, not cleared)
+ * Parameters	:  iEvent -- event type
+ * 				   iParam -- event parameter
+ * Return		:  bool, true if queued or coalesced,
+ * 						 false if dropped (ring full)
+ ******************************************************************************************/
+bool BusPost(BUS_EVENT iEvent, uint32 iParam);
+
+/*******************************************************************************************
+ * FunctionName	:  GetBusStats
+ * Description	:  Post counters of an event type
+ * Parameters	:  iEvent -- event type
+ * 				   oStats -- output
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR GetBusStats(BUS_EVENT iEvent, BUS_STATS *oStats);
+
+/*******************************************************************************************
+ * FunctionName	:  BusHighWater
+ * Description	:  Most events pending at once since boot
+ * Return		:  high-water mark, at most BUS_QUEUE
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR BusHighWater(void);
+
+/*******************************************************************************************
+ * FunctionName	:  BusEventName
+ * Description	:  Name of an event type, as in metric labels
+ * Parameters	:  iEvent -- event type
+ * Return		:  name, "unknown" if out of range
+ ******************************************************************************************/
+const char * ICACHE_FLASH_ATTR BusEventName(BUS_EVENT iEvent);
+
+#endif /* INCLUDE_USER_BUS_H_ */
@@ -0,0 +1,35 @@
+/*
+ * user_console.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_CONSOLE_H_
+#define INCLUDE_USER_CONSOLE_H_
+
+#include "c_types.h"
+
+/*
+ * Line oriented command console on UART0. Received bytes are taken from uart rx buffer in
+ * uart task (one post per rx fifo batch, not per byte) and collected into a static line,
+ * a command runs once its line ends (CR or LF). Type help for commands.
+ */
+#define CONSOLE_LINE_SIZE			64		//longest command line, longer ones are discarded
+#define CONSOLE_ARGS				4		//command and its arguments
+#define CONSOLE_ECHO				1		//echo typed characters, serial terminals do not echo locally
+#define CONSOLE_DUMP_INTERVAL		10		//ms, metrics dump waits this long for tx buffer room
+
+//called by read command, takes a sample as sample timer does
+typedef void (*CONSOLE_READ_CB)(void);
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitConsole
+ * Description	:  Starts console, registers it as consumer of uart rx buffer
+ * Parameters	:  iReadSample -- called by read command (may be NULL)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitConsole(CONSOLE_READ_CB iReadSample);
+
+#endif /* INCLUDE_USER_CONSOLE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * user_credentials.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_CREDENTIALS_H_
+#define INCLUDE_USER_CREDENTIALS_H_
+
+#include "c_types.h"
+#include "user_wifi.h"
+
+/*
+ * Known AP's are kept in flash with system_param_save_with_protect, which uses three
+ * sectors from CREDENTIALS_SECTOR (0x3F7000 - 0x3F9FFF, below RF calibration sector)
+ * so a power loss while saving keeps the previous copy.
+ */
+#define CREDENTIALS_SECTOR			0x3F7
+#define CREDENTIALS_MAGIC			0x50414B45
+#define CREDENTIALS_VERSION			1
+#define CREDENTIALS_MAX				5				//known AP's, least recently used one is replaced
+
+//selection
+#define CREDENTIALS_MIN_RSSI		-90				//dBm, weaker AP's are not joined
+#define CREDENTIALS_PREFER_RECENT	5				//dB bonus of last used AP, avoids flapping between equals
+#define CREDENTIALS_ROAM_MARGIN		8				//dB a candidate must beat current BSS by to roam
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitCredentials
+ * Description	:  Loads known AP's from flash, an invalid or missing store (magic, version
+ * 				   or checksum mismatch) is treated as empty
+ * Return		:  number of known AP's
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR InitCredentials(void);
+
+/*******************************************************************************************
+ * FunctionName	:  CredentialCount
+ * Description	:  Number of known AP's
+ * Return		:  number of known AP's
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR CredentialCount(void);
+
+/*******************************************************************************************
+ * FunctionName	:  SaveCredential
+ * Description	:  Adds or updates a known AP (ssid, password, last seen bssid and channel) and
+ * 				   marks it most recently used. Flash is only written when an AP is added or
+ * 				   replaced or its password changed; recency, bssid and channel of a rejoin
+ * 				   are kept in RAM and reach flash with the next write, so after a reboot
+ * 				   without one the previous order applies.
+ * Parameters	:  iAP -- AP that was joined (bssid and channel are kept if bssid_set)
+ * Return		:  bool, true if store is up to date (rejoin: in RAM),
+ * 						 false if write failed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR SaveCredential(const AP_Info *iAP);
+
+/*******************************************************************************************
+ * FunctionName	:  SelectCredential
+ * Description	:  Picks known AP to join from a scan list. Strongest known AP above
+ * 				   CREDENTIALS_MIN_RSSI wins, last used one gets CREDENTIALS_PREFER_RECENT
+ * 				   bonus. When roaming (iCurrent given) candidate must be another BSS and
+ * 				   beat current rssi by CREDENTIALS_ROAM_MARGIN. Needs no SDK calls.
+ * Parameters	:  iScanned -- scan list (one entry per ssid)
+ * 				   iCount -- scan list length
+ * 				   iCurrent -- BSS currently joined (bssid and rssi), NULL if not connected
+ * 				   oAP -- AP to join, with password and scanned bssid, channel and rssi
+ * Return		:  index of known AP chosen, -1 if none (oAP untouched)
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR SelectCredential(const AP_Info *iScanned, uint8 iCount, const AP_Info *iCurrent, AP_Info *oAP);
+
+#endif /* INCLUDE_USER_CREDENTIALS_H_ */
@@ -0,0 +1,47 @@
+/*
+ * user_dns.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_DNS_H_
+#define INCLUDE_USER_DNS_H_
+
+#include "c_types.h"
+
+#define CAPTIVE_DNS_PORT			53
+#define CAPTIVE_DNS_TTL				60		//seconds, kept short so answers do not outlive provisioning
+#define CAPTIVE_DNS_MAX_PACKET		512		//plain DNS over UDP limit, larger queries are dropped
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  StartCaptiveDNS
+ * Description	:  Starts DNS responder on SoftAP, every A query is answered with SoftAP
+ * 				   address so clients land on local server (captive portal)
+ * Return		:  0 if successful, else failed
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR StartCaptiveDNS(void);
+
+/*******************************************************************************************
+ * FunctionName	:  StopCaptiveDNS
+ * Description	:  Stops DNS responder
+ * Return		:  0 if successful, else failed
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR StopCaptiveDNS(void);
+
+/*******************************************************************************************
+ * FunctionName	:  CaptiveDNSResponse
+ * Description	:  Turns a DNS query into its response in place. A (and ANY) questions of
+ * 				   class IN get one answer with iAddress, other questions get an empty
+ * 				   NOERROR answer so clients do not wait for them. Needs no SDK calls.
+ * Parameters	:  ioPacket -- query, overwritten with response
+ * 				   iLength -- query length
+ * 				   iSize -- size of packet buffer (answer is appended after question)
+ * 				   iAddress -- address to answer with (network byte order, as ip_addr)
+ * Return		:  response length, 0 if packet is not a query that can be answered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR CaptiveDNSResponse(uint8 *ioPacket, uint16 iLength, uint16 iSize, const uint8 iAddress[4]);
+
+#endif /* INCLUDE_USER_DNS_H_ */
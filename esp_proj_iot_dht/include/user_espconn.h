@@ -10,11 +10,26 @@
 
 #include "c_types.h"
 
-//uncomment for log messages
-#define ESP_ESPCONN_LOGGER
-
 #define TCP_LOCAL_PORT		80
 
+//local server connection pool, allocated once at init
+#define HTTP_MAX_CONNECTIONS	4		//maximum simultaneous client connections served by local server
+#define HTTP_RX_BUFFER_SIZE		1024	//bytes of a request split over TCP segments that are collected
+#define HTTP_TX_QUEUE_LENGTH	2		//responses queued per connection while previous one is being sent
+#define HTTP_DROP_SLOTS			4		//connections without context waiting for the bus to disconnect them
+
+//remote server (data collector)
+#define COLLECTOR_IP			"192.168.0.105"		//default, see LinkSetCollector
+#define COLLECTOR_PORT			8080
+#define COLLECTOR_DATA_SIZE		128		//largest upload
+
+//Server-Sent Events (events), subscribers hold one of HTTP_MAX_CONNECTIONS each
+#define SSE_MAX_SUBSCRIBERS		2
+#define SSE_HEARTBEAT			15		//seconds between heartbeat comments
+#define SSE_IDLE_TIMEOUT		45		//seconds, subscriber connection idle timeout
+#define SSE_MAX_MISSED			2		//frames missed while previous one is unsent before dropping subscriber
+#define SSE_RETRY				5000	//ms, client reconnect delay
+
 // APIs
 
 /*******************************************************************************************
@@ -38,10 +53,21 @@ sint8 ICACHE_FLASH_ATTR StartLocalServer(void);
  ******************************************************************************************/
 sint8 ICACHE_FLASH_ATTR StopLocalServer(void);
 
+/*******************************************************************************************
+ * FunctionName	:  PublishSample
+ * Description	:  Pushes latest sample to Server-Sent Events subscribers (events)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR PublishSample(void);
+
 /*******************************************************************************************
  * FunctionName	:  SendDataToRemoteServer
- * Description	:
- * Return		:
+ * Description	:  Uploads data to remote server (LinkCollector address) over its own
+ * 				   connection, local server is not affected.
+ * Parameters	:  iUrl -- remote server url (not resolved yet, collector ip is used)
+ * 				   iUrlLength -- url length
+ * 				   iData -- data to upload (copied)
+ * 				   iDataLength -- data length (at most COLLECTOR_DATA_SIZE)
+ * Return		:  0 if successful, ESPCONN_INPROGRESS if previous upload is not done, else failed
  ******************************************************************************************/
 sint8 ICACHE_FLASH_ATTR SendDataToRemoteServer(char *iUrl, uint16 iUrlLength, char*iData, uint16 iDataLength);
 
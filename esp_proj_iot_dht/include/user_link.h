@@ -0,0 +1,111 @@
+/*
+ * user_link.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_LINK_H_
+#define INCLUDE_USER_LINK_H_
+
+#include "c_types.h"
+
+/*
+ * Link probe opens (and closes) a TCP connection to collector (COLLECTOR_IP:COLLECTOR_PORT
+ * unless LinkSetCollector changed it), connect time is round trip time of the path uploads take. Unlike ICMP it is not blocked
+ * by sites that only let the collector through.
+ */
+#define LINK_PROBE_INTERVAL			30		//seconds between probes while collector is reachable
+#define LINK_PROBE_RETRY			2		//seconds, first retry after a failed probe, doubled on each failure
+#define LINK_PROBE_RETRY_MAX		64		//seconds, backoff limit while collector is down
+#define LINK_PROBE_TIMEOUT			3		//seconds to wait for connect before probe counts as lost
+#define LINK_DOWN_AFTER				2		//consecutive lost probes before collector is reported down
+#define LINK_HISTORY				8		//probes kept for rtt, jitter and loss estimate
+
+//uploads are thinned out on a lossy path, see LinkUploadDue
+#define LINK_LOSSY_PERCENT			25
+#define LINK_LOSSY_UPLOAD_EVERY		2		//upload every Nth sample while path is lossy
+
+//live estimate over last LINK_HISTORY probes
+typedef struct linkQuality{
+	bool reachable;				//collector accepted a connection recently
+	uint8 samples;				//probes in history
+	uint8 loss;					//lost probes, percent of samples
+	uint32 rttMean;				//us, mean connect time of answered probes
+	uint32 jitter;				//us, mean difference of consecutive answered probes
+	uint32 failures;			//consecutive lost probes
+} LINK_QUALITY;
+
+//called when collector becomes reachable or unreachable
+typedef void (*LINK_STATE_CB)(bool iReachable);
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitLinkProbe
+ * Description	:  Initializes link probe, probing starts with StartLinkProbe
+ * Parameters	:  iStateChanged -- called on each reachability change (may be NULL)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitLinkProbe(LINK_STATE_CB iStateChanged);
+
+/*******************************************************************************************
+ * FunctionName	:  StartLinkProbe
+ * Description	:  Clears history and starts probing collector, call once station got ip
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StartLinkProbe(void);
+
+/*******************************************************************************************
+ * FunctionName	:  StopLinkProbe
+ * Description	:  Stops probing, collector is reported unreachable
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StopLinkProbe(void);
+
+/*******************************************************************************************
+ * FunctionName	:  LinkProbeSoon
+ * Description	:  Brings next probe forward (LINK_PROBE_RETRY), call when an upload failed
+ * 				   so a broken path is noticed before next regular probe
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR LinkProbeSoon(void);
+
+/*******************************************************************************************
+ * FunctionName	:  LinkReachable
+ * Description	:  Checks whether collector answered recently
+ * Return		:  bool, true if reachable
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkReachable(void);
+
+/*******************************************************************************************
+ * FunctionName	:  LinkUploadDue
+ * Description	:  Decides whether a sample should be uploaded now. Every sample is uploaded
+ * 				   while path is clean, every LINK_LOSSY_UPLOAD_EVERY th while loss is at or
+ * 				   above LINK_LOSSY_PERCENT and none while collector is unreachable.
+ * Return		:  bool, true if sample should be uploaded
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkUploadDue(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetLinkQuality
+ * Description	:  Computes rtt mean, jitter and loss over probe history
+ * Parameters	:  oQuality -- output
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR GetLinkQuality(LINK_QUALITY *oQuality);
+
+/*******************************************************************************************
+ * FunctionName	:  LinkSetCollector
+ * Description	:  Sets collector address until reboot. Probe history of previous one is
+ * 				   cleared and new collector is probed at once, uploads wait for its answer.
+ * Parameters	:  iIp -- collector ipv4 address, dotted decimal
+ * 				   iPort -- collector tcp port
+ * Return		:  bool, true if set, false if address or port is invalid
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkSetCollector(const char *iIp, uint16 iPort);
+
+/*******************************************************************************************
+ * FunctionName	:  LinkCollector
+ * Description	:  Collector address that probes and uploads connect to
+ * Parameters	:  oIp -- output, ipv4 address (network order, as espconn remote_ip)
+ * 				   oPort -- output, tcp port
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR LinkCollector(uint32 *oIp, uint16 *oPort);
+
+#endif /* INCLUDE_USER_LINK_H_ */
@@ -0,0 +1,121 @@
+/*
+ * user_log.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_LOG_H_
+#define INCLUDE_USER_LOG_H_
+
+//system includes
+#include "c_types.h"
+#include "osapi.h"
+
+//user includes
+#include "user_tlog.h"
+
+//log levels, a message is logged if its level is at most module's level
+#define LOG_LEVEL_NONE				0
+#define LOG_LEVEL_ERROR				1
+#define LOG_LEVEL_WARN				2
+#define LOG_LEVEL_INFO				3
+#define LOG_LEVEL_DEBUG				4
+
+//compile-time floor, calls of a higher (more verbose) level compile to nothing
+#define LOG_FLOOR					LOG_LEVEL_DEBUG
+
+//uncomment to log tokenised (user_tlog.h): message id and packed arguments instead of text,
+//decode captured UART output with tools/tlog.py
+//#define ESP_LOG_TOKENISED
+
+/*
+ * Modules that log. LOG_INFO(WIFI, ...) prefixes text logs with "[WIFI-INFO] ". Each module
+ * has a runtime level (logLevels, set with LogSetLevels or POST api/log) starting at its
+ * default in user_log.c.
+ */
+typedef enum logModule{
+	LOG_MODULE_ESP,
+	LOG_MODULE_WIFI,
+	LOG_MODULE_WIFI_FSM,
+	LOG_MODULE_ESPCONN,
+	LOG_MODULE_HTTP,
+	LOG_MODULE_DHT,
+	LOG_MODULE_TIMER,
+	LOG_MODULE_LINK,
+	LOG_MODULE_DNS,
+	LOG_MODULE_CREDENTIALS,
+	LOG_MODULE_METRICS,
+	LOG_MODULE_SAMPLES,
+	LOG_MODULE_TRACE,
+	LOG_MODULE_CONSOLE,
+	LOG_MODULE_STREAM,
+	LOG_MODULE_BUS,
+	LOG_MODULES
+} LOG_MODULE;
+
+extern uint8 logLevels[LOG_MODULES];
+
+//largest JSON GetLogLevelsJSON renders
+#define LOG_JSON_SIZE				(LOG_MODULES * 24 + 2)
+
+#ifndef ESP_LOG_TOKENISED
+	#define LOG_PRINT(module, level, message, args...)	do {os_printf("[" #module "-" #level "] " message "\r\n", ##args);} while(0)
+#else
+	#define LOG_PRINT(module, level, message, args...)	TLOG("[" #module "-" #level "] " message, ##args)
+#endif
+
+//true if module logs at level, for code that only prepares log arguments
+#define LOG_ON(module, level)		(LOG_LEVEL_##level <= LOG_FLOOR && LOG_LEVEL_##level <= logLevels[LOG_MODULE_##module])
+
+//one byte load and compare on hot path
+#define _LOG(module, level, message, args...) \
+	do {if(LOG_LEVEL_##level <= logLevels[LOG_MODULE_##module]) LOG_PRINT(module, level, message, ##args);} while(0)
+
+#if LOG_FLOOR >= LOG_LEVEL_ERROR
+	#define LOG_ERROR(module, message, args...)	_LOG(module, ERROR, message, ##args)
+#else
+	#define LOG_ERROR(module, message, args...)	do {} while(0)
+#endif
+
+#if LOG_FLOOR >= LOG_LEVEL_WARN
+	#define LOG_WARN(module, message, args...)	_LOG(module, WARN, message, ##args)
+#else
+	#define LOG_WARN(module, message, args...)	do {} while(0)
+#endif
+
+#if LOG_FLOOR >= LOG_LEVEL_INFO
+	#define LOG_INFO(module, message, args...)	_LOG(module, INFO, message, ##args)
+#else
+	#define LOG_INFO(module, message, args...)	do {} while(0)
+#endif
+
+#if LOG_FLOOR >= LOG_LEVEL_DEBUG
+	#define LOG_DEBUG(module, message, args...)	_LOG(module, DEBUG, message, ##args)
+#else
+	#define LOG_DEBUG(module, message, args...)	do {} while(0)
+#endif
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  LogSetLevels
+ * Description	:  Sets runtime levels of modules, until reboot
+ * Parameters	:  iData -- form (application/x-www-form-urlencoded) of module=level pairs,
+ * 				   e.g. wifi=debug&http=warn, level is none, error, warn, info or debug
+ * 				   iDataLength -- iData length
+ * Return		:  bool, true if at least one level is set and none is invalid
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LogSetLevels(const char *iData, uint16 iDataLength);
+
+/*******************************************************************************************
+ * FunctionName	:  GetLogLevelsJSON
+ * Description	:  Renders runtime levels of modules (api/log) as JSON object,
+ * 				   e.g. {"esp":"debug","wifi":"warn",...}. HTTP_CONTENT_WRITER.
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetLogLevelsJSON(char *oBuffer, uint16 iSize);
+
+#endif /* INCLUDE_USER_LOG_H_ */
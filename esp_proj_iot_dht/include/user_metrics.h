@@ -0,0 +1,89 @@
+/*
+ * user_metrics.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_METRICS_H_
+#define INCLUDE_USER_METRICS_H_
+
+#include "c_types.h"
+
+//how often heap low-water mark and uptime are sampled, in seconds
+#define METRICS_TICK					10
+
+//distinct wifi disconnect reasons counted, others are counted as reason 0
+#define METRICS_DISCONNECT_REASONS		8
+
+//room one metric family renders to with its terminator, RenderMetrics needs this much per
+//family. Largest one is wifi disconnects with all reason slots taken, 532 bytes at 10 digit
+//counts (tools/metrics_test.c). At most HTTP_CHUNK_SIZE.
+#define METRICS_FAMILY_SIZE				640
+
+/*
+ * Plain counters. SDK callbacks and tasks never preempt each other, so hot paths
+ * update them in place with METRIC_INC/METRIC_ADD, no locking or call is needed.
+ */
+typedef enum metricCounter{
+	METRIC_DHT_READ_OK,				//DHT read counters, in DHT_STATUS order
+	METRIC_DHT_READ_FAIL,
+	METRIC_DHT_READ_POLL_ERROR,
+	METRIC_UPLOAD_ATTEMPTS,			//uploads to collector started (connect issued)
+	METRIC_UPLOAD_SUCCESS,			//uploads sent completely
+	METRIC_UPLOAD_BYTES,			//payload bytes sent to collector
+	METRIC_TCP_RECONNECTS,			//aborted TCP connections (reconnect callback)
+	METRIC_PROBE_SUCCESS,			//link probes answered by collector
+	METRIC_PROBE_FAILURES,			//link probes lost (refused or timed out)
+	METRIC_STREAM_FRAMES,			//wired mode records sent
+	METRIC_STREAM_SKIPPED,			//wired mode readings held back (paused, window full, no room)
+	METRIC_STREAM_BYTES,			//wired mode frame bytes sent
+	METRIC_COUNTERS
+} METRIC_COUNTER;
+
+extern uint32 metricCounters[METRIC_COUNTERS];
+
+#define METRIC_INC(counter)				(++metricCounters[(counter)])
+#define METRIC_ADD(counter, value)		(metricCounters[(counter)] += (value))
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitMetrics
+ * Description	:  Starts sampling of heap low-water mark and uptime
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitMetrics(void);
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsSampleHeap
+ * Description	:  Updates heap low-water mark with current free heap, call after large
+ * 				   allocations to catch peaks between ticks
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsSampleHeap(void);
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsDHTDecodeTime
+ * Description	:  Records duration of a DHT bus read in decode latency histogram
+ * Parameters	:  iTime -- duration in microseconds (dht_decode_time)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsDHTDecodeTime(uint32 iTime);
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsWifiDisconnect
+ * Description	:  Counts a station disconnect by its reason
+ * Parameters	:  iReason -- disconnect reason (REASON_* of user_interface.h)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsWifiDisconnect(uint8 iReason);
+
+/*******************************************************************************************
+ * FunctionName	:  RenderMetrics
+ * Description	:  Renders metrics (/metrics) in Prometheus text format, a few metric
+ * 				   families per call so the page is never held in RAM. HTTP_CHUNK_WRITER.
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (at least METRICS_FAMILY_SIZE)
+ * 				   ioCursor -- next metric family, 0 on first call
+ * Return		:  length rendered, 0 once all families are rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR RenderMetrics(char *oBuffer, uint16 iSize, uint16 *ioCursor);
+
+#endif /* INCLUDE_USER_METRICS_H_ */
@@ -0,0 +1,79 @@
+/*
+ * user_samples.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_SAMPLES_H_
+#define INCLUDE_USER_SAMPLES_H_
+
+#include "c_types.h"
+
+//number of recent samples kept in memory (power of 2)
+#define SAMPLE_HISTORY				32
+
+//size of buffer needed to render one sample as JSON
+#define SAMPLE_JSON_SIZE			64
+
+//a sensor reading, values are in tenths so no float formatting is needed
+typedef struct sample{
+	uint32 timestamp;			//system_get_time() when sample was taken (us)
+	sint16 temperature;			//tenths of a degree, in unit of sample cache
+	uint16 humidity;			//tenths of a percent
+} SAMPLE;
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  AddSample
+ * Description	:  Stores a sensor reading in sample cache, overwriting oldest one when full
+ * Parameters	:  iHumidity -- humidity (percent)
+ * 				   iTemperature -- temperature
+ * 				   iTempUnit -- unit of temperature (TEMP_UNITS)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR AddSample(float iHumidity, float iTemperature, uint8 iTempUnit);
+
+/*******************************************************************************************
+ * FunctionName	:  GetLatestSample
+ * Description	:  Used to retrieve latest sample from sample cache
+ * Parameters	:  oSample -- latest sample
+ * Return		:  bool, true if successful,
+ * 						 false if no sample is taken yet
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR GetLatestSample(SAMPLE *oSample);
+
+/*******************************************************************************************
+ * FunctionName	:  GetSampleCount
+ * Description	:  Used to retrieve number of samples taken so far
+ * Return		:  sample count, also sequence number of latest sample
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR GetSampleCount(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetSampleUnit
+ * Description	:  Unit of temperatures in sample cache
+ * Return		:  TEMP_UNITS of latest sample
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR GetSampleUnit(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetLatestSampleJSON
+ * Description	:  Renders latest sample as JSON object {"t":23.4,"h":45.1,"age_ms":0}
+ * Parameters	:  oBuffer -- output buffer (SAMPLE_JSON_SIZE is always enough)
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON, 0 if no sample is taken yet
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetLatestSampleJSON(char *oBuffer, uint16 iSize);
+
+/*******************************************************************************************
+ * FunctionName	:  GetSamplesJSON
+ * Description	:  Renders latest sample and history (api/readings) as JSON, only from
+ * 				   sample cache, sensor is never read. HTTP_CONTENT_WRITER.
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure (must precede rendering)
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetSamplesJSON(char *oBuffer, uint16 iSize);
+
+#endif /* INCLUDE_USER_SAMPLES_H_ */
@@ -0,0 +1,84 @@
+/*
+ * user_stream.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_STREAM_H_
+#define INCLUDE_USER_STREAM_H_
+
+#include "c_types.h"
+
+/*
+ * Wired mode, readings as binary records on UART0 for a gateway on the serial line
+ * (tools/stream_reader.c). Each record is CRC-16 protected and COBS encoded, so it has
+ * no 0x00 byte and ends with one; a reader resyncs on the next 0x00 after any damage.
+ *
+ * Record, little endian, before COBS:
+ *   type (1, STREAM_RECORD_SAMPLE), seq (4), timestamp us (4), temperature tenths (2, signed),
+ *   humidity tenths (2), unit (1), skipped (4), CRC-16/CCITT-FALSE of preceding bytes (2)
+ * seq counts every reading of stream, skipped counts the ones not sent (paused, window full,
+ * no tx room), so reader tells frames lost on the wire from frames held back here.
+ *
+ * While streaming, text logs and SDK prints are off (they would corrupt frames), the
+ * stream takes uart rx from console and reads single control bytes of gateway.
+ */
+#define STREAM_INTERVAL				2000		//ms, default reading interval
+#define STREAM_INTERVAL_MIN			2000		//ms, DHT answers at most every 2 s (dht_read)
+#define STREAM_INTERVAL_MAX			3600000		//ms
+#define STREAM_WINDOW				8			//frames sent ahead of gateway acks, below 128
+#define STREAM_ACK_TIMEOUT			10000		//ms, window full this long: frames in flight are given up
+#define STREAM_WIRED				0			//1: stream from boot, wifi stays off
+
+#define STREAM_RECORD_SAMPLE		0x01
+#define STREAM_RECORD_SIZE			20			//before COBS
+#define STREAM_FRAME_SIZE			(STREAM_RECORD_SIZE + STREAM_RECORD_SIZE / 254 + 2)	//COBS and delimiter
+
+/*
+ * Gateway control bytes. An ack carries the low 7 bits of the frame number (seq - skipped)
+ * of the newest good frame and acks every frame up to it, so a lost or damaged frame or a
+ * lost ack does not hold the window. If acks stop coming, frames in flight are given
+ * up once the window has been full for STREAM_ACK_TIMEOUT and the window opens again.
+ */
+#define STREAM_ACK					0x80		//| frame number & STREAM_ACK_MASK
+#define STREAM_ACK_MASK				0x7F
+#define STREAM_XON					0x11		//resume
+#define STREAM_XOFF					0x13		//pause, readings are skipped
+#define STREAM_STOP					0x04		//leave wired mode, console takes uart rx again
+
+//called on each reading interval, takes a sample as sample timer does
+typedef void (*STREAM_READ_CB)(void);
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  StartStream
+ * Description	:  Enters wired mode, reads every iInterval ms and streams readings
+ * Parameters	:  iInterval -- reading interval in ms (STREAM_INTERVAL_MIN to STREAM_INTERVAL_MAX)
+ * 				   iReadSample -- takes a sample, StreamSample sends it
+ * Return		:  bool, true if started (or interval changed)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR StartStream(uint32 iInterval, STREAM_READ_CB iReadSample);
+
+/*******************************************************************************************
+ * FunctionName	:  StopStream
+ * Description	:  Leaves wired mode, restores logs, uart rx consumer and sample timer
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StopStream(void);
+
+/*******************************************************************************************
+ * FunctionName	:  StreamSample
+ * Description	:  Sends latest sample of sample cache as a record, call after AddSample.
+ * 				   Does nothing unless streaming.
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StreamSample(void);
+
+/*******************************************************************************************
+ * FunctionName	:  Streaming
+ * Description	:  Wired mode state
+ * Return		:  bool, true while streaming
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR Streaming(void);
+
+#endif /* INCLUDE_USER_STREAM_H_ */
@@ -10,36 +10,72 @@
 
 #include "c_types.h"
 
-//uncomment for Debug Log
-//#define ESP_TIMER_LOGGER
+/*
+ * Software timers on one os timer. Entries come from a static pool and sit in a
+ * hierarchical timer wheel: TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots, a
+ * level 0 slot is 1 ms, a slot of each next level spans a whole lower level. Arming
+ * links an entry into the slot of its expiry, disarming unlinks it, both O(1). Higher
+ * level slots are cascaded down as time reaches them. The os timer is only armed for
+ * the next occupied slot (at least once per TIMER_WAKE_MAX), it does not tick.
+ *
+ * Callbacks run from os timer context, never from ISR. Functions here are not ISR safe.
+ */
+#define TIMER_ENTRIES				16			//timers that can be created, at most 254
+#define TIMER_WHEEL_BITS			5
+#define TIMER_WHEEL_SLOTS			(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS			5			//2^25 ms (9.3 h) ahead, later expiries wait in last slot
+#define TIMER_WAKE_MAX				3600000		//ms, keeps ms clock across system_get_time wrap (71 min)
+
+#define TIMER_NONE					0xFF		//no timer (pool is full)
+
+typedef uint8 TIMER_ID;
+typedef void (*TIMER_CB)(void *iArg);
 
 // API's
+
 /*******************************************************************************************
- * FunctionName	:  DisarmTimer1
- * Description	:  Disarms timer1.
- * Return		:  bool, true if successful,
- * 						 false if failed
+ * FunctionName	:  CreateTimer
+ * Description	:  Takes a timer from pool, it starts disarmed
+ * Parameters	:  iCallback -- called on expiry
+ * 				   iArg -- callback argument
+ * Return		:  TIMER_ID, TIMER_NONE if pool is used up (TIMER_ENTRIES)
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR DisarmTimer1(void);
+TIMER_ID ICACHE_FLASH_ATTR CreateTimer(TIMER_CB iCallback, void *iArg);
 
 /*******************************************************************************************
- * FunctionName	:  ArmTimer1
- * Description	:  Arms timer1.
- * Parmaters	:  iTime -- time in seconds
- * 				   iRepeat -- timer repeat
+ * FunctionName	:  ArmTimer
+ * Description	:  Arms a timer, an armed one is re-armed. A periodic timer keeps its phase,
+ * 				   a late expiry does not shift the next one.
+ * Parameters	:  iTimer -- timer
+ * 				   iTime -- time in ms, 0 runs it on next pass
+ * 				   iRepeat -- periodic, every iTime ms (iTime must not be 0)
  * Return		:  bool, true if successful,
  * 						 false if failed
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR ArmTimer1(uint8 iTime, bool iRepeat);
+bool ICACHE_FLASH_ATTR ArmTimer(TIMER_ID iTimer, uint32 iTime, bool iRepeat);
 
 /*******************************************************************************************
- * FunctionName	:  InitTimer1
- * Description	:  Initializes timer1
- * Parameter	:  pfunction -- timer callback function
- * 				   parg -- timer callback arguments
+ * FunctionName	:  DisarmTimer
+ * Description	:  Disarms a timer, also from its own or another timer's callback
+ * Parameters	:  iTimer -- timer
  * Return		:  bool, true if successful,
  * 						 false if failed
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR InitTimer1(void *pfunction, void *parg);
+bool ICACHE_FLASH_ATTR DisarmTimer(TIMER_ID iTimer);
+
+/*******************************************************************************************
+ * FunctionName	:  TimerArmed
+ * Description	:  Timer state
+ * Parameters	:  iTimer -- timer
+ * Return		:  bool, true if armed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR TimerArmed(TIMER_ID iTimer);
+
+/*******************************************************************************************
+ * FunctionName	:  TimerNow
+ * Description	:  Clock of timers
+ * Return		:  ms since boot, wraps after 49 days
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR TimerNow(void);
 
 #endif /* INCLUDE_USER_TIMER_H_ */
@@ -0,0 +1,99 @@
+/*
+ * user_tlog.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_TLOG_H_
+#define INCLUDE_USER_TLOG_H_
+
+#include "c_types.h"
+
+/*
+ * Tokenised logging. TLOG("format", args...) sends a record instead of a text line, the
+ * format string is reduced to a 32 bit hash at compile time and never reaches flash:
+ *
+ *   TLOG_FRAME_START, id (4 bytes LE), arguments..., '\n'
+ *
+ * Integer arguments are zigzag varints (1 to 5 bytes), strings (char or uint8 pointers and
+ * arrays) are copied NUL terminated, cut to TLOG_STRING_MAX. Between start and end, '\n',
+ * TLOG_FRAME_START and TLOG_ESCAPE are sent as TLOG_ESCAPE, byte ^ 0x20, so '\n' ends
+ * records as it ends text lines: the uart tx ring drops whole records when it is full.
+ * Records share the UART with text output, tools/tlog.py builds the id -> format dictionary
+ * from the sources (same hash) and turns a capture back into text.
+ */
+#define TLOG_FRAME_START			0xF5		//never sent in text output (not ASCII, not UTF-8)
+#define TLOG_ESCAPE					0xDB
+#define TLOG_RECORD_SIZE			128			//fits 16 integer arguments, before escapes
+#define TLOG_STRING_MAX				24			//characters kept of a string argument
+#define TLOG_ARGS_MAX				16
+
+//65599 hash (as in tools/tlog.py) of the first TLOG_HASH_LENGTH characters and the length,
+//folds to a constant for a string literal s
+#define TLOG_HASH_LENGTH			64
+#define _TLOG_C(s, i, k)			((i) < sizeof(s) - 1 ? (uint32)(uint8)(s)[(i) < sizeof(s) - 1 ? (i) : 0] * (k) : 0u)
+#define TLOG_HASH(s)				((uint32)(sizeof(s) - 1) + \
+		_TLOG_C(s, 0, 0x0001003fu) + _TLOG_C(s, 1, 0x007e0f81u) + _TLOG_C(s, 2, 0x2e86d0bfu) + _TLOG_C(s, 3, 0x43ec5f01u) + \
+		_TLOG_C(s, 4, 0x162c613fu) + _TLOG_C(s, 5, 0xd62aee81u) + _TLOG_C(s, 6, 0xa311b1bfu) + _TLOG_C(s, 7, 0xd319be01u) + \
+		_TLOG_C(s, 8, 0xb156c23fu) + _TLOG_C(s, 9, 0x6698cd81u) + _TLOG_C(s, 10, 0x0d1b92bfu) + _TLOG_C(s, 11, 0xcc881d01u) + \
+		_TLOG_C(s, 12, 0x7280233fu) + _TLOG_C(s, 13, 0x50c7ac81u) + _TLOG_C(s, 14, 0x8da473bfu) + _TLOG_C(s, 15, 0x4f377c01u) + \
+		_TLOG_C(s, 16, 0xfaa8843fu) + _TLOG_C(s, 17, 0x33b78b81u) + _TLOG_C(s, 18, 0x45ac54bfu) + _TLOG_C(s, 19, 0x7a27db01u) + \
+		_TLOG_C(s, 20, 0xeacfe53fu) + _TLOG_C(s, 21, 0xae686a81u) + _TLOG_C(s, 22, 0x563335bfu) + _TLOG_C(s, 23, 0x6c593a01u) + \
+		_TLOG_C(s, 24, 0xe3f6463fu) + _TLOG_C(s, 25, 0x5fda4981u) + _TLOG_C(s, 26, 0xe03916bfu) + _TLOG_C(s, 27, 0x44cb9901u) + \
+		_TLOG_C(s, 28, 0x871ba73fu) + _TLOG_C(s, 29, 0xe70d2881u) + _TLOG_C(s, 30, 0x04bdf7bfu) + _TLOG_C(s, 31, 0x227ef801u) + \
+		_TLOG_C(s, 32, 0x7540083fu) + _TLOG_C(s, 33, 0xe3010781u) + _TLOG_C(s, 34, 0xe4c1d8bfu) + _TLOG_C(s, 35, 0x24735701u) + \
+		_TLOG_C(s, 36, 0x4f63693fu) + _TLOG_C(s, 37, 0xf2b5e681u) + _TLOG_C(s, 38, 0xa144b9bfu) + _TLOG_C(s, 39, 0x69a8b601u) + \
+		_TLOG_C(s, 40, 0xb685ca3fu) + _TLOG_C(s, 41, 0xb52bc581u) + _TLOG_C(s, 42, 0x5b469abfu) + _TLOG_C(s, 43, 0x111f1501u) + \
+		_TLOG_C(s, 44, 0x4ba72b3fu) + _TLOG_C(s, 45, 0xc962a481u) + _TLOG_C(s, 46, 0x33c77bbfu) + _TLOG_C(s, 47, 0x39d67401u) + \
+		_TLOG_C(s, 48, 0xafc78c3fu) + _TLOG_C(s, 49, 0xce5a8381u) + _TLOG_C(s, 50, 0x4bc75cbfu) + _TLOG_C(s, 51, 0x02ced301u) + \
+		_TLOG_C(s, 52, 0x83e6ed3fu) + _TLOG_C(s, 53, 0x63136281u) + _TLOG_C(s, 54, 0xc4463dbfu) + _TLOG_C(s, 55, 0x8b083201u) + \
+		_TLOG_C(s, 56, 0x69054e3fu) + _TLOG_C(s, 57, 0x268d4181u) + _TLOG_C(s, 58, 0xbe441ebfu) + _TLOG_C(s, 59, 0xf1829101u) + \
+		_TLOG_C(s, 60, 0x0022af3fu) + _TLOG_C(s, 61, 0xb7c82081u) + _TLOG_C(s, 62, 0x5ac0ffbfu) + _TLOG_C(s, 63, 0x553df001u))
+
+//argument count (up to TLOG_ARGS_MAX, after expansion of IP2STR and alike)
+#define _TLOG_NARGS(args...)		_TLOG_NARGS_(0, ##args, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _TLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, rest...)	n
+
+//bit i is set if argument i is a string, arrays decay to pointers through +0
+#define _TLOG_IS_STR(x)				(__builtin_types_compatible_p(typeof((x) + 0), char *) || \
+										__builtin_types_compatible_p(typeof((x) + 0), const char *) || \
+										__builtin_types_compatible_p(typeof((x) + 0), uint8 *) || \
+										__builtin_types_compatible_p(typeof((x) + 0), const uint8 *))
+#define _TLOG_S(x, i)				((uint16)_TLOG_IS_STR(x) << (i))
+#define _TLOG_MASK0()				0
+#define _TLOG_MASK1(a)	(_TLOG_S(a, 0))
+#define _TLOG_MASK2(a,b)	(_TLOG_S(a, 0) | _TLOG_S(b, 1))
+#define _TLOG_MASK3(a,b,c)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2))
+#define _TLOG_MASK4(a,b,c,d)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3))
+#define _TLOG_MASK5(a,b,c,d,e)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4))
+#define _TLOG_MASK6(a,b,c,d,e,f)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5))
+#define _TLOG_MASK7(a,b,c,d,e,f,g)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6))
+#define _TLOG_MASK8(a,b,c,d,e,f,g,h)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7))
+#define _TLOG_MASK9(a,b,c,d,e,f,g,h,i)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8))
+#define _TLOG_MASK10(a,b,c,d,e,f,g,h,i,j)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9))
+#define _TLOG_MASK11(a,b,c,d,e,f,g,h,i,j,k)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10))
+#define _TLOG_MASK12(a,b,c,d,e,f,g,h,i,j,k,l)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10) | _TLOG_S(l, 11))
+#define _TLOG_MASK13(a,b,c,d,e,f,g,h,i,j,k,l,m)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10) | _TLOG_S(l, 11) | _TLOG_S(m, 12))
+#define _TLOG_MASK14(a,b,c,d,e,f,g,h,i,j,k,l,m,n)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10) | _TLOG_S(l, 11) | _TLOG_S(m, 12) | _TLOG_S(n, 13))
+#define _TLOG_MASK15(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10) | _TLOG_S(l, 11) | _TLOG_S(m, 12) | _TLOG_S(n, 13) | _TLOG_S(o, 14))
+#define _TLOG_MASK16(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p)	(_TLOG_S(a, 0) | _TLOG_S(b, 1) | _TLOG_S(c, 2) | _TLOG_S(d, 3) | _TLOG_S(e, 4) | _TLOG_S(f, 5) | _TLOG_S(g, 6) | _TLOG_S(h, 7) | _TLOG_S(i, 8) | _TLOG_S(j, 9) | _TLOG_S(k, 10) | _TLOG_S(l, 11) | _TLOG_S(m, 12) | _TLOG_S(n, 13) | _TLOG_S(o, 14) | _TLOG_S(p, 15))
+#define _TLOG_MASK_(n)				_TLOG_MASK##n
+#define _TLOG_MASK(n)				_TLOG_MASK_(n)
+#define _TLOG_STRINGS(args...)		_TLOG_MASK(_TLOG_NARGS(args))(args)
+
+#define TLOG(message, args...)		TLogWrite(TLOG_HASH(message), _TLOG_NARGS(args), _TLOG_STRINGS(args), ##args)
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  TLogWrite
+ * Description	:  Packs a tokenised log record and queues it on UART0, use TLOG
+ * Parameters	:  iId -- TLOG_HASH of format string
+ * 				   iCount -- number of arguments
+ * 				   iStrings -- bit i set if argument i is a string
+ * 				   ... -- arguments
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TLogWrite(uint32 iId, uint8 iCount, uint16 iStrings, ...);
+
+#endif /* INCLUDE_USER_TLOG_H_ */
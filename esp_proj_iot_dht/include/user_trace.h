@@ -0,0 +1,105 @@
+/*
+ * user_trace.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_TRACE_H_
+#define INCLUDE_USER_TRACE_H_
+
+#include "c_types.h"
+#include "user_interface.h"
+
+//uncomment to compile tracepoints out
+//#define ESP_TRACE_DISABLE
+
+/*
+ * Tracepoints only stamp their id with system_get_time() into a RAM ring, so they stay in
+ * release builds. Ring is drained every TRACE_DRAIN_INTERVAL seconds (and before export):
+ * each stage pairs its end point with latest start point and adds the time between them
+ * to its latency histogram. Points lost to an overflowing ring are counted.
+ */
+#define TRACE_RING					32			//tracepoints buffered between drains (power of 2)
+#define TRACE_DRAIN_INTERVAL		5			//seconds
+#define TRACE_REPORT_INTERVAL		300			//seconds between histogram reports on UART, 0 for none
+
+//histogram buckets, upper bounds in ms grow by 4x from 1 ms, last bucket is +Inf
+#define TRACE_BUCKETS				10
+
+//largest JSON one part of GetTraceJSON renders to
+#define TRACE_JSON_PART_SIZE		384
+
+typedef enum tracePoint{
+	TRACE_USER_INIT,			//espUserInit, SDK init done
+	TRACE_WIFI_CONNECTED,		//station associated
+	TRACE_WIFI_GOT_IP,
+	TRACE_LINK_VERIFIED,		//collector answered link probe
+	TRACE_DHT_START,			//DHT read started
+	TRACE_DHT_END,				//DHT read decoded
+	TRACE_TCP_CONNECT,			//upload connection requested
+	TRACE_TCP_SEND,				//upload connection established, data handed to espconn
+	TRACE_TCP_SENT,				//upload acknowledged (sent callback)
+	TRACE_POINTS
+} TRACE_POINT;
+
+typedef enum traceStage{
+	TRACE_STAGE_ASSOCIATE,		//user init -> wifi connected
+	TRACE_STAGE_DHCP,			//wifi connected -> got ip
+	TRACE_STAGE_VERIFY,			//got ip -> link verified
+	TRACE_STAGE_DHT_READ,		//dht start -> dht end
+	TRACE_STAGE_TCP_CONNECT,	//tcp connect -> tcp send
+	TRACE_STAGE_TCP_ACK,		//tcp send -> tcp sent
+	TRACE_STAGE_UPLOAD,			//dht end -> tcp sent, reading to acknowledged upload
+	TRACE_STAGE_FIRST_UPLOAD,	//user init -> tcp sent, only once per boot
+	TRACE_STAGES
+} TRACE_STAGE;
+
+typedef struct traceEntry{
+	uint32 time;				//system_get_time(), us
+	uint32 point;				//TRACE_POINT
+} TRACE_ENTRY;
+
+extern TRACE_ENTRY traceRing[TRACE_RING];
+extern uint32 traceHead;
+
+#ifndef ESP_TRACE_DISABLE
+	#define TRACE(iPoint)		do {TRACE_ENTRY *_entry = &traceRing[traceHead++ & (TRACE_RING - 1)]; \
+									_entry->time = system_get_time(); _entry->point = (iPoint);} while(0)
+#else
+	#define TRACE(iPoint)		do {} while(0)
+#endif
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitTrace
+ * Description	:  Starts draining tracepoint ring into stage histograms
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitTrace(void);
+
+/*******************************************************************************************
+ * FunctionName	:  TraceReport
+ * Description	:  Prints stage histograms on UART
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TraceReport(void);
+
+/*******************************************************************************************
+ * FunctionName	:  TraceDump
+ * Description	:  Prints ring's latest tracepoints (up to TRACE_RING, oldest first) on UART,
+ * 				   drained ones included
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TraceDump(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetTraceJSON
+ * Description	:  Renders tracepoints (count, first time since boot) and stage histograms
+ * 				   (api/trace) as JSON, a part per call. HTTP_CHUNK_WRITER.
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (at least TRACE_JSON_PART_SIZE)
+ * 				   ioCursor -- next part, 0 on first call
+ * Return		:  length rendered, 0 once all parts are rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetTraceJSON(char *oBuffer, uint16 iSize, uint16 *ioCursor);
+
+#endif /* INCLUDE_USER_TRACE_H_ */
@@ -10,72 +10,51 @@
 
 #include "c_types.h"
 
+//driver libs
+#include "driver/http.h"
+
 //forward declaration
 struct scanned_AP_info;
 
+//comment out to serve "/" as separate HTML, CSS and JS requests (debugging)
+#define WEBPAGE_BUNDLED
+
 /********************************* WEB PAGE *********************************/
 
-static char WIFI_AP_HTML [350] = "<title>ESP8266</title>\
-<meta content='width=device-width,initial-scale=1'name=viewport>\
-<link rel='stylesheet' href='./styles.css'>\
-<script src='./script.js' ></script>\
-<h2>WiFi Networks</h2>\
-<form id=f method=POST>\
-<input id=P type=password name=P placeholder='Enter WiFi Password'><br>\
-<input id=I type=submit value=SUBMIT>\
-</form>";
-
-static char WIFI_AP_CSS [400] = "h2{\
-background-color:#ff9800;\
-padding:2%;\
-font-style:oblique;\
-border-radius:5px;\
-color:#f0f8ff;\
-margin:.5%\
-}\
-form{\
-background-color:#f2f2f2;\
-border-style:groove;\
-border-radius:5px;\
-margin:.5%\
-}\
-div{\
-margin:10px\
-}\
-label{\
-font-size:larger;\
-font-family:sans-serif;\
-margin:2px\
-}\
-#I,#P{\
-padding:.75%;\
-margin:10px;\
-box-shadow:inset 0 1px 3px #ddd;\
-border-radius:4px;\
-border:1px solid #ccc\
-}";
-
-static char WIFI_AP_JS [800] = "document.addEventListener('DOMContentLoaded',function(){\
-let e=document.getElementById('f');\
-for(let t=AP.length-1;t>=0;--t){\
-let n=e.childNodes[0];\
-d=document.createElement('div');\
-r=document.createElement('input');\
-r.setAttribute('type','radio');\
-r.setAttribute('name','S');\
-r.setAttribute('checked','checked');\
-r.setAttribute('value',AP[t]);\
-r.setAttribute('id',AP[t]);\
-d.appendChild(r);\
-let i=document.createElement('label');\
-i.setAttribute('for',AP[t]);\
-i.innerHTML=AP[t];\
-d.appendChild(i);\
-let l=document.createElement('br');\
-d.appendChild(l);\
-e.insertBefore(d,n);\
-}\
-});";
+/*
+ * Web page sources live in webpage/ and are minified, gzip compressed and compiled into
+ * flash resident byte arrays (user/user_webpage_assets.c) by tools/webpage_gen.py.
+ * Both representations are stored in flash and must be read with aligned 4-byte loads.
+ */
+typedef struct webAsset{
+	const uint8 *content;			//minified content (flash)
+	uint16 contentLength;
+	const uint8 *gzipContent;		//gzip compressed content (flash)
+	uint16 gzipContentLength;
+	uint32 etag;					//hash of minified content
+	CONTENT_TYPE contentType;
+} WEB_ASSET;
+
+extern const WEB_ASSET WIFI_AP_HTML;
+extern const WEB_ASSET WIFI_AP_CSS;
+extern const WEB_ASSET WIFI_AP_JS;
+
+/*
+ * Single document version of the page with CSS and JS inlined, so the page loads with one
+ * request. Scan results are appended at send time as "<script>var AP=[...];</script>".
+ * gzipPrefix is a gzip stream of content that is not finished (sync flushed), the tail is
+ * appended to it as a final stored deflate block followed by the gzip trailer.
+ */
+typedef struct webBundle{
+	const uint8 *content;			//minified static part (flash)
+	uint16 contentLength;
+	const uint8 *gzipPrefix;		//gzip header + deflated static part (flash)
+	uint16 gzipPrefixLength;
+	uint32 crc;						//CRC32 of static part
+	uint32 etag;					//hash of static part
+} WEB_BUNDLE;
+
+extern const WEB_BUNDLE WIFI_AP_BUNDLE;
 
 /****************************************************************************/
 
@@ -84,27 +63,69 @@ e.insertBefore(d,n);\
 /*******************************************************************************************
  * FunctionName	:  GetWifi_AP_HTML
  * Description	:  Used to retrieve HTML Page of Station Select Page
- * Return		:  HTML String
+ * Return		:  HTML asset
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_HTML(void);
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_HTML(void);
 
 /*******************************************************************************************
  * FunctionName	:  GetWifi_AP_CSS
  * Description	:  Used to retrieve CSS of HTML Page of Station Select Page
- * Return		:  CSS String
+ * Return		:  CSS asset
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_CSS(void);
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_CSS(void);
 
 /*******************************************************************************************
- * FunctionName	:  GetWifi_AP_CSS
+ * FunctionName	:  GetWifi_AP_JS
  * Description	:  Used to retrieve JS of HTML Page of Station Select Page
- * Return		:  JS String
+ * Return		:  JS asset
+ ******************************************************************************************/
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_JS(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_ScanJSON
+ * Description	:  Renders scan results (api/scan) as JSON array of
+ * 				   {"ssid":"..","rssi":-60,"channel":6,"authmode":3}. HTTP_CONTENT_WRITER.
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_ScanJSON(char *oBuffer, uint16 iSize);
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_BundleSize
+ * Description	:  Used to retrieve size of buffer needed to render Station Select Page bundle
+ * Parameters	:  iGzip -- true, for gzip encoded bundle
+ * Return		:  buffer size
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_BundleSize(bool iGzip);
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_Bundle
+ * Description	:  Renders single document Station Select Page with scanned AP data
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (see GetWifi_AP_BundleSize)
+ * 				   iGzip -- true, to render gzip encoded bundle
+ * Return		:  length of rendered bundle, 0 if buffer is too small
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_Bundle(char *oBuffer, uint16 iSize, bool iGzip);
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_BundleETag
+ * Description	:  Used to retrieve weak validator of Station Select Page bundle
+ * Return		:  hash of bundle, changes whenever page or scan data changes
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR GetWifi_AP_BundleETag(void);
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_DataETag
+ * Description	:  Used to retrieve weak validator of scan results (api/scan)
+ * Return		:  hash of scanned AP data, changes whenever scan data changes
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_JS(void);
+uint32 ICACHE_FLASH_ATTR GetWifi_AP_DataETag(void);
 
 /*******************************************************************************************
  * FunctionName	:  UpdateJSData
- * Description	:  Appends scanned AP data in JS Script
+ * Description	:  Updates scanned AP data served to Station Select Page
  * Parameters	:  scanned_APs -- scanned APs array
  * 				   size -- size of scanned AP's array
  ******************************************************************************************/
@@ -11,9 +11,6 @@
 //system includes
 #include "c_types.h"
 
-//uncomment for log messages
-//#define ESP_WIFI_LOGGER
-
 //Soft-AP Configuration
 #define SOFTAP_SSID					"ESP8266"
 #define SOFTAP_PASSWORD				"esp8266_01"
@@ -22,6 +19,7 @@
 
 //Station Configuration
 #define SCAN_LIST					10			//Maximum number of scanned AP's that will be stored
+#define SCAN_FRESHNESS				30			//seconds, scan button within this reuses last scan
 #define SCAN_BUTTON					5
 
 //Wifi LEDs
@@ -29,22 +27,21 @@
 #define SOFTAP_LED					12
 #define LOS_LED						13
 
-//Wifi Internet ping params
-#define PING_INTERNET_TASK_EVENT	4
-#define GOOGLE_DNS					"8.8.8.8"
-#define PING_COARSE					1
-#define PING_COUNT					2
-
 //Wifi Timers
-#define STATION_TIMER				10 		//seconds
-#define SOFTAP_TIMER				60		//seconds
+#define STATION_TIMER				10 		//seconds, default sample interval (SetSampleInterval)
+#define STATION_TIMER_MAX			65535	//seconds, longest sample interval
+#define SOFTAP_TIMER				60		//seconds, SoftAP is checked for clients (and left) this often
 
 //structure to store scanned Ap info
 typedef struct scanned_AP_info{
 	uint8 ssid[32];
 	uint8 ssid_len;
 	uint8 password[64];
-	//AUTH_MODE authmode;
+	sint8 rssi;
+	uint8 channel;
+	uint8 authmode;			//AUTH_MODE
+	uint8 bssid[6];			//strongest BSS of this ssid
+	bool bssid_set;			//bssid and channel are known (AP is in scan list)
 } AP_Info;
 
 //API's
@@ -52,7 +49,8 @@ typedef struct scanned_AP_info{
 /*******************************************************************************************
  * FunctionName	:  InitWifi
  * Description	:  Initializes Wifi. Set wifi in Station mode and tries to reconnect using
- * 				   saved AP info in flash. If fails to do so, it switches on LOS LED
+ * 				   saved AP info in flash (best known AP of a scan if several are known).
+ * 				   If fails to do so, it switches on LOS LED
  * Parameter	:  Timer_cb -- timer callback function.
  * Return		:  bool, true if successful,
  * 						 false if failed
@@ -63,18 +61,44 @@ bool ICACHE_FLASH_ATTR InitWifi(void* Timer_cb);
  * FunctionName	:  ConnectToStation
  * Description	:  Connects to Wifi Router(AP)
  * Parameters	:  iData -- Raw HTTP Data received consisting of ssid and password
+ * 				   (application/x-www-form-urlencoded, S=<ssid>&P=<password>)
  * 				   iDataLength -- iData length
  * Return		:  bool, true if successful,
- * 						 false if failed
+ * 						 false if form is malformed, ssid is missing or too long
  ******************************************************************************************/
 bool ICACHE_FLASH_ATTR ConnectToStation(char *iData, uint16 iDataLength);
 
 /***************************************************************************************
  * FunctionName	:  ConnectedToInternet
- * Description	:  Checks whether Esp is connected to internet or not
+ * Description	:  Checks whether Esp is connected to internet or not, i.e. station
+ * 				   got ip and collector answers link probes (user_link.h)
  * Returns		:  bool, true if connected
  * 						 false if not connected
  **************************************************************************************/
 bool ICACHE_FLASH_ATTR ConnectedToInternet(void);
 
+/*******************************************************************************************
+ * FunctionName	:  SetSampleInterval
+ * Description	:  Sets sample timer interval until reboot, timer is re-armed at once
+ * 				   if it runs
+ * Parameters	:  iSeconds -- interval in seconds, 1 to STATION_TIMER_MAX
+ * Return		:  bool, true if set
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR SetSampleInterval(uint16 iSeconds);
+
+/*******************************************************************************************
+ * FunctionName	:  GetSampleInterval
+ * Description	:  Sample timer interval
+ * Return		:  interval in seconds
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetSampleInterval(void);
+
+/*******************************************************************************************
+ * FunctionName	:  SetSampling
+ * Description	:  Starts or stops sample timer, it only runs in station mode and not
+ * 				   while readings are streamed (user_stream.h)
+ * Parameters	:  iOn -- true to start
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR SetSampling(bool iOn);
+
 #endif /* INCLUDE_USER_WIFI_H_ */
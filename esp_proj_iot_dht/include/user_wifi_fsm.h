@@ -0,0 +1,111 @@
+/*
+ * user_wifi_fsm.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#ifndef INCLUDE_USER_WIFI_FSM_H_
+#define INCLUDE_USER_WIFI_FSM_H_
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "user_wifi.h"
+
+/*
+ * Station connection state machine. SDK events, scan results, the scan button, link
+ * probe and state timeouts all become WIFI_INPUTs that are queued on the event bus
+ * (user_bus.h) and dispatched one at a time through a transition table, so no two handlers ever
+ * race. Peripherals (LEDs, servers, link probe) follow states through WIFI_STATE_CB.
+ * Only SDK wifi calls are made from here, tools/wifi_sim.c runs it on a Linux host.
+ */
+
+//state timeouts and backoff, seconds
+#define WIFI_SCAN_TIMEOUT			10			//selection scan
+#define WIFI_CONNECT_TIMEOUT		20			//join and DHCP
+#define WIFI_BACKOFF_MIN			1			//after losing AP, doubled on each failed join
+#define WIFI_BACKOFF_MAX			60
+#define ROAM_CHECK_INTERVAL			30			//rssi checks while connected
+#define ROAM_RSSI					-75			//dBm, below this a scan looks for a stronger known AP
+
+typedef enum wifiState{
+	WIFI_IDLE,					//no AP known, waiting for provisioning
+	WIFI_SELECTING,				//scanning for best known AP
+	WIFI_CONNECTING,			//joining AP, waiting for ip
+	WIFI_GOT_IP,				//station has ip, collector not verified (yet)
+	WIFI_VERIFIED,				//collector answers link probes
+	WIFI_BACKOFF,				//waiting before next selection
+	WIFI_PROVISIONING,			//SoftAP serves station select page
+	WIFI_STATES,
+	WIFI_ANY = WIFI_STATES,		//transition table: row matches every state
+	WIFI_SAME					//transition table: state is kept, timeout keeps running
+} WIFI_STATE;
+
+typedef enum wifiInput{
+	WIFI_IN_START,				//boot
+	WIFI_IN_SCAN_BUTTON,		//provisioning requested
+	WIFI_IN_PROVISIONED,		//AP submitted through station select page
+	WIFI_IN_SCAN_DONE,			//scan list updated
+	WIFI_IN_SCAN_FAILED,
+	WIFI_IN_GOT_IP,
+	WIFI_IN_DISCONNECTED,		//AP lost or join failed, leaves of our own are not reported
+	WIFI_IN_LINK_UP,			//collector reachable
+	WIFI_IN_LINK_DOWN,
+	WIFI_IN_TIMEOUT,			//state timeout
+	WIFI_INPUTS
+} WIFI_INPUT;
+
+//called after every transition, also when a state is re-entered (iOld == iNew)
+typedef void (*WIFI_STATE_CB)(WIFI_STATE iOld, WIFI_STATE iNew);
+
+// API's
+
+/*******************************************************************************************
+ * FunctionName	:  InitWifiFsm
+ * Description	:  Subscribes machine to its bus events and loads known AP's, machine starts in WIFI_IDLE
+ * 				   and leaves it on WIFI_IN_START
+ * Parameters	:  iStateChanged -- transition callback (may be NULL)
+ * Return		:  bool, true if successful,
+ * 						 false if failed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR InitWifiFsm(WIFI_STATE_CB iStateChanged);
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmInput
+ * Description	:  Queues an input, safe from ISR
+ * Parameters	:  iInput -- input
+ * Return		:  bool, true if queued (or merged into same pending input)
+ ******************************************************************************************/
+bool WifiFsmInput(WIFI_INPUT iInput);
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmSdkEvent
+ * Description	:  Turns station events of SDK wifi event handler into inputs
+ * Parameters	:  event -- SDK wifi event
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR WifiFsmSdkEvent(System_Event_t *event);
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmProvision
+ * Description	:  Joins an AP given through station select page, from any state
+ * Parameters	:  iAP -- ssid and password (bssid and channel are taken from scan list)
+ * Return		:  bool, true if queued (or merged into same pending input)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR WifiFsmProvision(const AP_Info *iAP);
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmState
+ * Description	:  Current state
+ * Return		:  WIFI_STATE
+ ******************************************************************************************/
+WIFI_STATE ICACHE_FLASH_ATTR WifiFsmState(void);
+
+/*******************************************************************************************
+ * FunctionName	:  WifiStateName
+ * Description	:  Name of a state, for logs
+ * Parameters	:  iState -- state
+ * Return		:  name
+ ******************************************************************************************/
+const char* ICACHE_FLASH_ATTR WifiStateName(WIFI_STATE iState);
+
+#endif /* INCLUDE_USER_WIFI_FSM_H_ */
@@ -0,0 +1,184 @@
+/*
+ * bus_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of the event bus (user/user_bus.c) on SDK task queues: posts before the first
+ * subscriber wait for it, subscriber slots and repeats, one event per task run with a
+ * higher priority task getting its turn in between, then random posts (also from
+ * callbacks, as SDK and ISR posts come in during dispatch) against a model of the ring:
+ * coalescing into the newest pending event of a type only, drops once BUS_QUEUE events
+ * are pending, delivery order per subscriber, per type counters and high-water mark.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o bus_test tools/bus_test.c \
+ *       tools/host_sdk.c user/user_bus.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "user_bus.h"
+#include "host_sdk.h"
+
+#define TEST_STEPS				200000
+#define TEST_LOG_SIZE			64
+#define TEST_OTHER_PRIO			USER_TASK_PRIO_2	//a task above bus task, as SDK ones are
+
+//a delivery: callback (0 or 1, 2 for the other task), event, param
+typedef struct testDelivery{
+	uint8 callback;
+	BUS_EVENT event;
+	uint32 param;
+} TEST_DELIVERY;
+
+static TEST_DELIVERY deliveries[TEST_LOG_SIZE];
+static uint32 delivered = 0;
+static TEST_DELIVERY last;
+static bool postFromCallback = false;
+static os_event_t otherQueue[4];
+
+//model of the ring
+static TEST_DELIVERY pending[BUS_QUEUE];
+static uint8 pendingCount = 0;
+static BUS_STATS modelStats[BUS_EVENTS];
+static uint8 modelHighWater = 0;
+
+/******** test ********/
+
+//keeps first deliveries of a run and the last one
+void _Deliver(uint8 iCallback, BUS_EVENT iEvent, uint32 iParam){
+	last = (TEST_DELIVERY){iCallback, iEvent, iParam};
+	if(delivered < TEST_LOG_SIZE) deliveries[delivered] = last;
+	++delivered;
+}
+
+//posts to bus and model, checks bus answers as model does
+void _Post(BUS_EVENT iEvent, uint32 iParam){
+	bool queued = true;
+	++modelStats[iEvent].posted;
+
+	sint8 newest = -1;
+	for(uint8 i = 0; i < pendingCount; ++i) if(pending[i].event == iEvent) newest = i;
+	if(newest >= 0 && pending[newest].param == iParam) ++modelStats[iEvent].coalesced;
+	else if(pendingCount == BUS_QUEUE){
+		++modelStats[iEvent].dropped;
+		queued = false;
+	}
+	else{
+		pending[pendingCount++] = (TEST_DELIVERY){0, iEvent, iParam};
+		if(pendingCount > modelHighWater) modelHighWater = pendingCount;
+	}
+	HOST_CHECK(BusPost(iEvent, iParam) == queued);
+}
+
+//first subscriber of every type, dispatch must take oldest pending event of model
+void _Callback0(BUS_EVENT iEvent, uint32 iParam){
+	HOST_CHECK(pendingCount > 0 && pending[0].event == iEvent && pending[0].param == iParam);
+	if(pendingCount > 0) memmove(pending, pending + 1, --pendingCount * sizeof(pending[0]));
+	_Deliver(0, iEvent, iParam);
+
+	if(iEvent == BUS_SERVER_DELETE) system_os_post(TEST_OTHER_PRIO, 0, iParam);
+
+	//callbacks post too, some equal to what was just taken off the ring
+	if(postFromCallback && rand() % 2) _Post(rand() % BUS_EVENTS, rand() % 2 ? iParam : rand() % 3);
+}
+
+//second subscriber of two types, called right after first one
+void _Callback1(BUS_EVENT iEvent, uint32 iParam){
+	HOST_CHECK(iEvent == BUS_WIFI_INPUT || iEvent == BUS_SERVER_CLOSE);
+	HOST_CHECK(delivered > 0 && last.callback == 0 && last.event == iEvent && last.param == iParam);
+	_Deliver(1, iEvent, iParam);
+}
+
+void _OtherTask(os_event_t *iEvent){
+	_Deliver(2, 0, iEvent->par);
+}
+
+//runs tasks until all is dispatched
+void _Run(void){
+	delivered = 0;
+	HostRunTasks();
+	HOST_CHECK(pendingCount == 0);
+}
+
+bool _Stats(void){
+	for(uint8 i = 0; i < BUS_EVENTS; ++i){
+		BUS_STATS stats;
+		GetBusStats(i, &stats);
+		if(memcmp(&stats, &modelStats[i], sizeof(stats)) != 0) return false;
+	}
+	return BusHighWater() == modelHighWater;
+}
+
+int main(void){
+	BUS_STATS stats;
+
+	//names and bad types
+	HOST_CHECK(strcmp(BusEventName(BUS_WIFI_INPUT), "wifi_input") == 0 && strcmp(BusEventName(BUS_EVENTS), "unknown") == 0);
+	HOST_CHECK(!BusPost(BUS_EVENTS, 0) && !BusSubscribe(BUS_EVENTS, _Callback0) && !BusSubscribe(BUS_WIFI_INPUT, NULL));
+	GetBusStats(BUS_EVENTS, &stats);
+	HOST_CHECK(stats.posted == 0 && stats.coalesced == 0 && stats.dropped == 0);
+
+	//posts before first subscriber wait for its task
+	_Post(BUS_WIFI_INPUT, 1);
+	_Post(BUS_WIFI_INPUT, 1);
+	_Post(BUS_CLIENT_CLOSE, 0);
+	HostRunTasks();
+	HOST_CHECK(pendingCount == 2 && _Stats() && BusHighWater() == 2);
+	HOST_CHECK(BusSubscribe(BUS_WIFI_INPUT, _Callback0) && BusSubscribe(BUS_WIFI_INPUT, _Callback0));
+
+	//subscriber slots: callback 0 on every type, callback 1 on two, then full
+	for(uint8 i = 0; i < BUS_EVENTS; ++i) HOST_CHECK(BusSubscribe(i, _Callback0));
+	HOST_CHECK(BusSubscribe(BUS_WIFI_INPUT, _Callback1) && BusSubscribe(BUS_SERVER_CLOSE, _Callback1));
+	HOST_CHECK(BUS_EVENTS + 2 == BUS_SUBSCRIBERS);
+	HOST_CHECK(!BusSubscribe(BUS_CLIENT_CLOSE, _Callback1) && BusSubscribe(BUS_SERVER_CLOSE, _Callback1));
+	_Run();
+	HOST_CHECK(delivered == 3 && deliveries[1].callback == 1 && deliveries[2].event == BUS_CLIENT_CLOSE);
+
+	//one event per task run, a higher priority task posted from a callback runs before next event
+	HOST_CHECK(system_os_task(_OtherTask, TEST_OTHER_PRIO, otherQueue, 4));
+	_Post(BUS_SERVER_DELETE, 0);
+	_Post(BUS_SERVER_DELETE, 0);
+	_Post(BUS_SERVER_DROP, 7);
+	_Run();
+	HOST_CHECK(delivered == 3 && deliveries[0].event == BUS_SERVER_DELETE && deliveries[1].callback == 2);
+	HOST_CHECK(deliveries[2].event == BUS_SERVER_DROP && _Stats());
+
+	//coalesced into newest of its type only, order within a type kept
+	_Post(BUS_WIFI_INPUT, 6);
+	_Post(BUS_WIFI_INPUT, 6);
+	_Post(BUS_WIFI_TIMEOUT, 3);
+	_Post(BUS_WIFI_INPUT, 6);
+	_Post(BUS_WIFI_INPUT, 5);
+	_Post(BUS_WIFI_INPUT, 6);
+	HOST_CHECK(pendingCount == 4 && _Stats());
+	_Run();
+	HOST_CHECK(delivered == 7 && deliveries[2].event == BUS_WIFI_TIMEOUT && deliveries[3].param == 5);
+
+	//full ring drops, high-water at BUS_QUEUE
+	for(uint32 i = 0; i < BUS_QUEUE + 4; ++i) _Post(BUS_SERVER_CLOSE, i);
+	HOST_CHECK(_Stats() && BusHighWater() == BUS_QUEUE);
+	_Run();
+	HOST_CHECK(delivered == 2 * BUS_QUEUE && deliveries[2 * BUS_QUEUE - 1].param == BUS_QUEUE - 1);
+
+	//random posts of few params, so they coalesce and fill, also from callbacks
+	postFromCallback = true;
+	for(uint32 step = 0; step < TEST_STEPS; ++step){
+		uint8 posts = rand() % (BUS_QUEUE + 4);
+		for(uint8 i = 0; i < posts; ++i) _Post(rand() % BUS_EVENTS, rand() % 3);
+		_Run();
+		if(step % 1000 == 0) HOST_CHECK(_Stats());
+	}
+	HOST_CHECK(_Stats() && hostPostsDropped == 0);
+	for(uint8 i = 0; i < BUS_EVENTS; ++i){
+		GetBusStats(i, &stats);
+		HOST_CHECK(stats.coalesced > 0 && stats.dropped > 0);
+	}
+	printf("%u posts of wifi_input, %u coalesced, %u dropped\n",
+			modelStats[BUS_WIFI_INPUT].posted, modelStats[BUS_WIFI_INPUT].coalesced, modelStats[BUS_WIFI_INPUT].dropped);
+
+	return HostResult("bus_test");
+}
@@ -0,0 +1,280 @@
+/*
+ * console_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of the UART console (user/user_console.c): bytes are fed through the uart rx
+ * callback in batches as the uart task would and everything the console prints or echoes
+ * is kept as one transcript. Checks line assembly across batches, CR LF and empty lines,
+ * backspace, ignored control bytes, lines at and past CONSOLE_LINE_SIZE, argument
+ * splitting and counts, every command and its bad input, and the metrics dump waiting
+ * for tx buffer room a family at a time. Module source is included so its prints can
+ * be kept.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o console_test tools/console_test.c \
+ *       tools/host_sdk.c user/user_bus.c user/user_timer.c user/user_log.c driver/http.c driver/rodata.c
+ */
+
+#include <string.h>
+#include <stdarg.h>
+
+#include "c_types.h"
+#include "osapi.h"
+#include "espconn.h"
+#include "host_sdk.h"
+
+//console prints go to transcript
+int _Printf(const char *iFormat, ...);
+#undef os_printf
+#define os_printf(format, args...)	_Printf(format, ##args)
+
+#include "../user/user_console.c"
+
+//metrics families RenderMetrics stand-in has
+#define TEST_FAMILIES				3
+
+static char transcript[8192];
+static uint32 transcriptLength = 0;
+static const char *rxData = NULL;
+static uint32 rxLength = 0;
+static uart_rx_cb_t rxCallback = NULL;
+static uint16 txFree = UART_TX_BUFFER_SIZE;
+static uint32 reads = 0;
+static uint16 interval = STATION_TIMER;
+static uint32 collectorIp = 0x0701a8c0;
+static uint16 collectorPort = 8080;
+static bool streaming = false;
+static uint32 streamInterval = 0;
+static uint16 renders = 0;
+
+/******** firmware stand-ins ********/
+
+int _Printf(const char *iFormat, ...){
+	va_list args;
+	va_start(args, iFormat);
+	int length = vsnprintf(transcript + transcriptLength, sizeof(transcript) - transcriptLength, iFormat, args);
+	va_end(args);
+	transcriptLength += length;
+	HOST_CHECK(transcriptLength < sizeof(transcript));
+	return length;
+}
+
+void tx_buff_enq(char *pdata, uint16_t data_len){
+	HOST_CHECK(transcriptLength + data_len < sizeof(transcript));
+	memcpy(transcript + transcriptLength, pdata, data_len);
+	transcriptLength += data_len;
+	transcript[transcriptLength] = '\0';
+}
+
+uint16_t tx_buff_free(void){ return txFree; }
+
+uint16_t rx_buff_deq(char *pdata, uint16_t data_len){
+	uint16 length = rxLength < data_len ? rxLength : data_len;
+	memcpy(pdata, rxData, length);
+	rxData += length;
+	rxLength -= length;
+	return length;
+}
+
+void uart_set_rx_cb(uart_rx_cb_t cb){ rxCallback = cb; }
+
+//rest of driver/http.c links against it, console never sends
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){
+	return ESPCONN_OK;
+}
+
+bool SetSampleInterval(uint16 iSeconds){
+	if(iSeconds == 0) return false;
+	interval = iSeconds;
+	return true;
+}
+
+uint16 GetSampleInterval(void){ return interval; }
+
+bool LinkSetCollector(const char *iIp, uint16 iPort){
+	if(strcmp(iIp, "10.0.0.9") != 0 || iPort == 0) return false;
+	collectorIp = 0x0900000a;
+	collectorPort = iPort;
+	return true;
+}
+
+void LinkCollector(uint32 *oIp, uint16 *oPort){
+	*oIp = collectorIp;
+	*oPort = collectorPort;
+}
+
+bool LinkReachable(void){ return true; }
+
+void GetLinkQuality(LINK_QUALITY *oQuality){
+	*oQuality = (LINK_QUALITY){.reachable = true, .samples = 8, .loss = 25, .rttMean = 12000, .jitter = 3000};
+}
+
+WIFI_STATE WifiFsmState(void){ return 0; }
+const char *WifiStateName(WIFI_STATE iState){ return "verified"; }
+bool wifi_get_ip_info(uint8 if_index, struct ip_info *info){ return true; }
+sint8 wifi_station_get_rssi(void){ return -61; }
+
+void TraceDump(void){ _Printf("<trace dump>\r\n"); }
+void TraceReport(void){ _Printf("<trace report>\r\n"); }
+
+bool StartStream(uint32 iInterval, STREAM_READ_CB iReadSample){
+	if(iInterval < STREAM_INTERVAL_MIN) return false;
+	streamInterval = iInterval;
+	return true;
+}
+
+bool Streaming(void){ return streaming; }
+
+//families of two lines each, LF ends as RenderMetrics renders them
+uint16 RenderMetrics(char *oBuffer, uint16 iSize, uint16 *ioCursor){
+	if(*ioCursor >= TEST_FAMILIES) return 0;
+	HOST_CHECK(iSize >= METRICS_FAMILY_SIZE);
+	++renders;
+	uint16 family = (*ioCursor)++;
+	return sprintf(oBuffer, "# TYPE family_%u counter\nfamily_%u %u\n", family, family, family * 10);
+}
+
+/******** test ********/
+
+void _ReadSample(void){
+	++reads;
+}
+
+//types iText as one rx batch (console takes it in CONSOLE_DEQ_SIZE parts), returns transcript of it
+const char *_Type(const char *iText){
+	transcriptLength = 0;
+	transcript[0] = '\0';
+	rxData = iText;
+	rxLength = strlen(iText);
+	rxCallback();
+	HOST_CHECK(rxLength == 0);
+	return transcript;
+}
+
+bool _Says(const char *iText, const char *iExpected){
+	return strstr(_Type(iText), iExpected) != NULL;
+}
+
+//runs clock a ms at a time until dump renders a family, returns ms it took, 0 if none comes
+uint32 _NextRender(void){
+	uint16 before = renders;
+	for(uint32 ms = 1; ms <= 10 * CONSOLE_DUMP_INTERVAL; ++ms){
+		HostAdvance(1000);
+		if(renders != before) return ms;
+	}
+	return 0;
+}
+
+uint32 _Count(const char *iText, const char *iNeedle){
+	uint32 count = 0;
+	for(const char *c = strstr(iText, iNeedle); c != NULL; c = strstr(c + 1, iNeedle)) ++count;
+	return count;
+}
+
+int main(void){
+	char text[256];
+
+	//without a sampler read and stream refuse
+	InitConsole(NULL);
+	HOST_CHECK(rxCallback != NULL && strstr(transcript, "console ready") != NULL);
+	HOST_CHECK(_Says("read\r\n", "no sampler") && _Says("stream\r\n", "no sampler"));
+	InitConsole(_ReadSample);
+
+	//a line across batches, echoed, runs once at CR LF
+	HOST_CHECK(strcmp(_Type("he"), "he") == 0);
+	_Type("lp\r\n");
+	HOST_CHECK(strncmp(transcript, "lp\r\n", 4) == 0 && _Count(transcript, "  ") == CONSOLE_COMMANDS);
+	HOST_CHECK(strstr(transcript, "interval [seconds]") != NULL && strstr(transcript, "bus -- ") != NULL);
+
+	//empty lines and a lone LF after CR run nothing, print nothing
+	HOST_CHECK(strcmp(_Type("\r\n\n\r\r"), "") == 0);
+	HOST_CHECK(_Count(_Type("read\rread\nread\r\n"), "\r\n") == 3 && reads == 3);
+
+	//backspace and delete edit, control and non ASCII bytes are dropped
+	HOST_CHECK(strstr(_Type("rex\b\x7f" "ead\r"), "rex\b \b\b \bead\r\n") != NULL && reads == 4);
+	HOST_CHECK(strcmp(_Type("\b\b\x7f"), "") == 0);
+	_Type("r\te\x1b" "a\xc3\xa9" "d\n");
+	HOST_CHECK(reads == 5 && strncmp(transcript, "read\r\n", 6) == 0);
+
+	//arguments: runs of spaces split, leading and trailing ones too
+	HOST_CHECK(_Says("   trace    \r\n", "<trace dump>") && _Says("trace  hist\r\n", "<trace report>"));
+	HOST_CHECK(_Says("trace foo\r\n", "usage: trace [hist]"));
+	HOST_CHECK(_Says("trace hist x\r\n", "usage: trace [hist] --"));
+	HOST_CHECK(_Says("read now please\r\n", "usage: read --") && reads == 5);
+	HOST_CHECK(_Says("a b c d\r\n", "unknown command a") && _Says("a b c d e\r\n", "too many arguments"));
+	HOST_CHECK(_Says("Help\r\n", "unknown command Help") && _Says("helpx\r\n", "unknown command helpx"));
+
+	//longest line is CONSOLE_LINE_SIZE - 1, a longer one is dropped whole, even if edited back
+	memset(text, 'x', CONSOLE_LINE_SIZE - 1);
+	strcpy(text + CONSOLE_LINE_SIZE - 1, "\r\n");
+	HOST_CHECK(_Says(text, "unknown command xxx") && _Count(transcript, "x") == 2 * (CONSOLE_LINE_SIZE - 1));
+	memset(text, 'x', CONSOLE_LINE_SIZE);
+	strcpy(text + CONSOLE_LINE_SIZE, "\b\b\r\nread\r\n");
+	HOST_CHECK(_Says(text, "line too long, at most 63 characters") && strstr(transcript, "unknown") == NULL && reads == 6);
+	HOST_CHECK(strchr(transcript, '\b') == NULL);
+	memset(text, 'y', sizeof(text) - 1);
+	text[sizeof(text) - 1] = '\0';
+	_Type(text);
+	HOST_CHECK(_Says("help\r\n", "line too long") && strstr(transcript, "  help") == NULL);
+
+	//interval
+	HOST_CHECK(_Says("interval\r\n", "sample interval 10 s") && _Says("interval 30\r\n", "sample interval 30 s"));
+	HOST_CHECK(_Says("interval 0\r\n", "interval is 1 to 65535 seconds") && interval == 30);
+	HOST_CHECK(_Says("interval 65536\r\n", "interval is 1") && _Says("interval 99999999999\r\n", "interval is 1"));
+	HOST_CHECK(_Says("interval -5\r\n", "interval is 1") && _Says("interval 3s\r\n", "interval is 1") && interval == 30);
+	HOST_CHECK(_Says("interval 65535\r\n", "sample interval 65535 s"));
+	HOST_CHECK(_Says("interval 1 2\r\n", "usage: interval") && interval == 65535);
+
+	//collector, a port keeps its value unless given, a bad one is refused
+	HOST_CHECK(_Says("collector\r\n", "collector 192.168.1.7:8080, reachable : 1"));
+	HOST_CHECK(_Says("collector 10.0.0.9\r\n", "collector 10.0.0.9:8080"));
+	HOST_CHECK(_Says("collector 10.0.0.9 9000\r\n", "collector 10.0.0.9:9000"));
+	HOST_CHECK(_Says("collector 10.0.0.9 65536\r\n", "collector is a.b.c.d") && collectorPort == 9000);
+	HOST_CHECK(_Says("collector 10.0.0.9 x\r\n", "collector is a.b.c.d") && _Says("collector 1.2.3.4\r\n", "collector is"));
+
+	//wifi, log, stream and bus
+	HOST_CHECK(_Says("wifi\r\n", "wifi verified, rssi -61") && strstr(transcript, "rtt 12000 us, jitter 3000 us, loss 25% of 8") != NULL);
+	HOST_CHECK(_Says("log\r\n", "{\"esp\":\"debug\",\"wifi\":\"info\""));
+	HOST_CHECK(_Says("log wifi=debug&dht=none\r\n", "\"wifi\":\"debug\"") && strstr(transcript, "\"dht\":\"none\"") != NULL);
+	HOST_CHECK(_Says("log wifi=loud\r\n", "usage: log module=level") && logLevels[LOG_MODULE_WIFI] == LOG_LEVEL_DEBUG);
+	HOST_CHECK(strcmp(_Type("stream\r\n"), "stream\r\n") == 0 && streamInterval == STREAM_INTERVAL);
+	HOST_CHECK(_Says("stream 5000\r\n", "stream") && streamInterval == 5000);
+	HOST_CHECK(_Says("stream 10\r\n", "interval is 2000 to 3600000 ms") && _Says("stream 3600001\r\n", "interval is 2000"));
+	HOST_CHECK(_Says("stream 2s\r\n", "interval is 2000") && streamInterval == 5000);
+	_Type("bus\r\n");
+	sprintf(text, "queue high-water 0 of %d\r\n", BUS_QUEUE);
+	HOST_CHECK(_Count(transcript, ": posted ") == BUS_EVENTS && strstr(transcript, text) != NULL);
+
+	//metrics: nothing while tx buffer lacks room for a family
+	HOST_CHECK(strcmp(_Type("metrics\r\n"), "metrics\r\n") == 0 && renders == 0);
+	HOST_CHECK(_Says("metrics\r\n", "metrics dump in progress"));
+	transcriptLength = 0;
+	txFree = CONSOLE_DUMP_ROOM - 1;
+	HostAdvance(100 * CONSOLE_DUMP_INTERVAL * 1000);
+	HOST_CHECK(transcriptLength == 0 && renders == 0 && dumping);
+
+	//then a family per CONSOLE_DUMP_INTERVAL, LF as CR LF
+	txFree = CONSOLE_DUMP_ROOM;
+	HOST_CHECK(_NextRender() <= CONSOLE_DUMP_INTERVAL + 1);
+	HOST_CHECK(strcmp(transcript, "# TYPE family_0 counter\r\nfamily_0 0\r\n") == 0);
+	for(uint8 i = 1; i < TEST_FAMILIES; ++i){
+		uint32 ms = _NextRender();
+		HOST_CHECK(ms + 1 >= CONSOLE_DUMP_INTERVAL && ms <= CONSOLE_DUMP_INTERVAL + 1);
+	}
+	HOST_CHECK(_Count(transcript, "\r\n") == 2 * TEST_FAMILIES && _Count(transcript, "\n") == 2 * TEST_FAMILIES);
+	HOST_CHECK(strstr(transcript, "family_2 20\r\n") != NULL);
+	HOST_CHECK(_NextRender() == 0 && !dumping);
+
+	//a stream started during a dump ends it, a new dump starts over
+	_Type("metrics\r\n");
+	HOST_CHECK(_NextRender() > 0 && renders == TEST_FAMILIES + 1);
+	streaming = true;
+	HOST_CHECK(_NextRender() == 0 && !dumping);
+	streaming = false;
+	HOST_CHECK(strcmp(_Type("metrics\r\n"), "metrics\r\n") == 0);
+	HOST_CHECK(_NextRender() > 0 && strstr(transcript, "family_0 0\r\n") != NULL);
+
+	return HostResult("console_test");
+}
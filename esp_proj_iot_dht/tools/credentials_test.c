@@ -0,0 +1,154 @@
+/*
+ * credentials_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of known AP store (user/user_credentials.c) against a flash model that keeps
+ * the last saved copy and counts writes: load of missing and damaged stores, flash is
+ * written only when an AP is added or replaced or its password changed (rejoins and
+ * roams stay in RAM), least recently used AP is replaced, selection with recent bonus,
+ * RSSI floor and roam margin.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o credentials_test \
+ *       tools/credentials_test.c tools/host_sdk.c user/user_credentials.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "user_credentials.h"
+#include "host_sdk.h"
+
+static uint8 flash[4096];
+static bool flashValid = false;
+static uint32 writes = 0;
+
+/******** firmware stand-ins ********/
+
+bool system_param_save_with_protect(uint16 start_sec, void *param, uint16 len){
+	memcpy(flash, param, len);
+	flashValid = true;
+	++writes;
+	return true;
+}
+
+bool system_param_load(uint16 start_sec, uint16 offset, void *param, uint16 len){
+	if(!flashValid) memset(param, 0xFF, len);
+	else memcpy(param, flash + offset, len);
+	return true;
+}
+
+/******** test ********/
+
+AP_Info _Scanned(const char *iSsid, sint8 iRssi, uint8 iBss){
+	AP_Info ap;
+	memset(&ap, 0, sizeof(ap));
+	ap.ssid_len = strlen(iSsid);
+	memcpy(ap.ssid, iSsid, ap.ssid_len);
+	ap.rssi = iRssi;
+	ap.bssid[5] = iBss;
+	ap.bssid_set = true;
+	ap.channel = iBss % 13 + 1;
+	return ap;
+}
+
+AP_Info _Joined(const char *iSsid, const char *iPassword, uint8 iBss){
+	AP_Info ap = _Scanned(iSsid, 0, iBss);
+	strcpy((char*)ap.password, iPassword);
+	return ap;
+}
+
+bool _Selects(const AP_Info *iScanned, uint8 iCount, const AP_Info *iCurrent, const char *iSsid){
+	AP_Info out;
+	if(SelectCredential(iScanned, iCount, iCurrent, &out) < 0) return iSsid == NULL;
+	return iSsid != NULL && out.ssid_len == strlen(iSsid) && memcmp(out.ssid, iSsid, out.ssid_len) == 0;
+}
+
+int main(void){
+	AP_Info out, list[3];
+
+	//empty flash, nothing known
+	HOST_CHECK(InitCredentials() == 0);
+	list[0] = _Scanned("home", -50, 1);
+	HOST_CHECK(_Selects(list, 1, NULL, NULL));
+	AP_Info none;
+	memset(&none, 0, sizeof(none));
+	HOST_CHECK(!SaveCredential(&none));
+
+	//new AP's are written, a rejoin is not
+	AP_Info home = _Joined("home", "pw1", 1), office = _Joined("office", "pw2", 2);
+	HOST_CHECK(SaveCredential(&home) && writes == 1);
+	HOST_CHECK(SaveCredential(&office) && writes == 2);
+	HOST_CHECK(SaveCredential(&home) && writes == 2);
+
+	//roaming between BSS's of a network and between networks stays in RAM
+	for(uint8 i = 0; i < 50; ++i){
+		AP_Info bss = _Joined(i % 3 == 2 ? "office" : "home", i % 3 == 2 ? "pw2" : "pw1", i % 3 == 1 ? 3 : 1);
+		HOST_CHECK(SaveCredential(&bss));
+	}
+	HOST_CHECK(writes == 2);
+
+	//password change is written
+	office = _Joined("office", "new", 2);
+	HOST_CHECK(SaveCredential(&office) && writes == 3);
+	list[0] = _Scanned("office", -60, 2);
+	HOST_CHECK(SelectCredential(list, 1, NULL, &out) >= 0 && strcmp((char*)out.password, "new") == 0);
+
+	//reload, damaged store is dropped
+	HOST_CHECK(InitCredentials() == 2);
+	flash[40] ^= 1;
+	HOST_CHECK(InitCredentials() == 0);
+	flash[40] ^= 1;
+	HOST_CHECK(InitCredentials() == 2);
+
+	//recency from RAM: office rejoined last gets bonus over a slightly stronger home
+	HOST_CHECK(SaveCredential(&office) && writes == 3);
+	list[0] = _Scanned("cafe", -40, 9);
+	list[1] = _Scanned("home", -60, 1);
+	list[2] = _Scanned("office", -63, 2);
+	HOST_CHECK(_Selects(list, 3, NULL, "office"));
+	list[1] = _Scanned("home", -55, 1);
+	HOST_CHECK(_Selects(list, 3, NULL, "home"));
+	HOST_CHECK(SelectCredential(list, 3, NULL, &out) >= 0 && out.bssid[5] == 1 && out.rssi == -55);
+	list[0] = _Scanned("home", CREDENTIALS_MIN_RSSI - 1, 1);
+	HOST_CHECK(_Selects(list, 1, NULL, NULL));
+
+	//roaming needs another BSS, CREDENTIALS_ROAM_MARGIN stronger
+	AP_Info current = _Scanned("office", -78, 2);
+	list[0] = _Scanned("home", -78 + CREDENTIALS_ROAM_MARGIN - 1, 1);
+	list[1] = _Scanned("office", -78, 2);
+	HOST_CHECK(_Selects(list, 2, &current, NULL));
+	list[0] = _Scanned("home", -78 + CREDENTIALS_ROAM_MARGIN, 1);
+	HOST_CHECK(_Selects(list, 2, &current, "home"));
+	list[0] = _Scanned("office", -60, 7);
+	HOST_CHECK(SelectCredential(list, 1, &current, &out) >= 0 && out.bssid[5] == 7);
+	list[0] = _Scanned("office", -60, 2);
+	HOST_CHECK(_Selects(list, 1, &current, NULL));
+
+	//full store replaces least recently used, by RAM recency: home was joined before office
+	HOST_CHECK(SaveCredential(&home) && SaveCredential(&office) && writes == 3);
+	for(uint8 i = 0; i < CREDENTIALS_MAX - 2; ++i){
+		char ssid[8];
+		sprintf(ssid, "n%d", i);
+		AP_Info ap = _Joined(ssid, "x", 20 + i);
+		HOST_CHECK(SaveCredential(&ap));
+	}
+	HOST_CHECK(CredentialCount() == CREDENTIALS_MAX && writes == 3 + CREDENTIALS_MAX - 2);
+	AP_Info extra = _Joined("extra", "y", 30);
+	HOST_CHECK(SaveCredential(&extra) && writes == 4 + CREDENTIALS_MAX - 2);
+	list[0] = _Scanned("home", -30, 1);
+	HOST_CHECK(_Selects(list, 1, NULL, NULL));
+	list[0] = _Scanned("office", -30, 2);
+	HOST_CHECK(_Selects(list, 1, NULL, "office"));
+
+	//recency kept in RAM reached flash with last write
+	HOST_CHECK(InitCredentials() == CREDENTIALS_MAX);
+	list[0] = _Scanned("office", -62, 2);
+	list[1] = _Scanned("extra", -64, 30);
+	HOST_CHECK(_Selects(list, 2, NULL, "extra"));
+
+	return HostResult("credentials_test");
+}
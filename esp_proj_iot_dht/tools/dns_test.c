@@ -0,0 +1,194 @@
+/*
+ * dns_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of captive DNS responder (user/user_dns.c): A and ANY queries are answered
+ * with SoftAP address, other types get an empty NOERROR reply, truncated queries,
+ * compressed question names, several questions, responses and other opcodes are
+ * dropped, random packets never make it write past its buffer. Receive callback does
+ * not answer while SoftAP has no address.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o dns_test tools/dns_test.c \
+ *       tools/host_sdk.c user/user_dns.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "espconn.h"
+#include "user_dns.h"
+#include "host_sdk.h"
+
+#define TEST_SOFTAP_IP			0x0104A8C0		//192.168.4.1, as in ip_info
+
+static const uint8 softAP[4] = {192, 168, 4, 1};
+
+//query for connectivitycheck.gstatic.com with recursion desired and an EDNS OPT record, as dig sends it
+static const uint8 queryA[] = {
+	0x12, 0x34, 0x01, 0x20, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	17, 'c', 'o', 'n', 'n', 'e', 'c', 't', 'i', 'v', 'i', 't', 'y', 'c', 'h', 'e', 'c', 'k',
+	7, 'g', 's', 't', 'a', 't', 'i', 'c', 3, 'c', 'o', 'm', 0,
+	0x00, 0x01, 0x00, 0x01,
+	0x00, 0x00, 0x29, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+#define QUERY_A_QUESTION_END	(sizeof(queryA) - 11)
+
+static uint32 softAPAddress = TEST_SOFTAP_IP;
+static struct espconn *dnsConn = NULL;
+static espconn_recv_callback recvCallback = NULL;
+static uint8 sent[CAPTIVE_DNS_MAX_PACKET];
+static uint16 sentLength = 0;
+static uint32 sends = 0;
+static remot_info remote = {ESPCONN_NONE, 5353, {192, 168, 4, 2}};
+
+/******** firmware stand-ins ********/
+
+bool wifi_get_ip_info(uint8 if_index, struct ip_info *info){
+	memset(info, 0, sizeof(struct ip_info));
+	info->ip.addr = softAPAddress;
+	return if_index == SOFTAP_IF;
+}
+
+sint8 espconn_regist_recvcb(struct espconn *espconn, espconn_recv_callback recv_cb){
+	dnsConn = espconn;
+	recvCallback = recv_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_create(struct espconn *espconn){ return ESPCONN_OK; }
+sint8 espconn_delete(struct espconn *espconn){ return ESPCONN_OK; }
+
+sint8 espconn_get_connection_info(struct espconn *pespconn, remot_info **pcon_info, uint8 typeflags){
+	*pcon_info = &remote;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_sendto(struct espconn *espconn, uint8 *psent, uint16 length){
+	HOST_CHECK(length <= sizeof(sent));
+	memcpy(sent, psent, length);
+	sentLength = length;
+	++sends;
+	return ESPCONN_OK;
+}
+
+/******** test ********/
+
+uint16 _Respond(const uint8 *iQuery, uint16 iLength, uint16 iSize, uint8 *oPacket){
+	memcpy(oPacket, iQuery, iLength);
+	return CaptiveDNSResponse(oPacket, iLength, iSize, softAP);
+}
+
+uint16 _Get16(const uint8 *iData){
+	return (iData[0] << 8) | iData[1];
+}
+
+int main(void){
+	uint8 packet[CAPTIVE_DNS_MAX_PACKET];
+	uint8 query[CAPTIVE_DNS_MAX_PACKET];
+
+	//A query: one answer after question, id and RD kept, EDNS record dropped
+	uint16 length = _Respond(queryA, sizeof(queryA), sizeof(packet), packet);
+	HOST_CHECK(length == QUERY_A_QUESTION_END + 16);
+	HOST_CHECK(packet[0] == 0x12 && packet[1] == 0x34);
+	HOST_CHECK(packet[2] == 0x85 && packet[3] == 0x80);
+	HOST_CHECK(_Get16(packet + 4) == 1 && _Get16(packet + 6) == 1 && _Get16(packet + 8) == 0 && _Get16(packet + 10) == 0);
+	HOST_CHECK(memcmp(packet + 12, queryA + 12, QUERY_A_QUESTION_END - 12) == 0);
+	const uint8 *answer = packet + QUERY_A_QUESTION_END;
+	HOST_CHECK(_Get16(answer) == 0xC00C && _Get16(answer + 2) == 1 && _Get16(answer + 4) == 1);
+	HOST_CHECK(_Get16(answer + 6) == 0 && _Get16(answer + 8) == CAPTIVE_DNS_TTL && _Get16(answer + 10) == 4);
+	HOST_CHECK(memcmp(answer + 12, softAP, 4) == 0);
+
+	//ANY is answered too, AAAA and class CH get an empty NOERROR reply
+	memcpy(query, queryA, sizeof(queryA));
+	query[QUERY_A_QUESTION_END - 3] = 255;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == QUERY_A_QUESTION_END + 16);
+	query[QUERY_A_QUESTION_END - 3] = 28;
+	length = _Respond(query, sizeof(queryA), sizeof(packet), packet);
+	HOST_CHECK(length == QUERY_A_QUESTION_END && (packet[3] & 0x0F) == 0 && _Get16(packet + 6) == 0);
+	query[QUERY_A_QUESTION_END - 3] = 1;
+	query[QUERY_A_QUESTION_END - 1] = 3;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == QUERY_A_QUESTION_END);
+
+	//truncated anywhere before end of question
+	for(uint16 i = 0; i < QUERY_A_QUESTION_END; ++i){
+		HOST_CHECK(_Respond(queryA, i, sizeof(packet), packet) == 0);
+	}
+	HOST_CHECK(_Respond(queryA, QUERY_A_QUESTION_END, sizeof(packet), packet) == QUERY_A_QUESTION_END + 16);
+
+	//no room for answer in buffer, or query longer than buffer
+	HOST_CHECK(_Respond(queryA, QUERY_A_QUESTION_END, QUERY_A_QUESTION_END + 15, packet) == 0);
+	HOST_CHECK(_Respond(queryA, sizeof(queryA), sizeof(queryA) - 1, packet) == 0);
+
+	//compressed question name, pointer to itself and to header
+	static const uint8 queryPointer[] = {0xab, 0xcd, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01};
+	HOST_CHECK(_Respond(queryPointer, sizeof(queryPointer), sizeof(packet), packet) == 0);
+	static const uint8 queryLabelPointer[] = {0xab, 0xcd, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			3, 'w', 'w', 'w', 0xC0, 0x00, 0x00, 0x01, 0x00, 0x01};
+	HOST_CHECK(_Respond(queryLabelPointer, sizeof(queryLabelPointer), sizeof(packet), packet) == 0);
+
+	//one question only
+	memcpy(query, queryA, sizeof(queryA));
+	query[5] = 2;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == 0);
+	query[5] = 0;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == 0);
+	query[4] = 1;
+	query[5] = 1;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == 0);
+
+	//responses and other opcodes (NOTIFY)
+	memcpy(query, queryA, sizeof(queryA));
+	query[2] |= 0x80;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == 0);
+	query[2] = 0x20 | 0x01;
+	HOST_CHECK(_Respond(query, sizeof(queryA), sizeof(packet), packet) == 0);
+
+	//name longer than 255
+	memcpy(query, queryA, 12);
+	length = 12;
+	for(uint8 i = 0; i < 5; ++i){
+		query[length++] = 60;
+		memset(query + length, 'a', 60);
+		length += 60;
+	}
+	query[length++] = 0;
+	memcpy(query + length, "\x00\x01\x00\x01", 4);
+	length += 4;
+	HOST_CHECK(_Respond(query, length, sizeof(packet), packet) == 0);
+
+	//random packets, all with a query header so that name walk is reached
+	for(uint32 i = 0; i < 200000; ++i){
+		uint16 size = 1 + rand() % sizeof(query);
+		for(uint16 j = 0; j < size; ++j) query[j] = rand() % 4 == 0 ? rand() % 4 : rand();
+		query[2] &= 0x07;
+		query[4] = 0;
+		query[5] = 1;
+		uint16 bufferSize = size + rand() % (sizeof(packet) - size + 1);
+		uint8 *buffer = malloc(bufferSize);
+		memcpy(buffer, query, size);
+		length = CaptiveDNSResponse(buffer, size, bufferSize, softAP);
+		HOST_CHECK(length <= bufferSize);
+		free(buffer);
+	}
+
+	//receive callback answers sender with SoftAP address, not while SoftAP has none
+	StartCaptiveDNS();
+	HOST_CHECK(recvCallback != NULL && dnsConn != NULL);
+	memcpy(query, queryA, sizeof(queryA));
+	softAPAddress = 0;
+	recvCallback(dnsConn, (char *)query, sizeof(queryA));
+	HOST_CHECK(sends == 0);
+	softAPAddress = TEST_SOFTAP_IP;
+	recvCallback(dnsConn, (char *)query, sizeof(queryA));
+	HOST_CHECK(sends == 1 && sentLength == QUERY_A_QUESTION_END + 16);
+	HOST_CHECK(memcmp(sent + sentLength - 4, softAP, 4) == 0 && memcmp(query, queryA, sizeof(queryA)) == 0);
+	HOST_CHECK(dnsConn->proto.udp->remote_port == 5353 && memcmp(dnsConn->proto.udp->remote_ip, remote.remote_ip, 4) == 0);
+	StopCaptiveDNS();
+
+	return HostResult("dns_test");
+}
@@ -0,0 +1,199 @@
+/*
+ * form_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of form decoding (httpDecodeForm in driver/http.c): fixed cases for escapes,
+ * empty and repeated fields, truncation and nulls; round trip of random ssid/password
+ * pairs encoded the way browsers do; random garbage (values always terminated and never
+ * past their size, under ASan); forms of 65535 bytes, the largest length there is. Request
+ * bodies (processHttpRequest) are found by a Content-Length header of the head only, in
+ * any case and of any digits, and never reach past received data.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o form_test tools/form_test.c \
+ *       tools/host_sdk.c driver/http.c driver/rodata.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "espconn.h"
+#include "driver/http.h"
+#include "host_sdk.h"
+
+static const char hexDigits[] = "0123456789ABCDEF";
+static char ssid[33];
+static char password[65];
+static FORM_FIELD fields[2];
+
+/******** firmware stand-ins ********/
+
+//rest of driver/http.c links against it, forms never send
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){
+	return ESPCONN_OK;
+}
+
+/******** test ********/
+
+//processes a request from an exact size heap copy, so a read past its end is caught
+bool _Request(const char *iRequest, HTTP_REQUEST_PACKET *oRequest){
+	uint16 length = strlen(iRequest);
+	char *request = malloc(length);
+	memcpy(request, iRequest, length);
+	bool result = processHttpRequest(request, length, oRequest);
+	if(oRequest->data != NULL){
+		oRequest->data = (char *)iRequest + (oRequest->data - request);
+	}
+	free(request);
+	return result;
+}
+
+//body of a request as found, "-" if none
+bool _Body(const char *iRequest, const char *iBody){
+	HTTP_REQUEST_PACKET request;
+	if(!_Request(iRequest, &request)) return false;
+	if(request.data == NULL) return strcmp(iBody, "-") == 0;
+	return request.dataLength == strlen(iBody) && strncmp(request.data, iBody, request.dataLength) == 0;
+}
+
+//form encodes iData, as a browser does (letters and digits as is, space as '+')
+uint32 _Encode(char *oForm, const uint8 *iData, uint32 iLength){
+	uint32 length = 0;
+	for(uint32 i = 0; i < iLength; ++i){
+		uint8 c = iData[i];
+		if(c == ' ') oForm[length++] = '+';
+		else if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) oForm[length++] = c;
+		else{
+			oForm[length++] = '%';
+			oForm[length++] = hexDigits[c >> 4];
+			oForm[length++] = hexDigits[c & 0x0F];
+		}
+	}
+	return length;
+}
+
+//decodes from an exact size heap copy, so ASan sees any read past the data
+FORM_STATUS _Decode(const char *iForm, uint32 iLength){
+	char *data = malloc(iLength > 0 ? iLength : 1);
+	memcpy(data, iForm, iLength);
+	FORM_STATUS status = httpDecodeForm(data, iLength, fields, 2);
+	free(data);
+	return status;
+}
+
+void _CheckTerminated(void){
+	for(uint8 i = 0; i < 2; ++i){
+		HOST_CHECK(fields[i].length < fields[i].size && fields[i].value[fields[i].length] == '\0');
+		HOST_CHECK(strlen(fields[i].value) == fields[i].length || fields[i].status == FORM_MALFORMED);
+	}
+}
+
+int main(void){
+	fields[0] = (FORM_FIELD){.name = "S", .value = ssid, .size = sizeof(ssid)};
+	fields[1] = (FORM_FIELD){.name = "P", .value = password, .size = sizeof(password)};
+
+	//escapes, '+' and an escaped '&'
+	const char *form = "S=My+Net%21%C3%A9&P=pa%26ss";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_OK);
+	HOST_CHECK(strcmp(ssid, "My Net!\xC3\xA9") == 0 && strcmp(password, "pa&ss") == 0);
+
+	//name without '=' is an empty value, missing field stays missing
+	form = "S=abc&P";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_OK && fields[1].status == FORM_OK && password[0] == '\0');
+	form = "S=abc";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_OK && fields[1].status == FORM_MISSING);
+
+	//malformed escapes are kept as is and reported
+	form = "X=1&S=a%2&P=%zz";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_MALFORMED);
+	HOST_CHECK(fields[0].status == FORM_MALFORMED && fields[1].status == FORM_MALFORMED);
+	HOST_CHECK(strcmp(ssid, "a%2") == 0 && strcmp(password, "%zz") == 0);
+
+	//first of repeated fields wins, a longer name with same prefix is another field
+	form = "SS=1&S=first&S=second";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_OK && strcmp(ssid, "first") == 0);
+
+	//value cut at field size
+	form = "S=0123456789012345678901234567890123456789";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_TRUNCATED);
+	HOST_CHECK(fields[0].status == FORM_TRUNCATED && fields[0].length == sizeof(ssid) - 1);
+
+	//null, escaped or raw, can not be held
+	form = "S=a%00b";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_MALFORMED && fields[0].status == FORM_MALFORMED);
+	HOST_CHECK(_Decode("S=a\0b", 5) == FORM_MALFORMED);
+
+	//escape at the very end
+	form = "S=%41";
+	HOST_CHECK(_Decode(form, strlen(form)) == FORM_OK && strcmp(ssid, "A") == 0);
+	HOST_CHECK(_Decode(form, strlen(form) - 1) == FORM_MALFORMED);
+
+	//round trip in either order, with an unknown field first at times
+	static char buffer[1024];
+	for(uint32 n = 0; n < 200000; ++n){
+		uint8 s[32], p[64];
+		uint32 sLength = 1 + rand() % 32, pLength = rand() % 64;
+		for(uint32 i = 0; i < sLength; ++i) s[i] = 1 + rand() % 255;
+		for(uint32 i = 0; i < pLength; ++i) p[i] = 1 + rand() % 255;
+
+		uint32 length = 0;
+		if(rand() % 2) length += sprintf(buffer, "junk=%d&", rand());
+		bool ssidFirst = rand() % 2;
+		length += sprintf(buffer + length, ssidFirst ? "S=" : "P=");
+		length += ssidFirst ? _Encode(buffer + length, s, sLength) : _Encode(buffer + length, p, pLength);
+		length += sprintf(buffer + length, ssidFirst ? "&P=" : "&S=");
+		length += ssidFirst ? _Encode(buffer + length, p, pLength) : _Encode(buffer + length, s, sLength);
+
+		HOST_CHECK(_Decode(buffer, length) == FORM_OK);
+		HOST_CHECK(fields[0].length == sLength && memcmp(ssid, s, sLength) == 0 && ssid[sLength] == '\0');
+		HOST_CHECK(fields[1].length == pLength && memcmp(password, p, pLength) == 0 && password[pLength] == '\0');
+	}
+
+	//garbage, mostly from form characters
+	static const char alphabet[] = "SP=&%+0aFz\x00\xFF";
+	for(uint32 n = 0; n < 500000; ++n){
+		uint32 length = rand() % 80;
+		for(uint32 i = 0; i < length; ++i) buffer[i] = rand() % 3 ? alphabet[rand() % (sizeof(alphabet) - 1)] : rand();
+		_Decode(buffer, length);
+		_CheckTerminated();
+	}
+
+	//largest form there is, index must get past its end (loop used to be endless here)
+	char *large = malloc(65535);
+	memset(large, 'a', 65535);
+	memcpy(large, "P=pw&S=", 7);
+	HOST_CHECK(httpDecodeForm(large, 65535, fields, 2) == FORM_TRUNCATED);
+	HOST_CHECK(strcmp(password, "pw") == 0 && fields[0].status == FORM_TRUNCATED);
+	_CheckTerminated();
+	memcpy(large + 65535 - 4, "&S=x", 4);
+	HOST_CHECK(httpDecodeForm(large, 65535, fields, 2) == FORM_TRUNCATED && fields[0].length == sizeof(ssid) - 1);
+	memcpy(large, "S=s&P=", 6);
+	memcpy(large + 65535 - 4, "%41", 3);
+	HOST_CHECK(httpDecodeForm(large, 65535, fields, 2) == FORM_TRUNCATED && strcmp(ssid, "s") == 0);
+	free(large);
+
+	//request bodies: header name in any case, value cut to received data, digits of any count
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nContent-Length: 5\r\n\r\nS=abcdef", "S=abc"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\ncontent-length:3\r\n\r\nS=abc", "S=a"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nCONTENT-LENGTH: 40\r\n\r\nS=abc", "S=abc"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nContent-Length: 123456789012345678901234\r\n\r\nS=abc", "S=abc"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nContent-Length: 4294967298\r\n\r\nS=abc", "S=abc"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nContent-Length: x\r\n\r\nS=abc", ""));
+
+	//no body without the header in the head, or without the end of the head
+	HOST_CHECK(_Body("GET /api/scan HTTP/1.1\r\nHost: x\r\n\r\n", "-"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\n\r\nContent-Length: 3\r\n", "-"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nContent-Length: 123456789", "-"));
+	HOST_CHECK(_Body("POST /api/wifi HTTP/1.1\r\nX-Content-Length: 3\r\n\r\nS=abc", "-"));
+
+	//message ends after Content-Length bytes, a huge one waits for more data
+	uint16 messageLength = 0;
+	const char *message = "POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\nabGET";
+	HOST_CHECK(httpMessageComplete((char *)message, strlen(message), &messageLength) && messageLength == strlen(message) - 3);
+	message = "POST / HTTP/1.1\r\nContent-Length: 4294967298\r\n\r\nab";
+	HOST_CHECK(!httpMessageComplete((char *)message, strlen(message), &messageLength));
+
+	return HostResult("form_test");
+}
@@ -0,0 +1,235 @@
+/*
+ * host_sdk.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * SDK stand-ins for host tests, see host_sdk.h. No SDK header is included here: SDK
+ * versions declare ets_* and heap functions with slightly different types, these
+ * definitions only have to link.
+ */
+
+#include "host_sdk.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define HOST_TIMERS				32
+#define HOST_TASK_PRIOS			3
+
+typedef void (*HOST_TIMER_FUNC)(void *iArg);
+
+typedef struct hostTimer{
+	void *timer;				//os_timer_t of firmware, only its address is used
+	HOST_TIMER_FUNC func;
+	void *arg;
+	bool armed;
+	uint64_t due;				//us on 64 bit clock
+	uint64_t period;			//us, 0 if one-shot
+} HOST_TIMER;
+
+typedef struct hostEvent{
+	uint32_t sig;
+	uint32_t par;
+} HOST_EVENT;
+
+typedef struct hostTask{
+	void (*task)(HOST_EVENT *iEvent);
+	HOST_EVENT *queue;
+	uint8_t length;
+	uint8_t head;
+	uint8_t count;
+} HOST_TASK;
+
+uint32_t hostTimeUs = 0xFF000000;
+uint32_t hostTimerLateUs = 0;
+uint32_t hostPostsDropped = 0;
+
+static uint64_t clockUs = 0xFF000000;
+static HOST_TIMER timers[HOST_TIMERS];
+static HOST_TASK tasks[HOST_TASK_PRIOS];
+static uint32_t failures = 0;
+static int lockDepth = 0;
+
+/******** libc backed SDK functions ********/
+
+int os_printf_plus(const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	int ret = vprintf(format, args);
+	va_end(args);
+	return ret;
+}
+
+int ets_sprintf(char *str, const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	int ret = vsprintf(str, format, args);
+	va_end(args);
+	return ret;
+}
+
+int ets_snprintf(char *str, unsigned int size, const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	int ret = vsnprintf(str, size, format, args);
+	va_end(args);
+	return ret;
+}
+
+int ets_vsnprintf(char *str, unsigned int size, const char *format, va_list args){
+	return vsnprintf(str, size, format, args);
+}
+
+void *ets_memcpy(void *dest, const void *src, size_t n){ return memcpy(dest, src, n); }
+void *ets_memmove(void *dest, const void *src, size_t n){ return memmove(dest, src, n); }
+void *ets_memset(void *s, int c, size_t n){ return memset(s, c, n); }
+int ets_memcmp(const void *s1, const void *s2, size_t n){ return memcmp(s1, s2, n); }
+int ets_strcmp(const char *s1, const char *s2){ return strcmp(s1, s2); }
+int ets_strncmp(const char *s1, const char *s2, size_t n){ return strncmp(s1, s2, n); }
+int ets_strlen(const char *s){ return strlen(s); }
+char *ets_strcpy(char *dest, const char *src){ return strcpy(dest, src); }
+char *ets_strncpy(char *dest, const char *src, size_t n){ return strncpy(dest, src, n); }
+char *ets_strstr(const char *haystack, const char *needle){ return strstr(haystack, needle); }
+char *ets_strchr(const char *s, int c){ return strchr(s, c); }
+
+//SDK versions add file, line (and iram) arguments, they are ignored
+void *pvPortMalloc(size_t size, const char *file, unsigned line){ return malloc(size); }
+void *pvPortZalloc(size_t size, const char *file, unsigned line){ return calloc(1, size); }
+void *pvPortRealloc(void *p, size_t size, const char *file, unsigned line){ return realloc(p, size); }
+void vPortFree(void *p, const char *file, unsigned line){ free(p); }
+
+//one thread, lock only has to pair up
+void ets_intr_lock(void){
+	if(lockDepth++ != 0) HostFail(__FILE__, __LINE__, "ets_intr_lock nested");
+}
+
+void ets_intr_unlock(void){
+	if(--lockDepth != 0) HostFail(__FILE__, __LINE__, "ets_intr_unlock without lock");
+}
+
+//user_log.c takes log levels from a form, tests that do not link driver/http.c get this
+__attribute__((weak)) int httpDecodeForm(const char *iData, uint16_t iLength, void *ioFields, uint8_t iFieldCount){
+	return 2;
+}
+
+/******** clock, os timers, tasks ********/
+
+uint32_t system_get_time(void){
+	return hostTimeUs;
+}
+
+HOST_TIMER *_HostTimer(void *iTimer, bool iCreate){
+	HOST_TIMER *unused = NULL;
+	for(uint8_t i = 0; i < HOST_TIMERS; ++i){
+		if(timers[i].timer == iTimer) return &timers[i];
+		if(timers[i].timer == NULL && unused == NULL) unused = &timers[i];
+	}
+	if(!iCreate) return NULL;
+	if(unused == NULL){
+		fprintf(stderr, "out of host timers\n");
+		exit(2);
+	}
+	unused->timer = iTimer;
+	return unused;
+}
+
+void ets_timer_setfn(void *ptimer, HOST_TIMER_FUNC pfunction, void *parg){
+	HOST_TIMER *timer = _HostTimer(ptimer, true);
+	timer->func = pfunction;
+	timer->arg = parg;
+	timer->armed = false;
+}
+
+void ets_timer_disarm(void *ptimer){
+	HOST_TIMER *timer = _HostTimer(ptimer, false);
+	if(timer != NULL) timer->armed = false;
+}
+
+void ets_timer_arm_new(void *ptimer, uint32_t time, bool repeat_flag, bool ms_flag){
+	HOST_TIMER *timer = _HostTimer(ptimer, true);
+	uint64_t us = ms_flag ? (uint64_t)time * 1000 : time;
+	if(ms_flag && time > 6871947) HostFail(__FILE__, __LINE__, "os timer armed beyond 6871947 ms");
+	timer->armed = true;
+	timer->due = clockUs + us;
+	timer->period = repeat_flag ? us : 0;
+}
+
+bool system_os_task(void (*task)(HOST_EVENT *), uint8_t prio, HOST_EVENT *queue, uint8_t qlen){
+	if(prio >= HOST_TASK_PRIOS || tasks[prio].task != NULL || qlen == 0) return false;
+	tasks[prio].task = task;
+	tasks[prio].queue = queue;
+	tasks[prio].length = qlen;
+	return true;
+}
+
+bool system_os_post(uint8_t prio, uint32_t sig, uint32_t par){
+	if(prio >= HOST_TASK_PRIOS || tasks[prio].task == NULL) return false;
+	HOST_TASK *task = &tasks[prio];
+	if(task->count == task->length){
+		++hostPostsDropped;
+		return false;
+	}
+	HOST_EVENT *event = &task->queue[(task->head + task->count++) % task->length];
+	event->sig = sig;
+	event->par = par;
+	return true;
+}
+
+void HostRunTasks(void){
+	for(;;){
+		HOST_TASK *task = NULL;
+		for(int8_t prio = HOST_TASK_PRIOS - 1; prio >= 0 && task == NULL; --prio){
+			if(tasks[prio].count > 0) task = &tasks[prio];
+		}
+		if(task == NULL) return;
+
+		HOST_EVENT event = task->queue[task->head];
+		task->head = (task->head + 1) % task->length;
+		--task->count;
+		task->task(&event);
+	}
+}
+
+uint64_t HostNextTimer(void){
+	uint64_t next = UINT64_MAX;
+	for(uint8_t i = 0; i < HOST_TIMERS; ++i){
+		if(timers[i].armed && timers[i].due - clockUs < next) next = timers[i].due - clockUs;
+	}
+	return next;
+}
+
+void HostAdvance(uint64_t iUs){
+	uint64_t end = clockUs + iUs;
+	HostRunTasks();
+	for(;;){
+		HOST_TIMER *next = NULL;
+		for(uint8_t i = 0; i < HOST_TIMERS; ++i){
+			if(timers[i].armed && timers[i].due <= end && (next == NULL || timers[i].due < next->due)) next = &timers[i];
+		}
+		if(next == NULL) break;
+
+		uint64_t fire = next->due + (hostTimerLateUs ? (uint64_t)rand() % (hostTimerLateUs + 1) : 0);
+		if(fire > clockUs) clockUs = fire;
+		hostTimeUs = (uint32_t)clockUs;
+		if(next->period > 0) next->due += next->period;
+		else next->armed = false;
+		next->func(next->arg);
+		HostRunTasks();
+	}
+	if(end > clockUs) clockUs = end;
+	hostTimeUs = (uint32_t)clockUs;
+}
+
+/******** results ********/
+
+void HostFail(const char *iFile, int iLine, const char *iCondition){
+	++failures;
+	if(failures <= 20) fprintf(stderr, "%s:%d: check failed: %s\n", iFile, iLine, iCondition);
+}
+
+int HostResult(const char *iName){
+	printf("%s: %s (%u failed checks)\n", iName, failures ? "FAIL" : "ok", failures);
+	return failures ? 1 : 0;
+}
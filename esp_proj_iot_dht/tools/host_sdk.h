@@ -0,0 +1,49 @@
+/*
+ * host_sdk.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * SDK stand-ins for host tests (tools/<name>_test.c, `make hosttest`): libc backed ets_*
+ * and heap functions, a virtual clock behind system_get_time, os timers that fire as
+ * the clock is moved and SDK task queues that are run on request. Firmware modules are
+ * compiled unchanged against SDK headers and linked with tools/host_sdk.c.
+ */
+
+#ifndef TOOLS_HOST_SDK_H_
+#define TOOLS_HOST_SDK_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+//fails a test with file and line, tests keep going and exit with HostResult()
+#define HOST_CHECK(condition)		do {if(!(condition)) HostFail(__FILE__, __LINE__, #condition);} while(0)
+
+//virtual clock of system_get_time, starts close to its wrap so tests cross it
+extern uint32_t hostTimeUs;
+
+//os timers fire up to this many us after their expiry (random), 0 by default
+extern uint32_t hostTimerLateUs;
+
+//system_os_post calls that found their task queue full
+extern uint32_t hostPostsDropped;
+
+/*
+ * Moves the clock forward by iUs, firing os timers in expiry order on the way (each at
+ * its expiry plus lateness) and running task queues after each one.
+ */
+void HostAdvance(uint64_t iUs);
+
+//runs posted task events, highest priority first, until all queues are empty
+void HostRunTasks(void);
+
+//us until next os timer fires, UINT64_MAX if none is armed
+uint64_t HostNextTimer(void);
+
+void HostFail(const char *iFile, int iLine, const char *iCondition);
+
+//prints result, return value for main: 0 if no check failed
+int HostResult(const char *iName);
+
+#endif /* TOOLS_HOST_SDK_H_ */
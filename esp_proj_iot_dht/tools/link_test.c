@@ -0,0 +1,231 @@
+/*
+ * link_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of collector link probe (user/user_link.c) on the virtual clock, with
+ * espconn callbacks called as the SDK would: probe schedule and retry backoff, timeout
+ * of an unanswered connect and a late answer to it, reachability changes after
+ * LINK_DOWN_AFTER lost probes, rtt, jitter and loss over history, upload thinning on a
+ * lossy path, stop and start, and collector address changes.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o link_test tools/link_test.c \
+ *       tools/host_sdk.c user/user_link.c user/user_timer.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "espconn.h"
+#include "user_espconn.h"
+#include "user_link.h"
+#include "user_metrics.h"
+#include "user_timer.h"
+#include "host_sdk.h"
+
+//clock run before link timer counts as idle, ms, longer than any probe delay
+#define TEST_IDLE			(2 * LINK_PROBE_RETRY_MAX * 1000)
+
+uint32 metricCounters[METRIC_COUNTERS];
+
+static espconn_connect_callback connectCallback = NULL;
+static espconn_reconnect_callback reconCallback = NULL;
+static espconn_connect_callback disconCallback = NULL;
+static struct espconn *probeConn = NULL;
+static sint8 connectResult = ESPCONN_OK;
+static uint32 connects = 0, disconnects = 0;
+static uint32 changes = 0;
+static bool lastReachable = false;
+
+/******** firmware stand-ins ********/
+
+//dotted decimal only, LinkSetCollector rejects other forms before it asks
+uint32 ipaddr_addr(const char *cp){
+	unsigned a, b, c, d;
+	char end;
+	if(sscanf(cp, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+		return IPADDR_NONE;
+	return a | (b << 8) | (c << 16) | ((uint32)d << 24);
+}
+
+uint32 espconn_port(void){ return 4000; }
+
+sint8 espconn_regist_connectcb(struct espconn *espconn, espconn_connect_callback connect_cb){
+	connectCallback = connect_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_reconcb(struct espconn *espconn, espconn_reconnect_callback recon_cb){
+	reconCallback = recon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_disconcb(struct espconn *espconn, espconn_connect_callback discon_cb){
+	disconCallback = discon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_connect(struct espconn *espconn){
+	probeConn = espconn;
+	++connects;
+	return connectResult;
+}
+
+sint8 espconn_disconnect(struct espconn *espconn){
+	++disconnects;
+	return ESPCONN_OK;
+}
+
+/******** test ********/
+
+void _StateChanged(bool iReachable){
+	++changes;
+	lastReachable = iReachable;
+}
+
+//connects, timeouts and closes, everything link timer does shows in one of them
+uint32 _Events(void){
+	return connects + disconnects + metricCounters[METRIC_PROBE_FAILURES];
+}
+
+//runs clock until link timer acts, stopping right there, returns us it took, 0 if it stays idle
+uint32 _Fire(void){
+	uint32 events = _Events(), elapsed = 0;
+	while(elapsed < TEST_IDLE * 1000){
+		//wheel's os timer wakes early at times, to cascade
+		uint64_t step = HostNextTimer();
+		if(step > TEST_IDLE * 1000ULL - elapsed) step = TEST_IDLE * 1000ULL - elapsed;
+		HostAdvance(step);
+		elapsed += step;
+		if(_Events() != events) return elapsed > 0 ? elapsed : 1;
+	}
+	return 0;
+}
+
+//wheel keeps expiries in ms
+bool _FiresIn(uint32 iMs){
+	uint32 us = _Fire();
+	return us > 0 && us + 1000 >= iMs * 1000 && us <= iMs * 1000 + 1000;
+}
+
+//a probe answered in iRtt us, closed from link timer
+void _Answer(uint32 iRtt){
+	uint32 before = disconnects;
+	HostAdvance(iRtt);
+	connectCallback(probeConn);
+	HOST_CHECK(_FiresIn(0) && disconnects == before + 1);
+	disconCallback(probeConn);
+}
+
+void _Refused(void){
+	reconCallback(probeConn, ESPCONN_RST);
+}
+
+int main(void){
+	LINK_QUALITY quality;
+	uint32 ip;
+	uint16 port;
+	InitLinkProbe(_StateChanged);
+	HOST_CHECK(!LinkReachable() && _Fire() == 0 && connects == 0);
+
+	//first probe at once, to collector
+	StartLinkProbe();
+	HOST_CHECK(_FiresIn(0) && connects == 1);
+	LinkCollector(&ip, &port);
+	HOST_CHECK(ip == ipaddr_addr(COLLECTOR_IP) && port == COLLECTOR_PORT);
+	HOST_CHECK(memcmp(probeConn->proto.tcp->remote_ip, &ip, 4) == 0 && probeConn->proto.tcp->remote_port == port);
+
+	//answered: reachable, next one after LINK_PROBE_INTERVAL
+	_Answer(20000);
+	HOST_CHECK(changes == 1 && lastReachable && LinkReachable());
+	HOST_CHECK(_FiresIn(LINK_PROBE_INTERVAL * 1000) && connects == 2);
+	_Answer(40000);
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.samples == 2 && quality.loss == 0 && quality.rttMean == 30000 && quality.jitter == 20000);
+	HOST_CHECK(metricCounters[METRIC_PROBE_SUCCESS] == 2);
+
+	//unanswered probe is lost after LINK_PROBE_TIMEOUT and left to SDK, one is not down yet
+	HOST_CHECK(_FiresIn(LINK_PROBE_INTERVAL * 1000) && connects == 3);
+	HOST_CHECK(_FiresIn(LINK_PROBE_TIMEOUT * 1000) && metricCounters[METRIC_PROBE_FAILURES] == 1);
+	HOST_CHECK(LinkReachable() && _Fire() == 0);
+	_Refused();
+	HOST_CHECK(metricCounters[METRIC_PROBE_FAILURES] == 1);
+	HOST_CHECK(_FiresIn(LINK_PROBE_RETRY * 1000) && connects == 4);
+
+	//refused, LINK_DOWN_AFTER in a row: down, retries back off to LINK_PROBE_RETRY_MAX
+	_Refused();
+	HOST_CHECK(changes == 2 && !lastReachable && !LinkReachable());
+	uint32 delay = LINK_PROBE_RETRY * 2;
+	for(uint8 i = 0; i < 8; ++i){
+		HOST_CHECK(_FiresIn(delay * 1000));
+		_Refused();
+		delay = delay * 2 < LINK_PROBE_RETRY_MAX ? delay * 2 : LINK_PROBE_RETRY_MAX;
+	}
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.samples == LINK_HISTORY && quality.loss == 100 && quality.failures == 10);
+	HOST_CHECK(quality.rttMean == 0 && quality.jitter == 0 && !LinkUploadDue());
+
+	//connect that fails at once counts as lost too
+	connectResult = ESPCONN_RTE;
+	HOST_CHECK(_FiresIn(LINK_PROBE_RETRY_MAX * 1000) && metricCounters[METRIC_PROBE_FAILURES] == 11);
+	connectResult = ESPCONN_OK;
+
+	//late answer of a timed out probe is closed, not counted
+	HOST_CHECK(_FiresIn(LINK_PROBE_RETRY_MAX * 1000));
+	HOST_CHECK(_FiresIn(LINK_PROBE_TIMEOUT * 1000) && metricCounters[METRIC_PROBE_FAILURES] == 12);
+	_Answer(1000);
+	HOST_CHECK(metricCounters[METRIC_PROBE_SUCCESS] == 2 && !LinkReachable());
+
+	//one answer brings link back, path stays lossy for a while: every second upload
+	HOST_CHECK(_FiresIn(LINK_PROBE_RETRY_MAX * 1000));
+	_Answer(10000);
+	HOST_CHECK(changes == 3 && LinkReachable());
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.loss == (LINK_HISTORY - 1) * 100 / LINK_HISTORY && quality.rttMean == 10000);
+	uint8 due = 0;
+	for(uint8 i = 0; i < 2 * LINK_LOSSY_UPLOAD_EVERY; ++i) due += LinkUploadDue();
+	HOST_CHECK(due == 2);
+	for(uint8 i = 0; i < LINK_HISTORY; ++i){
+		HOST_CHECK(_FiresIn(LINK_PROBE_INTERVAL * 1000));
+		_Answer(10000 + i * 1000);
+	}
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.loss == 0 && quality.jitter == 1000 && LinkUploadDue() && LinkUploadDue());
+
+	//failed upload brings probe forward
+	LinkProbeSoon();
+	HOST_CHECK(_FiresIn(LINK_PROBE_RETRY * 1000));
+	_Answer(10000);
+
+	//stop: down and no more probes, start clears history and probes at once
+	StopLinkProbe();
+	HOST_CHECK(!LinkReachable() && changes == 4 && _Fire() == 0);
+	StartLinkProbe();
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.samples == 0 && _FiresIn(0));
+
+	//stopped while connecting: its error schedules nothing
+	StopLinkProbe();
+	_Refused();
+	HOST_CHECK(_Fire() == 0);
+
+	//collector address: only a.b.c.d with a port, a new one is probed at once
+	HOST_CHECK(!LinkSetCollector("10.0.0", 9000) && !LinkSetCollector("10.0.0.1.2", 9000));
+	HOST_CHECK(!LinkSetCollector("10.0.0.x", 9000) && !LinkSetCollector("0.0.0.0", 9000));
+	HOST_CHECK(!LinkSetCollector("10.0.0.256", 9000) && !LinkSetCollector("10.0.0.1", 0));
+	LinkCollector(&ip, &port);
+	HOST_CHECK(ip == ipaddr_addr(COLLECTOR_IP) && port == COLLECTOR_PORT);
+	StartLinkProbe();
+	HOST_CHECK(_FiresIn(0));
+	_Answer(5000);
+	HOST_CHECK(LinkReachable());
+	HOST_CHECK(LinkSetCollector("10.0.0.7", 9000) && !LinkReachable());
+	HOST_CHECK(_FiresIn(0) && probeConn->proto.tcp->remote_port == 9000);
+	HOST_CHECK(probeConn->proto.tcp->remote_ip[0] == 10 && probeConn->proto.tcp->remote_ip[3] == 7);
+	GetLinkQuality(&quality);
+	HOST_CHECK(quality.samples == 0);
+
+	return HostResult("link_test");
+}
@@ -0,0 +1,141 @@
+/*
+ * log_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of runtime log levels (user/user_log.c): every LOG_* level against every
+ * module level prints exactly when it should and LOG_ON agrees, forms of POST api/log
+ * (and the console's log command) set levels all or nothing, and api/log JSON lists
+ * every module, measures what it renders and fits LOG_JSON_SIZE at its longest.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o log_test tools/log_test.c \
+ *       tools/host_sdk.c user/user_log.c driver/http.c driver/rodata.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "espconn.h"
+#include "user_log.h"
+#include "host_sdk.h"
+
+//counts what would be printed instead
+#undef LOG_PRINT
+#define LOG_PRINT(module, level, message, args...)	do {++printed;} while(0)
+
+static uint32 printed = 0;
+static uint8 defaults[LOG_MODULES];
+
+/******** firmware stand-ins ********/
+
+//rest of driver/http.c links against it, log never sends
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){
+	return ESPCONN_OK;
+}
+
+/******** test ********/
+
+bool _Set(const char *iForm){
+	return LogSetLevels(iForm, strlen(iForm));
+}
+
+bool _Unchanged(void){
+	return memcmp(logLevels, defaults, sizeof(defaults)) == 0;
+}
+
+//renders into an exact size heap buffer, null terminated copy in oJSON
+uint16 _Render(char *oJSON, uint16 iSize){
+	char *buffer = malloc(iSize > 0 ? iSize : 1);
+	uint16 length = GetLogLevelsJSON(buffer, iSize);
+	memcpy(oJSON, buffer, length < iSize ? length : iSize);
+	oJSON[length < iSize ? length : iSize] = '\0';
+	free(buffer);
+	return length;
+}
+
+//prints of one LOG_* call per level for a module, as a bit mask of levels
+uint8 _Printed(void){
+	uint8 mask = 0;
+	uint32 before = printed;
+	LOG_ERROR(DHT, "error %d", 1);
+	if(printed != before) mask |= 1 << LOG_LEVEL_ERROR;
+	before = printed;
+	LOG_WARN(DHT, "warn %s", "x");
+	if(printed != before) mask |= 1 << LOG_LEVEL_WARN;
+	before = printed;
+	LOG_INFO(DHT, "info");
+	if(printed != before) mask |= 1 << LOG_LEVEL_INFO;
+	before = printed;
+	LOG_DEBUG(DHT, "debug %u", 4u);
+	if(printed != before) mask |= 1 << LOG_LEVEL_DEBUG;
+	return mask;
+}
+
+uint8 _On(void){
+	return (LOG_ON(DHT, ERROR) << LOG_LEVEL_ERROR) | (LOG_ON(DHT, WARN) << LOG_LEVEL_WARN) |
+			(LOG_ON(DHT, INFO) << LOG_LEVEL_INFO) | (LOG_ON(DHT, DEBUG) << LOG_LEVEL_DEBUG);
+}
+
+int main(void){
+	static const char *levels[] = {"none", "error", "warn", "info", "debug"};
+	char json[LOG_JSON_SIZE + 1], form[64];
+	memcpy(defaults, logLevels, sizeof(defaults));
+
+	//boot defaults, every module named once
+	uint16 length = _Render(json, LOG_JSON_SIZE);
+	HOST_CHECK(length < LOG_JSON_SIZE && GetLogLevelsJSON(NULL, 0) == length);
+	HOST_CHECK(json[0] == '{' && json[length - 1] == '}');
+	HOST_CHECK(strstr(json, "\"wifi\":\"info\"") != NULL && strstr(json, "\"dht\":\"warn\"") != NULL);
+	uint8 pairs = 0;
+	for(char *c = json; *c != '\0'; ++c) pairs += *c == ':';
+	HOST_CHECK(pairs == LOG_MODULES && strstr(json, "\"bus\":") != NULL);
+
+	//a message prints iff its level is at most module's, LOG_ON agrees
+	for(uint8 level = LOG_LEVEL_NONE; level <= LOG_LEVEL_DEBUG; ++level){
+		sprintf(form, "dht=%s", levels[level]);
+		HOST_CHECK(_Set(form) && logLevels[LOG_MODULE_DHT] == level);
+		uint8 expected = ((1 << (level + 1)) - 1) & ~1;
+		HOST_CHECK(_Printed() == expected && _On() == expected);
+	}
+	HOST_CHECK(_Set("dht=warn") && _Unchanged());
+
+	//several at once, escaped and in any order, others keep theirs
+	HOST_CHECK(_Set("http=debug&wifi=%6Eone&junk=1"));
+	HOST_CHECK(logLevels[LOG_MODULE_HTTP] == LOG_LEVEL_DEBUG && logLevels[LOG_MODULE_WIFI] == LOG_LEVEL_NONE);
+	HOST_CHECK(logLevels[LOG_MODULE_DHT] == defaults[LOG_MODULE_DHT]);
+	HOST_CHECK(_Set("http=warn&wifi=info") && _Unchanged());
+
+	//all or nothing: one bad level, no known module or a bad form sets none
+	HOST_CHECK(!_Set("wifi=debug&http=bogus") && _Unchanged());
+	HOST_CHECK(!_Set("wifi=debug&http=DEBUG") && _Unchanged());
+	HOST_CHECK(!_Set("wifi=debug&http=") && _Unchanged());
+	HOST_CHECK(!_Set("wifi=debug&http=debugging") && _Unchanged());
+	HOST_CHECK(!_Set("wifi=debug&http=%zz") && _Unchanged());
+	HOST_CHECK(!_Set("x=1") && !_Set("") && !_Set("wifi_fsmx=none") && _Unchanged());
+
+	//every module by its name in JSON, in module order
+	const char *name = json + 2;
+	for(uint8 i = 0; i < LOG_MODULES; ++i, name = strchr(name, ',') + 2){
+		uint8 nameLength = strchr(name, '"') - name;
+		sprintf(form, "%.*s=error", nameLength, name);
+		HOST_CHECK(_Set(form) && logLevels[i] == LOG_LEVEL_ERROR);
+		logLevels[i] = defaults[i];
+	}
+	HOST_CHECK(_Unchanged());
+
+	//longest JSON: every module at a five letter level, out of range shown as debug
+	for(uint8 i = 0; i < LOG_MODULES; ++i) logLevels[i] = i % 2 ? LOG_LEVEL_ERROR : 200;
+	length = _Render(json, LOG_JSON_SIZE);
+	HOST_CHECK(length < LOG_JSON_SIZE && strstr(json, "\"esp\":\"debug\",\"wifi\":\"error\"") != NULL);
+	printf("api/log JSON at its longest: %u of %u bytes\n", length, LOG_JSON_SIZE);
+
+	//a smaller buffer gets a cut copy, never more
+	for(uint16 size = 0; size < length; ++size){
+		char cut[LOG_JSON_SIZE + 1];
+		HOST_CHECK(_Render(cut, size) == length && strncmp(cut, json, size) == 0 && strlen(cut) == size);
+	}
+
+	return HostResult("log_test");
+}
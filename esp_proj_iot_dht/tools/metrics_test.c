@@ -0,0 +1,125 @@
+/*
+ * metrics_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of /metrics rendering (user/user_metrics.c): every family is rendered with
+ * its largest values (all counters at 10 digits, all disconnect reason slots taken, all
+ * bus counters full) and must fit METRICS_FAMILY_SIZE with its terminator, then whole
+ * pages are rendered through buffers from METRICS_FAMILY_SIZE to HTTP_CHUNK_SIZE and
+ * must match a family by family render, never writing past the buffer (under ASan).
+ * Module sources are included so their state can be set to worst case directly.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o metrics_test tools/metrics_test.c \
+ *       tools/host_sdk.c user/user_timer.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "driver/http.h"
+#include "host_sdk.h"
+
+#include "../user/user_metrics.c"
+#include "../user/user_bus.c"
+
+//lines a family may have, console adds a CR to each (CONSOLE_DUMP_ROOM)
+#define TEST_FAMILY_LINES		64
+
+static uint32 heapFree = 40000;
+static uint32 uartDropped = 0;
+static LINK_QUALITY linkQuality = {0};
+
+/******** firmware stand-ins ********/
+
+uint32 system_get_free_heap_size(void){ return heapFree; }
+uint32_t uart_tx_dropped(void){ return uartDropped; }
+bool LinkReachable(void){ return linkQuality.reachable; }
+void GetLinkQuality(LINK_QUALITY *oQuality){ *oQuality = linkQuality; }
+
+/******** test ********/
+
+void _WorstCase(void){
+	for(uint8 i = 0; i < METRIC_COUNTERS; ++i) metricCounters[i] = 4000000000u;
+	heapFree = heapMinFree = 4000000000u;
+	uartDropped = 4000000000u;
+	uptimeWraps = 0xFFFFFFFF;
+	uptimeLast = hostTimeUs;
+
+	//cumulative buckets and count are sums, pick counts that stay at 10 digits
+	for(uint8 i = 0; i <= DHT_DECODE_BUCKETS; ++i) dhtDecodeBuckets[i] = 700000000u;
+	dhtDecodeSum = 4000000000u;
+
+	for(uint8 i = 0; i < METRICS_DISCONNECT_REASONS; ++i){
+		disconnectReasons[i].reason = i == 0 ? 0 : 200 + i;
+		disconnectReasons[i].count = 4000000000u;
+	}
+
+	for(uint8 i = 0; i < BUS_EVENTS; ++i) stats[i].posted = stats[i].coalesced = stats[i].dropped = 4000000000u;
+	highWater = BUS_QUEUE;
+
+	linkQuality = (LINK_QUALITY){.reachable = true, .samples = 255, .loss = 100,
+			.rttMean = 4000000000u, .jitter = 4000000000u};
+}
+
+//renders every family alone into an exact size heap buffer, returns length of all
+uint32 _CheckFamilies(char *oPage){
+	uint32 total = 0;
+	uint16 largest = 0;
+	for(uint8 family = 0; family < FAMILY_COUNT; ++family){
+		char *buffer = malloc(METRICS_FAMILY_SIZE);
+		uint16 length = _RenderFamily(family, buffer);
+		HOST_CHECK(length > 0 && length < METRICS_FAMILY_SIZE && buffer[length] == '\0');
+		HOST_CHECK(buffer[length - 1] == '\n');
+
+		uint16 lines = 0;
+		for(uint16 i = 0; i < length; ++i) lines += buffer[i] == '\n';
+		HOST_CHECK(lines <= TEST_FAMILY_LINES);
+
+		if(length > largest) largest = length;
+		memcpy(oPage + total, buffer, length);
+		total += length;
+		free(buffer);
+	}
+	printf("largest family %u of %u bytes, page %u bytes\n", largest, METRICS_FAMILY_SIZE, total);
+	return total;
+}
+
+//renders whole page as HTTP chunk writer and console do, in iSize buffers
+void _CheckPage(const char *iPage, uint32 iLength, uint16 iSize){
+	static char page[FAMILY_COUNT * METRICS_FAMILY_SIZE];
+	uint32 total = 0;
+	uint16 cursor = 0, length;
+	uint8 calls = 0;
+	do{
+		char *buffer = malloc(iSize);
+		length = RenderMetrics(buffer, iSize, &cursor);
+		HOST_CHECK(length < iSize);
+		memcpy(page + total, buffer, length);
+		total += length;
+		free(buffer);
+	} while(length > 0 && ++calls <= FAMILY_COUNT);
+	HOST_CHECK(cursor == FAMILY_COUNT && total == iLength && memcmp(page, iPage, iLength) == 0);
+}
+
+int main(void){
+	static char page[FAMILY_COUNT * METRICS_FAMILY_SIZE];
+
+	//page must fit a chunk buffer a family at a time
+	HOST_CHECK(METRICS_FAMILY_SIZE <= HTTP_CHUNK_SIZE);
+
+	//fresh boot
+	MetricsSampleHeap();
+	uint32 length = _CheckFamilies(page);
+	_CheckPage(page, length, METRICS_FAMILY_SIZE);
+	_CheckPage(page, length, HTTP_CHUNK_SIZE);
+
+	//largest values everywhere
+	_WorstCase();
+	length = _CheckFamilies(page);
+	for(uint16 size = METRICS_FAMILY_SIZE; size <= HTTP_CHUNK_SIZE; ++size) _CheckPage(page, length, size);
+
+	return HostResult("metrics_test");
+}
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""
+readings_load.py
+
+Polls /api/readings of the device from many concurrent clients and reports
+latency, errors and whether sampling keeps up while the server is loaded.
+
+Each client keeps one persistent (keep-alive) connection and reconnects when
+the device closes it (it does so every HTTP_KEEPALIVE_MAX_REQUESTS requests).
+
+usage: readings_load.py <device ip> [--clients N] [--interval S] [--duration S]
+"""
+
+import argparse
+import http.client
+import json
+import threading
+import time
+
+
+class Stats(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.errors = 0
+        self.connects = 0
+        self.max_age_ms = 0
+        self.counts = []
+
+    def record(self, latency, readings):
+        with self.lock:
+            self.latencies.append(latency)
+            if readings["latest"] is not None:
+                self.max_age_ms = max(self.max_age_ms, readings["latest"]["age_ms"])
+            self.counts.append(readings["count"])
+
+
+def client(host, port, interval, deadline, stats):
+    conn = None
+    while time.time() < deadline:
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(host, port, timeout=5)
+                with stats.lock:
+                    stats.connects += 1
+            start = time.time()
+            conn.request("GET", "/api/readings")
+            response = conn.getresponse()
+            body = response.read()
+            latency = time.time() - start
+            if response.status != 200:
+                raise ValueError("status %d" % response.status)
+            stats.record(latency, json.loads(body))
+            if response.getheader("Connection", "").lower() == "close":
+                conn.close()
+                conn = None
+        except (OSError, ValueError, http.client.HTTPException):
+            with stats.lock:
+                stats.errors += 1
+            if conn is not None:
+                conn.close()
+            conn = None
+        time.sleep(interval)
+    if conn is not None:
+        conn.close()
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--interval", type=float, default=0.5, help="seconds between polls of a client")
+    parser.add_argument("--duration", type=float, default=60, help="test duration in seconds")
+    args = parser.parse_args()
+
+    stats = Stats()
+    deadline = time.time() + args.duration
+    threads = [threading.Thread(target=client, args=(args.host, args.port, args.interval, deadline, stats))
+               for _ in range(args.clients)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    ok = len(stats.latencies)
+    print("requests   : %d ok, %d errors, %d connections" % (ok, stats.errors, stats.connects))
+    print("latency ms : p50 %.1f, p95 %.1f, max %.1f" % (percentile(stats.latencies, 0.5) * 1000,
+                                                          percentile(stats.latencies, 0.95) * 1000,
+                                                          max(stats.latencies or [0]) * 1000))
+    if stats.counts:
+        # samples taken during the run, sampling is blocked if this stays flat
+        print("samples    : %d taken during run, max age of latest %d ms"
+              % (max(stats.counts) - min(stats.counts), stats.max_age_ms))
+    return 0 if ok > 0 else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
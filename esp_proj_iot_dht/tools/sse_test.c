@@ -0,0 +1,284 @@
+/*
+ * sse_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of Server-Sent Events (events, user/user_espconn.c) through the local server's
+ * espconn callbacks: a subscriber gets the retry hint and the latest sample on open, then
+ * "id/event: reading/data" frames per sample and a heartbeat comment every SSE_HEARTBEAT.
+ * Subscribers past SSE_MAX_SUBSCRIBERS get a 503. A subscriber whose previous frame is
+ * unsent skips frames, a sent one resets that count, and it is dropped after SSE_MAX_MISSED
+ * or at once when a send fails; its slot is then free for a new subscriber.
+ * Module source is included to check its connection state directly.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o sse_test tools/sse_test.c \
+ *       tools/host_sdk.c user/user_samples.c user/user_timer.c user/user_bus.c driver/http.c \
+ *       driver/rodata.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "host_sdk.h"
+
+#include "../user/user_espconn.c"
+
+#define TEST_CLIENTS			(SSE_MAX_SUBSCRIBERS + 2)
+#define TEST_RX_SIZE			2048
+
+//a browser at the other end of a connection, sends go out only once it takes them (_Take)
+typedef struct testClient{
+	struct espconn conn;
+	esp_tcp tcp;
+	char rx[TEST_RX_SIZE + 1];	//what arrived since last _Take, null terminated
+	uint16 rxLength;
+	bool sending;				//a send is on the wire, sent callback not called yet
+	sint8 sendResult;			//what espconn_send answers
+	uint32 idleTimeout;			//espconn_regist_time of connection
+	bool disconnected;
+} TEST_CLIENT;
+
+uint32 metricCounters[METRIC_COUNTERS];
+TRACE_ENTRY traceRing[TRACE_RING];
+uint32 traceHead = 0;
+
+static TEST_CLIENT clients[TEST_CLIENTS];
+
+/******** firmware stand-ins ********/
+
+TEST_CLIENT *_Client(struct espconn *pesp_conn){
+	for(uint8 i = 0; i < TEST_CLIENTS; ++i) if(&clients[i].conn == pesp_conn) return &clients[i];
+	return NULL;
+}
+
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){
+	TEST_CLIENT *client = _Client(espconn);
+	HOST_CHECK(client != NULL && !client->disconnected);
+	if(client == NULL) return ESPCONN_ARG;
+	if(client->sendResult != ESPCONN_OK) return client->sendResult;
+
+	//one send at a time per connection, as SDK has it
+	HOST_CHECK(!client->sending && client->rxLength + length <= TEST_RX_SIZE);
+	if(client->rxLength + length <= TEST_RX_SIZE){
+		memcpy(client->rx + client->rxLength, psent, length);
+		client->rxLength += length;
+		client->rx[client->rxLength] = '\0';
+	}
+	client->sending = true;
+	return ESPCONN_OK;
+}
+
+//a connection is closed by SDK with its disconnect callback, never from espconn callbacks
+sint8 espconn_disconnect(struct espconn *espconn){
+	TEST_CLIENT *client = _Client(espconn);
+	HOST_CHECK(client != NULL && !client->disconnected);
+	if(client == NULL) return ESPCONN_ARG;
+	client->disconnected = true;
+	client->sending = false;
+	espTcp.disconnect_callback(espconn);
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_time(struct espconn *espconn, uint32 interval, uint8 type_flag){
+	TEST_CLIENT *client = _Client(espconn);
+	if(client != NULL) client->idleTimeout = interval;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_connectcb(struct espconn *espconn, espconn_connect_callback connect_cb){
+	espconn->proto.tcp->connect_callback = connect_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_reconcb(struct espconn *espconn, espconn_reconnect_callback recon_cb){
+	espconn->proto.tcp->reconnect_callback = recon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_disconcb(struct espconn *espconn, espconn_connect_callback discon_cb){
+	espconn->proto.tcp->disconnect_callback = discon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_recvcb(struct espconn *espconn, espconn_recv_callback recv_cb){
+	espconn->recv_callback = recv_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_sentcb(struct espconn *espconn, espconn_sent_callback sent_cb){
+	espconn->sent_callback = sent_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_accept(struct espconn *espconn){ return ESPCONN_OK; }
+sint8 espconn_tcp_set_max_con_allow(struct espconn *espconn, uint8 num){ return ESPCONN_OK; }
+sint8 espconn_get_connection_info(struct espconn *pespconn, remot_info **pcon_info, uint8 typeflags){ return ESPCONN_ARG; }
+sint8 espconn_connect(struct espconn *espconn){ return ESPCONN_ARG; }
+sint8 espconn_delete(struct espconn *espconn){ return ESPCONN_OK; }
+uint32 espconn_port(void){ return 49152; }
+
+//station only, no captive portal
+uint8 wifi_get_opmode(void){ return STATION_MODE; }
+bool wifi_get_ip_info(uint8 if_index, struct ip_info *info){ memset(info, 0, sizeof(*info)); return false; }
+
+bool ConnectToStation(char *iData, uint16 iDataLength){ return false; }
+void LinkCollector(uint32 *oIp, uint16 *oPort){ *oIp = 0; *oPort = COLLECTOR_PORT; }
+void LinkProbeSoon(void){}
+void MetricsSampleHeap(void){}
+uint16 RenderMetrics(char *oBuffer, uint16 iSize, uint16 *ioCursor){ return 0; }
+uint16 GetTraceJSON(char *oBuffer, uint16 iSize, uint16 *ioCursor){ return 0; }
+const WEB_ASSET* GetWifi_AP_HTML(void){ return NULL; }
+const WEB_ASSET* GetWifi_AP_CSS(void){ return NULL; }
+const WEB_ASSET* GetWifi_AP_JS(void){ return NULL; }
+uint16 GetWifi_AP_ScanJSON(char *oBuffer, uint16 iSize){ return 0; }
+uint16 GetWifi_AP_BundleSize(bool iGzip){ return 0; }
+uint16 GetWifi_AP_Bundle(char *oBuffer, uint16 iSize, bool iGzip){ return 0; }
+uint32 GetWifi_AP_BundleETag(void){ return 0; }
+uint32 GetWifi_AP_DataETag(void){ return 0; }
+
+/******** test ********/
+
+void _Connect(uint8 iClient){
+	TEST_CLIENT *client = &clients[iClient];
+	memset(client, 0, sizeof(*client));
+	client->conn.type = ESPCONN_TCP;
+	client->conn.proto.tcp = &client->tcp;
+	client->tcp.remote_ip[0] = 192;
+	client->tcp.remote_ip[1] = 168;
+	client->tcp.remote_ip[3] = 2 + iClient;
+	client->tcp.remote_port = 50000 + iClient;
+	client->sendResult = ESPCONN_OK;
+	espTcp.connect_callback(&client->conn);
+}
+
+void _Get(uint8 iClient, const char *iRoute){
+	char request[128];
+	int length = sprintf(request, "GET /%s HTTP/1.1\r\nHost: 192.168.0.2\r\nAccept: text/event-stream\r\n\r\n", iRoute);
+	clients[iClient].conn.recv_callback(&clients[iClient].conn, request, length);
+	HostRunTasks();
+}
+
+//what client received since last call, null terminated, and lets SDK call sent callback
+const char *_Take(uint8 iClient){
+	static char taken[TEST_RX_SIZE + 1];
+	TEST_CLIENT *client = &clients[iClient];
+	strcpy(taken, client->rx);
+	client->rxLength = 0;
+	client->rx[0] = '\0';
+	if(client->sending){
+		client->sending = false;
+		client->conn.sent_callback(&client->conn);
+		HostRunTasks();
+	}
+	return taken;
+}
+
+//body of an events response, NULL if head is not an open event stream
+const char *_Stream(const char *iResponse){
+	if(strncmp(iResponse, "HTTP/1.1 200 OK\r\n", 17) != 0 || strstr(iResponse, "Content-Type: text/event-stream\r\n") == NULL ||
+			strstr(iResponse, "Content-Length:") != NULL || strstr(iResponse, "Connection: keep-alive\r\n") == NULL)
+		return NULL;
+	const char *body = strstr(iResponse, "\r\n\r\n");
+	return body == NULL ? NULL : body + 4;
+}
+
+//frame of latest sample, as a subscriber must see it
+const char *_SampleFrame(void){
+	static char frame[SSE_FRAME_SIZE + 1];
+	int length = sprintf(frame, "id: %u\nevent: reading\ndata: ", GetSampleCount());
+	length += GetLatestSampleJSON(frame + length, SAMPLE_JSON_SIZE);
+	strcpy(frame + length, "\n\n");
+	return frame;
+}
+
+void _Sample(float iHumidity){
+	AddSample(iHumidity, 21.5f, 0);
+	PublishSample();
+	HostRunTasks();
+}
+
+int main(void){
+	char retry[32], expected[TEST_RX_SIZE];
+	sprintf(retry, "retry: %d\n\n", SSE_RETRY);
+
+	HOST_CHECK(InitESPConn() == ESPCONN_OK && StartLocalServer() == ESPCONN_OK);
+
+	//no sample yet: stream opens with retry hint only, nothing is published
+	_Connect(0);
+	_Get(0, "events");
+	const char *body = _Stream(_Take(0));
+	HOST_CHECK(body != NULL && strcmp(body, retry) == 0 && clients[0].idleTimeout == SSE_IDLE_TIMEOUT);
+	PublishSample();
+	HOST_CHECK(clients[0].rxLength == 0 && _SubscriberCount() == 1);
+
+	//a sample is a frame of its own
+	_Sample(45.0f);
+	HOST_CHECK(strncmp(clients[0].rx, "id: 1\nevent: reading\ndata: {", 28) == 0);
+	HOST_CHECK(strcmp(_Take(0), _SampleFrame()) == 0);
+
+	//second subscriber opens with retry hint and latest sample
+	_Connect(1);
+	_Get(1, "events");
+	body = _Stream(_Take(1));
+	HOST_CHECK(body != NULL && strcmp(body, strcat(strcpy(expected, retry), _SampleFrame())) == 0);
+
+	//past SSE_MAX_SUBSCRIBERS: 503, connection is not a subscriber
+	_Connect(2);
+	_Get(2, "events");
+	HOST_CHECK(strncmp(_Take(2), "HTTP/1.1 503 Service Unavailable\r\n", 34) == 0);
+	HOST_CHECK(_SubscriberCount() == SSE_MAX_SUBSCRIBERS && !_FindConnection(&clients[2].conn)->subscriber);
+	_Sample(46.0f);
+	HOST_CHECK(clients[2].rxLength == 0 && strcmp(_Take(0), _SampleFrame()) == 0 && strcmp(_Take(1), _SampleFrame()) == 0);
+
+	//heartbeat comment every SSE_HEARTBEAT, counted from first subscriber
+	HostAdvance(SSE_HEARTBEAT * 1000000ULL);
+	HOST_CHECK(strcmp(_Take(0), ":\n\n") == 0 && strcmp(_Take(1), ":\n\n") == 0 && clients[2].rxLength == 0);
+	HostAdvance(SSE_HEARTBEAT * 1000000ULL - 1000);
+	HOST_CHECK(clients[0].rxLength == 0 && clients[1].rxLength == 0);
+	HostAdvance(1000);
+	HOST_CHECK(strcmp(_Take(0), ":\n\n") == 0 && strcmp(_Take(1), ":\n\n") == 0);
+
+	//a frame unsent skips the next one, a sent one clears that; client 1 takes nothing from here
+	_Sample(47.0f);
+	strcpy(expected, _SampleFrame());
+	_Sample(48.0f);
+	HOST_CHECK(strcmp(_Take(0), expected) == 0 && _FindConnection(&clients[0].conn)->missedFrames == 1);
+	HOST_CHECK(_FindConnection(&clients[1].conn)->missedFrames == 1 && !clients[1].disconnected);
+	for(uint8 i = 1; i < SSE_MAX_MISSED - 1; ++i){ HostAdvance(SSE_HEARTBEAT * 1000000ULL); _Take(0); }
+	HOST_CHECK(!clients[1].disconnected);
+	_Sample(49.0f);
+	HOST_CHECK(strcmp(_Take(0), _SampleFrame()) == 0 && _FindConnection(&clients[0].conn)->missedFrames == 0);
+
+	//client 1 dropped after SSE_MAX_MISSED skipped frames, having got only the first one
+	HOST_CHECK(clients[1].disconnected && strcmp(clients[1].rx, expected) == 0);
+	HOST_CHECK(_FindConnection(&clients[1].conn) == NULL && _SubscriberCount() == 1);
+	HostAdvance(SSE_HEARTBEAT * 1000000ULL);
+	HOST_CHECK(strcmp(_Take(0), ":\n\n") == 0);
+
+	//freed slot takes a new subscriber
+	_Connect(3);
+	_Get(3, "events");
+	body = _Stream(_Take(3));
+	HOST_CHECK(body != NULL && strcmp(body, strcat(strcpy(expected, retry), _SampleFrame())) == 0);
+	HOST_CHECK(_SubscriberCount() == SSE_MAX_SUBSCRIBERS);
+
+	//a failed send drops a subscriber right away
+	clients[0].sendResult = ESPCONN_MEM;
+	_Sample(50.0f);
+	HOST_CHECK(clients[0].disconnected && _SubscriberCount() == 1 && strcmp(_Take(3), _SampleFrame()) == 0);
+
+	//last subscriber gone: no heartbeats, first new one starts them again
+	clients[3].sendResult = ESPCONN_MEM;
+	_Sample(51.0f);
+	HOST_CHECK(clients[3].disconnected && _SubscriberCount() == 0);
+	HostAdvance(2 * SSE_HEARTBEAT * 1000000ULL);
+	_Connect(0);
+	_Get(0, "events");
+	HOST_CHECK(_Stream(_Take(0)) != NULL);
+	HostAdvance(SSE_HEARTBEAT * 1000000ULL);
+	HOST_CHECK(strcmp(_Take(0), ":\n\n") == 0 && clients[2].rxLength == 0);
+
+	return HostResult("sse_test");
+}
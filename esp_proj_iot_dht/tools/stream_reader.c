@@ -0,0 +1,305 @@
+/*
+ * stream_reader.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Linux gateway side of wired mode (include/user_stream.h): reads COBS framed sample
+ * records from a serial port (or a capture file, or stdin), checks their CRC, acks
+ * them and reports throughput and frame loss. Acks are cumulative: one byte with the
+ * frame number of the newest good record acks everything up to it, so one goes out per
+ * read at most.
+ *
+ * Framing is done in the read buffer: frames are found with memchr on the 0x00
+ * delimiter and COBS decoded in place (decoded data is never longer), records are
+ * parsed where they lie. Only an unfinished frame at the end of the buffer is moved
+ * to its front before the next read.
+ *
+ * Loss: seq counts every reading of the station, skipped counts the ones it held back
+ * (gateway paused it, window full, no tx room), so a seq gap minus the growth of skipped
+ * is frames lost on the wire. Damaged frames (bad CRC or length) are counted apart,
+ * their readings also show up as lost.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path):
+ *   gcc -O2 -DICACHE_FLASH -I include -I $SDK_PATH/include -o stream_reader \
+ *       tools/stream_reader.c
+ *
+ * usage: stream_reader [-b baud] [-s ms] [-r seconds] [-n] [-v] <device | capture | ->
+ *   -b  serial baud rate (115200)
+ *   -s  start streaming with console command "stream <ms>", stopped again on exit
+ *   -r  report interval in seconds (10), 0 for a report at end only
+ *   -n  do not ack frames (station then sends without window)
+ *   -v  print each reading
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+
+#include "c_types.h"
+#include "user_stream.h"
+
+#define READER_BUFFER		4096
+#define READER_FRAME_MAX	256			//longer runs without delimiter are dropped as noise
+
+typedef struct readerStats{
+	uint64_t bytes;					//all bytes read
+	uint64_t frameBytes;			//bytes of good frames, delimiters included
+	uint32_t frames;				//good records
+	uint32_t damaged;				//bad CRC, length or type
+	uint32_t noise;					//runs that were too long to be frames
+	uint32_t lost;					//readings lost on the wire
+	uint32_t skipped;				//readings station held back
+} READER_STATS;
+
+static volatile sig_atomic_t stop = 0;
+static bool haveSeq = false;
+static uint32_t lastSeq = 0;
+static uint32_t lastSkipped = 0;
+
+static void _OnSignal(int iSignal){
+	stop = 1;
+}
+
+static double _Now(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static uint32_t _Get(const uint8_t *iData, uint8_t iBytes){
+	uint32_t value = 0;
+	for(uint8_t i = 0; i < iBytes; ++i) value |= (uint32_t)iData[i] << (8 * i);
+	return value;
+}
+
+static uint16_t _CRC16(const uint8_t *iData, size_t iLength){
+	uint16_t crc = 0xFFFF;
+	for(size_t i = 0; i < iLength; ++i){
+		crc ^= (uint16_t)iData[i] << 8;
+		for(int bit = 0; bit < 8; ++bit) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+/*
+ * COBS decodes a frame (delimiter excluded) in place, returns decoded length or -1 if
+ * a block runs past the end. Output position never passes input position.
+ */
+static long _DecodeCOBS(uint8_t *ioData, size_t iLength){
+	size_t in = 0, out = 0;
+	while(in < iLength){
+		uint8_t code = ioData[in++];
+		if(code == 0 || in + code - 1 > iLength) return -1;
+		memmove(ioData + out, ioData + in, code - 1);
+		in += code - 1;
+		out += code - 1;
+		if(code < 0xFF && in < iLength) ioData[out++] = 0;
+	}
+	return out;
+}
+
+//checks and accounts one decoded record, true if it is good, oFrame is its frame number
+static bool _Record(const uint8_t *iRecord, long iLength, bool iVerbose, READER_STATS *ioStats, uint32_t *oFrame){
+	if(iLength != STREAM_RECORD_SIZE || iRecord[0] != STREAM_RECORD_SAMPLE) return false;
+	if(_CRC16(iRecord, iLength - 2) != _Get(iRecord + iLength - 2, 2)) return false;
+
+	uint32_t seq = _Get(iRecord + 1, 4);
+	uint32_t timestamp = _Get(iRecord + 5, 4);
+	int16_t temperature = (int16_t)_Get(iRecord + 9, 2);
+	uint16_t humidity = _Get(iRecord + 11, 2);
+	uint8_t unit = iRecord[13];
+	uint32_t skipped = _Get(iRecord + 14, 4);
+
+	//first record only sets the base, station restarted its stream if seq went back
+	if(haveSeq){
+		if(seq <= lastSeq){
+			lastSeq = 0;
+			lastSkipped = 0;
+		}
+		uint32_t held = skipped - lastSkipped;
+		uint32_t missing = seq - lastSeq - 1;
+		ioStats->skipped += held;
+		ioStats->lost += (missing > held) ? missing - held : 0;
+	}
+	haveSeq = true;
+	lastSeq = seq;
+	lastSkipped = skipped;
+	*oFrame = seq - skipped;
+
+	if(iVerbose){
+		printf("seq %u t %u us temperature %s%d.%d %c humidity %u.%u %%\n", seq, timestamp,
+				temperature < 0 ? "-" : "", abs(temperature) / 10, abs(temperature) % 10,
+				"CFK"[unit < 3 ? unit : 0], humidity / 10, humidity % 10);
+	}
+	return true;
+}
+
+static void _Report(const char *iLabel, const READER_STATS *iStats, const READER_STATS *iSince, double iSeconds){
+	uint32_t frames = iStats->frames - iSince->frames;
+	uint32_t lost = iStats->lost - iSince->lost;
+	uint32_t expected = frames + lost;
+	if(iSeconds <= 0) iSeconds = 1e-9;
+
+	fprintf(stderr, "%s %.1f s: %u frames %.2f/s, %.0f B/s (%.0f B/s framed), lost %u (%.2f%%), "
+			"damaged %u, skipped by station %u, noise %u\n",
+			iLabel, iSeconds, frames, frames / iSeconds,
+			(iStats->bytes - iSince->bytes) / iSeconds, (iStats->frameBytes - iSince->frameBytes) / iSeconds,
+			lost, expected ? 100.0 * lost / expected : 0.0,
+			iStats->damaged - iSince->damaged, iStats->skipped - iSince->skipped, iStats->noise - iSince->noise);
+}
+
+static speed_t _Baud(long iBaud){
+	switch(iBaud){
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	case 230400: return B230400;
+	case 460800: return B460800;
+	case 921600: return B921600;
+	default: return 0;
+	}
+}
+
+static int _OpenSerial(const char *iPath, long iBaud){
+	int fd = open(iPath, O_RDWR | O_NOCTTY);
+	if(fd < 0) return -1;
+
+	struct termios tty;
+	if(tcgetattr(fd, &tty) == 0){
+		cfmakeraw(&tty);
+		cfsetispeed(&tty, _Baud(iBaud));
+		cfsetospeed(&tty, _Baud(iBaud));
+		tty.c_cflag |= CLOCAL | CREAD;
+		tty.c_cc[VMIN] = 1;
+		tty.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tty);
+		tcflush(fd, TCIFLUSH);
+	}
+	return fd;
+}
+
+int main(int argc, char **argv){
+	long baud = 115200, startInterval = 0, reportInterval = 10;
+	bool ack = true, verbose = false;
+	int opt;
+	while((opt = getopt(argc, argv, "b:s:r:nv")) != -1){
+		switch(opt){
+		case 'b': baud = atol(optarg); break;
+		case 's': startInterval = atol(optarg); break;
+		case 'r': reportInterval = atol(optarg); break;
+		case 'n': ack = false; break;
+		case 'v': verbose = true; break;
+		default: optind = argc + 1; break;
+		}
+	}
+	if(optind != argc - 1 || _Baud(baud) == 0){
+		fprintf(stderr, "usage: %s [-b baud] [-s ms] [-r seconds] [-n] [-v] <device | capture | ->\n", argv[0]);
+		return 2;
+	}
+
+	const char *path = argv[optind];
+	int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDWR | O_NOCTTY);
+	bool serial = fd >= 0 && fd != STDIN_FILENO && isatty(fd);
+	if(serial){
+		close(fd);
+		fd = _OpenSerial(path, baud);
+	}
+	else if(fd < 0) fd = open(path, O_RDONLY);
+	if(fd < 0){
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return 1;
+	}
+	//acks only make sense on a live line
+	ack = ack && serial;
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = _OnSignal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	if(serial && startInterval > 0){
+		char command[32];
+		int length = snprintf(command, sizeof(command), "\rstream %ld\r", startInterval);
+		if(write(fd, command, length) != length) fprintf(stderr, "could not start stream\n");
+	}
+
+	static uint8_t buffer[READER_BUFFER];
+	size_t used = 0;				//bytes in buffer, all of an unfinished frame
+	bool synced = false;
+	READER_STATS stats, reported;
+	memset(&stats, 0, sizeof(stats));
+	reported = stats;
+	double start = _Now(), lastReport = start;
+
+	while(!stop){
+		ssize_t n = read(fd, buffer + used, sizeof(buffer) - used);
+		if(n < 0 && errno == EINTR) continue;
+		if(n <= 0) break;
+		stats.bytes += n;
+
+		size_t end = used + n, frame = 0;
+		bool ackDue = false;
+		uint32_t ackFrame = 0;
+		uint8_t *delimiter;
+		//only new bytes can hold a delimiter, older ones were searched before
+		size_t from = used;
+		while((delimiter = memchr(buffer + from, 0, end - from)) != NULL){
+			size_t length = delimiter - (buffer + frame);
+			//whatever came before first delimiter (console text, a cut frame) is not counted
+			if(!synced) synced = true;
+			else if(length > 0){
+				long decoded = length <= READER_FRAME_MAX ? _DecodeCOBS(buffer + frame, length) : -1;
+				if(decoded >= 0 && _Record(buffer + frame, decoded, verbose, &stats, &ackFrame)){
+					++stats.frames;
+					stats.frameBytes += length + 1;
+					ackDue = true;
+				}
+				else if(length > READER_FRAME_MAX) ++stats.noise;
+				else ++stats.damaged;
+			}
+			frame = delimiter - buffer + 1;
+			from = frame;
+		}
+
+		//keep unfinished frame, a run this long without delimiter is not one
+		used = end - frame;
+		if(used > READER_FRAME_MAX){
+			if(synced) ++stats.noise;
+			used = 0;
+		}
+		else if(frame > 0) memmove(buffer, buffer + frame, used);
+
+		uint8_t ackByte = STREAM_ACK | (ackFrame & STREAM_ACK_MASK);
+		if(ack && ackDue && write(fd, &ackByte, 1) != 1) fprintf(stderr, "ack write failed\n");
+
+		double now = _Now();
+		if(reportInterval > 0 && now - lastReport >= reportInterval){
+			_Report("last", &stats, &reported, now - lastReport);
+			reported = stats;
+			lastReport = now;
+		}
+	}
+
+	if(serial && startInterval > 0){
+		uint8_t command = STREAM_STOP;
+		if(write(fd, &command, 1) != 1) fprintf(stderr, "could not stop stream\n");
+	}
+
+	READER_STATS none;
+	memset(&none, 0, sizeof(none));
+	_Report("total", &stats, &none, _Now() - start);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ * stream_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of wired mode (user/user_stream.c). The station streams through a channel
+ * that loses and damages frames and loses acks, a gateway model decodes frames the way
+ * tools/stream_reader.c does and acks them. Checks that the gateway's loss accounting
+ * matches what the channel did and that the window never stalls the stream, also
+ * through an outage and with a gateway that never acks; then pause, a full tx ring and
+ * STOP.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o stream_test tools/stream_test.c \
+ *       tools/host_sdk.c user/user_stream.c user/user_samples.c user/user_timer.c driver/http.c \
+ *       driver/rodata.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "espconn.h"
+#include "driver/uart.h"
+#include "user_stream.h"
+#include "user_samples.h"
+#include "user_metrics.h"
+#include "user_log.h"
+#include "host_sdk.h"
+
+#define TEST_INTERVAL		2000		//ms
+
+typedef struct channel{
+	uint8 dropPercent;			//frames lost on wire
+	uint8 damagePercent;		//frames with a flipped bit
+	uint8 ackDropPercent;		//acks lost on wire
+	uint32 dropped;
+	uint32 damaged;
+} CHANNEL;
+
+typedef struct gateway{
+	bool acking;
+	uint8 frame[64];
+	uint8 length;
+	bool haveSeq;
+	uint32 firstSeq;
+	uint32 lastSeq;
+	uint32 lastSkipped;
+	uint32 frames;
+	uint32 damaged;
+	uint32 lost;				//readings lost on wire, from seq and skipped
+	uint32 skipped;				//readings station held back
+} GATEWAY;
+
+uint32 metricCounters[METRIC_COUNTERS];
+
+static CHANNEL channel;
+static GATEWAY gateway;
+static uint8 rx[256];
+static uint16 rxLength = 0, rxPosition = 0;
+static uint16 txFree = 2048;
+static uart_rx_cb_t rxCallback = NULL;
+static uint8 osPrint = 1;
+static uint32 readings = 0;
+
+/******** firmware stand-ins ********/
+
+uint16_t rx_buff_deq(char *pdata, uint16_t data_len){
+	uint16 length = rxLength - rxPosition < data_len ? rxLength - rxPosition : data_len;
+	memcpy(pdata, rx + rxPosition, length);
+	rxPosition += length;
+	if(rxPosition == rxLength) rxLength = rxPosition = 0;
+	return length;
+}
+
+uint16_t tx_buff_free(void){ return txFree; }
+void uart_set_rx_cb(uart_rx_cb_t cb){ rxCallback = cb; }
+uart_rx_cb_t uart_get_rx_cb(void){ return rxCallback; }
+void system_set_os_print(uint8 onoff){ osPrint = onoff; }
+void SetSampling(bool iOn){}
+
+//rest of driver/http.c (samples render with httpPut) links against it
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){ return ESPCONN_OK; }
+
+/******** gateway ********/
+
+uint16 _CRC16(const uint8 *iData, uint16 iLength){
+	uint16 crc = 0xFFFF;
+	for(uint16 i = 0; i < iLength; ++i){
+		crc ^= (uint16)iData[i] << 8;
+		for(uint8 bit = 0; bit < 8; ++bit) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+uint32 _Get(const uint8 *iData, uint8 iBytes){
+	uint32 value = 0;
+	for(uint8 i = 0; i < iBytes; ++i) value |= (uint32)iData[i] << (8 * i);
+	return value;
+}
+
+void _Control(uint8 iByte){
+	rx[rxLength++] = iByte;
+	rxCallback();
+}
+
+//one frame, delimiter excluded
+void _GatewayFrame(void){
+	uint8 record[64];
+	uint8 in = 0, out = 0;
+	while(in < gateway.length){
+		uint8 code = gateway.frame[in++];
+		if(code == 0 || in + code - 1 > gateway.length){
+			++gateway.damaged;
+			return;
+		}
+		memcpy(record + out, gateway.frame + in, code - 1);
+		in += code - 1;
+		out += code - 1;
+		if(code < 0xFF && in < gateway.length) record[out++] = 0;
+	}
+	if(out != STREAM_RECORD_SIZE || record[0] != STREAM_RECORD_SAMPLE ||
+			_CRC16(record, out - 2) != _Get(record + out - 2, 2)){
+		++gateway.damaged;
+		return;
+	}
+
+	uint32 seq = _Get(record + 1, 4), skipped = _Get(record + 14, 4);
+	if(gateway.haveSeq){
+		uint32 held = skipped - gateway.lastSkipped, missing = seq - gateway.lastSeq - 1;
+		gateway.skipped += held;
+		gateway.lost += missing > held ? missing - held : 0;
+	}
+	else gateway.firstSeq = seq;
+	gateway.haveSeq = true;
+	gateway.lastSeq = seq;
+	gateway.lastSkipped = skipped;
+	++gateway.frames;
+
+	//acks reach station before its next reading, as uart task runs in between
+	if(gateway.acking && (uint32)rand() % 100 >= channel.ackDropPercent && rxLength < sizeof(rx))
+		rx[rxLength++] = STREAM_ACK | ((seq - skipped) & STREAM_ACK_MASK);
+}
+
+void tx_buff_enq(char *pdata, uint16_t data_len){
+	uint8 data[64];
+	memcpy(data, pdata, data_len);
+
+	//a frame per call (or a lone delimiter), faults hit whole frames
+	if(data_len > 1){
+		if((uint32)rand() % 100 < channel.dropPercent){
+			++channel.dropped;
+			return;
+		}
+		if((uint32)rand() % 100 < channel.damagePercent){
+			++channel.damaged;
+			data[5] ^= data[5] == 0x01 ? 0x02 : 0x01;
+		}
+	}
+	for(uint16 i = 0; i < data_len; ++i){
+		if(data[i] != 0){
+			if(gateway.length < sizeof(gateway.frame)) gateway.frame[gateway.length++] = data[i];
+			continue;
+		}
+		if(gateway.length > 0) _GatewayFrame();
+		gateway.length = 0;
+	}
+}
+
+/******** test ********/
+
+void _ReadSample(void){
+	if(rxLength > 0) rxCallback();
+	AddSample(40.0f + readings % 10, 21.5f, 0);
+	StreamSample();
+	++readings;
+}
+
+void _ConsoleRx(void){}
+
+void _Start(bool iAcking, uint8 iDrop, uint8 iDamage, uint8 iAckDrop){
+	memset(&gateway, 0, sizeof(gateway));
+	memset(&channel, 0, sizeof(channel));
+	gateway.acking = iAcking;
+	channel.dropPercent = iDrop;
+	channel.damagePercent = iDamage;
+	channel.ackDropPercent = iAckDrop;
+	readings = 0;
+	metricCounters[METRIC_STREAM_SKIPPED] = 0;
+	HOST_CHECK(StartStream(TEST_INTERVAL, _ReadSample));
+	//a first ack turns window on, as reader's first ack does
+	if(iAcking) _Control(STREAM_ACK);
+}
+
+void _Stop(void){
+	_Control(STREAM_STOP);
+	HOST_CHECK(!Streaming());
+	HOST_CHECK(rxCallback == _ConsoleRx);
+}
+
+int main(int argc, char **argv){
+	srand(argc > 1 ? atoi(argv[1]) : 1);
+	uart_set_rx_cb(_ConsoleRx);
+	HOST_CHECK(!StartStream(STREAM_INTERVAL_MIN - 1, _ReadSample));
+
+	//clean line, every reading arrives
+	_Start(true, 0, 0, 0);
+	HOST_CHECK(osPrint == 0 && logLevels[LOG_MODULE_STREAM] == LOG_LEVEL_NONE);
+	HostAdvance(200ULL * TEST_INTERVAL * 1000);
+	HOST_CHECK(readings == 200 && gateway.frames == 200);
+	HOST_CHECK(gateway.lost == 0 && gateway.skipped == 0 && gateway.damaged == 0);
+	_Stop();
+	HOST_CHECK(osPrint == 1 && logLevels[LOG_MODULE_STREAM] != LOG_LEVEL_NONE);
+
+	//lossy line: lost and damaged frames and lost acks must not close window for good
+	_Start(true, 10, 5, 20);
+	HostAdvance(5000ULL * TEST_INTERVAL * 1000);
+	//clean tail so that gateway sees every loss, frames before its first one it can not
+	channel.dropPercent = channel.damagePercent = 0;
+	HostAdvance(1ULL * TEST_INTERVAL * 1000);
+	printf("lossy: %u readings, %u frames, %u lost (%u dropped, %u damaged), %u skipped\n", readings,
+			gateway.frames, gateway.lost, channel.dropped, channel.damaged, gateway.skipped);
+	HOST_CHECK(gateway.firstSeq - 1 + gateway.lost == channel.dropped + channel.damaged);
+	HOST_CHECK(gateway.damaged == channel.damaged);
+	HOST_CHECK(gateway.skipped <= metricCounters[METRIC_STREAM_SKIPPED]);
+	HOST_CHECK(metricCounters[METRIC_STREAM_SKIPPED] < readings / 50);
+	HOST_CHECK(gateway.lastSeq == readings);
+	_Stop();
+
+	//acks mostly lost: window fills, is given up after STREAM_ACK_TIMEOUT and stream goes on
+	_Start(true, 0, 0, 95);
+	HostAdvance(1000ULL * TEST_INTERVAL * 1000);
+	printf("acks lost: %u readings, %u frames, %u skipped\n", readings, gateway.frames, gateway.skipped);
+	HOST_CHECK(gateway.skipped > 0 && gateway.lost == 0);
+	HOST_CHECK(gateway.frames > readings / 2 && gateway.lastSeq + STREAM_ACK_TIMEOUT / TEST_INTERVAL >= readings);
+	_Stop();
+
+	//outage: nothing gets through, window is given up and stream comes back with line
+	_Start(true, 0, 0, 0);
+	HostAdvance(20ULL * TEST_INTERVAL * 1000);
+	channel.dropPercent = 100;
+	HostAdvance(100ULL * TEST_INTERVAL * 1000);
+	uint32 framesBefore = gateway.frames, readingsBefore = readings;
+	channel.dropPercent = 0;
+	HostAdvance((STREAM_ACK_TIMEOUT / TEST_INTERVAL + 2ULL) * TEST_INTERVAL * 1000);
+	HOST_CHECK(gateway.frames > framesBefore);
+	framesBefore = gateway.frames;
+	readingsBefore = readings;
+	HostAdvance(50ULL * TEST_INTERVAL * 1000);
+	HOST_CHECK(gateway.frames - framesBefore == readings - readingsBefore);
+	HOST_CHECK(gateway.lost == channel.dropped);
+	_Stop();
+
+	//gateway that never acks gets every reading
+	_Start(false, 0, 0, 0);
+	HostAdvance(100ULL * TEST_INTERVAL * 1000);
+	HOST_CHECK(gateway.frames == 100 && metricCounters[METRIC_STREAM_SKIPPED] == 0);
+
+	//pause and a full tx ring are skipped readings, not loss
+	_Control(STREAM_XOFF);
+	HostAdvance(3ULL * TEST_INTERVAL * 1000);
+	_Control(STREAM_XON);
+	txFree = STREAM_FRAME_SIZE - 1;
+	HostAdvance(1ULL * TEST_INTERVAL * 1000);
+	txFree = 2048;
+	HostAdvance(2ULL * TEST_INTERVAL * 1000);
+	HOST_CHECK(gateway.skipped == 4 && gateway.lost == 0 && gateway.frames == 102);
+	_Stop();
+
+	//no readings once stopped
+	uint32 frames = gateway.frames;
+	HostAdvance(10ULL * TEST_INTERVAL * 1000);
+	HOST_CHECK(gateway.frames == frames);
+
+	return HostResult("stream_test");
+}
@@ -0,0 +1,173 @@
+/*
+ * timer_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of the timer wheel (user/user_timer.c) against a reference model: every timer
+ * of the pool is armed, re-armed and disarmed at random (delays from 0 ms to past the
+ * wheel span, one-shot and periodic), also from callbacks, while the virtual clock runs
+ * for days with late os timers, crossing the system_get_time wrap many times. Model
+ * keeps each timer's due ms the plain way; a timer must never fire disarmed or early,
+ * never later than os timer lateness allows and never be missed, TimerArmed must agree
+ * and TimerNow must follow the clock.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o timer_test tools/timer_test.c \
+ *       tools/host_sdk.c user/user_timer.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "user_timer.h"
+#include "host_sdk.h"
+
+#define TEST_STEPS				400000
+#define TEST_OS_LATE			2500		//us, os timers fire up to this late
+#define TEST_LATE_MAX			(TEST_OS_LATE / 1000 + 1)	//ms a timer may fire after its due ms
+#define TEST_STEP_MAX			3000000000u	//us, longest clock step, well within a system_get_time wrap
+
+typedef struct testTimer{
+	TIMER_ID id;
+	bool armed;
+	uint32 due;					//TimerNow() it fires at
+	uint32 period;				//ms, 0 for one-shot
+	bool far;					//armed past wheel span
+	uint32 fires;
+} TEST_TIMER;
+
+static TEST_TIMER model[TIMER_ENTRIES];
+static uint32 errors = 0;
+static sint32 maxLate = 0;
+static uint32 farFires = 0;
+
+/******** test ********/
+
+//delays of all sizes: within a slot, each wheel level, past the wheel span
+uint32 _Delay(void){
+	uint8 r = rand() % 100;
+	if(r < 40) return rand() % 40;
+	if(r < 70) return rand() % 5000;
+	if(r < 90) return rand() % 2000000;
+	if(r < 97) return rand() % 40000000;
+	return 40000000u + rand() % 100000000u;
+}
+
+void _Arm(uint8 iTimer){
+	bool repeat = rand() % 3 == 0;
+	uint32 delay = _Delay();
+	if(repeat && delay == 0) delay = 1;
+	HOST_CHECK(ArmTimer(model[iTimer].id, delay, repeat));
+	model[iTimer].armed = true;
+	model[iTimer].due = TimerNow() + delay;
+	model[iTimer].period = repeat ? delay : 0;
+	model[iTimer].far = delay >> (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS) != 0;
+}
+
+void _Disarm(uint8 iTimer){
+	HOST_CHECK(DisarmTimer(model[iTimer].id));
+	model[iTimer].armed = false;
+}
+
+//a random timer armed or disarmed
+void _Poke(void){
+	uint8 timer = rand() % TIMER_ENTRIES;
+	if(rand() % 4 == 0) _Disarm(timer);
+	else _Arm(timer);
+}
+
+void _Fired(void *iArg){
+	TEST_TIMER *timer = iArg;
+	uint32 now = TimerNow();
+	if(!timer->armed){
+		printf("timer %u fired disarmed\n", timer->id);
+		++errors;
+		return;
+	}
+
+	sint32 late = (sint32)(now - timer->due);
+	if(late < 0 || late > TEST_LATE_MAX){
+		printf("timer %u fired %d ms after its due ms %u\n", timer->id, late, timer->due);
+		++errors;
+	}
+	if(late > maxLate) maxLate = late;
+	++timer->fires;
+	farFires += timer->far;
+
+	//periodic keeps its phase, missed periods are skipped
+	if(timer->period > 0){
+		timer->due += timer->period;
+		if((sint32)(timer->due - now) < 0) timer->due = now + timer->period;
+	}
+	else timer->armed = false;
+
+	//callbacks arm and disarm others and themselves
+	uint8 r = rand() % 10;
+	if(r == 0) _Disarm(rand() % TIMER_ENTRIES);
+	else if(r == 1) _Arm(rand() % TIMER_ENTRIES);
+	else if(r == 2) _Disarm(timer - model);
+}
+
+//timers past their due ms by more than lateness allows were missed
+void _CheckMissed(void){
+	uint32 now = TimerNow();
+	for(uint8 i = 0; i < TIMER_ENTRIES; ++i){
+		HOST_CHECK(TimerArmed(model[i].id) == model[i].armed);
+		if(model[i].armed && (sint32)(now - model[i].due) > TEST_LATE_MAX){
+			printf("timer %u missed, due %u, now %u\n", i, model[i].due, now);
+			++errors;
+			_Disarm(i);
+		}
+	}
+}
+
+int main(void){
+	//pool, ids and arguments
+	for(uint8 i = 0; i < TIMER_ENTRIES; ++i){
+		model[i].id = CreateTimer(_Fired, &model[i]);
+		HOST_CHECK(model[i].id == i && !TimerArmed(i));
+	}
+	HOST_CHECK(CreateTimer(_Fired, NULL) == TIMER_NONE && CreateTimer(NULL, NULL) == TIMER_NONE);
+	HOST_CHECK(!ArmTimer(0, 0, true) && !ArmTimer(TIMER_ENTRIES, 10, false) && !ArmTimer(TIMER_NONE, 10, false));
+	HOST_CHECK(!DisarmTimer(TIMER_ENTRIES) && !TimerArmed(TIMER_NONE));
+
+	//idle wheel still wakes, keeping its clock across wraps. Clock started at a us within a ms
+	uint32 start = TimerNow();
+	uint64_t elapsed = hostTimeUs % 1000;
+	uint32 lastUs = hostTimeUs;
+	HOST_CHECK(HostNextTimer() <= TIMER_WAKE_MAX * 1000ULL);
+
+	hostTimerLateUs = TEST_OS_LATE;
+	for(uint32 step = 0; step < TEST_STEPS; ++step){
+		uint64_t next = HostNextTimer();
+		HOST_CHECK(next != UINT64_MAX);
+		if(next > TEST_STEP_MAX) next = TEST_STEP_MAX;
+
+		//something happens before os timer fires, or it fires
+		if(rand() % 3 == 0 && next > 1000){
+			HostAdvance(rand() % next);
+			_Poke();
+		}
+		else HostAdvance(next);
+
+		elapsed += (uint32)(hostTimeUs - lastUs);
+		lastUs = hostTimeUs;
+		uint32 ms = TimerNow() - start;
+		HOST_CHECK(ms == (uint32)(elapsed / 1000));
+		_CheckMissed();
+	}
+
+	//every timer fired, also ones past wheel span
+	HOST_CHECK(farFires > 0);
+	uint64_t fires = 0;
+	for(uint8 i = 0; i < TIMER_ENTRIES; ++i){
+		HOST_CHECK(model[i].fires > 0);
+		fires += model[i].fires;
+	}
+	printf("%llu fires (%u past wheel span), latest %d ms, %llu h, %llu system_get_time wraps\n", (unsigned long long)fires, farFires, maxLate,
+			(unsigned long long)(elapsed / 3600000000ULL), (unsigned long long)(elapsed >> 32));
+	HOST_CHECK(errors == 0 && (elapsed >> 32) >= 10);
+
+	return HostResult("timer_test");
+}
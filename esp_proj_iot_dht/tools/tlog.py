@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+"""
+tlog.py
+
+Dictionary builder and decoder for tokenised logs (include/user_tlog.h).
+
+With ESP_LOG_TOKENISED the firmware sends log calls as records:
+
+    0xF5, id (4 bytes LE), arguments..., '\\n'
+
+where id is the 65599 hash of the format string (TLOG_HASH), integer arguments
+are zigzag varints and string arguments are NUL terminated. After the start
+byte, '\\n', 0xF5 and 0xDB are sent as 0xDB, byte ^ 0x20, so a record ends at
+the first '\\n' like a text line. Text output of the SDK (and untokenised
+os_printf) is interleaved with the records.
+
+  dict    scans the sources for log calls with a literal format (LOG_ERROR,
+          LOG_WARN, LOG_INFO, LOG_DEBUG, LOG_PRINT and TLOG), hashes their
+          formats as LOG_PRINT prefixes them ("[WIFI-INFO] ...") and writes the
+          id -> format dictionary. Hash collisions are reported as errors.
+
+  decode  turns a UART capture (file or stdin, e.g. a serial port) back into
+          text, records with an unknown id are shown as such.
+
+usage: tlog.py dict <project dir> <dictionary .json>
+       tlog.py decode <dictionary .json> [capture]
+"""
+
+import json
+import os
+import re
+import sys
+
+FRAME_START = 0xF5
+ESCAPE = 0xDB           # TLOG_ESCAPE
+HASH_LENGTH = 64        # TLOG_HASH_LENGTH
+HASH_FACTOR = 65599
+
+# string macros of the SDK used inside formats
+STRING_MACROS = {
+    "IPSTR": "%d.%d.%d.%d",
+    "MACSTR": "%02x:%02x:%02x:%02x:%02x:%02x",
+}
+
+LITERAL = r'"(?:\\.|[^"\\])*"'
+FORMAT = r'((?:%s|\s+|IPSTR|MACSTR)+)' % LITERAL
+# LOG_INFO(WIFI, "format", ...) and LOG_PRINT(WIFI, INFO, "format", ...)
+LEVEL_CALL = re.compile(r'\bLOG_(ERROR|WARN|INFO|DEBUG)\s*\(\s*(\w+)\s*,\s*' + FORMAT + r'\s*[,)]')
+LOG_PRINT_CALL = re.compile(r'\bLOG_PRINT\s*\(\s*(\w+)\s*,\s*(\w+)\s*,\s*' + FORMAT + r'\s*[,)]')
+TLOG_CALL = re.compile(r'\bTLOG\s*\(\s*' + FORMAT + r'\s*[,)]')
+
+ESCAPES = {"n": "\n", "r": "\r", "t": "\t", "\\": "\\", '"': '"', "'": "'", "0": "\0"}
+
+
+def tlog_hash(text):
+    """TLOG_HASH of a format string (bytes as in the C literal)"""
+    data = text.encode("latin-1")
+    value = len(data)
+    factor = HASH_FACTOR
+    for byte in data[:HASH_LENGTH]:
+        value = (value + factor * byte) & 0xFFFFFFFF
+        factor = (factor * HASH_FACTOR) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    out = []
+    i = 0
+    while i < len(literal):
+        c = literal[i]
+        if c == "\\":
+            i += 1
+            e = literal[i]
+            if e == "x":
+                digits = re.match(r"[0-9a-fA-F]+", literal[i + 1:]).group(0)
+                out.append(chr(int(digits, 16) & 0xFF))
+                i += len(digits)
+            else:
+                out.append(ESCAPES.get(e, e))
+        else:
+            out.append(c)
+        i += 1
+    return "".join(out)
+
+
+def format_string(expression):
+    """joins adjacent literals and SDK string macros of a call's format argument"""
+    parts = re.findall(LITERAL + r'|IPSTR|MACSTR', expression)
+    return "".join(STRING_MACROS[p] if p in STRING_MACROS else unescape(p[1:-1]) for p in parts)
+
+
+def strip_comments(source):
+    """drops comments, string literals are kept"""
+    return re.sub(LITERAL + r"|'(?:\\.|[^'\\])*'|//[^\n]*|/\*.*?\*/",
+                  lambda m: m.group(0) if m.group(0)[0] in "\"'" else " ", source, flags=re.S)
+
+
+def prefix(module, level):
+    """LOG_PRINT prefix of a module and level"""
+    return "[%s-%s] " % (module, level)
+
+
+def build_dictionary(project):
+    sources = {}
+    for folder in ("user", "driver", "include"):
+        for root, _, files in os.walk(os.path.join(project, folder)):
+            for name in sorted(files):
+                if name.endswith((".c", ".h")):
+                    path = os.path.join(root, name)
+                    sources[path] = strip_comments(open(path, encoding="latin-1").read())
+
+    formats = {}
+    errors = []
+    for path, source in sorted(sources.items()):
+        texts = [prefix(m.group(2), m.group(1)) + format_string(m.group(3)) for m in LEVEL_CALL.finditer(source)]
+        texts += [prefix(m.group(1), m.group(2)) + format_string(m.group(3)) for m in LOG_PRINT_CALL.finditer(source)]
+        texts += [format_string(m.group(1)) for m in TLOG_CALL.finditer(source)]
+        for text in texts:
+            key = "%08x" % tlog_hash(text)
+            if key in formats and formats[key] != text:
+                errors.append("%s: id %s of %r collides with %r" % (path, key, text, formats[key]))
+            formats[key] = text
+    return {"formats": formats}, errors
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            break
+    value &= 0xFFFFFFFF
+    signed = (value >> 1) ^ -(value & 1)
+    return signed, pos
+
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l)?([diuxXcsp%])")
+
+
+def render(text, data, pos):
+    """formats text with arguments unpacked from data at pos, as os_printf would,
+    returns the line and the position after the arguments. IndexError if data ends early"""
+    out = []
+    last = 0
+    for match in CONVERSION.finditer(text):
+        out.append(text[last:match.start()])
+        last = match.end()
+        flags, width, precision, kind = match.groups()
+        if kind == "%":
+            out.append("%")
+            continue
+        spec = "%" + flags + width + ("." + precision if precision else "")
+        if kind == "s":
+            end = data.find(b"\0", pos)
+            if end < 0:
+                raise IndexError("string not terminated")
+            out.append((spec + "s") % data[pos:end].decode("latin-1"))
+            pos = end + 1
+            continue
+        value, pos = read_varint(data, pos)
+        if kind in "di":
+            out.append((spec + "d") % value)
+        elif kind == "c":
+            out.append((spec + "c") % chr(value & 0xFF))
+        elif kind == "p":
+            out.append("0x%08x" % (value & 0xFFFFFFFF))
+        else:
+            out.append((spec + ("d" if kind == "u" else kind)) % (value & 0xFFFFFFFF))
+    out.append(text[last:])
+    return "".join(out), pos
+
+
+def unescape_record(data):
+    """record bytes between start byte and '\\n' without their escapes, ValueError if an
+    escape is cut"""
+    out = bytearray()
+    escaped = False
+    for byte in data:
+        if escaped:
+            out.append(byte ^ 0x20)
+            escaped = False
+        elif byte == ESCAPE:
+            escaped = True
+        else:
+            out.append(byte)
+    if escaped:
+        raise ValueError("escape cut")
+    return bytes(out)
+
+
+def decode(dictionary, stream, output):
+    formats = dictionary["formats"]
+    data = b""
+    while True:
+        chunk = stream.read(4096)
+        data += chunk
+        pos = 0
+        while pos < len(data):
+            start = data.find(bytes([FRAME_START]), pos)
+            if start < 0:
+                start = len(data)
+            output.write(data[pos:start].decode("latin-1"))
+            pos = start
+            if start == len(data):
+                break
+            end = data.find(b"\n", start + 1)
+            if end < 0:
+                if chunk:
+                    break                       # record not complete yet
+                output.write(data[start:].decode("latin-1"))
+                pos = len(data)
+                break
+            try:
+                record = unescape_record(data[start + 1:end])
+                if len(record) < 4:
+                    raise IndexError("id incomplete")
+                key = "%08x" % int.from_bytes(record[:4], "little")
+                text = formats.get(key)
+                if text is None:
+                    # stale dictionary or not a record, skipped
+                    line = "<unknown id %s>" % key
+                else:
+                    line, used = render(text, record, 4)
+                    if used != len(record):
+                        raise IndexError("record longer than its format")
+            except (IndexError, ValueError):
+                output.write("?")               # not a record (or a damaged one), resync
+                pos = start + 1
+                continue
+            output.write(line + "\r\n")
+            pos = end + 1
+        data = data[pos:]
+        output.flush()
+        if not chunk:
+            break
+
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == "dict":
+        dictionary, errors = build_dictionary(sys.argv[2])
+        for error in errors:
+            print(error, file=sys.stderr)
+        with open(sys.argv[3], "w") as f:
+            json.dump(dictionary, f, indent=1, sort_keys=True)
+        print("%d formats" % len(dictionary["formats"]))
+        sys.exit(1 if errors else 0)
+    elif len(sys.argv) in (3, 4) and sys.argv[1] == "decode":
+        dictionary = json.load(open(sys.argv[2]))
+        stream = open(sys.argv[3], "rb", buffering=0) if len(sys.argv) == 4 else sys.stdin.buffer
+        decode(dictionary, stream, sys.stdout)
+    else:
+        print(__doc__.strip().split("usage: ")[1], file=sys.stderr)
+        sys.exit(2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,259 @@
+/*
+ * tlog_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of tokenised logging (include/user_tlog.h, user/user_tlog.c) and its decoder
+ * (tools/tlog.py). Log calls of this file are encoded as the firmware does with
+ * ESP_LOG_TOKENISED while the text os_printf would print is kept. Checks TLOG_HASH against
+ * tools/tlog.py's hash, varint encoding, escapes (no '\n' inside a record, so the tx ring
+ * drops whole records), string cuts and a record of TLOG_ARGS_MAX arguments, then builds a dictionary from this file with tools/tlog.py, decodes the
+ * capture (SDK text in between) and compares it with the text; a damaged capture must
+ * resync and decode every record not hit. Needs python3 for the decoder part, run from
+ * esp_proj_iot_dht.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o tlog_test tools/tlog_test.c \
+ *       tools/host_sdk.c user/user_tlog.c
+ */
+
+#define ESP_LOG_TOKENISED
+
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+
+#include "c_types.h"
+#include "ip_addr.h"
+#include "user_interface.h"
+#include "user_log.h"
+#include "host_sdk.h"
+
+//capture and decoder files, from esp_proj_iot_dht
+#define TEST_DIR				".output/host/tlog_test.d"
+#define TEST_CAPTURE_SIZE		8192
+
+//every log call also renders the text os_printf would print, levels are not checked
+#undef _LOG
+#define _LOG(module, level, message, args...) \
+	do {_Expect("[" #module "-" #level "] " message "\r\n", ##args); LOG_PRINT(module, level, message, ##args);} while(0)
+
+static uint8 capture[TEST_CAPTURE_SIZE];
+static uint32 captureLength = 0;
+static char expected[TEST_CAPTURE_SIZE];
+static uint32 expectedLength = 0;
+
+uint8 _TLogVarint(uint8 *oBuffer, sint32 iValue);
+
+/******** firmware stand-ins ********/
+
+void tx_buff_enq(char *pdata, uint16_t data_len){
+	HOST_CHECK(captureLength + data_len <= sizeof(capture));
+	memcpy(capture + captureLength, pdata, data_len);
+	captureLength += data_len;
+}
+
+/******** test ********/
+
+void _Expect(const char *iFormat, ...){
+	va_list args;
+	va_start(args, iFormat);
+	expectedLength += vsnprintf(expected + expectedLength, sizeof(expected) - expectedLength, iFormat, args);
+	va_end(args);
+}
+
+//SDK text between records passes through decoder
+void _SDKText(const char *iText){
+	tx_buff_enq((char *)iText, strlen(iText));
+	_Expect("%s", iText);
+}
+
+//65599 hash as tools/tlog.py computes it
+uint32 _Hash(const char *iText){
+	uint32 length = strlen(iText), value = length, factor = 65599;
+	for(uint32 i = 0; i < length && i < TLOG_HASH_LENGTH; ++i, factor *= 65599) value += factor * (uint8)iText[i];
+	return value;
+}
+
+bool _Varint(sint32 iValue, const char *iBytes, uint8 iLength){
+	uint8 buffer[8];
+	return _TLogVarint(buffer, iValue) == iLength && memcmp(buffer, iBytes, iLength) == 0;
+}
+
+void _Logs(void){
+	uint8 ip[4] = {192, 168, 1, 7}, mask[4] = {255, 255, 255, 0}, gw[4] = {192, 168, 1, 1};
+	uint8 mac[6] = {0xde, 0xad, 0xbe, 0xef, 0x00, 0x01};
+	uint8 ssid[33] = "HomeNet";
+	const char *state = "CONNECTING";
+	char name[40] = "a name longer than what a record keeps";
+
+	LOG_INFO(ESP, "Starting WebServer");
+	LOG_INFO(WIFI, "wifi state %s -> %s", state, "GOT_IP");
+	LOG_INFO(WIFI, "Got IP, ip:" IPSTR ",mask:" IPSTR ",gw:" IPSTR, IP2STR(ip), IP2STR(mask), IP2STR(gw));
+	LOG_WARN(WIFI_FSM, "Station mac: " MACSTR " join, AID = %d", MAC2STR(mac), 3);
+	LOG_INFO(WIFI, "Connected to ssid %s, channel %d", ssid, 6);
+	LOG_ERROR(HTTP, "min %d, max %d, -1 %d, unsigned %u, hex %x", INT_MIN, INT_MAX, -1, 0xFFFFFFFFu, 0xdeadbeef);
+	LOG_DEBUG(DHT, "char %c, percent %%, padded %5d|%-4d|%03u", 'x', 42, -7, 9);
+	TLOG("tokenised only %d %s", -5, "x");
+	_Expect("tokenised only %d %s\r\n", -5, "x");
+	LOG_DEBUG(STREAM, "escaped %d %d %d %s", 5, -110, -123, "a\nb");
+
+	//record keeps TLOG_STRING_MAX characters of a string
+	uint32 mark = expectedLength;
+	LOG_INFO(CONSOLE, "name %s!", name);
+	expectedLength = mark + sprintf(expected + mark, "[CONSOLE-INFO] name %.*s!\r\n", TLOG_STRING_MAX, name);
+
+	//TLOG_ARGS_MAX arguments, strings get what is left after room for the rest
+	mark = expectedLength;
+	uint32 before = captureLength;
+	LOG_INFO(STREAM, "%s %s %s %s %d %d %d %d %d %d %d %d %d %d %d %d", name, name, name, name,
+			INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN);
+	HOST_CHECK(captureLength - before == TLOG_RECORD_SIZE);
+	expectedLength = mark + sprintf(expected + mark, "[STREAM-INFO] %.24s %.24s %.6s %.4s %d %d %d %d %d %d %d %d %d %d %d %d\r\n",
+			name, name, name, name,
+			INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN);
+}
+
+int _Run(const char *iCommand){
+	printf("%s\n", iCommand);
+	return system(iCommand);
+}
+
+void _WriteFile(const char *iPath, const void *iData, uint32 iLength){
+	FILE *file = fopen(iPath, "wb");
+	HOST_CHECK(file != NULL && fwrite(iData, 1, iLength, file) == iLength);
+	if(file != NULL) fclose(file);
+}
+
+//decodes a capture with tools/tlog.py, null terminated output
+char *_Decode(const uint8 *iCapture, uint32 iLength){
+	static char output[TEST_CAPTURE_SIZE * 2];
+	_WriteFile(TEST_DIR "/capture.bin", iCapture, iLength);
+	if(_Run("python3 tools/tlog.py decode " TEST_DIR "/dict.json " TEST_DIR "/capture.bin > " TEST_DIR "/decoded.txt") != 0)
+		return NULL;
+	FILE *file = fopen(TEST_DIR "/decoded.txt", "rb");
+	size_t length = fread(output, 1, sizeof(output) - 1, file);
+	fclose(file);
+	output[length] = '\0';
+
+	//damaged records pass through as text, their NULs too
+	for(size_t i = 0; i < length; ++i) if(output[i] == '\0') output[i] = '.';
+	return output;
+}
+
+int main(void){
+	//hash folds the same as tools/tlog.py's, past TLOG_HASH_LENGTH only length counts
+	HOST_CHECK(TLOG_HASH("") == _Hash(""));
+	HOST_CHECK(TLOG_HASH("a") == _Hash("a"));
+	HOST_CHECK(TLOG_HASH("[WIFI-INFO] wifi state %s -> %s") == _Hash("[WIFI-INFO] wifi state %s -> %s"));
+	#define TEXT_64		"0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+	HOST_CHECK(TLOG_HASH(TEXT_64) == _Hash(TEXT_64));
+	HOST_CHECK(TLOG_HASH(TEXT_64 "x") == _Hash(TEXT_64 "x") && TLOG_HASH(TEXT_64 "x") != TLOG_HASH(TEXT_64 "xy"));
+	HOST_CHECK(TLOG_HASH(TEXT_64 "x") == TLOG_HASH(TEXT_64 "y"));
+
+	//zigzag varints
+	HOST_CHECK(_Varint(0, "\x00", 1) && _Varint(-1, "\x01", 1) && _Varint(1, "\x02", 1));
+	HOST_CHECK(_Varint(63, "\x7e", 1) && _Varint(-64, "\x7f", 1) && _Varint(64, "\x80\x01", 2));
+	HOST_CHECK(_Varint(INT_MAX, "\xfe\xff\xff\xff\x0f", 5) && _Varint(INT_MIN, "\xff\xff\xff\xff\x0f", 5));
+
+	//record layout, a NULL string is sent empty. Id de f5 8e b9 has a frame start byte, escaped
+	captureLength = 0;
+	TLOG("x %s %d", (char *)NULL, 300);
+	HOST_CHECK(_Hash("x %s %d") == 0xb98ef5de);
+	HOST_CHECK(captureLength == 10 && memcmp(capture, "\xf5\xde\xdb\xd5\x8e\xb9\x00\xd8\x04\n", 10) == 0);
+	uint32 id;
+
+	//'\n', frame start and escape bytes are escaped after the start byte
+	captureLength = 0;
+	TLOG("y %d %d %d %s", 5, -110, -123, "a\n\xf5\xdb");
+	id = _Hash("y %d %d %d %s");
+	uint8 plain[] = {id, id >> 8, id >> 16, id >> 24, 0x0a, 0xdb, 0x01, 0xf5, 0x01, 'a', '\n', 0xf5, 0xdb, '\0'};
+	uint8 frame[2 * sizeof(plain) + 2];
+	uint32 frameLength = 0;
+	frame[frameLength++] = TLOG_FRAME_START;
+	for(uint32 i = 0; i < sizeof(plain); ++i){
+		if(plain[i] == '\n' || plain[i] == TLOG_FRAME_START || plain[i] == TLOG_ESCAPE){
+			frame[frameLength++] = TLOG_ESCAPE;
+			frame[frameLength++] = plain[i] ^ 0x20;
+		}
+		else frame[frameLength++] = plain[i];
+	}
+	frame[frameLength++] = '\n';
+	HOST_CHECK(captureLength == frameLength && memcmp(capture, frame, frameLength) == 0);
+	HOST_CHECK(memchr(capture, '\n', captureLength - 1) == NULL && memchr(capture + 1, TLOG_FRAME_START, captureLength - 1) == NULL);
+
+	//capture: records with SDK text in between
+	captureLength = 0;
+	_SDKText("SDK text line\r\n");
+	_Logs();
+	_SDKText("scandone\r\nadd 0\r\n");
+	_Logs();
+	HOST_CHECK(expectedLength < sizeof(expected) && strstr(expected, "ip:192.168.1.7,mask:255.255.255.0,gw:192.168.1.1"));
+	printf("%u bytes of text, %u tokenised\n", expectedLength, captureLength);
+
+	//dictionary from this file, as `make tlogdict` builds it from firmware sources
+	if(_Run("python3 --version") != 0){
+		printf("no python3, decoder part skipped\n");
+		return HostResult("tlog_test");
+	}
+	HOST_CHECK(_Run("rm -rf " TEST_DIR " && mkdir -p " TEST_DIR "/src/user && cp tools/tlog_test.c " TEST_DIR "/src/user/") == 0);
+	HOST_CHECK(_Run("python3 tools/tlog.py dict " TEST_DIR "/src " TEST_DIR "/dict.json") == 0);
+
+	//round trip
+	char *decoded = _Decode(capture, captureLength);
+	HOST_CHECK(decoded != NULL && strcmp(decoded, expected) == 0);
+
+	//unknown id is shown and skipped to end of its line
+	static uint8 damaged[TEST_CAPTURE_SIZE];
+	memcpy(damaged, "\xf5\x01\x02\x03\x04junk\nok\r\n", 14);
+	decoded = _Decode(damaged, 14);
+	HOST_CHECK(decoded != NULL && strcmp(decoded, "<unknown id 04030201>\r\nok\r\n") == 0);
+
+	//damage: cut records, flipped bits, lost bytes; records two past a damage decode
+	uint32 length = 0, kept = 0;
+	char intact[TEST_CAPTURE_SIZE];
+	uint32 intactLength = 0;
+	uint8 since = 2;
+	const char *line = expected;
+	for(uint32 i = 0; i < captureLength; ){
+		uint32 end = i;
+		while(end < captureLength && capture[end] != '\n') ++end;
+		++end;
+		const char *lineEnd = strstr(line, "\r\n") + 2;
+		if(capture[i] == TLOG_FRAME_START && rand() % 4 == 0){
+			uint32 cut = i + 1 + rand() % (end - i - 1);
+			memcpy(damaged + length, capture + i, end - i);
+			if(rand() % 2) damaged[cut - 1] ^= 1 << (rand() % 8);
+			else memmove(damaged + cut - 1, damaged + cut, end - cut);
+			length += end - i - 1;
+			since = 0;
+		}
+		else{
+			memcpy(damaged + length, capture + i, end - i);
+			length += end - i;
+			if(since >= 2){
+				memcpy(intact + intactLength, line, lineEnd - line);
+				intactLength += lineEnd - line;
+				intact[intactLength++] = '\0';
+				++kept;
+			}
+			++since;
+		}
+		i = end;
+		line = lineEnd;
+	}
+	decoded = _Decode(damaged, length);
+	HOST_CHECK(decoded != NULL);
+	uint32 found = 0;
+	for(const char *text = intact; decoded != NULL && text < intact + intactLength; text += strlen(text) + 1){
+		const char *at = strstr(decoded, text);
+		if(at == NULL) continue;
+		decoded = (char *)at + strlen(text);
+		++found;
+	}
+	printf("damaged capture: %u of %u records past a damage decoded\n", found, kept);
+	HOST_CHECK(kept > 0 && found == kept);
+
+	return HostResult("tlog_test");
+}
@@ -0,0 +1,191 @@
+/*
+ * trace_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of tracepoints (user/user_trace.c) on the virtual clock: a boot and uploads
+ * are traced and each stage must pair its end point with latest start point (a point
+ * may end one stage and start another, once-stages count their first pair only, an
+ * end without start is not paired), latencies land in the right buckets also across
+ * a system_get_time wrap, the drain timer empties the ring and an overflowing ring
+ * counts its lost points. /api/trace JSON is checked for shape and, at largest values,
+ * for parts that fit TRACE_JSON_PART_SIZE. Module source is included to set those.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o trace_test tools/trace_test.c \
+ *       tools/host_sdk.c user/user_timer.c user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "driver/http.h"
+#include "host_sdk.h"
+
+#include "../user/user_trace.c"
+
+#define TEST_PAGE_SIZE			((TRACE_POINTS + TRACE_STAGES + 1) * TRACE_JSON_PART_SIZE)
+
+static char page[TEST_PAGE_SIZE];
+
+/******** test ********/
+
+//moves clock by iMs and traces a point there
+void _At(uint32 iMs, TRACE_POINT iPoint){
+	HostAdvance(iMs * 1000ULL);
+	TRACE(iPoint);
+}
+
+//a reading uploaded: dht read, connect, send, ack, iMs apart
+void _Upload(uint32 iDht, uint32 iConnect, uint32 iSend, uint32 iAck){
+	_At(0, TRACE_DHT_START);
+	_At(iDht, TRACE_DHT_END);
+	_At(0, TRACE_TCP_CONNECT);
+	_At(iConnect, TRACE_TCP_SEND);
+	_At(iSend, TRACE_TCP_SENT);
+	HostAdvance(iAck * 1000ULL);
+}
+
+//renders whole JSON in iSize buffers, checks every part fits and returns length
+uint32 _Render(uint16 iSize){
+	uint32 length = 0;
+	uint16 cursor = 0, part;
+	do{
+		char *buffer = malloc(iSize);
+		part = GetTraceJSON(buffer, iSize, &cursor);
+		HOST_CHECK(part < iSize && length + part < TEST_PAGE_SIZE);
+		memcpy(page + length, buffer, part);
+		length += part;
+		free(buffer);
+	} while(part > 0);
+	HOST_CHECK(cursor == TRACE_POINTS + TRACE_STAGES + 1);
+	page[length] = '\0';
+	return length;
+}
+
+//brackets balance outside strings and no element is empty
+bool _JSONShape(const char *iText){
+	char stack[8];
+	uint8 depth = 0;
+	bool inString = false;
+	char previous = '\0';
+	for(const char *c = iText; *c != '\0'; ++c){
+		if(inString){
+			if(*c == '"') inString = false;
+			continue;
+		}
+		if(*c == '"') inString = true;
+		else if(*c == '{' || *c == '['){
+			if(depth == sizeof(stack)) return false;
+			stack[depth++] = *c;
+		}
+		else if(*c == '}' || *c == ']'){
+			if(depth == 0 || stack[--depth] != (*c == '}' ? '{' : '[') || previous == ',') return false;
+		}
+		else if(*c == ',' && (previous == ',' || previous == '[' || previous == '{')) return false;
+		previous = *c;
+	}
+	return depth == 0 && !inString;
+}
+
+uint32 _Count(const char *iText, const char *iNeedle){
+	uint32 count = 0;
+	for(const char *c = strstr(iText, iNeedle); c != NULL; c = strstr(c + 1, iNeedle)) ++count;
+	return count;
+}
+
+int main(void){
+	InitTrace();
+
+	//boot: associate and first upload are once-stages, dhcp and verify are not
+	_At(300, TRACE_USER_INIT);
+	_At(2000, TRACE_WIFI_CONNECTED);
+	_At(600, TRACE_WIFI_GOT_IP);
+	_At(100, TRACE_LINK_VERIFIED);
+	_Upload(4, 50, 65, 0);
+	_At(10000, TRACE_WIFI_CONNECTED);
+	_At(700, TRACE_WIFI_GOT_IP);
+	_At(100, TRACE_LINK_VERIFIED);
+	_Upload(5, 60, 70, 0);
+	TraceReport();
+
+	TRACE_HISTOGRAM *h = histograms;
+	HOST_CHECK(h[TRACE_STAGE_ASSOCIATE].count == 1 && h[TRACE_STAGE_ASSOCIATE].sum == 2000);
+	HOST_CHECK(h[TRACE_STAGE_DHCP].count == 2 && h[TRACE_STAGE_DHCP].min == 600 && h[TRACE_STAGE_DHCP].max == 700);
+	HOST_CHECK(h[TRACE_STAGE_VERIFY].count == 2 && h[TRACE_STAGE_VERIFY].sum == 200);
+	HOST_CHECK(h[TRACE_STAGE_DHT_READ].count == 2 && h[TRACE_STAGE_DHT_READ].sum == 9);
+	HOST_CHECK(h[TRACE_STAGE_TCP_CONNECT].count == 2 && h[TRACE_STAGE_TCP_CONNECT].sum == 110);
+	HOST_CHECK(h[TRACE_STAGE_TCP_ACK].count == 2 && h[TRACE_STAGE_TCP_ACK].sum == 135);
+	//dht end ends dht read and starts upload
+	HOST_CHECK(h[TRACE_STAGE_UPLOAD].count == 2 && h[TRACE_STAGE_UPLOAD].min == 115 && h[TRACE_STAGE_UPLOAD].max == 130);
+	HOST_CHECK(h[TRACE_STAGE_FIRST_UPLOAD].count == 1 && h[TRACE_STAGE_FIRST_UPLOAD].sum == 2000 + 600 + 100 + 4 + 50 + 65);
+	HOST_CHECK(pointCounts[TRACE_DHT_START] == 2 && pointCounts[TRACE_USER_INIT] == 1);
+
+	//latest start wins, an end without start is not paired
+	_At(1000, TRACE_DHT_START);
+	_At(1000, TRACE_DHT_START);
+	_At(3, TRACE_DHT_END);
+	_At(10, TRACE_DHT_END);
+	TraceReport();
+	HOST_CHECK(h[TRACE_STAGE_DHT_READ].count == 3 && h[TRACE_STAGE_DHT_READ].max == 5 && h[TRACE_STAGE_DHT_READ].min == 3);
+
+	//bucket bounds are inclusive, 4x from 1 ms, last is +Inf
+	static const uint32 latencies[] = {0, 1, 2, 4, 5, 16, 17, 65536, 65537, 3000000};
+	static const uint8 buckets[] = {0, 0, 1, 1, 2, 2, 3, 8, 9, 9};
+	for(uint8 i = 0; i < sizeof(latencies) / sizeof(latencies[0]); ++i){
+		uint32 before[TRACE_BUCKETS];
+		memcpy(before, h[TRACE_STAGE_TCP_ACK].buckets, sizeof(before));
+		_At(1, TRACE_TCP_SEND);
+		_At(latencies[i], TRACE_TCP_SENT);
+		TraceReport();
+		for(uint8 b = 0; b < TRACE_BUCKETS; ++b)
+			HOST_CHECK(h[TRACE_STAGE_TCP_ACK].buckets[b] == before[b] + (b == buckets[i]));
+	}
+
+	//latency across system_get_time wrap, clock starts close to it
+	HostAdvance(0x100000000ULL - hostTimeUs - 500);
+	_At(0, TRACE_TCP_CONNECT);
+	_At(2, TRACE_TCP_SEND);
+	HOST_CHECK(hostTimeUs < 2000);
+	TraceReport();
+	HOST_CHECK(h[TRACE_STAGE_TCP_CONNECT].count == 3 && h[TRACE_STAGE_TCP_CONNECT].min == 2);
+
+	//drain timer keeps ring empty
+	for(uint8 i = 0; i < 3 * TRACE_RING; ++i) _At(TRACE_DRAIN_INTERVAL * 1000 / (TRACE_RING - 1), TRACE_DHT_START);
+	HOST_CHECK(traceLost == 0);
+	HostAdvance(TRACE_DRAIN_INTERVAL * 1000000ULL);
+	HOST_CHECK(traceTail == traceHead);
+
+	//overflow between drains: lost points counted, newest TRACE_RING kept
+	uint32 starts = pointCounts[TRACE_DHT_START];
+	for(uint8 i = 0; i < TRACE_RING + 10; ++i) TRACE(TRACE_DHT_START);
+	TraceReport();
+	HOST_CHECK(traceLost == 10 && pointCounts[TRACE_DHT_START] == starts + TRACE_RING);
+
+	//JSON: header, a part per point and stage, same in any buffer size
+	uint32 length = _Render(TRACE_JSON_PART_SIZE);
+	HOST_CHECK(_JSONShape(page) && strncmp(page, "{\"lost\":10,", 11) == 0);
+	HOST_CHECK(_Count(page, "{\"point\":") == TRACE_POINTS && _Count(page, "{\"stage\":") == TRACE_STAGES);
+	HOST_CHECK(strstr(page, "{\"stage\":\"first_upload\",\"from\":\"user_init\",\"to\":\"tcp_sent\",\"count\":1,") != NULL);
+	char copy[TEST_PAGE_SIZE];
+	memcpy(copy, page, length + 1);
+	HOST_CHECK(_Render(HTTP_CHUNK_SIZE) == length && strcmp(copy, page) == 0);
+
+	//largest values: every part fits TRACE_JSON_PART_SIZE
+	traceLost = 4000000000u;
+	for(uint8 i = 0; i < TRACE_POINTS; ++i){
+		pointCounts[i] = 4000000000u;
+		pointFirst[i] = 4000000000u;
+	}
+	for(uint8 i = 0; i < TRACE_STAGES; ++i){
+		h[i].count = h[i].sum = h[i].min = h[i].max = 4000000000u;
+		for(uint8 b = 0; b < TRACE_BUCKETS; ++b) h[i].buckets[b] = 4000000000u;
+	}
+	traceTail = traceHead;
+	length = _Render(TRACE_JSON_PART_SIZE);
+	HOST_CHECK(_JSONShape(page));
+	printf("JSON at largest values: %u bytes\n", length);
+
+	return HostResult("trace_test");
+}
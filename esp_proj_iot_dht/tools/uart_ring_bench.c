@@ -0,0 +1,386 @@
+/*
+ * uart_ring_bench.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host benchmark of uart tx/rx buffers: the SPSC ring of driver/uart_ring.h against the
+ * pointer and Space counter buffer driver/uart.c used before (copied below as old_*).
+ *
+ * Both run the same deterministic schedule, uart fifo registers are volatile bytes:
+ *   tx     log lines of 8-120 bytes are queued, a tx fifo (128 bytes) is drained every
+ *          line, oldest lines are dropped when the 2048 byte buffer is full
+ *   tx-full  same with a fifo drained every 4th line, so most lines go through dropping
+ *   rx     rx fifo batches of 1-128 bytes are moved into the 256 byte buffer and read
+ *          out 32 bytes at a time, as the console does
+ * Output checksums and drop counts of both must match. Then the ring is run with
+ * producer and consumer on two threads and every byte is checked. Exits non-zero if either fails.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), `make hosttest` runs it on 4 MB:
+ *   gcc -O2 -DICACHE_FLASH -I include -I $SDK_PATH/include -o uart_ring_bench \
+ *       tools/uart_ring_bench.c -lpthread
+ *
+ * usage: uart_ring_bench [megabytes per run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "c_types.h"
+#include "osapi.h"
+#include "driver/uart_ring.h"
+
+#define BENCH_TX_SIZE		2048		//UART_TX_BUFFER_SIZE
+#define BENCH_RX_SIZE		256			//UART_RX_BUFFER_SIZE
+#define BENCH_FIFO_LEN		128			//UART_FIFO_LEN
+#define BENCH_DEQ_SIZE		32			//CONSOLE_DEQ_SIZE
+#define BENCH_LINES			4096		//pregenerated log lines
+
+//SDK rom functions os_memcpy maps to
+void *ets_memcpy(void *dest, const void *src, size_t n){ return memcpy(dest, src, n); }
+void *ets_memset(void *s, int c, size_t n){ return memset(s, c, n); }
+
+//uart fifo registers
+static volatile uint8_t txFifo;
+static volatile uint8_t rxFifo;
+
+static char lines[BENCH_LINES][128];
+static uint8_t lineLengths[BENCH_LINES];
+static uint8_t rxBatches[BENCH_LINES];
+
+/******** old buffer, as driver/uart.c had it ********/
+
+struct OldUartBuffer {
+	uint32_t UartBuffSize;
+	uint8_t *pUartBuff;
+	uint8_t *pInPos;
+	uint8_t *pOutPos;
+	uint16_t Space;
+};
+
+static uint32_t oldDropped;
+
+static void old_init(struct OldUartBuffer *pBuff, uint32_t size){
+	pBuff->UartBuffSize = size;
+	pBuff->pUartBuff = malloc(size);
+	pBuff->pInPos = pBuff->pUartBuff;
+	pBuff->pOutPos = pBuff->pUartBuff;
+	pBuff->Space = size;
+}
+
+static void old_buf_cpy(struct OldUartBuffer *pCur, char *pdata, uint16_t data_len){
+	if(data_len == 0) return;
+	uint16_t tail_len = pCur->pUartBuff + pCur->UartBuffSize - pCur->pInPos;
+	if(tail_len >= data_len){
+		os_memcpy(pCur->pInPos, pdata, data_len);
+		pCur->pInPos += (data_len);
+		pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
+		pCur->Space -= data_len;
+	}
+	else{
+		os_memcpy(pCur->pInPos, pdata, tail_len);
+		pCur->pInPos += (tail_len);
+		pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
+		pCur->Space -= tail_len;
+		os_memcpy(pCur->pInPos, pdata + tail_len, data_len - tail_len);
+		pCur->pInPos += (data_len - tail_len);
+		pCur->pInPos = (pCur->pUartBuff + (pCur->pInPos - pCur->pUartBuff) % pCur->UartBuffSize);
+		pCur->Space -= (data_len - tail_len);
+	}
+}
+
+static void old_drop_oldest(struct OldUartBuffer *pTxBuff, uint16_t data_len){
+	uint8_t data;
+	while(pTxBuff->Space < data_len && pTxBuff->Space < pTxBuff->UartBuffSize){
+		do{
+			data = *(pTxBuff->pOutPos++);
+			if(pTxBuff->pOutPos == (pTxBuff->pUartBuff + pTxBuff->UartBuffSize)) pTxBuff->pOutPos = pTxBuff->pUartBuff;
+			pTxBuff->Space++;
+		} while(data != '\n' && pTxBuff->Space < pTxBuff->UartBuffSize);
+		oldDropped++;
+	}
+}
+
+static void old_tx_enq(struct OldUartBuffer *pTxBuffer, char *pdata, uint16_t data_len){
+	if(data_len > pTxBuffer->UartBuffSize) oldDropped++;
+	else{
+		if(data_len > pTxBuffer->Space) old_drop_oldest(pTxBuffer, data_len);
+		old_buf_cpy(pTxBuffer, pdata, data_len);
+	}
+}
+
+static void old_tx_fifo_insert(struct OldUartBuffer *pTxBuff, uint8_t data_len){
+	for(uint8_t i = 0; i < data_len; i++){
+		txFifo = *(pTxBuff->pOutPos++);
+		if(pTxBuff->pOutPos == (pTxBuff->pUartBuff + pTxBuff->UartBuffSize)) pTxBuff->pOutPos = pTxBuff->pUartBuff;
+	}
+	pTxBuff->pOutPos = (pTxBuff->pUartBuff + (pTxBuff->pOutPos - pTxBuff->pUartBuff) % pTxBuff->UartBuffSize);
+	pTxBuff->Space += data_len;
+}
+
+static void old_tx_start(struct OldUartBuffer *pTxBuffer){
+	uint16_t data_len = (pTxBuffer->UartBuffSize - pTxBuffer->Space);
+	old_tx_fifo_insert(pTxBuffer, data_len > BENCH_FIFO_LEN ? BENCH_FIFO_LEN : data_len);
+}
+
+static uint16_t old_rx_deq(struct OldUartBuffer *pRxBuffer, char *pdata, uint16_t data_len){
+	uint16_t buf_len = (pRxBuffer->UartBuffSize - pRxBuffer->Space);
+	uint16_t tail_len = pRxBuffer->pUartBuff + pRxBuffer->UartBuffSize - pRxBuffer->pOutPos;
+	uint16_t len_tmp = ((data_len > buf_len) ? buf_len : data_len);
+
+	if(pRxBuffer->pOutPos <= pRxBuffer->pInPos){
+		os_memcpy(pdata, pRxBuffer->pOutPos, len_tmp);
+		pRxBuffer->pOutPos += len_tmp;
+		pRxBuffer->Space += len_tmp;
+	}
+	else if(len_tmp > tail_len){
+		os_memcpy(pdata, pRxBuffer->pOutPos, tail_len);
+		pRxBuffer->pOutPos += tail_len;
+		pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
+		pRxBuffer->Space += tail_len;
+		os_memcpy(pdata + tail_len, pRxBuffer->pOutPos, len_tmp - tail_len);
+		pRxBuffer->pOutPos += (len_tmp - tail_len);
+		pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
+		pRxBuffer->Space += (len_tmp - tail_len);
+	}
+	else{
+		os_memcpy(pdata, pRxBuffer->pOutPos, len_tmp);
+		pRxBuffer->pOutPos += len_tmp;
+		pRxBuffer->pOutPos = (pRxBuffer->pUartBuff + (pRxBuffer->pOutPos - pRxBuffer->pUartBuff) % pRxBuffer->UartBuffSize);
+		pRxBuffer->Space += len_tmp;
+	}
+	return len_tmp;
+}
+
+static void old_rx_enq(struct OldUartBuffer *pRxBuffer, uint8_t fifo_len){
+	if(fifo_len >= pRxBuffer->Space) return;		//"buf full!!!", left in fifo
+	for(uint8_t i = 0; i < fifo_len; i++){
+		*(pRxBuffer->pInPos++) = rxFifo;
+		if(pRxBuffer->pInPos == (pRxBuffer->pUartBuff + pRxBuffer->UartBuffSize)) pRxBuffer->pInPos = pRxBuffer->pUartBuff;
+	}
+	pRxBuffer->Space -= fifo_len;
+}
+
+/******** new ring, driver/uart.c functions on driver/uart_ring.h ********/
+
+static uint32_t newDropped;
+
+static void new_init(struct UartBuffer *pBuff, uint32_t size){
+	pBuff->UartBuffSize = size;
+	pBuff->pUartBuff = malloc(size);
+	pBuff->Head = 0;
+	pBuff->Tail = 0;
+}
+
+static void new_drop_oldest(struct UartBuffer *pTxBuff, uint16_t data_len){
+	uint32_t tail = pTxBuff->Tail;
+	uint32_t head = pTxBuff->Head;
+	uint32_t mask = pTxBuff->UartBuffSize - 1;
+	while(pTxBuff->UartBuffSize - (head - tail) < data_len && tail != head){
+		while(tail != head && pTxBuff->pUartBuff[tail++ & mask] != '\n');
+		newDropped++;
+	}
+	uart_ring_consume(pTxBuff, tail - pTxBuff->Tail);
+}
+
+static void new_tx_enq(struct UartBuffer *pTxBuffer, char *pdata, uint16_t data_len){
+	if(data_len > pTxBuffer->UartBuffSize) newDropped++;
+	else{
+		if(data_len > uart_ring_free(pTxBuffer)) new_drop_oldest(pTxBuffer, data_len);
+		uart_ring_write(pTxBuffer, (uint8_t *)pdata, data_len);
+	}
+}
+
+static void new_tx_fifo_insert(struct UartBuffer *pTxBuff, uint8_t data_len){
+	uint32_t run, done = 0;
+	while(done < data_len){
+		uint8_t *pos = uart_ring_read_ptr(pTxBuff, &run);
+		if(run > data_len - done) run = data_len - done;
+		for(uint32_t i = 0; i < run; i++) txFifo = pos[i];
+		uart_ring_consume(pTxBuff, run);
+		done += run;
+	}
+}
+
+static void new_tx_start(struct UartBuffer *pTxBuffer){
+	uint32_t data_len = uart_ring_used(pTxBuffer);
+	new_tx_fifo_insert(pTxBuffer, data_len > BENCH_FIFO_LEN ? BENCH_FIFO_LEN : data_len);
+}
+
+static void new_rx_enq(struct UartBuffer *pRxBuffer, uint8_t fifo_len){
+	uint32_t run;
+	//old buffer leaves a whole batch in fifo unless it fits, do the same so outputs compare
+	if(fifo_len >= uart_ring_free(pRxBuffer)) return;
+	while(fifo_len > 0){
+		uint8_t *pos = uart_ring_write_ptr(pRxBuffer, &run);
+		if(run > fifo_len) run = fifo_len;
+		for(uint32_t i = 0; i < run; i++) pos[i] = rxFifo;
+		uart_ring_commit(pRxBuffer, run);
+		fifo_len -= run;
+	}
+}
+
+/******** schedules ********/
+
+static double _Now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void _Sum(uint32_t *ioSum, const char *iData, uint16_t iLength){
+	for(uint16_t i = 0; i < iLength; ++i) *ioSum = (*ioSum ^ (uint8_t)iData[i]) * 16777619u;
+}
+
+//bytes queued per run, tx fifo drained every iDrainEvery lines
+static double _RunTx(bool iNew, uint64_t iBytes, uint32_t iDrainEvery, uint32_t *oSum){
+	struct OldUartBuffer old;
+	struct UartBuffer ring;
+	old_init(&old, BENCH_TX_SIZE);
+	new_init(&ring, BENCH_TX_SIZE);
+	uint32_t sum = 2166136261u;
+
+	double start = _Now();
+	uint64_t queued = 0;
+	for(uint32_t n = 0; queued < iBytes; ++n){
+		uint32_t i = n % BENCH_LINES;
+		if(iNew) new_tx_enq(&ring, lines[i], lineLengths[i]);
+		else old_tx_enq(&old, lines[i], lineLengths[i]);
+		queued += lineLengths[i];
+
+		if(n % iDrainEvery == 0){
+			//tx fifo register is a sink, checksum what a drain would send
+			if(iNew){
+				uint32_t run, used = uart_ring_used(&ring);
+				if(used > BENCH_FIFO_LEN) used = BENCH_FIFO_LEN;
+				uint8_t *pos = uart_ring_read_ptr(&ring, &run);
+				_Sum(&sum, (char *)pos, run < used ? run : used);
+				if(run < used) _Sum(&sum, (char *)ring.pUartBuff, used - run);
+				new_tx_start(&ring);
+			}
+			else{
+				uint16_t used = old.UartBuffSize - old.Space;
+				if(used > BENCH_FIFO_LEN) used = BENCH_FIFO_LEN;
+				uint16_t run = old.pUartBuff + old.UartBuffSize - old.pOutPos;
+				_Sum(&sum, (char *)old.pOutPos, run < used ? run : used);
+				if(run < used) _Sum(&sum, (char *)old.pUartBuff, used - run);
+				old_tx_start(&old);
+			}
+		}
+	}
+	double elapsed = _Now() - start;
+
+	free(old.pUartBuff);
+	free(ring.pUartBuff);
+	*oSum = sum;
+	return elapsed;
+}
+
+static double _RunRx(bool iNew, uint64_t iBytes, uint32_t *oSum){
+	struct OldUartBuffer old;
+	struct UartBuffer ring;
+	old_init(&old, BENCH_RX_SIZE);
+	new_init(&ring, BENCH_RX_SIZE);
+	uint32_t sum = 2166136261u;
+	char data[BENCH_DEQ_SIZE];
+
+	double start = _Now();
+	uint64_t moved = 0;
+	for(uint32_t n = 0; moved < iBytes; ++n){
+		uint8_t batch = rxBatches[n % BENCH_LINES];
+		if(iNew) new_rx_enq(&ring, batch);
+		else old_rx_enq(&old, batch);
+
+		uint16_t length;
+		while((length = iNew ? uart_ring_read(&ring, (uint8_t *)data, sizeof(data)) : old_rx_deq(&old, data, sizeof(data))) > 0){
+			_Sum(&sum, data, length);
+			moved += length;
+		}
+	}
+	double elapsed = _Now() - start;
+
+	free(old.pUartBuff);
+	free(ring.pUartBuff);
+	*oSum = sum;
+	return elapsed;
+}
+
+/******** two thread check of the ring ********/
+
+static struct UartBuffer threadRing;
+static uint64_t threadBytes;
+
+static void *_Producer(void *arg){
+	uint64_t written = 0;
+	uint8_t chunk[BENCH_FIFO_LEN];
+	while(written < threadBytes){
+		//as much of next chunk as fits
+		uint32_t length = 1 + (written * 7919) % sizeof(chunk);
+		uint32_t room = uart_ring_free(&threadRing);
+		if(length > room) length = room;
+		if(length > threadBytes - written) length = threadBytes - written;
+		if(length == 0){
+			sched_yield();
+			continue;
+		}
+		for(uint32_t i = 0; i < length; ++i) chunk[i] = (uint8_t)((written + i) * 131);
+		uart_ring_write(&threadRing, chunk, length);
+		written += length;
+	}
+	return NULL;
+}
+
+static uint64_t _Consume(void){
+	uint64_t read = 0, errors = 0;
+	uint8_t chunk[BENCH_DEQ_SIZE + 7];
+	while(read < threadBytes){
+		uint32_t length = uart_ring_read(&threadRing, chunk, 1 + read % sizeof(chunk));
+		if(length == 0) sched_yield();
+		for(uint32_t i = 0; i < length; ++i) errors += chunk[i] != (uint8_t)((read + i) * 131);
+		read += length;
+	}
+	return errors;
+}
+
+int main(int argc, char **argv){
+	uint64_t bytes = (uint64_t)(argc > 1 ? atoi(argv[1]) : 64) << 20;
+
+	srand(1);
+	for(uint32_t i = 0; i < BENCH_LINES; ++i){
+		lineLengths[i] = 8 + rand() % 113;
+		for(uint8_t c = 0; c < lineLengths[i] - 1; ++c) lines[i][c] = ' ' + rand() % 95;
+		lines[i][lineLengths[i] - 1] = '\n';
+		rxBatches[i] = 1 + rand() % BENCH_FIFO_LEN;
+	}
+
+	int failed = 0;
+	const char *names[] = {"tx", "tx-full", "rx"};
+	printf("%-8s %12s %12s %8s  %s\n", "path", "old ns/B", "ring ns/B", "speedup", "outputs");
+	for(uint8_t path = 0; path < 3; ++path){
+		uint32_t oldSum = 0, newSum = 0;
+		oldDropped = newDropped = 0;
+		double oldTime = path < 2 ? _RunTx(false, bytes, path == 0 ? 1 : 4, &oldSum) : _RunRx(false, bytes, &oldSum);
+		double newTime = path < 2 ? _RunTx(true, bytes, path == 0 ? 1 : 4, &newSum) : _RunRx(true, bytes, &newSum);
+		bool same = (oldSum == newSum && oldDropped == newDropped);
+		failed |= !same;
+		printf("%-8s %12.3f %12.3f %7.2fx  %s (%u lines dropped)\n", names[path], oldTime * 1e9 / bytes, newTime * 1e9 / bytes,
+				oldTime / newTime, same ? "match" : "DIFFER", newDropped);
+	}
+
+	new_init(&threadRing, BENCH_RX_SIZE);
+	threadBytes = bytes;
+	pthread_t producer;
+	double start = _Now();
+	pthread_create(&producer, NULL, _Producer, NULL);
+	uint64_t errors = _Consume();
+	pthread_join(producer, NULL);
+	printf("two threads: %llu MB through %d byte ring in %.2f s, %llu bytes wrong\n",
+			(unsigned long long)(bytes >> 20), BENCH_RX_SIZE, _Now() - start, (unsigned long long)errors);
+	failed |= errors > 0;
+
+	return failed;
+}
@@ -0,0 +1,154 @@
+/*
+ * uart_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of the uart tx buffer (driver/uart.c) on a small ring: os_printf lines queued
+ * through putc1 while the tx fifo is drained now and then, a full ring drops its oldest
+ * whole lines (and counts each) so what comes out is always the newest lines, whole and
+ * in order. A message larger than the ring is dropped, not cut, and with no heap for the
+ * buffers tx and rx calls drop or return nothing instead of touching a NULL buffer.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o uart_test tools/uart_test.c \
+ *       tools/host_sdk.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "ets_sys.h"
+#include "osapi.h"
+#include "host_sdk.h"
+
+//uart registers are a table, fifo registers are the tx capture and an empty rx fifo
+#undef READ_PERI_REG
+#undef WRITE_PERI_REG
+#define READ_PERI_REG(addr)			_RegRead((uint32)(addr))
+#define WRITE_PERI_REG(addr, val)	_RegWrite((uint32)(addr), (uint32)(val))
+
+uint32 _RegRead(uint32 iAddr);
+void _RegWrite(uint32 iAddr, uint32 iValue);
+
+#include "../driver/uart.c"
+
+#define TEST_RING_SIZE			64
+#define TEST_STEPS				200000
+#define TEST_LINES				16			//lines queued between two drains at most
+#define TEST_LINE_MAX			(TEST_RING_SIZE / 2)
+
+static uint32 regs[2][64];
+static char tx[UART_TX_BUFFER_SIZE + 1];
+static uint32 txLength = 0;
+static uint32 freeHeap = 40000;
+
+/******** firmware stand-ins ********/
+
+UartDevice UartDev;
+
+uint32 system_get_free_heap_size(void){
+	return freeHeap;
+}
+
+void uart_div_modify(uint8 uart_no, uint32 DivLatchValue){}
+void ets_isr_attach(int i, void *func, void *arg){}
+void ets_isr_mask(uint32 mask){}
+void ets_isr_unmask(uint32 mask){}
+void ets_install_putc1(void *routine){}
+
+uint32 *_Reg(uint32 iAddr){
+	return &regs[(iAddr & 0xF00) != 0][(iAddr & 0xFF) / 4];
+}
+
+//tx fifo of uart0 is drained as soon as it is read, uart1 (DBG1) is discarded
+uint32 _RegRead(uint32 iAddr){
+	if(iAddr == UART_STATUS(UART0) || iAddr == UART_STATUS(UART1)) return 0;
+	return *_Reg(iAddr);
+}
+
+void _RegWrite(uint32 iAddr, uint32 iValue){
+	if(iAddr == UART_FIFO(UART0)){
+		HOST_CHECK(txLength < sizeof(tx) - 1);
+		if(txLength < sizeof(tx) - 1) tx[txLength++] = iValue;
+	}
+	else *_Reg(iAddr) = iValue;
+}
+
+/******** test ********/
+
+//as os_printf prints a line
+void _Print(const char *iLine){
+	for(const char *c = iLine; *c != '\0'; ++c) uart0_write_char_no_wait(*c);
+	uart0_write_char_no_wait('\n');
+}
+
+//what the tx fifo empty interrupt sends, null terminated
+const char *_Drain(void){
+	txLength = 0;
+	tx_start_uart_buffer(UART0);
+	tx[txLength] = '\0';
+	return tx;
+}
+
+bool _TxInterrupt(void){
+	return (*_Reg(UART_INT_ENA(UART0)) & UART_TXFIFO_EMPTY_INT_ENA) != 0;
+}
+
+int main(void){
+	char lines[TEST_LINES][TEST_LINE_MAX + 1], expected[TEST_LINES * (TEST_LINE_MAX + 2) + 1];
+	char data[TEST_RING_SIZE + 1];
+
+	//no heap for buffers: nothing queued or read, each message counted as dropped
+	freeHeap = 1000;
+	HOST_CHECK(Uart_Buf_Init(UART_TX_BUFFER_SIZE) == NULL);
+	_Print("lost");
+	HOST_CHECK(pTxBuffer == NULL && uart_tx_dropped() == 5 && tx_buff_free() == 0);
+	HOST_CHECK(rx_buff_deq(data, sizeof(data)) == 0 && *_Drain() == '\0');
+	Uart_rx_buff_enq();
+
+	//sizes must be powers of 2, a buffer is created at first print once there is heap
+	freeHeap = 40000;
+	HOST_CHECK(Uart_Buf_Init(TEST_RING_SIZE + 1) == NULL);
+	_Print("first");
+	HOST_CHECK(pTxBuffer != NULL && pTxBuffer->UartBuffSize == UART_TX_BUFFER_SIZE && _TxInterrupt());
+	HOST_CHECK(strcmp(_Drain(), "first\r\n") == 0 && uart_tx_dropped() == 5);
+	uart_buf_free(pTxBuffer);
+
+	//small ring: message larger than it is dropped whole, one that fits is kept
+	pTxBuffer = Uart_Buf_Init(TEST_RING_SIZE);
+	HOST_CHECK(pTxBuffer != NULL);
+	memset(data, 'x', sizeof(data));
+	tx_buff_enq(data, TEST_RING_SIZE + 1);
+	HOST_CHECK(uart_tx_dropped() == 6 && tx_buff_free() == TEST_RING_SIZE);
+	tx_buff_enq(data, TEST_RING_SIZE);
+	HOST_CHECK(tx_buff_free() == 0 && strlen(_Drain()) == TEST_RING_SIZE && uart_tx_dropped() == 6);
+
+	//a full ring drops oldest lines: a drain sends the newest lines queued since the last one
+	uint32 queued = 0, sent = 0, dropped = uart_tx_dropped();
+	for(uint32 step = 0; step < TEST_STEPS; ++step){
+		uint8 count = 1 + rand() % TEST_LINES;
+		for(uint8 i = 0; i < count; ++i){
+			uint8 length = rand() % (TEST_LINE_MAX - 1);
+			for(uint8 c = 0; c < length; ++c) lines[i][c] = 'a' + (queued + c) % 26;
+			lines[i][length] = '\0';
+			_Print(lines[i]);
+			++queued;
+		}
+
+		//longest suffix of the lines that fits the ring
+		uint8 first = count, used = 0;
+		while(first > 0 && used + strlen(lines[first - 1]) + 2 <= TEST_RING_SIZE) used += strlen(lines[--first]) + 2;
+		expected[0] = '\0';
+		for(uint8 i = first; i < count; ++i) strcat(strcat(expected, lines[i]), "\r\n");
+
+		HOST_CHECK(strcmp(_Drain(), expected) == 0 && tx_buff_free() == TEST_RING_SIZE);
+		HOST_CHECK(uart_tx_dropped() - dropped == first);
+		sent += count - first;
+		dropped = uart_tx_dropped();
+	}
+	printf("%u lines queued, %u sent, %u dropped\n", queued, sent, queued - sent);
+	HOST_CHECK(sent > 0 && sent < queued);
+
+	return HostResult("uart_test");
+}
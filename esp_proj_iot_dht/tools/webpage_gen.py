@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""
+webpage_gen.py
+
+Generates user/user_webpage_assets.c from the web page sources in webpage/.
+
+Each source is minified, gzip compressed and emitted as a pair of flash
+resident (ICACHE_RODATA_ATTR) byte arrays together with their lengths and a
+precomputed ETag hash, wrapped in a WEB_ASSET (see include/user_webpage.h).
+
+The sources are also combined into a single document bundle (styles and
+scripts inlined) served at "/" in WEBPAGE_BUNDLED mode. The scanned AP data is
+only known at send time and goes at the end of the bundle, so the bundle is
+emitted as a WEB_BUNDLE: the static part, and a gzip prefix holding the gzip
+header and the static part deflated with a sync flush. The device appends the
+dynamic tail as a final stored deflate block, followed by the gzip trailer
+(CRC32 continued from the prefix CRC, and total length).
+
+usage: webpage_gen.py <webpage dir> <output .c file>
+"""
+
+import gzip
+import os
+import re
+import struct
+import sys
+import zlib
+
+# source file, C symbol, content type (CONTENT_TYPE in include/driver/http.h)
+ASSETS = (
+    ("index.html", "WIFI_AP_HTML", "text_html"),
+    ("styles.css", "WIFI_AP_CSS", "text_css"),
+    ("script.js", "WIFI_AP_JS", "application_javascript"),
+)
+
+# (pattern in minified index.html, replacement) used to inline the assets into
+# the bundle; "%s" is replaced with the minified asset
+BUNDLE_INLINE = (
+    (r'<link rel="stylesheet" href="\./styles\.css">', "styles.css", "<style>%s</style>"),
+    (r'<script src="\./script\.js"></script>', "script.js", "<script>%s</script>"),
+)
+
+# gzip header: no flags, mtime 0, max compression, unknown OS (as gzip.compress)
+GZIP_HEADER = b"\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\xff"
+
+IDENT = re.compile(r"[A-Za-z0-9_$]")
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    text = re.sub(r">\s+<", "><", text)
+    text = re.sub(r"\s+", " ", text)
+    return text.strip()
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};:,>])\s*", r"\1", text)
+    text = text.replace(";}", "}")
+    return text.strip()
+
+
+def minify_js(text):
+    """Conservative minifier: drops comments and redundant whitespace, never
+    renames anything and keeps a newline wherever automatic semicolon insertion
+    could depend on it."""
+    out = []
+    i, n = 0, len(text)
+    while i < n:
+        c = text[i]
+        if c in "'\"`":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            out.append(text[i:j + 1])
+            i = j + 1
+        elif text.startswith("//", i):
+            while i < n and text[i] != "\n":
+                i += 1
+        elif text.startswith("/*", i):
+            i = text.index("*/", i) + 2
+        elif c.isspace():
+            j = i
+            while j < n and text[j].isspace():
+                j += 1
+            newline = "\n" in text[i:j]
+            prev = out[-1][-1] if out else ""
+            nxt = text[j] if j < n else ""
+            if not prev or not nxt:
+                pass
+            elif newline and prev not in "{;,(" and nxt not in "})":
+                out.append("\n")
+            elif IDENT.match(prev) and IDENT.match(nxt):
+                out.append(" ")
+            i = j
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out).strip()
+
+
+MINIFIERS = {".html": minify_html, ".css": minify_css, ".js": minify_js}
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def c_array(name, data):
+    lines = ["static const uint8 %s[] ICACHE_RODATA_ATTR STORE_ATTR = {" % name]
+    for i in range(0, len(data), 16):
+        lines.append("\t" + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def make_bundle(minified):
+    """Inlines the assets into index.html and returns (static part, gzip prefix)."""
+    html = minified["index.html"].decode("utf-8")
+    for pattern, source, template in BUNDLE_INLINE:
+        inline = minified[source].decode("utf-8")
+        if re.search(r"</(style|script)", inline, re.I):
+            raise ValueError("%s cannot be inlined" % source)
+        inline = template % inline
+        html, count = re.subn(pattern, lambda m: inline, html)
+        if count != 1:
+            raise ValueError("index.html does not reference %s as expected" % pattern)
+    static = html.encode("utf-8")
+
+    deflate = zlib.compressobj(9, zlib.DEFLATED, -15, 9)
+    prefix = GZIP_HEADER + deflate.compress(static) + deflate.flush(zlib.Z_SYNC_FLUSH)
+    return static, prefix
+
+
+def check_bundle(static, prefix):
+    """Completes the bundle the way the device does and makes sure it inflates."""
+    tail = b'<script>var AP=[{"ssid":"test","rssi":-60,"channel":6,"authmode":3}];</script>'
+    stream = (prefix + struct.pack("<BHH", 1, len(tail), len(tail) ^ 0xFFFF) + tail
+              + struct.pack("<II", zlib.crc32(tail, zlib.crc32(static)) & 0xFFFFFFFF,
+                            len(static) + len(tail)))
+    if gzip.decompress(stream) != static + tail:
+        raise ValueError("bundle does not inflate to its source")
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+    src_dir, out_file = argv[1], argv[2]
+
+    body = []
+    minified_assets = {}
+    total_raw = total_gz = 0
+    for filename, symbol, content_type in ASSETS:
+        with open(os.path.join(src_dir, filename), encoding="utf-8") as f:
+            raw = f.read()
+        minified = MINIFIERS[os.path.splitext(filename)[1]](raw).encode("utf-8")
+        minified_assets[filename] = minified
+        # mtime=0 keeps the output reproducible
+        compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+        if len(minified) > 0xFFFF or len(compressed) > 0xFFFF:
+            sys.stderr.write("%s is too large for a WEB_ASSET\n" % filename)
+            return 1
+
+        total_raw += len(raw.encode("utf-8"))
+        total_gz += len(compressed)
+        print("webpage_gen: %-12s %5d -> %5d minified -> %5d gzip"
+              % (filename, len(raw.encode("utf-8")), len(minified), len(compressed)))
+
+        lower = symbol.lower()
+        body.append("/%s %s %s/" % ("*" * 30, filename, "*" * 30))
+        body.append("")
+        body.append(c_array(lower, minified))
+        body.append("")
+        body.append(c_array(lower + "_gz", compressed))
+        body.append("")
+        body.append("const WEB_ASSET %s = {" % symbol)
+        body.append("\t%s, %d," % (lower, len(minified)))
+        body.append("\t%s_gz, %d," % (lower, len(compressed)))
+        body.append("\t0x%08x," % fnv1a(minified))
+        body.append("\t%s" % content_type)
+        body.append("};")
+        body.append("")
+
+    print("webpage_gen: total %d -> %d bytes (%.1fx)"
+          % (total_raw, total_gz, float(total_raw) / total_gz))
+
+    try:
+        static, prefix = make_bundle(minified_assets)
+        check_bundle(static, prefix)
+    except ValueError as e:
+        sys.stderr.write("webpage_gen: %s\n" % e)
+        return 1
+    print("webpage_gen: %-12s %5d bytes -> %5d gzip prefix"
+          % ("bundle", len(static), len(prefix)))
+
+    body.append("/%s %s %s/" % ("*" * 30, "bundle", "*" * 30))
+    body.append("")
+    body.append(c_array("wifi_ap_bundle", static))
+    body.append("")
+    body.append(c_array("wifi_ap_bundle_gz", prefix))
+    body.append("")
+    body.append("const WEB_BUNDLE WIFI_AP_BUNDLE = {")
+    body.append("\twifi_ap_bundle, %d," % len(static))
+    body.append("\twifi_ap_bundle_gz, %d," % len(prefix))
+    body.append("\t0x%08x," % (zlib.crc32(static) & 0xFFFFFFFF))
+    body.append("\t0x%08x" % fnv1a(static))
+    body.append("};")
+    body.append("")
+
+    header = [
+        "/*",
+        " * %s" % os.path.basename(out_file),
+        " *",
+        " *  Generated by tools/webpage_gen.py from webpage/, do not edit.",
+        " */",
+        "",
+        '#include "user_webpage.h"',
+        "",
+    ]
+    with open(out_file, "w", newline="\n") as f:
+        f.write("\n".join(header + body))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
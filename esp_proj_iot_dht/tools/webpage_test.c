@@ -0,0 +1,287 @@
+/*
+ * webpage_test.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Host test of scan results JSON (api/scan and the bundle tail, user/user_webpage.c):
+ * ssids with quotes, backslashes, '<', control bytes, UTF-8 and bytes that are not UTF-8
+ * (stray, cut, overlong, surrogate sequences), also random ones, must render as a JSON
+ * document a strict parser (UTF-8 only, no raw control bytes) reads back to the ssid: its
+ * code points if it is UTF-8, else its bytes as latin-1. No raw '<' may be in it, measuring
+ * agrees with rendering and a smaller buffer gets a cut copy.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), or `make hosttest`:
+ *   gcc -DICACHE_FLASH -I include -I $SDK_PATH/include -o webpage_test tools/webpage_test.c \
+ *       tools/host_sdk.c user/user_webpage.c user/user_webpage_assets.c driver/http.c \
+ *       user/user_log.c
+ */
+
+#include <string.h>
+
+#include "c_types.h"
+#include "espconn.h"
+#include "driver/rodata.h"
+#include "user_webpage.h"
+#include "user_wifi.h"
+#include "host_sdk.h"
+
+#define TEST_STEPS				20000
+#define TEST_JSON_SIZE			4096
+
+static AP_Info aps[SCAN_LIST];
+
+/******** firmware stand-ins ********/
+
+//rest of driver/http.c links against it, JSON is rendered into buffers here
+sint8 espconn_send(struct espconn *espconn, uint8 *psent, uint16 length){
+	return ESPCONN_OK;
+}
+
+//driver/rodata.c reads flash with word loads at 32 bit addresses, assets are in RAM here
+uint8 rodata_read_byte(const void *iAddr){
+	return *(const uint8*) iAddr;
+}
+
+void rodata_memcpy(void *oDest, const void *iSrc, uint16 iLength){
+	memcpy(oDest, iSrc, iLength);
+}
+
+/******** test ********/
+
+//strict UTF-8 sequence: its length and code point, 0 if cut, overlong, surrogate or past U+10FFFF
+uint8 _UTF8(const uint8 *iData, uint32 iLength, uint32 *oCode){
+	uint8 length;
+	uint32 code, min;
+	if(iData[0] < 0x80){
+		*oCode = iData[0];
+		return 1;
+	}
+	else if((iData[0] & 0xE0) == 0xC0){ length = 2; code = iData[0] & 0x1F; min = 0x80; }
+	else if((iData[0] & 0xF0) == 0xE0){ length = 3; code = iData[0] & 0x0F; min = 0x800; }
+	else if((iData[0] & 0xF8) == 0xF0){ length = 4; code = iData[0] & 0x07; min = 0x10000; }
+	else return 0;
+
+	if(iLength < length) return 0;
+	for(uint8 i = 1; i < length; ++i){
+		if((iData[i] & 0xC0) != 0x80) return 0;
+		code = code << 6 | (iData[i] & 0x3F);
+	}
+	if(code < min || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return 0;
+	*oCode = code;
+	return length;
+}
+
+//code points a client must read for an ssid
+uint8 _Expected(const uint8 *iSsid, uint8 iLength, uint32 *oCodes){
+	uint8 count = 0;
+	for(uint8 i = 0, length; i < iLength; i += length){
+		length = _UTF8(iSsid + i, iLength - i, &oCodes[count++]);
+		if(length == 0) break;
+		if(i + length == iLength) return count;
+	}
+	for(uint8 i = 0; i < iLength; ++i) oCodes[i] = iSsid[i];
+	return iLength;
+}
+
+bool _Literal(const char *iJSON, uint32 iLength, uint32 *ioPos, const char *iLiteral){
+	uint32 length = strlen(iLiteral);
+	if(*ioPos + length > iLength || memcmp(iJSON + *ioPos, iLiteral, length) != 0) return false;
+	*ioPos += length;
+	return true;
+}
+
+bool _Integer(const char *iJSON, uint32 iLength, uint32 *ioPos, int *oValue){
+	bool negative = *ioPos < iLength && iJSON[*ioPos] == '-';
+	uint32 start = *ioPos += negative;
+	*oValue = 0;
+	while(*ioPos < iLength && iJSON[*ioPos] >= '0' && iJSON[*ioPos] <= '9') *oValue = *oValue * 10 + iJSON[(*ioPos)++] - '0';
+	if(negative) *oValue = -*oValue;
+	return *ioPos > start && (iJSON[start] != '0' || *ioPos == start + 1);
+}
+
+uint32 _Hex4(const char *iJSON, uint32 iLength, uint32 *ioPos){
+	uint32 value = 0;
+	for(uint8 i = 0; i < 4; ++i, ++*ioPos){
+		char c = *ioPos < iLength ? iJSON[*ioPos] : 'x';
+		if(c >= '0' && c <= '9') value = value << 4 | (c - '0');
+		else if(c >= 'a' && c <= 'f') value = value << 4 | (c - 'a' + 10);
+		else if(c >= 'A' && c <= 'F') value = value << 4 | (c - 'A' + 10);
+		else return UINT32_MAX;
+	}
+	return value;
+}
+
+//JSON string as a strict parser reads it, into code points
+bool _String(const char *iJSON, uint32 iLength, uint32 *ioPos, uint32 *oCodes, uint8 *oCount){
+	static const char escapes[] = "\"\"\\\\//b\bf\fn\nr\rt\t";
+	const uint8 *json = (const uint8*) iJSON;
+	*oCount = 0;
+	if(!_Literal(iJSON, iLength, ioPos, "\"")) return false;
+
+	while(*ioPos < iLength && json[*ioPos] != '"'){
+		uint32 code;
+		if(json[*ioPos] < 0x20) return false;
+		if(json[*ioPos] == '\\'){
+			if(++*ioPos >= iLength) return false;
+			if(json[*ioPos] == 'u'){
+				++*ioPos;
+				code = _Hex4(iJSON, iLength, ioPos);
+				if(code == UINT32_MAX || (code >= 0xDC00 && code <= 0xDFFF)) return false;
+				if(code >= 0xD800 && code <= 0xDBFF){
+					if(!_Literal(iJSON, iLength, ioPos, "\\u")) return false;
+					uint32 low = _Hex4(iJSON, iLength, ioPos);
+					if(low < 0xDC00 || low > 0xDFFF) return false;
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				}
+			}
+			else{
+				const char *escape = NULL;
+				for(uint8 i = 0; i < sizeof(escapes) - 1; i += 2) if(escapes[i] == json[*ioPos]) escape = escapes + i;
+				if(escape == NULL) return false;
+				code = escape[1];
+				++*ioPos;
+			}
+		}
+		else{
+			uint8 length = _UTF8(json + *ioPos, iLength - *ioPos, &code);
+			if(length == 0) return false;
+			*ioPos += length;
+		}
+		if(*oCount == 32) return false;
+		oCodes[(*oCount)++] = code;
+	}
+	return _Literal(iJSON, iLength, ioPos, "\"");
+}
+
+//parses rendered JSON back and checks it against the scan list
+void _CheckJSON(const char *iJSON, uint32 iLength, uint8 iCount){
+	uint32 pos = 0, codes[32], expected[32];
+	uint8 count, expectedCount;
+	int rssi, channel, authmode;
+
+	HOST_CHECK(memchr(iJSON, '<', iLength) == NULL);
+	bool ok = _Literal(iJSON, iLength, &pos, "[");
+	for(uint8 i = 0; ok && i < iCount; ++i){
+		ok = (i == 0 || _Literal(iJSON, iLength, &pos, ",")) && _Literal(iJSON, iLength, &pos, "{\"ssid\":") &&
+				_String(iJSON, iLength, &pos, codes, &count) &&
+				_Literal(iJSON, iLength, &pos, ",\"rssi\":") && _Integer(iJSON, iLength, &pos, &rssi) &&
+				_Literal(iJSON, iLength, &pos, ",\"channel\":") && _Integer(iJSON, iLength, &pos, &channel) &&
+				_Literal(iJSON, iLength, &pos, ",\"authmode\":") && _Integer(iJSON, iLength, &pos, &authmode) &&
+				_Literal(iJSON, iLength, &pos, "}");
+		if(!ok) break;
+
+		expectedCount = _Expected(aps[i].ssid, aps[i].ssid_len, expected);
+		HOST_CHECK(count == expectedCount && memcmp(codes, expected, count * sizeof(codes[0])) == 0);
+		HOST_CHECK(rssi == aps[i].rssi && channel == aps[i].channel && authmode == aps[i].authmode);
+	}
+	ok = ok && _Literal(iJSON, iLength, &pos, "]") && pos == iLength;
+	HOST_CHECK(ok);
+	if(!ok) printf("bad JSON at %u: %.*s\n", pos, (int) iLength, iJSON);
+}
+
+//renders into an exact size heap buffer, checks measuring, cut copies and the bundle tail
+uint16 _Render(char *oJSON, uint8 iCount){
+	UpdateJSData(aps, SCAN_LIST);
+	uint16 length = GetWifi_AP_ScanJSON(NULL, 0);
+	HOST_CHECK(length <= TEST_JSON_SIZE);
+	char *buffer = malloc(length);
+	HOST_CHECK(GetWifi_AP_ScanJSON(buffer, length) == length);
+	memcpy(oJSON, buffer, length);
+	free(buffer);
+	_CheckJSON(oJSON, length, iCount);
+
+	uint16 size = rand() % (length + 1);
+	char cut[TEST_JSON_SIZE];
+	memset(cut, 0x55, sizeof(cut));
+	HOST_CHECK(GetWifi_AP_ScanJSON(cut, size) == length && memcmp(cut, oJSON, size) == 0 && (uint8) cut[size] == 0x55);
+
+	uint16 bundleSize = GetWifi_AP_BundleSize(false);
+	char *bundle = malloc(bundleSize);
+	HOST_CHECK(GetWifi_AP_Bundle(bundle, bundleSize, false) == bundleSize && GetWifi_AP_Bundle(bundle, bundleSize - 1, false) == 0);
+	uint16 tail = bundleSize - length - sizeof(";</script>") + 1;
+	HOST_CHECK(memcmp(bundle + tail - sizeof("<script>var AP=") + 1, "<script>var AP=", sizeof("<script>var AP=") - 1) == 0);
+	HOST_CHECK(memcmp(bundle + tail, oJSON, length) == 0 && memcmp(bundle + tail + length, ";</script>", 10) == 0);
+	free(bundle);
+	return length;
+}
+
+void _SetAP(uint8 iIndex, const char *iSsid){
+	memset(aps[iIndex].ssid, 'z', sizeof(aps[iIndex].ssid));
+	memcpy(aps[iIndex].ssid, iSsid, strlen(iSsid));
+	aps[iIndex].ssid_len = strlen(iSsid);
+	aps[iIndex].rssi = -30 - iIndex;
+	aps[iIndex].channel = 1 + iIndex;
+	aps[iIndex].authmode = iIndex % 5;
+}
+
+//random ssid bytes, weighted to what needs escaping and to UTF-8 good and bad
+uint8 _RandomSsid(uint8 *oSsid){
+	static const char *pieces[] = {"\"", "\\", "<", "/", "\x01", "\n", "\x1f", "\x7f", "a", "Z",
+			"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x93\xb6", "\xef\xbf\xbf", "\xf4\x8f\xbf\xbf",
+			"\xff", "\x80", "\xc3", "\xe2\x82", "\xc0\x80", "\xc1\xbf", "\xe0\x80\x80", "\xe0\x9f\xbf",
+			"\xed\xa0\x80", "\xed\xbf\xbf", "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80"};
+	uint8 length = 0, target = 1 + rand() % 32;
+	while(length < target){
+		const char *piece = pieces[rand() % (sizeof(pieces) / sizeof(pieces[0]))];
+		if(rand() % 4 == 0){
+			oSsid[length++] = rand() % 256;
+			continue;
+		}
+		for(uint8 i = 0; piece[i] != '\0' && length < target; ++i) oSsid[length++] = piece[i];
+	}
+	return length;
+}
+
+int main(void){
+	static char json[TEST_JSON_SIZE];
+
+	//no scan yet, then an empty list
+	HOST_CHECK(GetWifi_AP_ScanJSON(NULL, 0) == 2);
+	HOST_CHECK(_Render(json, 0) == 2 && memcmp(json, "[]", 2) == 0);
+
+	//what needs escaping, each in its own ssid
+	_SetAP(0, "say \"hi\" \\o/");
+	_SetAP(1, "</script><b>");
+	_SetAP(2, "tab\tnl\n\x01\x1f\x7f");
+	_SetAP(3, "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x93\xb6");
+	_SetAP(4, "caf\xe9 \xff\x80");
+	_SetAP(5, "\xc0\x80 overlong");
+	_SetAP(6, "\xed\xa0\x80 surrogate");
+	_SetAP(7, "past \xf4\x90\x80\x80");
+	_SetAP(8, "cut \xe2\x82");
+	_SetAP(9, "0123456789abcdef0123456789abcdef");		//no terminator
+	uint16 length = _Render(json, SCAN_LIST);
+	HOST_CHECK(strstr(json, "\"say \\\"hi\\\" \\\\o/\"") != NULL);
+	HOST_CHECK(strstr(json, "\"\\u003c/script>\\u003cb>\"") != NULL);
+	HOST_CHECK(strstr(json, "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x93\xb6\"") != NULL);
+	HOST_CHECK(strstr(json, "\"caf\\u00e9 \\u00ff\\u0080\"") != NULL);
+	HOST_CHECK(strstr(json, "\"\\u00c0\\u0080 overlong\"") != NULL && strstr(json, "\"\\u00ed\\u00a0\\u0080 surrogate\"") != NULL);
+	HOST_CHECK(strstr(json, "\"0123456789abcdef0123456789abcdef\",") != NULL);
+	printf("%u bytes of JSON for %u escaping ssids\n", length, SCAN_LIST);
+
+	//list ends at first empty ssid, validator follows data
+	uint32 etag = GetWifi_AP_DataETag();
+	aps[3].rssi = -90;
+	_Render(json, SCAN_LIST);
+	HOST_CHECK(GetWifi_AP_DataETag() != etag);
+	aps[4].ssid_len = 0;
+	_Render(json, 4);
+
+	//random ssids of every length
+	uint32 longest = 0;
+	for(uint32 step = 0; step < TEST_STEPS; ++step){
+		uint8 count = rand() % (SCAN_LIST + 1);
+		for(uint8 i = 0; i < SCAN_LIST; ++i){
+			aps[i].ssid_len = i < count ? _RandomSsid(aps[i].ssid) : 0;
+			aps[i].rssi = -(rand() % 100);
+			aps[i].channel = 1 + rand() % 13;
+			aps[i].authmode = rand() % 5;
+		}
+		length = _Render(json, count);
+		if(length > longest) longest = length;
+	}
+	printf("random scans: longest JSON %u bytes\n", longest);
+
+	return HostResult("webpage_test");
+}
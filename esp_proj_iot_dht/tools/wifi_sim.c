@@ -0,0 +1,594 @@
+/*
+ * wifi_sim.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ *
+ * Runs wifi state machine (user_wifi_fsm.c, user_credentials.c) on a Linux host against
+ * a simulated radio and reports time-to-connect after boot and time-to-recover after the
+ * joined AP drops out, over many seeded runs. It also counts credential store writes
+ * caused by joins and roams, there should be none.
+ *
+ * Two known networks are on air, "home" with two BSSs and "office" with one. Every BSS
+ * goes down and comes back at random (exponential up and down times), joins fail now and
+ * then, scans take 2-3 s. SDK events are injected through WifiFsmSdkEvent() the way
+ * the firmware's event handler does, collector probe answers 0.5 s after GOT_IP.
+ * Everything runs on a virtual millisecond clock, so an hour of radio takes milliseconds.
+ *
+ * Exits non-zero if a run never connected, the bus dropped an event or flash was written.
+ *
+ * build (from esp_proj_iot_dht, SDK headers on include path), `make hosttest` runs 5 one hour runs:
+ *   gcc -O2 -DICACHE_FLASH -I include -I $SDK_PATH/include -o wifi_sim \
+ *       tools/wifi_sim.c user/user_wifi_fsm.c user/user_credentials.c user/user_timer.c \
+ *       user/user_bus.c user/user_log.c -lm
+ *
+ * usage: wifi_sim [runs] [seconds per run] [mean BSS uptime s] [mean BSS downtime s]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#include "c_types.h"
+#include "osapi.h"
+#include "user_interface.h"
+#include "driver/http.h"
+#include "user_wifi_fsm.h"
+#include "user_credentials.h"
+#include "user_bus.h"
+
+#define SIM_APS				3
+#define SIM_TIMERS			8
+#define SIM_EVENTS			64
+#define SIM_SAMPLES			4096
+#define SIM_FLASH			4096
+
+typedef struct simAP{
+	const char *ssid;
+	uint8 bssid[6];
+	uint8 channel;
+	sint8 rssi;
+	bool up;
+} SIM_AP;
+
+typedef enum simEventType{
+	SIM_SCAN_DONE,
+	SIM_ASSOC,				//connected event
+	SIM_DHCP,				//got ip event
+	SIM_JOIN_FAILED,		//disconnected event while joining
+	SIM_BEACON_LOST,		//disconnected event after joined BSS went down
+	SIM_LEAVE,				//disconnected event of wifi_station_disconnect
+	SIM_LINK_UP,			//collector answers
+	SIM_TOGGLE_AP			//BSS goes down or comes back
+} SIM_EVENT_TYPE;
+
+typedef struct simEvent{
+	uint32 due;
+	SIM_EVENT_TYPE type;
+	uint32 arg;
+	uint32 session;			//join session it belongs to, stale ones are dropped
+	bool used;
+} SIM_EVENT;
+
+//radio
+static SIM_AP aps[SIM_APS] = {
+	{"home",   {0x02,0x00,0x00,0x00,0x00,0x01}, 1,  -62, true},
+	{"home",   {0x02,0x00,0x00,0x00,0x00,0x02}, 6,  -70, true},
+	{"office", {0x02,0x00,0x00,0x00,0x00,0x03}, 11, -74, true}
+};
+static struct station_config configDefault, configCurrent;
+static uint8 opmode = STATION_MODE;
+static sint8 joined = -1;				//index of BSS station is associated with
+static sint8 joining = -1;
+static bool gotIp = false;
+static bool scanning = false;
+static scan_done_cb_t scanCb = NULL;
+static uint32 session = 0;
+static uint8 flash[SIM_FLASH];
+static uint16 flashLength = 0;
+static uint32 flashWrites = 0;			//credential store writes after setup of a run
+static bool flashSetup = false;
+
+//virtual clock, timers, user task; clock runs on across runs as timer wheel keeps its own
+static uint32 now = 0, runStart = 0;
+static os_timer_t *timers[SIM_TIMERS];
+static SIM_EVENT events[SIM_EVENTS];
+static os_task_t task = NULL;
+static os_event_t *taskQueue = NULL;
+static uint8 taskQueueLength = 0, taskHead = 0, taskCount = 0;
+static uint32 postsDropped = 0;
+
+//results
+static uint32 connectTimes[SIM_SAMPLES], recoverTimes[SIM_SAMPLES];
+static uint32 connects = 0, recovers = 0, neverConnected = 0, roams = 0, joinsStarted = 0;
+static uint32 outageStart = 0;
+static bool outage = false, everVerified = false;
+static uint64 verifiedMs = 0;
+static uint32 verifiedSince = 0;
+
+/******** SDK stubs ********/
+
+int os_printf_plus(const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	int ret = vprintf(format, args);
+	va_end(args);
+	return ret;
+}
+
+int ets_sprintf(char *str, const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	int ret = vsprintf(str, format, args);
+	va_end(args);
+	return ret;
+}
+
+void *ets_memcpy(void *dest, const void *src, size_t n){ return memcpy(dest, src, n); }
+void *ets_memset(void *s, int c, size_t n){ return memset(s, c, n); }
+int ets_memcmp(const void *s1, const void *s2, unsigned int n){ return memcmp(s1, s2, n); }
+int ets_strcmp(const char *s1, const char *s2){ return strcmp(s1, s2); }
+int ets_strlen(const char *s){ return strlen(s); }
+
+void ets_timer_setfn(os_timer_t *ptimer, os_timer_func_t *pfunction, void *parg){
+	ptimer->timer_func = pfunction;
+	ptimer->timer_arg = parg;
+}
+
+void ets_timer_disarm(os_timer_t *ptimer){
+	for(uint8 i = 0; i < SIM_TIMERS; ++i) if(timers[i] == ptimer) timers[i] = NULL;
+}
+
+void ets_timer_arm_new(os_timer_t *ptimer, uint32_t time, bool repeat_flag, bool ms_flag){
+	ets_timer_disarm(ptimer);
+	ptimer->timer_expire = now + (ms_flag ? time : time / 1000);
+	ptimer->timer_period = repeat_flag ? (ms_flag ? time : time / 1000) : 0;
+	for(uint8 i = 0; i < SIM_TIMERS; ++i){
+		if(timers[i] == NULL){
+			timers[i] = ptimer;
+			return;
+		}
+	}
+	fprintf(stderr, "out of timers\n");
+	exit(1);
+}
+
+bool system_os_task(os_task_t iTask, uint8 prio, os_event_t *queue, uint8 qlen){
+	task = iTask;
+	taskQueue = queue;
+	taskQueueLength = qlen;
+	taskHead = taskCount = 0;
+	return true;
+}
+
+bool system_os_post(uint8 prio, os_signal_t sig, os_param_t par){
+	if(taskCount == taskQueueLength){
+		++postsDropped;
+		return false;
+	}
+	os_event_t *event = &taskQueue[(taskHead + taskCount++) % taskQueueLength];
+	event->sig = sig;
+	event->par = par;
+	return true;
+}
+
+//one thread, nothing to lock out
+void ets_intr_lock(void){
+}
+
+void ets_intr_unlock(void){
+}
+
+uint32 system_get_time(void){
+	return now * 1000;
+}
+
+bool system_param_load(uint16 start_sec, uint16 offset, void *param, uint16 len){
+	if(flashLength < offset + len) return false;
+	memcpy(param, flash + offset, len);
+	return true;
+}
+
+bool system_param_save_with_protect(uint16 start_sec, void *param, uint16 len){
+	memcpy(flash, param, len);
+	flashLength = len;
+	if(!flashSetup) ++flashWrites;
+	return true;
+}
+
+void UpdateJSData(struct scanned_AP_info *scanned_APs, uint8 size){
+}
+
+//log level form of user_log.c, no http server here
+FORM_STATUS httpDecodeForm(const char *iData, uint16 iLength, FORM_FIELD *ioFields, uint8 iFieldCount){
+	return FORM_MALFORMED;
+}
+
+/******** Simulated radio ********/
+
+uint32 _Random(uint32 iMin, uint32 iMax){
+	return iMin + (uint32)(rand() % (iMax - iMin + 1));
+}
+
+//exponentially distributed ms with given mean in seconds
+uint32 _RandomExp(uint32 iMeanSeconds){
+	double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double ms = -log(u) * iMeanSeconds * 1000.0;
+	return ms < 1.0 ? 1 : (uint32)ms;
+}
+
+void _Schedule(uint32 iDelay, SIM_EVENT_TYPE iType, uint32 iArg){
+	for(uint8 i = 0; i < SIM_EVENTS; ++i){
+		if(!events[i].used){
+			events[i] = (SIM_EVENT){now + iDelay, iType, iArg, session, true};
+			return;
+		}
+	}
+	fprintf(stderr, "out of events\n");
+	exit(1);
+}
+
+sint8 _Rssi(uint8 iAP){
+	return aps[iAP].rssi + (sint8)_Random(0, 6) - 3;
+}
+
+void _Deliver(System_Event_t *iEvent){
+	WifiFsmSdkEvent(iEvent);
+}
+
+void _DeliverDisconnected(uint8 iAP, uint8 iReason){
+	System_Event_t event;
+	memset(&event, 0, sizeof(event));
+	event.event = EVENT_STAMODE_DISCONNECTED;
+	strcpy((char*)event.event_info.disconnected.ssid, aps[iAP].ssid);
+	event.event_info.disconnected.ssid_len = strlen(aps[iAP].ssid);
+	memcpy(event.event_info.disconnected.bssid, aps[iAP].bssid, 6);
+	event.event_info.disconnected.reason = iReason;
+	_Deliver(&event);
+}
+
+bool wifi_station_scan(struct scan_config *config, scan_done_cb_t cb){
+	if(scanning || opmode == SOFTAP_MODE) return false;
+	scanning = true;
+	scanCb = cb;
+	_Schedule(_Random(2000, 3000), SIM_SCAN_DONE, 0);
+	return true;
+}
+
+bool wifi_station_connect(void){
+	if(joined >= 0 || joining >= 0) return true;
+
+	//pinned BSS, else strongest BSS of ssid that is on air
+	sint8 target = -1;
+	for(uint8 i = 0; i < SIM_APS; ++i){
+		if(strcmp((char*)configCurrent.ssid, aps[i].ssid) != 0) continue;
+		if(configCurrent.bssid_set && memcmp(configCurrent.bssid, aps[i].bssid, 6) != 0) continue;
+		if(!aps[i].up) continue;
+		if(target < 0 || aps[i].rssi > aps[target].rssi) target = i;
+	}
+	++joinsStarted;
+	++session;
+	if(target < 0){
+		//SDK scans all channels for ssid first
+		joining = SIM_APS;
+		_Schedule(_Random(2000, 4000), SIM_JOIN_FAILED, REASON_NO_AP_FOUND);
+		return true;
+	}
+	joining = target;
+	if(_Random(0, 99) < 10) _Schedule(_Random(500, 5000), SIM_JOIN_FAILED, REASON_HANDSHAKE_TIMEOUT);
+	else _Schedule(_Random(300, 1500), SIM_ASSOC, target);
+	return true;
+}
+
+bool wifi_station_disconnect(void){
+	if(joined < 0 && joining < 0) return true;
+	uint8 left = joined >= 0 ? joined : (joining < SIM_APS ? joining : 0);
+	bool wasJoined = joined >= 0;
+	++session;
+	joined = joining = -1;
+	gotIp = false;
+	if(wasJoined) _Schedule(10, SIM_LEAVE, left);
+	return true;
+}
+
+bool wifi_station_get_config(struct station_config *config){
+	*config = configCurrent;
+	return true;
+}
+
+bool wifi_station_get_config_default(struct station_config *config){
+	*config = configDefault;
+	return true;
+}
+
+bool wifi_station_set_config(struct station_config *config){
+	configDefault = configCurrent = *config;
+	return true;
+}
+
+bool wifi_station_set_config_current(struct station_config *config){
+	configCurrent = *config;
+	return true;
+}
+
+sint8 wifi_station_get_rssi(void){
+	return joined >= 0 ? _Rssi(joined) : 31;
+}
+
+uint8 wifi_station_get_connect_status(void){
+	if(gotIp) return STATION_GOT_IP;
+	return joining >= 0 || joined >= 0 ? STATION_CONNECTING : STATION_IDLE;
+}
+
+bool wifi_station_set_reconnect_policy(bool set){
+	return true;
+}
+
+bool wifi_set_opmode_current(uint8 mode){
+	if(mode == SOFTAP_MODE) wifi_station_disconnect();
+	opmode = mode;
+	return true;
+}
+
+uint8 wifi_get_opmode(void){
+	return opmode;
+}
+
+bool wifi_softap_get_config(struct softap_config *config){
+	memset(config, 0, sizeof(*config));
+	return true;
+}
+
+bool wifi_softap_set_config(struct softap_config *config){
+	return true;
+}
+
+uint8 wifi_softap_get_station_num(void){
+	return 0;
+}
+
+/******** Harness ********/
+
+void _ScanDone(void){
+	static struct bss_info list[SIM_APS];
+	struct bss_info *head = NULL;
+	scanning = false;
+
+	if(_Random(0, 99) < 5){
+		scanCb(NULL, FAIL);
+		return;
+	}
+	for(sint8 i = SIM_APS - 1; i >= 0; --i){
+		if(!aps[i].up) continue;
+		memset(&list[i], 0, sizeof(list[i]));
+		memcpy(list[i].bssid, aps[i].bssid, 6);
+		strcpy((char*)list[i].ssid, aps[i].ssid);
+		list[i].ssid_len = strlen(aps[i].ssid);
+		list[i].channel = aps[i].channel;
+		list[i].rssi = _Rssi(i);
+		list[i].authmode = AUTH_WPA2_PSK;
+		list[i].next.stqe_next = head;
+		head = &list[i];
+	}
+	scanCb(head, OK);
+}
+
+void _SimEvent(SIM_EVENT *iEvent){
+	System_Event_t event;
+	memset(&event, 0, sizeof(event));
+
+	switch(iEvent->type){
+	case SIM_SCAN_DONE:
+		_ScanDone();
+		break;
+	case SIM_ASSOC:
+		if(iEvent->session != session) break;
+		if(!aps[iEvent->arg].up){
+			joining = -1;
+			_DeliverDisconnected(iEvent->arg, REASON_NO_AP_FOUND);
+			break;
+		}
+		joined = iEvent->arg;
+		joining = -1;
+		event.event = EVENT_STAMODE_CONNECTED;
+		strcpy((char*)event.event_info.connected.ssid, aps[joined].ssid);
+		memcpy(event.event_info.connected.bssid, aps[joined].bssid, 6);
+		event.event_info.connected.channel = aps[joined].channel;
+		_Deliver(&event);
+		_Schedule(_Random(200, 2000), SIM_DHCP, 0);
+		break;
+	case SIM_DHCP:
+		if(iEvent->session != session || joined < 0) break;
+		gotIp = true;
+		event.event = EVENT_STAMODE_GOT_IP;
+		_Deliver(&event);
+		break;
+	case SIM_JOIN_FAILED:
+		if(iEvent->session != session) break;
+		joining = -1;
+		_DeliverDisconnected(0, iEvent->arg);
+		break;
+	case SIM_BEACON_LOST:
+		if(iEvent->session != session || joined != (sint8)iEvent->arg) break;
+		joined = -1;
+		gotIp = false;
+		_DeliverDisconnected(iEvent->arg, REASON_BEACON_TIMEOUT);
+		break;
+	case SIM_LEAVE:
+		_DeliverDisconnected(iEvent->arg, REASON_ASSOC_LEAVE);
+		break;
+	case SIM_LINK_UP:
+		if(iEvent->session != session || !gotIp) break;
+		WifiFsmInput(WIFI_IN_LINK_UP);
+		break;
+	case SIM_TOGGLE_AP:
+		break;
+	}
+}
+
+void _StateChanged(WIFI_STATE iOld, WIFI_STATE iNew){
+	if(iOld == iNew) return;
+
+	//firmware starts link probe here, collector answers quickly in simulation
+	if(iNew == WIFI_GOT_IP) _Schedule(500, SIM_LINK_UP, 0);
+
+	if(iOld == WIFI_VERIFIED) verifiedMs += now - verifiedSince;
+	if(iNew == WIFI_VERIFIED){
+		verifiedSince = now;
+		if(!everVerified){
+			everVerified = true;
+			if(connects < SIM_SAMPLES) connectTimes[connects++] = now - runStart;
+		}
+		if(outage){
+			outage = false;
+			if(recovers < SIM_SAMPLES) recoverTimes[recovers++] = now - outageStart;
+		}
+	}
+	if((iOld == WIFI_GOT_IP || iOld == WIFI_VERIFIED) && iNew == WIFI_CONNECTING) ++roams;
+}
+
+void _RunTask(void){
+	while(taskCount > 0){
+		os_event_t event = taskQueue[taskHead];
+		taskHead = (taskHead + 1) % taskQueueLength;
+		--taskCount;
+		task(&event);
+	}
+}
+
+void _RunOnce(uint32 iSeed, uint32 iSeconds, uint32 iUptime, uint32 iDowntime){
+	//events left on bus by last run reach its machine before everything is reset
+	_RunTask();
+
+	srand(iSeed);
+	memset(events, 0, sizeof(events));
+	memset(&configDefault, 0, sizeof(configDefault));
+	runStart = now;
+	joined = joining = -1;
+	gotIp = scanning = false;
+	opmode = STATION_MODE;
+	flashLength = 0;
+	outage = everVerified = false;
+	for(uint8 i = 0; i < SIM_APS; ++i) aps[i].up = true;
+
+	//both networks were joined before, SDK remembers last one
+	flashSetup = true;
+	InitCredentials();
+	AP_Info known;
+	memset(&known, 0, sizeof(known));
+	strcpy((char*)known.ssid, "office");
+	known.ssid_len = 6;
+	strcpy((char*)known.password, "secret");
+	SaveCredential(&known);
+	strcpy((char*)known.ssid, "home");
+	known.ssid_len = 4;
+	SaveCredential(&known);
+	flashSetup = false;
+	strcpy((char*)configDefault.ssid, "home");
+	strcpy((char*)configDefault.password, "secret");
+	configCurrent = configDefault;
+
+	for(uint8 i = 0; i < SIM_APS; ++i) _Schedule(_RandomExp(iUptime), SIM_TOGGLE_AP, i);
+
+	InitWifiFsm(_StateChanged);
+	WifiFsmInput(WIFI_IN_START);
+
+	uint32 end = runStart + iSeconds * 1000;
+	while(now < end){
+		//user task runs until its queue is empty
+		_RunTask();
+
+		//next timer or radio event, whichever is first
+		uint32 due = end;
+		os_timer_t *timer = NULL;
+		SIM_EVENT *next = NULL;
+		for(uint8 i = 0; i < SIM_TIMERS; ++i){
+			if(timers[i] != NULL && timers[i]->timer_expire < due){
+				due = timers[i]->timer_expire;
+				timer = timers[i];
+			}
+		}
+		for(uint8 i = 0; i < SIM_EVENTS; ++i){
+			if(events[i].used && events[i].due < due){
+				due = events[i].due;
+				next = &events[i];
+				timer = NULL;
+			}
+		}
+		now = due;
+
+		if(timer != NULL){
+			ets_timer_disarm(timer);
+			if(timer->timer_period > 0) ets_timer_arm_new(timer, timer->timer_period, true, true);
+			timer->timer_func(timer->timer_arg);
+		}
+		else if(next != NULL){
+			SIM_EVENT event = *next;
+			next->used = false;
+			if(event.type == SIM_TOGGLE_AP){
+				SIM_AP *ap = &aps[event.arg];
+				ap->up = !ap->up;
+				_Schedule(ap->up ? _RandomExp(iUptime) : _RandomExp(iDowntime), SIM_TOGGLE_AP, event.arg);
+
+				//joined BSS is gone, SDK notices after missing beacons
+				if(!ap->up && joined == (sint8)event.arg){
+					if(WifiFsmState() == WIFI_VERIFIED && !outage){
+						outage = true;
+						outageStart = now;
+					}
+					_Schedule(_Random(3000, 6000), SIM_BEACON_LOST, event.arg);
+				}
+			}
+			else{
+				_SimEvent(&event);
+			}
+		}
+	}
+	if(WifiFsmState() == WIFI_VERIFIED) verifiedMs += now - verifiedSince;
+	if(!everVerified) ++neverConnected;
+}
+
+int _Compare(const void *a, const void *b){
+	uint32 x = *(const uint32*)a, y = *(const uint32*)b;
+	return x < y ? -1 : x > y;
+}
+
+void _Report(const char *iName, uint32 *iSamples, uint32 iCount){
+	if(iCount == 0){
+		printf("%-16s no samples\n", iName);
+		return;
+	}
+	qsort(iSamples, iCount, sizeof(uint32), _Compare);
+	printf("%-16s n=%-5u min %6.1f s  median %6.1f s  p95 %6.1f s  max %6.1f s\n", iName, iCount,
+			iSamples[0] / 1000.0, iSamples[iCount / 2] / 1000.0,
+			iSamples[(iCount * 95) / 100 < iCount ? (iCount * 95) / 100 : iCount - 1] / 1000.0,
+			iSamples[iCount - 1] / 1000.0);
+}
+
+int main(int argc, char **argv){
+	uint32 runs = argc > 1 ? atoi(argv[1]) : 50;
+	uint32 seconds = argc > 2 ? atoi(argv[2]) : 3600;
+	uint32 uptime = argc > 3 ? atoi(argv[3]) : 600;
+	uint32 downtime = argc > 4 ? atoi(argv[4]) : 30;
+
+	for(uint32 seed = 1; seed <= runs; ++seed) _RunOnce(seed, seconds, uptime, downtime);
+
+	//inputs and timeouts the bus merged or had no room for
+	BUS_STATS input, timeout;
+	GetBusStats(BUS_WIFI_INPUT, &input);
+	GetBusStats(BUS_WIFI_TIMEOUT, &timeout);
+
+	printf("%u runs of %u s, BSS up %u s / down %u s on average\n", runs, seconds, uptime, downtime);
+	_Report("time-to-connect", connectTimes, connects);
+	_Report("time-to-recover", recoverTimes, recovers);
+	printf("verified %.2f %% of time, %u joins, %u roams, %u runs never connected\n",
+			100.0 * verifiedMs / ((uint64)runs * seconds * 1000), joinsStarted, roams, neverConnected);
+	printf("bus: %u events posted, %u coalesced, %u dropped, queue high-water %d of %d, %u wakeups dropped\n",
+			input.posted + timeout.posted, input.coalesced + timeout.coalesced, input.dropped + timeout.dropped,
+			BusHighWater(), BUS_QUEUE, postsDropped);
+	//networks are known with their passwords, joins and roams must not write flash
+	printf("flash: %u credential store writes\n", flashWrites);
+	return neverConnected > 0 || input.dropped + timeout.dropped > 0 || postsDropped > 0 || flashWrites > 0;
+}
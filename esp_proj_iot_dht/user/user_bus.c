@@ -0,0 +1,229 @@
+/*
+ * user_bus.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_bus.h"
+
+//system includes
+#include "ets_sys.h"
+#include "osapi.h"
+#include "user_interface.h"
+
+//user includes
+#include "user_log.h"
+
+#define BUS_TASK_PRIO				USER_TASK_PRIO_1
+
+//interrupt lock keeping the level it found: BusPost also runs in the scan button ISR, where
+//ets_intr_unlock would drop the level to 0 and let the handler be interrupted again
+#if defined(__XTENSA__)
+	#define BUS_LOCK(ps)			__asm__ __volatile__("rsil %0, 15" : "=a"(ps) : : "memory")
+	#define BUS_UNLOCK(ps)			__asm__ __volatile__("wsr %0, ps; isync" : : "a"(ps) : "memory")
+#else
+	#define BUS_LOCK(ps)			do {ets_intr_lock(); (ps) = 0;} while(0)
+	#define BUS_UNLOCK(ps)			do {(void)(ps); ets_intr_unlock();} while(0)
+#endif
+
+typedef struct busEntry{
+	BUS_EVENT event;
+	uint32 param;
+} BUS_ENTRY;
+
+typedef struct busSubscriber{
+	BUS_EVENT event;
+	BUS_CB callback;
+} BUS_SUBSCRIBER;
+
+static const char *eventNames[BUS_EVENTS] = {
+	[BUS_WIFI_INPUT]			= "wifi_input",
+	[BUS_WIFI_TIMEOUT]			= "wifi_timeout",
+	[BUS_SERVER_DELETE]			= "server_delete",
+	[BUS_SERVER_CLOSE]			= "server_close",
+	[BUS_SERVER_DROP]			= "server_drop",
+	[BUS_CLIENT_CLOSE]			= "client_close"
+};
+
+//ring, changed by BusPost (also from ISR) and bus task under interrupt lock
+static BUS_ENTRY ring[BUS_QUEUE];
+static uint8 head = 0;
+static uint8 count = 0;
+static uint8 newest[BUS_EVENTS] = {0};		//slot + 1 of newest pending event of a type, 0 if none
+static uint8 highWater = 0;
+static BUS_STATS stats[BUS_EVENTS] = {0};
+static uint32 dropsLogged[BUS_EVENTS] = {0};
+
+static BUS_SUBSCRIBER subscribers[BUS_SUBSCRIBERS];
+static uint8 subscriberCount = 0;
+
+//SDK queue only holds a wakeup, there is never more than one in it
+static os_event_t wakeupQueue[1];
+static bool registered = false;
+static bool ringing = false;				//wakeup posted, task has not taken last event yet
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _BusWake
+ * Description	:  Posts wakeup of bus task, call with ringing set. Safe from ISR.
+ ******************************************************************************************/
+void _BusWake(void){
+	//cannot fail with one wakeup at a time, events wait for next post if it does
+	if(!system_os_post(BUS_TASK_PRIO, 0, 0)) ringing = false;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _BusLogDrops
+ * Description	:  Logs drops counted since last call, BusPost may run in ISR and can not
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _BusLogDrops(void){
+	for(uint8 i = 0; i < BUS_EVENTS; ++i){
+		uint32 dropped = stats[i].dropped;
+		if(dropped == dropsLogged[i]) continue;
+		LOG_WARN(BUS, "%u %s events dropped, queue full (%d)", dropped - dropsLogged[i], eventNames[i], BUS_QUEUE);
+		dropsLogged[i] = dropped;
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _BusTask
+ * Description	:  Bus task, dispatches oldest pending event. One event per run, SDK tasks
+ * 				   (wifi, lwip) get their turn between events.
+ * Parameters	:  event -- wakeup, unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _BusTask(os_event_t *event){
+	uint32 ps;
+	BUS_LOCK(ps);
+	if(count == 0){
+		ringing = false;
+		BUS_UNLOCK(ps);
+		return;
+	}
+	BUS_ENTRY entry = ring[head];
+	if(newest[entry.event] == head + 1) newest[entry.event] = 0;
+	head = (head + 1) % BUS_QUEUE;
+	bool more = --count > 0;
+	ringing = more;
+	BUS_UNLOCK(ps);
+
+	if(more) _BusWake();
+	_BusLogDrops();
+
+	LOG_DEBUG(BUS, "%s : %u", eventNames[entry.event], entry.param);
+	for(uint8 i = 0; i < subscriberCount; ++i){
+		if(subscribers[i].event == entry.event) subscribers[i].callback(entry.event, entry.param);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  BusSubscribe
+ * Description	:  Subscribes a callback to an event type, first call registers bus task
+ * Parameters	:  iEvent -- event type
+ * 				   iCallback -- callback
+ * Return		:  bool, true if subscribed,
+ * 						 false if BUS_SUBSCRIBERS are used up
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR BusSubscribe(BUS_EVENT iEvent, BUS_CB iCallback){
+	if(iEvent >= BUS_EVENTS || iCallback == NULL) return false;
+
+	for(uint8 i = 0; i < subscriberCount; ++i){
+		if(subscribers[i].event == iEvent && subscribers[i].callback == iCallback) return true;
+	}
+	if(subscriberCount == BUS_SUBSCRIBERS){
+		LOG_ERROR(BUS, "no subscriber slot for %s (%d)", eventNames[iEvent], BUS_SUBSCRIBERS);
+		return false;
+	}
+	subscribers[subscriberCount].event = iEvent;
+	subscribers[subscriberCount].callback = iCallback;
+	++subscriberCount;
+
+	if(!registered){
+		registered = system_os_task(_BusTask, BUS_TASK_PRIO, wakeupQueue, 1);
+		if(!registered) LOG_ERROR(BUS, "could not register bus task");
+
+		//events posted before are waiting
+		uint32 ps;
+		BUS_LOCK(ps);
+		bool wake = registered && count > 0 && !ringing;
+		if(wake) ringing = true;
+		BUS_UNLOCK(ps);
+		if(wake) _BusWake();
+	}
+	return registered;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  BusPost
+ * Description	:  Queues an event, coalesced into newest pending event of its type if equal.
+ * 				   Callable from ISR, leaves the interrupt level as it found it.
+ * Parameters	:  iEvent -- event type
+ * 				   iParam -- event parameter
+ * Return		:  bool, true if queued or coalesced,
+ * 						 false if dropped (ring full)
+ ******************************************************************************************/
+bool BusPost(BUS_EVENT iEvent, uint32 iParam){
+	if(iEvent >= BUS_EVENTS) return false;
+	bool queued = true, wake = false;
+	uint32 ps;
+
+	BUS_LOCK(ps);
+	++stats[iEvent].posted;
+	if(newest[iEvent] != 0 && ring[newest[iEvent] - 1].param == iParam){
+		++stats[iEvent].coalesced;
+	}
+	else if(count == BUS_QUEUE){
+		++stats[iEvent].dropped;
+		queued = false;
+	}
+	else{
+		uint8 slot = (head + count) % BUS_QUEUE;
+		ring[slot].event = iEvent;
+		ring[slot].param = iParam;
+		newest[iEvent] = slot + 1;
+		if(++count > highWater) highWater = count;
+		wake = registered && !ringing;
+		if(wake) ringing = true;
+	}
+	BUS_UNLOCK(ps);
+
+	if(wake) _BusWake();
+	return queued;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetBusStats
+ * Description	:  Post counters of an event type
+ * Parameters	:  iEvent -- event type
+ * 				   oStats -- output
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR GetBusStats(BUS_EVENT iEvent, BUS_STATS *oStats){
+	if(iEvent >= BUS_EVENTS){
+		os_memset(oStats, 0, sizeof(BUS_STATS));
+		return;
+	}
+	uint32 ps;
+	BUS_LOCK(ps);
+	*oStats = stats[iEvent];
+	BUS_UNLOCK(ps);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  BusHighWater
+ * Description	:  Most events pending at once since boot
+ * Return		:  high-water mark, at most BUS_QUEUE
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR BusHighWater(void){
+	return highWater;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  BusEventName
+ * Description	:  Name of an event type
+ * Parameters	:  iEvent -- event type
+ * Return		:  name, "unknown" if out of range
+ ******************************************************************************************/
+const char * ICACHE_FLASH_ATTR BusEventName(BUS_EVENT iEvent){
+	return iEvent < BUS_EVENTS ? eventNames[iEvent] : "unknown";
+}
@@ -0,0 +1,395 @@
+/*
+ * user_console.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_console.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//driver libs
+#include "driver/uart.h"
+
+//user includes
+#include "user_wifi.h"
+#include "user_wifi_fsm.h"
+#include "user_link.h"
+#include "user_metrics.h"
+#include "user_trace.h"
+#include "user_stream.h"
+#include "user_timer.h"
+#include "user_bus.h"
+#include "user_log.h"
+
+#if !UART_BUFF_EN
+	#error "console reads uart rx buffer, set UART_BUFF_EN in driver/uart.h"
+#endif
+
+//bytes taken from uart rx buffer at a time
+#define CONSOLE_DEQ_SIZE			32
+
+//tx buffer room a metrics part needs, a family and a CR per line
+#define CONSOLE_DUMP_ROOM			(METRICS_FAMILY_SIZE + 64)
+
+typedef void (*CONSOLE_HANDLER)(uint8 iArgc, char **iArgv);
+
+typedef struct consoleCommand{
+	const char *name;
+	uint8 maxArgs;				//arguments after command name
+	CONSOLE_HANDLER handler;
+	const char *usage;
+} CONSOLE_COMMAND;
+
+//static placeholders
+static char line[CONSOLE_LINE_SIZE];
+static uint8 lineLength = 0;
+static bool lineDiscard = false;			//line is too long, dropped until it ends
+static CONSOLE_READ_CB readSample = NULL;
+
+//metrics dump, a family per tx buffer drain
+static TIMER_ID dumpTimer = TIMER_NONE;
+static bool dumping = false;
+static uint16 dumpCursor = 0;
+static char dumpBuffer[METRICS_FAMILY_SIZE];
+
+void ICACHE_FLASH_ATTR _CmdHelp(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdInterval(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdCollector(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdMetrics(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdTrace(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdRead(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdWifi(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdLog(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdStream(uint8 iArgc, char **iArgv);
+void ICACHE_FLASH_ATTR _CmdBus(uint8 iArgc, char **iArgv);
+
+static const CONSOLE_COMMAND commands[] = {
+	{"help",		0, _CmdHelp,		"help"},
+	{"interval",	1, _CmdInterval,	"interval [seconds] -- show or set sample interval"},
+	{"collector",	2, _CmdCollector,	"collector [ip [port]] -- show or set collector"},
+	{"metrics",		0, _CmdMetrics,		"metrics -- dump metrics"},
+	{"trace",		1, _CmdTrace,		"trace [hist] -- dump trace ring, or stage histograms"},
+	{"read",		0, _CmdRead,		"read -- read DHT now (uploads as sample timer does)"},
+	{"wifi",		0, _CmdWifi,		"wifi -- show wifi and link state"},
+	{"log",			1, _CmdLog,			"log [module=level&...] -- show or set log levels"},
+	{"stream",		1, _CmdStream,		"stream [ms] -- binary readings for a wired gateway, 0x04 stops"},
+	{"bus",			0, _CmdBus,			"bus -- show event bus counters"}
+};
+
+#define CONSOLE_COMMANDS			(sizeof(commands) / sizeof(commands[0]))
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _ConsoleNumber
+ * Description	:  Parses an unsigned decimal argument
+ * Parameters	:  iText -- argument
+ * 				   iMax -- largest valid value
+ * 				   oValue -- output
+ * Return		:  bool, true if iText is a number from 0 to iMax
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _ConsoleNumber(const char *iText, uint32 iMax, uint32 *oValue){
+	uint32 value = 0;
+	if(*iText == '\0') return false;
+	for(; *iText != '\0'; ++iText){
+		if(*iText < '0' || *iText > '9') return false;
+		value = value * 10 + (*iText - '0');
+		if(value > iMax) return false;
+	}
+	*oValue = value;
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ConsoleWrite
+ * Description	:  Queues text on uart tx buffer, LF line ends become CR LF
+ * Parameters	:  iText -- text
+ * 				   iLength -- text length
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ConsoleWrite(const char *iText, uint16 iLength){
+	uint16 start = 0;
+	for(uint16 i = 0; i < iLength; ++i){
+		if(iText[i] != '\n') continue;
+		if(i > start) tx_buff_enq((char *)iText + start, i - start);
+		tx_buff_enq("\r\n", 2);
+		start = i + 1;
+	}
+	if(iLength > start) tx_buff_enq((char *)iText + start, iLength - start);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Console_DumpTimer
+ * Description	:  Metrics dump timer callback, renders next family once tx buffer has room
+ * 				   for it, so dump neither drops log lines nor is dropped itself
+ * Parameters	:  arg -- unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Console_DumpTimer(void *arg){
+	//text would corrupt stream frames
+	if(Streaming()){
+		dumping = false;
+		return;
+	}
+
+	if(tx_buff_free() >= CONSOLE_DUMP_ROOM){
+		uint16 length = RenderMetrics(dumpBuffer, sizeof(dumpBuffer), &dumpCursor);
+		if(length == 0){
+			dumping = false;
+			return;
+		}
+		_ConsoleWrite(dumpBuffer, length);
+	}
+
+	ArmTimer(dumpTimer, CONSOLE_DUMP_INTERVAL, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdHelp
+ * Description	:  help, lists commands
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdHelp(uint8 iArgc, char **iArgv){
+	for(uint8 i = 0; i < CONSOLE_COMMANDS; ++i) os_printf("  %s\r\n", commands[i].usage);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdInterval
+ * Description	:  interval [seconds], shows or sets sample interval
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdInterval(uint8 iArgc, char **iArgv){
+	uint32 seconds = 0;
+	if(iArgc > 1){
+		if(!_ConsoleNumber(iArgv[1], STATION_TIMER_MAX, &seconds) || !SetSampleInterval(seconds)){
+			os_printf("interval is 1 to %d seconds\r\n", STATION_TIMER_MAX);
+			return;
+		}
+	}
+	os_printf("sample interval %d s\r\n", GetSampleInterval());
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdCollector
+ * Description	:  collector [ip [port]], shows or sets collector address
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdCollector(uint8 iArgc, char **iArgv){
+	uint32 ip = 0;
+	uint16 port = 0;
+	LinkCollector(&ip, &port);
+
+	if(iArgc > 1){
+		uint32 value = port;
+		if(iArgc > 2 && !_ConsoleNumber(iArgv[2], 65535, &value)) value = 0;
+		if(!LinkSetCollector(iArgv[1], value)){
+			os_printf("collector is a.b.c.d and a port from 1 to 65535\r\n");
+			return;
+		}
+		LinkCollector(&ip, &port);
+	}
+	os_printf("collector " IPSTR ":%d, reachable : %d\r\n", IP2STR(&ip), port, LinkReachable());
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdMetrics
+ * Description	:  metrics, dumps metrics (text exposition format) a family at a time
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdMetrics(uint8 iArgc, char **iArgv){
+	if(dumping){
+		os_printf("metrics dump in progress\r\n");
+		return;
+	}
+	dumping = true;
+	dumpCursor = 0;
+	ArmTimer(dumpTimer, 0, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdTrace
+ * Description	:  trace [hist], dumps tracepoint ring or stage histograms
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdTrace(uint8 iArgc, char **iArgv){
+	if(iArgc == 1) TraceDump();
+	else if(os_strcmp(iArgv[1], "hist") == 0) TraceReport();
+	else os_printf("usage: trace [hist]\r\n");
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdRead
+ * Description	:  read, takes a sample now
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdRead(uint8 iArgc, char **iArgv){
+	if(readSample == NULL){
+		os_printf("no sampler\r\n");
+		return;
+	}
+	readSample();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdWifi
+ * Description	:  wifi, shows wifi machine state, station ip and collector link quality
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdWifi(uint8 iArgc, char **iArgv){
+	struct ip_info info;
+	os_memset(&info, 0, sizeof(info));
+	wifi_get_ip_info(STATION_IF, &info);
+	os_printf("wifi %s, rssi %d, ip " IPSTR "\r\n", WifiStateName(WifiFsmState()), wifi_station_get_rssi(), IP2STR(&info.ip));
+
+	LINK_QUALITY quality;
+	GetLinkQuality(&quality);
+	os_printf("link reachable : %d, rtt %u us, jitter %u us, loss %d%% of %d probes\r\n",
+			quality.reachable, quality.rttMean, quality.jitter, quality.loss, quality.samples);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdLog
+ * Description	:  log [module=level&...], shows or sets runtime log levels
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdLog(uint8 iArgc, char **iArgv){
+	if(iArgc > 1 && !LogSetLevels(iArgv[1], os_strlen(iArgv[1]))){
+		os_printf("usage: log module=level&..., level is none, error, warn, info or debug\r\n");
+		return;
+	}
+
+	char json[LOG_JSON_SIZE + 1];
+	uint16 length = GetLogLevelsJSON(json, LOG_JSON_SIZE);
+	json[length < LOG_JSON_SIZE ? length : LOG_JSON_SIZE] = '\0';
+	os_printf("%s\r\n", json);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdStream
+ * Description	:  stream [ms], enters wired mode, console is back once gateway sends STREAM_STOP
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdStream(uint8 iArgc, char **iArgv){
+	uint32 interval = STREAM_INTERVAL;
+	if(readSample == NULL){
+		os_printf("no sampler\r\n");
+		return;
+	}
+	if(iArgc > 1 && !_ConsoleNumber(iArgv[1], STREAM_INTERVAL_MAX, &interval)) interval = 0;
+	if(!StartStream(interval, readSample)) os_printf("interval is %u to %u ms\r\n", STREAM_INTERVAL_MIN, STREAM_INTERVAL_MAX);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _CmdBus
+ * Description	:  bus, shows posts per event type and queue high-water mark
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _CmdBus(uint8 iArgc, char **iArgv){
+	BUS_STATS stats;
+	for(uint8 i = 0; i < BUS_EVENTS; ++i){
+		GetBusStats(i, &stats);
+		os_printf("%s : posted %u, coalesced %u, dropped %u\r\n", BusEventName(i), stats.posted, stats.coalesced, stats.dropped);
+	}
+	os_printf("queue high-water %d of %d\r\n", BusHighWater(), BUS_QUEUE);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ConsoleExecute
+ * Description	:  Splits line into arguments (in place) and runs its command
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ConsoleExecute(void){
+	char *argv[CONSOLE_ARGS];
+	uint8 argc = 0;
+
+	for(uint8 i = 0; i < lineLength; ++i){
+		if(line[i] == ' '){
+			line[i] = '\0';
+			continue;
+		}
+		if(i > 0 && line[i - 1] != '\0') continue;
+		if(argc == CONSOLE_ARGS){
+			os_printf("too many arguments\r\n");
+			return;
+		}
+		argv[argc++] = &line[i];
+	}
+	if(argc == 0) return;
+
+	for(uint8 i = 0; i < CONSOLE_COMMANDS; ++i){
+		if(os_strcmp(argv[0], commands[i].name) != 0) continue;
+
+		LOG_DEBUG(CONSOLE, "command %s, %d arguments", argv[0], argc - 1);
+		if(argc - 1 > commands[i].maxArgs) os_printf("usage: %s\r\n", commands[i].usage);
+		else commands[i].handler(argc, argv);
+		return;
+	}
+	os_printf("unknown command %s, try help\r\n", argv[0]);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ConsoleFeed
+ * Description	:  Adds received bytes to line, runs line's command when it ends. Backspace
+ * 				   edits, other control characters are ignored.
+ * Parameters	:  iData -- received bytes
+ * 				   iLength -- iData length
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ConsoleFeed(const char *iData, uint16 iLength){
+	char echo[CONSOLE_DEQ_SIZE * 3];
+	uint16 echoLength = 0;
+
+	for(uint16 i = 0; i < iLength; ++i){
+		char c = iData[i];
+
+		//flush echo when it could not take a backspace, and before command output
+		if(echoLength + 3 > sizeof(echo) || ((c == '\r' || c == '\n') && echoLength > 0)){
+			if(CONSOLE_ECHO) tx_buff_enq(echo, echoLength);
+			echoLength = 0;
+		}
+
+		if(c == '\r' || c == '\n'){
+			//CR LF ends one line, empty lines are skipped
+			if(lineLength == 0 && !lineDiscard) continue;
+			if(CONSOLE_ECHO) tx_buff_enq("\r\n", 2);
+
+			if(lineDiscard) os_printf("line too long, at most %d characters\r\n", CONSOLE_LINE_SIZE - 1);
+			else{
+				line[lineLength] = '\0';
+				_ConsoleExecute();
+			}
+			lineLength = 0;
+			lineDiscard = false;
+		}
+		else if(c == '\b' || c == 0x7F){
+			if(lineLength == 0 || lineDiscard) continue;
+			--lineLength;
+			os_memcpy(echo + echoLength, "\b \b", 3);
+			echoLength += 3;
+		}
+		else if(c < ' ' || c > '~' || lineDiscard) continue;
+		else if(lineLength >= CONSOLE_LINE_SIZE - 1) lineDiscard = true;
+		else{
+			line[lineLength++] = c;
+			echo[echoLength++] = c;
+		}
+	}
+
+	if(CONSOLE_ECHO && echoLength > 0) tx_buff_enq(echo, echoLength);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Console_Rx
+ * Description	:  uart rx callback (uart task), drains uart rx buffer into console
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Console_Rx(void){
+	char data[CONSOLE_DEQ_SIZE];
+	uint16 length = 0;
+	while((length = rx_buff_deq(data, sizeof(data))) > 0) _ConsoleFeed(data, length);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitConsole
+ * Description	:  Starts console, registers it as consumer of uart rx buffer
+ * Parameters	:  iReadSample -- called by read command (may be NULL)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitConsole(CONSOLE_READ_CB iReadSample){
+	readSample = iReadSample;
+	lineLength = 0;
+	lineDiscard = false;
+
+	dumpTimer = CreateTimer(_Console_DumpTimer, NULL);
+
+	uart_set_rx_cb(_Console_Rx);
+	LOG_INFO(CONSOLE, "console ready, type help");
+}
@@ -0,0 +1,222 @@
+/*
+ * user_credentials.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_credentials.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//user includes
+#include "user_log.h"
+
+//known AP as kept in flash, size is a multiple of 4 (flash is written in words)
+typedef struct knownAP{
+	uint8 ssid[32];
+	uint8 password[64];
+	uint8 bssid[6];				//last joined BSS
+	uint8 ssid_len;
+	uint8 channel;				//channel of last joined BSS, 0 if unknown
+	uint32 lastUsed;			//store sequence when last joined, 0 for a free slot
+} KNOWN_AP;
+
+typedef struct credentialStore{
+	uint32 magic;
+	uint8 version;
+	uint8 count;
+	uint16 reserved;
+	uint32 sequence;			//last lastUsed handed out
+	KNOWN_AP aps[CREDENTIALS_MAX];
+	uint32 checksum;			//over everything above
+} CREDENTIAL_STORE;
+
+//static placeholders
+static CREDENTIAL_STORE store __attribute__((aligned(4)));
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _CredentialsChecksum
+ * Description	:  FNV-1a hash of store, checksum field excluded
+ * Return		:  checksum
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR _CredentialsChecksum(void){
+	const uint8 *data = (const uint8*) &store;
+	uint32 hash = 2166136261UL;
+	for(uint16 i = 0; i < sizeof(CREDENTIAL_STORE) - sizeof(store.checksum); ++i){
+		hash ^= data[i];
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _SsidString
+ * Description	:  Null terminated copy of an ssid for logs, a 32 byte ssid fills its
+ * 				   array without a terminator. Copy is overwritten by next call
+ * Parameters	:  iSsid -- ssid
+ * 				   iSsidLength -- ssid length
+ * Return		:  terminated ssid
+ ******************************************************************************************/
+char* ICACHE_FLASH_ATTR _SsidString(const uint8 *iSsid, uint8 iSsidLength){
+	static char ssid[33];
+	if(iSsidLength > 32) iSsidLength = 32;
+	os_memcpy(ssid, iSsid, iSsidLength);
+	ssid[iSsidLength] = '\0';
+	return ssid;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _FindCredential
+ * Description	:  Finds known AP by ssid
+ * Parameters	:  iSsid -- ssid
+ * 				   iSsidLength -- ssid length
+ * Return		:  index of known AP, -1 if unknown
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR _FindCredential(const uint8 *iSsid, uint8 iSsidLength){
+	for(uint8 i = 0; i < store.count; ++i){
+		if(store.aps[i].ssid_len == iSsidLength && os_memcmp(store.aps[i].ssid, iSsid, iSsidLength) == 0) return i;
+	}
+	return -1;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _MostRecentCredential
+ * Description	:  Finds known AP that was joined last
+ * Return		:  index of known AP, -1 if store is empty
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR _MostRecentCredential(void){
+	sint8 recent = -1;
+	for(uint8 i = 0; i < store.count; ++i){
+		if(recent < 0 || store.aps[i].lastUsed > store.aps[recent].lastUsed) recent = i;
+	}
+	return recent;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitCredentials
+ * Description	:  Loads known AP's from flash
+ * Return		:  number of known AP's
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR InitCredentials(void){
+	bool ret = system_param_load(CREDENTIALS_SECTOR, 0, &store, sizeof(CREDENTIAL_STORE));
+	LOG_DEBUG(CREDENTIALS, "load store, ret : %d", ret);
+
+	if(!ret || store.magic != CREDENTIALS_MAGIC || store.version != CREDENTIALS_VERSION ||
+			store.count > CREDENTIALS_MAX || store.checksum != _CredentialsChecksum()){
+		LOG_INFO(CREDENTIALS, "no valid store in flash, starting empty");
+		os_memset(&store, 0, sizeof(CREDENTIAL_STORE));
+		store.magic = CREDENTIALS_MAGIC;
+		store.version = CREDENTIALS_VERSION;
+	}
+
+	LOG_INFO(CREDENTIALS, "%d known AP's", store.count);
+	return store.count;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  CredentialCount
+ * Description	:  Number of known AP's
+ * Return		:  number of known AP's
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR CredentialCount(void){
+	return store.count;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  SaveCredential
+ * Description	:  Adds or updates a known AP and marks it most recently used, flash is
+ * 				   written when an AP is added or replaced or its password changed
+ * Parameters	:  iAP -- AP that was joined
+ * Return		:  bool, true if store is up to date (rejoin: in RAM),
+ * 						 false if write failed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR SaveCredential(const AP_Info *iAP){
+	if(iAP->ssid_len == 0 || iAP->ssid_len > sizeof(store.aps[0].ssid)) return false;
+
+	KNOWN_AP entry;
+	os_memset(&entry, 0, sizeof(KNOWN_AP));
+	os_memcpy(entry.ssid, iAP->ssid, iAP->ssid_len);
+	entry.ssid_len = iAP->ssid_len;
+	os_memcpy(entry.password, iAP->password, sizeof(entry.password));
+	if(iAP->bssid_set){
+		os_memcpy(entry.bssid, iAP->bssid, sizeof(entry.bssid));
+		entry.channel = iAP->channel;
+	}
+
+	sint8 slot = _FindCredential(entry.ssid, entry.ssid_len);
+	bool changed = true;
+	if(slot >= 0){
+		changed = os_memcmp(entry.password, store.aps[slot].password, sizeof(entry.password)) != 0;
+	}
+	else if(store.count < CREDENTIALS_MAX){
+		slot = store.count++;
+	}
+	else{
+		//replace least recently used
+		slot = 0;
+		for(uint8 i = 1; i < store.count; ++i){
+			if(store.aps[i].lastUsed < store.aps[slot].lastUsed) slot = i;
+		}
+		LOG_WARN(CREDENTIALS, "store full, replacing %s", _SsidString(store.aps[slot].ssid, store.aps[slot].ssid_len));
+	}
+
+	entry.lastUsed = ++store.sequence;
+	store.aps[slot] = entry;
+
+	//rejoin with same password: recency and BSS stay in RAM and reach flash with the next
+	//real change, roaming and reconnects do not wear flash
+	if(!changed){
+		LOG_DEBUG(CREDENTIALS, "%s rejoined, flash not written", _SsidString(entry.ssid, entry.ssid_len));
+		return true;
+	}
+	store.checksum = _CredentialsChecksum();
+
+	bool ret = system_param_save_with_protect(CREDENTIALS_SECTOR, &store, sizeof(CREDENTIAL_STORE));
+	LOG_INFO(CREDENTIALS, "saved %s in slot %d, ret : %d", _SsidString(entry.ssid, entry.ssid_len), slot, ret);
+	return ret;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  SelectCredential
+ * Description	:  Picks known AP to join from a scan list
+ * Parameters	:  iScanned -- scan list (one entry per ssid)
+ * 				   iCount -- scan list length
+ * 				   iCurrent -- BSS currently joined (bssid and rssi), NULL if not connected
+ * 				   oAP -- AP to join
+ * Return		:  index of known AP chosen, -1 if none
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR SelectCredential(const AP_Info *iScanned, uint8 iCount, const AP_Info *iCurrent, AP_Info *oAP){
+	sint8 recent = _MostRecentCredential();
+	sint8 best = -1, bestKnown = -1;
+	sint16 bestScore = 0;
+
+	for(uint8 i = 0; i < iCount; ++i){
+		if(iScanned[i].rssi < CREDENTIALS_MIN_RSSI) continue;
+		sint8 known = _FindCredential(iScanned[i].ssid, iScanned[i].ssid_len);
+		if(known < 0) continue;
+
+		sint16 score = iScanned[i].rssi + (known == recent ? CREDENTIALS_PREFER_RECENT : 0);
+		if(best < 0 || score > bestScore){
+			best = i;
+			bestKnown = known;
+			bestScore = score;
+		}
+	}
+	if(best < 0) return -1;
+
+	//roam only to another BSS that is clearly stronger
+	if(iCurrent != NULL){
+		if(os_memcmp(iScanned[best].bssid, iCurrent->bssid, sizeof(iCurrent->bssid)) == 0) return -1;
+		if(iScanned[best].rssi < iCurrent->rssi + CREDENTIALS_ROAM_MARGIN) return -1;
+	}
+	LOG_INFO(CREDENTIALS, "selected %s, rssi %d", _SsidString(iScanned[best].ssid, iScanned[best].ssid_len), iScanned[best].rssi);
+
+	*oAP = iScanned[best];
+	os_memcpy(oAP->password, store.aps[bestKnown].password, sizeof(oAP->password));
+	return bestKnown;
+}
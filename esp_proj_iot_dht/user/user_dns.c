@@ -0,0 +1,182 @@
+/*
+ * user_dns.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_dns.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+#include "espconn.h"
+
+//user includes
+#include "user_log.h"
+
+//DNS message layout (RFC 1035 4.1)
+#define DNS_HEADER_SIZE			12
+#define DNS_ANSWER_SIZE			16		//name pointer, type, class, ttl, rdlength, ipv4 address
+#define DNS_MAX_NAME			255
+#define DNS_MAX_LABEL			63
+
+#define DNS_FLAG_QR				0x80	//first flags byte
+#define DNS_FLAG_OPCODE			0x78
+#define DNS_FLAG_AA				0x04
+#define DNS_FLAG_RD				0x01
+#define DNS_FLAG_RA				0x80	//second flags byte
+
+#define DNS_TYPE_A				1
+#define DNS_TYPE_ANY			255
+#define DNS_CLASS_IN			1
+
+//static placeholders
+static struct espconn dnsEspconn;
+static esp_udp dnsUdp;
+static uint8 dnsPacket[CAPTIVE_DNS_MAX_PACKET];		//query is turned into response here
+static bool dnsRunning = false;
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _PutUint16
+ * Description	:  Writes a 16 bit value in network byte order
+ * Parameters	:  oPacket -- output
+ * 				   iValue -- value
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _PutUint16(uint8 *oPacket, uint16 iValue){
+	oPacket[0] = iValue >> 8;
+	oPacket[1] = iValue & 0xFF;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  CaptiveDNSResponse
+ * Description	:  Turns a DNS query into its response in place
+ * Parameters	:  ioPacket -- query, overwritten with response
+ * 				   iLength -- query length
+ * 				   iSize -- size of packet buffer
+ * 				   iAddress -- address to answer with
+ * Return		:  response length, 0 if packet is not a query that can be answered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR CaptiveDNSResponse(uint8 *ioPacket, uint16 iLength, uint16 iSize, const uint8 iAddress[4]){
+	if(ioPacket == NULL || iLength < DNS_HEADER_SIZE || iLength > iSize) return 0;
+
+	//standard query with exactly one question
+	if((ioPacket[2] & (DNS_FLAG_QR | DNS_FLAG_OPCODE)) != 0) return 0;
+	if(ioPacket[4] != 0 || ioPacket[5] != 1) return 0;
+
+	//walk question name, labels only (queries carry no compression pointers)
+	uint16 offset = DNS_HEADER_SIZE;
+	uint16 nameLength = 0;
+	while(true){
+		if(offset >= iLength) return 0;
+		uint8 label = ioPacket[offset];
+		if(label == 0) break;
+		if(label > DNS_MAX_LABEL) return 0;
+
+		nameLength += label + 1;
+		if(nameLength > DNS_MAX_NAME) return 0;
+		offset += label + 1;
+	}
+	++offset;
+
+	//question type and class
+	if(offset + 4 > iLength) return 0;
+	uint16 type = (ioPacket[offset] << 8) | ioPacket[offset + 1];
+	uint16 qclass = (ioPacket[offset + 2] << 8) | ioPacket[offset + 3];
+	offset += 4;
+
+	bool answer = (qclass == DNS_CLASS_IN && (type == DNS_TYPE_A || type == DNS_TYPE_ANY));
+	if(answer && offset + DNS_ANSWER_SIZE > iSize) return 0;
+	LOG_DEBUG(DNS, "query type %d, class %d, answered : %d", type, qclass, answer);
+
+	//response header, id and recursion desired are kept, other records (EDNS) dropped
+	ioPacket[2] = DNS_FLAG_QR | DNS_FLAG_AA | (ioPacket[2] & DNS_FLAG_RD);
+	ioPacket[3] = DNS_FLAG_RA;
+	_PutUint16(ioPacket + 6, answer ? 1 : 0);
+	_PutUint16(ioPacket + 8, 0);
+	_PutUint16(ioPacket + 10, 0);
+	if(!answer) return offset;
+
+	//answer, name points back to question name at offset 12
+	uint8 *record = ioPacket + offset;
+	_PutUint16(record, 0xC000 | DNS_HEADER_SIZE);
+	_PutUint16(record + 2, DNS_TYPE_A);
+	_PutUint16(record + 4, DNS_CLASS_IN);
+	_PutUint16(record + 6, 0);
+	_PutUint16(record + 8, CAPTIVE_DNS_TTL);
+	_PutUint16(record + 10, 4);
+	record[12] = iAddress[0];
+	record[13] = iAddress[1];
+	record[14] = iAddress[2];
+	record[15] = iAddress[3];
+	return offset + DNS_ANSWER_SIZE;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _DNS_recv
+ * Description	:  Callback when a DNS query is received, answers with SoftAP address
+ * Parameters	:  arg -- espconn obj
+ * 				   pdata -- received query
+ * 				   len -- query length
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _DNS_recv(void *arg, char *pdata, unsigned short len){
+	struct espconn *pesp_conn = arg;
+	if(pdata == NULL || len > CAPTIVE_DNS_MAX_PACKET) return;
+
+	//no answer pointing nowhere while SoftAP has no address
+	struct ip_info info;
+	if(!wifi_get_ip_info(SOFTAP_IF, &info) || info.ip.addr == 0) return;
+
+	os_memcpy(dnsPacket, pdata, len);
+	uint16 length = CaptiveDNSResponse(dnsPacket, len, CAPTIVE_DNS_MAX_PACKET, (uint8*) &info.ip.addr);
+	if(length == 0){
+		LOG_DEBUG(DNS, "not a query, dropped");
+		return;
+	}
+
+	//reply to sender of this datagram
+	remot_info *remote = NULL;
+	if(espconn_get_connection_info(pesp_conn, &remote, 0) != ESPCONN_OK) return;
+	os_memcpy(pesp_conn->proto.udp->remote_ip, remote->remote_ip, 4);
+	pesp_conn->proto.udp->remote_port = remote->remote_port;
+
+	sint8 ret = espconn_sendto(pesp_conn, dnsPacket, length);
+	LOG_DEBUG(DNS, "answer sent to " IPSTR ":%d, ret : %d", IP2STR(remote->remote_ip), remote->remote_port, ret);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StartCaptiveDNS
+ * Description	:  Starts DNS responder on SoftAP
+ * Return		:  0 if successful, else failed
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR StartCaptiveDNS(void){
+	if(dnsRunning) return ESPCONN_OK;
+
+	dnsEspconn.type = ESPCONN_UDP;
+	dnsEspconn.state = ESPCONN_NONE;
+	dnsEspconn.proto.udp = &dnsUdp;
+	dnsEspconn.proto.udp->local_port = CAPTIVE_DNS_PORT;
+
+	espconn_regist_recvcb(&dnsEspconn, _DNS_recv);
+	sint8 ret = espconn_create(&dnsEspconn);
+	LOG_DEBUG(DNS, "captive DNS started on port %d, ret : %d", CAPTIVE_DNS_PORT, ret);
+
+	if(ret == ESPCONN_OK) dnsRunning = true;
+	return ret;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StopCaptiveDNS
+ * Description	:  Stops DNS responder
+ * Return		:  0 if successful, else failed
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR StopCaptiveDNS(void){
+	if(!dnsRunning) return ESPCONN_OK;
+
+	sint8 ret = espconn_delete(&dnsEspconn);
+	LOG_DEBUG(DNS, "captive DNS stopped, ret : %d", ret);
+	dnsRunning = false;
+	return ret;
+}
@@ -16,50 +16,483 @@
 //user includes
 #include "user_webpage.h"
 #include "user_wifi.h"
+#include "user_samples.h"
+#include "user_metrics.h"
+#include "user_trace.h"
+#include "user_link.h"
+#include "user_timer.h"
+#include "user_bus.h"
+#include "user_log.h"
 
 //driver libs
 #include "driver/http.h"
 
 #define ASSERT_N_SKIP(var, condition, label)	if(var != condition) goto label
 
-//Set-Up Debugging Macros
-#ifndef ESP_ESPCONN_LOGGER
-	#define ESPCONN_DEBUG(message)					do {} while(0)
-	#define ESPCONN_DEBUG_ARGS(message, args...)	do {} while(0)
-#else
-	#define ESPCONN_DEBUG(message)					do {os_printf("[ESPCONN-DEBUG] %s", message); os_printf("\r\n");} while(0)
-	#define ESPCONN_DEBUG_ARGS(message, args...)	do {os_printf("[ESPCONN-DEBUG] "); os_printf(message, args); os_printf("\r\n");} while(0)
-#endif
+//route of request is the literal route, os_strncmp over routeLength alone also takes its prefixes ("api" as "api/scan")
+#define ROUTE_IS(request, route)	((request).routeLength == sizeof(route) - 1 && \
+										os_strncmp((request).routePath, route, sizeof(route) - 1) == 0)
+
+//local server connection context, connections are identified by remote ip and port
+typedef struct httpConnection{
+	bool inUse;
+	struct espconn *pespconn;
+	uint8 remote_ip[4];
+	int remote_port;
+	uint32 openedAt;				//system_get_time() when connection was accepted
+	uint32 lastActivity;			//system_get_time() of last data received or sent
+	uint8 requestCount;				//requests served on this connection
+	bool closeAfterSent;			//disconnect once current response is sent
+	bool subscriber;				//Server-Sent Events subscriber (events)
+	uint8 missedFrames;				//frames skipped because of pending send
+
+	//parse state, start of a request split over TCP segments
+	char rxBuffer[HTTP_RX_BUFFER_SIZE + 1];
+	uint16 rxLength;
+
+	//output queue, txQueue[txHead] is being sent and is freed once it is
+	char *txQueue[HTTP_TX_QUEUE_LENGTH];
+	uint16 txLength[HTTP_TX_QUEUE_LENGTH];
+	uint8 txHead;
+	uint8 txCount;
+
+	//chunked response being streamed, next chunk is rendered once queue has room
+	HTTP_CHUNK_WRITER chunkWriter;
+	uint16 chunkCursor;
+} HTTP_CONNECTION;
+
+//connection without context to be disconnected, its espconn may be gone when bus runs
+typedef struct httpDrop{
+	uint8 remote_ip[4];
+	int remote_port;
+} HTTP_DROP;
+
+//Server-Sent Events frame buffer size
+#define SSE_FRAME_SIZE		(SAMPLE_JSON_SIZE + 48)
 
 //static placeholders
-static os_event_t taskQueue[1] = {0};
+static HTTP_CONNECTION *httpConnections = NULL;		//pool of HTTP_MAX_CONNECTIONS, allocated at init
+static HTTP_DROP httpDrops[HTTP_DROP_SLOTS];			//ring, slot is posted with BUS_SERVER_DROP
+static uint8 httpDropNext = 0;
+
+//local server (listener)
 static struct espconn espconn;
 static esp_tcp espTcp;
-static ip_addr_t server_ip;
-
-static bool sendData = false;
+static bool serverListening = false;
+static TIMER_ID sseTimer = TIMER_NONE;
+
+//connectivity checks of common OSes, redirected to the portal page so the OS opens its
+//captive portal sheet right away (captive DNS sends every name to this server). Only
+//while SoftAP is up, in station mode they are unknown routes.
+static const char * const captivePortalRoutes[] = {
+	"generate_204",					//Android
+	"gen_204",
+	"hotspot-detect.html",			//Apple
+	"library/test/success.html",
+	"connecttest.txt",				//Windows
+	"ncsi.txt",
+	"redirect",
+	"success.txt",					//Firefox
+	"canonical.html",				//Ubuntu
+	"check_network_status.txt"		//Kindle
+};
+
+//remote server client
+static struct espconn clientEspconn;
+static esp_tcp clientTcp;
+static char clientData[COLLECTOR_DATA_SIZE];
+static uint16 clientDataLength = 0;
+static bool clientBusy = false;
 
 /******** Function Definitions ********/
 
 /***************************************************************************************
- * FunctionName	:  _UserTasks
- * Description	:  User task function callback for disconnecting TCP connection.
- * Parameters	:  event -- user task event
+ * FunctionName	:  _ESPConn_Event
+ * Description	:  Bus callback for deleting listener and disconnecting TCP connections,
+ * 				   espconn_disconnect must not be called from espconn callbacks.
+ * Parameters	:  iEvent -- BUS_SERVER_DELETE, BUS_SERVER_CLOSE, BUS_SERVER_DROP or
+ * 				   			 BUS_CLIENT_CLOSE
+ * 				   iParam -- connection of BUS_SERVER_CLOSE, drop slot of BUS_SERVER_DROP
  **************************************************************************************/
-void ICACHE_FLASH_ATTR _UserTasks(os_event_t *event){
-	ESPCONN_DEBUG_ARGS("Inside espconn user task, event : %d", event->sig);
+void ICACHE_FLASH_ATTR _ESPConn_Event(BUS_EVENT iEvent, uint32 iParam){
+	LOG_DEBUG(ESPCONN, "Inside espconn bus callback, event : %d", iEvent);
 
 	sint8 ret = false;
-	switch (event->sig) {
-	case 0:
+	switch (iEvent) {
+	case BUS_SERVER_DELETE:
 		ret = espconn_delete(&espconn);
-		ESPCONN_DEBUG_ARGS("espconn_delete : %d", ret);
+		LOG_DEBUG(ESPCONN, "espconn_delete : %d", ret);
+		break;
+	case BUS_SERVER_CLOSE:
+		if(iParam < HTTP_MAX_CONNECTIONS && httpConnections[iParam].inUse &&
+				httpConnections[iParam].closeAfterSent){
+			ret = espconn_disconnect(httpConnections[iParam].pespconn);
+			LOG_DEBUG(ESPCONN, "espconn_disconnect : %d", ret);
+		}
+		break;
+	case BUS_SERVER_DROP:
+		//listener with a remote ip:port makes SDK look that connection up among its active ones,
+		//one closed by client meanwhile is not found and refused
+		if(iParam < HTTP_DROP_SLOTS){
+			os_memcpy(espTcp.remote_ip, httpDrops[iParam].remote_ip, 4);
+			espTcp.remote_port = httpDrops[iParam].remote_port;
+			ret = espconn_disconnect(&espconn);
+			LOG_DEBUG(ESPCONN, "espconn_disconnect without context : %d", ret);
+		}
+		break;
+	case BUS_CLIENT_CLOSE:
+		ret = espconn_disconnect(&clientEspconn);
+		LOG_DEBUG(ESPCONN, "client espconn_disconnect : %d", ret);
 		break;
 	default:
 		break;
 	}
 }
 
+/***************************************************************************************
+ * FunctionName	:  _FindConnection
+ * Description	:  Finds local server connection state of a TCP connection
+ * Parameters	:  pesp_conn -- espconn obj
+ * Return		:  connection state, NULL if not found
+ **************************************************************************************/
+HTTP_CONNECTION* ICACHE_FLASH_ATTR _FindConnection(struct espconn *pesp_conn){
+	if(httpConnections == NULL) return NULL;
+	for(uint8 i = 0; i < HTTP_MAX_CONNECTIONS; ++i){
+		if(httpConnections[i].inUse &&
+				httpConnections[i].remote_port == pesp_conn->proto.tcp->remote_port &&
+				os_memcmp(httpConnections[i].remote_ip, pesp_conn->proto.tcp->remote_ip, 4) == 0){
+			return &httpConnections[i];
+		}
+	}
+	return NULL;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _OpenConnection
+ * Description	:  Allocates local server connection state for a new TCP connection
+ * Parameters	:  pesp_conn -- espconn obj
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _OpenConnection(struct espconn *pesp_conn){
+	if(httpConnections == NULL || _FindConnection(pesp_conn) != NULL) return;
+
+	for(uint8 i = 0; i < HTTP_MAX_CONNECTIONS; ++i){
+		if(!httpConnections[i].inUse){
+			HTTP_CONNECTION *connection = &httpConnections[i];
+			connection->inUse = true;
+			connection->pespconn = pesp_conn;
+			os_memcpy(connection->remote_ip, pesp_conn->proto.tcp->remote_ip, 4);
+			connection->remote_port = pesp_conn->proto.tcp->remote_port;
+			connection->openedAt = system_get_time();
+			connection->lastActivity = connection->openedAt;
+			connection->requestCount = 0;
+			connection->closeAfterSent = false;
+			connection->subscriber = false;
+			connection->missedFrames = 0;
+			connection->rxLength = 0;
+			connection->txHead = 0;
+			connection->txCount = 0;
+			connection->chunkWriter = NULL;
+			LOG_DEBUG(ESPCONN, "connection %d opened", i);
+			return;
+		}
+	}
+	LOG_WARN(ESPCONN, "no free connection context, connection gets one response and is closed");
+}
+
+/***************************************************************************************
+ * FunctionName	:  _DropConnection
+ * Description	:  Posts disconnect of a connection without context by its remote ip:port,
+ * 				   SDK may free its espconn before bus runs. A slot reused before that
+ * 				   loses its drop, SDK server timeout closes that connection.
+ * Parameters	:  pesp_conn -- espconn obj
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _DropConnection(struct espconn *pesp_conn){
+	uint8 slot = httpDropNext;
+	httpDropNext = (httpDropNext + 1) % HTTP_DROP_SLOTS;
+	os_memcpy(httpDrops[slot].remote_ip, pesp_conn->proto.tcp->remote_ip, 4);
+	httpDrops[slot].remote_port = pesp_conn->proto.tcp->remote_port;
+	BusPost(BUS_SERVER_DROP, slot);
+}
+
+/***************************************************************************************
+ * FunctionName	:  _ConnectionSendHead
+ * Description	:  Sends packet at head of connection's output queue. Packets that fail
+ * 				   to send are dropped.
+ * Parameters	:  connection -- connection context
+ * Return		:  bool, true if a packet is being sent
+ **************************************************************************************/
+bool ICACHE_FLASH_ATTR _ConnectionSendHead(HTTP_CONNECTION *connection){
+	while(connection->txCount > 0){
+		sint8 ret = espconn_send(connection->pespconn, connection->txQueue[connection->txHead],
+				connection->txLength[connection->txHead]);
+		if(ret == ESPCONN_OK) return true;
+
+		LOG_WARN(ESPCONN, "espconn_send failed : %d, packet dropped", ret);
+		os_free(connection->txQueue[connection->txHead]);
+		connection->txHead = (connection->txHead + 1) % HTTP_TX_QUEUE_LENGTH;
+		connection->txCount--;
+	}
+	return false;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _ConnectionSend
+ * Description	:  Queues a packet on connection's output queue, it is sent right away
+ * 				   if nothing else is being sent.
+ * Parameters	:  connection -- connection context
+ * 				   iPacket -- packet (os_malloc'ed, owned by queue from now on)
+ * 				   iLength -- packet length
+ * Return		:  bool, true if packet is queued
+ * 						 false if queue is full or send failed (packet is freed)
+ **************************************************************************************/
+bool ICACHE_FLASH_ATTR _ConnectionSend(HTTP_CONNECTION *connection, char *iPacket, uint16 iLength){
+	if(connection->txCount >= HTTP_TX_QUEUE_LENGTH){
+		LOG_WARN(ESPCONN, "output queue full, packet dropped");
+		os_free(iPacket);
+		return false;
+	}
+	uint8 tail = (connection->txHead + connection->txCount) % HTTP_TX_QUEUE_LENGTH;
+	connection->txQueue[tail] = iPacket;
+	connection->txLength[tail] = iLength;
+	connection->txCount++;
+
+	//queued behind packet being sent, goes out from sent callback
+	if(connection->txCount > 1) return true;
+	return _ConnectionSendHead(connection);
+}
+
+/***************************************************************************************
+ * FunctionName	:  _ConnectionStream
+ * Description	:  Renders and queues next chunk of connection's chunked response, if
+ * 				   output queue has room
+ * Parameters	:  connection -- connection context
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _ConnectionStream(HTTP_CONNECTION *connection){
+	if(connection->chunkWriter == NULL || connection->txCount >= HTTP_TX_QUEUE_LENGTH) return;
+
+	char *packet = NULL;
+	bool last = false;
+	uint16 length = buildHttpChunk(connection->chunkWriter, &connection->chunkCursor, &packet, &last);
+	if(last || length == 0) connection->chunkWriter = NULL;
+
+	//a cut chunked response can only be told apart by closing connection
+	if(length == 0 || !_ConnectionSend(connection, packet, length)){
+		LOG_DEBUG(ESPCONN, "chunked response cut, connection closed");
+		connection->chunkWriter = NULL;
+		connection->closeAfterSent = true;
+		if(connection->txCount == 0)
+			BusPost(BUS_SERVER_CLOSE, connection - httpConnections);
+	}
+}
+
+/***************************************************************************************
+ * FunctionName	:  _ConnectionSent
+ * Description	:  Releases packet at head of output queue once it is sent and sends
+ * 				   next one.
+ * Parameters	:  connection -- connection context
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _ConnectionSent(HTTP_CONNECTION *connection){
+	connection->lastActivity = system_get_time();
+	if(connection->txCount == 0) return;
+
+	os_free(connection->txQueue[connection->txHead]);
+	connection->txHead = (connection->txHead + 1) % HTTP_TX_QUEUE_LENGTH;
+	connection->txCount--;
+	_ConnectionSendHead(connection);
+	_ConnectionStream(connection);
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SendResponse
+ * Description	:  Renders HTTP response and queues it on connection
+ * Parameters	:  pesp_conn -- espconn obj
+ * 				   iResponse -- HTTP response obj
+ * Return		:  bool, true if successful
+ **************************************************************************************/
+bool ICACHE_FLASH_ATTR _SendResponse(struct espconn *pesp_conn, HTTP_RESPONSE_PACKET *iResponse){
+	HTTP_CONNECTION *connection = _FindConnection(pesp_conn);
+	if(connection == NULL) return sendHttpResponse(pesp_conn, iResponse);
+
+	char *packet = NULL;
+	uint16 length = buildHttpResponse(iResponse, &packet);
+	if(length == 0) return false;
+	MetricsSampleHeap();
+	if(!_ConnectionSend(connection, packet, length)) return false;
+
+	//headers are out, content follows chunk by chunk
+	if(iResponse->chunkWriter != NULL){
+		connection->chunkWriter = iResponse->chunkWriter;
+		connection->chunkCursor = 0;
+		_ConnectionStream(connection);
+	}
+	return true;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SubscriberCount
+ * Description	:  Counts Server-Sent Events subscribers
+ * Return		:  number of subscribers
+ **************************************************************************************/
+uint8 ICACHE_FLASH_ATTR _SubscriberCount(void){
+	uint8 count = 0;
+	for(uint8 i = 0; i < HTTP_MAX_CONNECTIONS; ++i){
+		if(httpConnections[i].inUse && httpConnections[i].subscriber) ++count;
+	}
+	return count;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _RenderSampleEvent
+ * Description	:  Renders latest sample as Server-Sent Events frame
+ * Parameters	:  oFrame -- output buffer (SSE_FRAME_SIZE)
+ * Return		:  length of frame, 0 if no sample is taken yet
+ **************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _RenderSampleEvent(char *oFrame){
+	uint16 length = os_sprintf(oFrame, "id: %u\nevent: reading\ndata: ", GetSampleCount());
+	uint16 jsonLength = GetLatestSampleJSON(oFrame + length, SSE_FRAME_SIZE - length - 3);
+	if(jsonLength == 0) return 0;
+	length += jsonLength;
+	length += os_sprintf(oFrame + length, "\n\n");
+	return length;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SendEvent
+ * Description	:  Sends a frame to Server-Sent Events subscriber. A subscriber that has
+ * 				   not taken previous frames is skipped, and dropped after SSE_MAX_MISSED
+ * 				   frames, rather than queuing frames for it.
+ * Parameters	:  connection -- subscriber
+ * 				   iFrame -- frame
+ * 				   iLength -- frame length
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _SendEvent(HTTP_CONNECTION *connection, char *iFrame, uint16 iLength){
+	bool drop = false;
+	if(connection->txCount > 0){
+		drop = ++connection->missedFrames >= SSE_MAX_MISSED;
+	}
+	else{
+		char *packet = (char*) os_malloc(iLength);
+		if(packet != NULL){
+			os_memcpy(packet, iFrame, iLength);
+			if(_ConnectionSend(connection, packet, iLength)) connection->missedFrames = 0;
+			else drop = true;
+		}
+		else drop = true;
+	}
+
+	if(drop && !connection->closeAfterSent){
+		LOG_DEBUG(ESPCONN, "slow subscriber dropped");
+		connection->closeAfterSent = true;
+		BusPost(BUS_SERVER_CLOSE, connection - httpConnections);
+	}
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SSE_Heartbeat
+ * Description	:  Timer callback, sends heartbeat comment to Server-Sent Events
+ * 				   subscribers so idle connections are kept (and dead ones detected)
+ * Parameters	:  arg -- unused
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _SSE_Heartbeat(void *arg){
+	char heartbeat[] = ":\n\n";
+	for(uint8 i = 0; i < HTTP_MAX_CONNECTIONS; ++i){
+		if(httpConnections[i].inUse && httpConnections[i].subscriber && !httpConnections[i].closeAfterSent)
+			_SendEvent(&httpConnections[i], heartbeat, sizeof(heartbeat) - 1);
+	}
+}
+
+/***************************************************************************************
+ * FunctionName	:  _CloseConnection
+ * Description	:  Releases local server connection state of a TCP connection
+ * Parameters	:  pesp_conn -- espconn obj
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _CloseConnection(struct espconn *pesp_conn){
+	HTTP_CONNECTION *connection = _FindConnection(pesp_conn);
+	if(connection != NULL){
+		LOG_DEBUG(ESPCONN, "connection closed after %d requests, %u ms", connection->requestCount,
+				(system_get_time() - connection->openedAt) / 1000);
+		connection->inUse = false;
+
+		//connection is gone, drop unsent responses
+		while(connection->txCount > 0){
+			os_free(connection->txQueue[connection->txHead]);
+			connection->txHead = (connection->txHead + 1) % HTTP_TX_QUEUE_LENGTH;
+			connection->txCount--;
+		}
+		if(connection->subscriber && _SubscriberCount() == 0) DisarmTimer(sseTimer);
+	}
+}
+
+/***************************************************************************************
+ * FunctionName	:  _IsCaptivePortalRoute
+ * Description	:  Checks if route is an OS connectivity check (captivePortalRoutes) to be
+ * 				   redirected, which is only while SoftAP is up and has an address
+ * Parameters	:  iRoutePath -- route path
+ * 				   iRouteLength -- route path length
+ * 				   oPortal -- SoftAP address of portal page
+ * Return		:  bool, true if route is a connectivity check and SoftAP is up
+ **************************************************************************************/
+bool ICACHE_FLASH_ATTR _IsCaptivePortalRoute(char *iRoutePath, uint16 iRouteLength, struct ip_info *oPortal){
+	if(!(wifi_get_opmode() & SOFTAP_MODE) || !wifi_get_ip_info(SOFTAP_IF, oPortal) || oPortal->ip.addr == 0) return false;
+
+	for(uint8 i = 0; i < sizeof(captivePortalRoutes) / sizeof(captivePortalRoutes[0]); ++i){
+		if(os_strlen(captivePortalRoutes[i]) == iRouteLength &&
+				os_strncmp(iRoutePath, captivePortalRoutes[i], iRouteLength) == 0) return true;
+	}
+	return false;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SetConnectionResponse
+ * Description	:  Decides whether connection is kept alive after this response. Closes
+ * 				   it when client asks to, or when request cap of connection is reached.
+ * Parameters	:  oResponse -- HTTP response obj
+ * 				   pesp_conn -- espconn obj
+ * 				   iRequest -- processed HTTP request obj
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _SetConnectionResponse(HTTP_RESPONSE_PACKET *oResponse, struct espconn *pesp_conn, HTTP_REQUEST_PACKET *iRequest){
+	HTTP_CONNECTION *connection = _FindConnection(pesp_conn);
+	oResponse->connection = Closed;
+	oResponse->keepAliveMax = 0;
+	if(connection != NULL){
+		connection->requestCount++;
+		if(iRequest->connection == Keep_Alive && connection->requestCount < HTTP_KEEPALIVE_MAX_REQUESTS){
+			oResponse->connection = Keep_Alive;
+			oResponse->keepAliveMax = HTTP_KEEPALIVE_MAX_REQUESTS - connection->requestCount;
+		}
+		else{
+			connection->closeAfterSent = true;
+		}
+	}
+}
+
+/***************************************************************************************
+ * FunctionName	:  _SetAssetResponse
+ * Description	:  Fills HTTP response with a flash resident web asset, gzip compressed
+ * 				   if client supports it.
+ * Parameters	:  oResponse -- HTTP response obj
+ * 				   iAsset -- web asset
+ * 				   iAcceptGzip -- client accepts gzip content encoding
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _SetAssetResponse(HTTP_RESPONSE_PACKET *oResponse, const WEB_ASSET *iAsset, bool iAcceptGzip){
+	oResponse->httpStatusCode = HTTP_OK;
+	oResponse->contentType = iAsset->contentType;
+	oResponse->contentInFlash = true;
+	oResponse->etag = iAsset->etag;
+	oResponse->etagType = etag_strong;
+	oResponse->cacheControl = cache_static;
+	if(iAcceptGzip){
+		oResponse->content = (char*) iAsset->gzipContent;
+		oResponse->contentLength = iAsset->gzipContentLength;
+		oResponse->contentEncoding = encoding_gzip;
+	}
+	else{
+		oResponse->content = (char*) iAsset->content;
+		oResponse->contentLength = iAsset->contentLength;
+		oResponse->contentEncoding = encoding_identity;
+	}
+}
+
 /***************************************************************************************
  * FunctionName	:  _processHttpData
  * Description	:  process received HTTP data
@@ -67,13 +500,15 @@ void ICACHE_FLASH_ATTR _UserTasks(os_event_t *event){
  * 				   pdata -- received data
  * 				   len -- received data length
  * 				   iMsgType -- HTTP message type
+ * Return		:  bool, true if a response was sent
  **************************************************************************************/
-void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short len, HTTP_MESSAGE_TYPE iMsgType){
+bool ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short len, HTTP_MESSAGE_TYPE iMsgType){
 	bool ret = false;
+	bool responded = false;
 	struct espconn *pesp_conn = arg;
 
 	if(iMsgType == HTTP_REQUEST){
-		ESPCONN_DEBUG("It is HTTP Request");
+		LOG_DEBUG(ESPCONN, "It is HTTP Request");
 
 		//initialize HTTP obj
 		HTTP_REQUEST_PACKET httpRequest;
@@ -81,43 +516,191 @@ void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short l
 		httpRequest.routeLength = -1;
 		httpRequest.data = NULL;
 		httpRequest.dataLength = -1;
+		httpRequest.acceptGzip = false;
+		httpRequest.ifNoneMatch = NULL;
+		httpRequest.ifNoneMatchLength = 0;
 
 		//process http request
 		ret = processHttpRequest(pdata, len, &httpRequest);
 		ASSERT_N_SKIP(ret, true, SKIP_PROCESS);
 
 		if(httpRequest.httpMethod == HTTP_GET && httpRequest.routeLength > 0){
-			ESPCONN_DEBUG("HTTP request type : GET");
+			LOG_DEBUG(ESPCONN, "HTTP request type : GET");
 
-			#ifdef ESP_ESPCONN_LOGGER
+			if(LOG_ON(ESPCONN, DEBUG)){
 				//print route
-				char *routePath = (char*) os_zalloc(httpRequest.routeLength);
+				char *routePath = (char*) os_zalloc(httpRequest.routeLength + 1);
 				os_memcpy(routePath, httpRequest.routePath, httpRequest.routeLength);
-				ESPCONN_DEBUG_ARGS("HTTP Route path : %s", routePath);
+				LOG_DEBUG(ESPCONN, "HTTP Route path : %s", routePath);
 				os_free(routePath);
-			#endif
+			}
 
 			//send response based on route
 			HTTP_RESPONSE_PACKET responsePacket;
-			responsePacket.connection = Closed;
-
-			if(os_strncmp(httpRequest.routePath, "/", httpRequest.routeLength) == 0){
+			_SetConnectionResponse(&responsePacket, pesp_conn, &httpRequest);
+			responsePacket.contentEncoding = encoding_identity;
+			responsePacket.contentInFlash = false;
+			responsePacket.contentWriter = NULL;
+			responsePacket.chunkWriter = NULL;
+			responsePacket.location = NULL;
+			responsePacket.etagType = etag_none;
+			responsePacket.cacheControl = cache_none;
+
+			char *bundle = NULL;
+			HTTP_CONNECTION *subscriber = NULL;
+			char eventFrame[SSE_FRAME_SIZE + 16];
+			char portal[24];			//"http://" IPSTR "/"
+			struct ip_info softAP;			//address of portal page
+			bool validated = false;			//If-None-Match checked already
+
+#ifdef WEBPAGE_BUNDLED
+			if(ROUTE_IS(httpRequest, "/")){
+				//whole page in one response, separate assets stay available below for debugging
 				responsePacket.httpStatusCode = HTTP_OK;
-				responsePacket.content = GetWifi_AP_HTML();
-				responsePacket.contentLength = os_strlen(responsePacket.content);
+				responsePacket.content = "";
+				responsePacket.contentLength = 0;
 				responsePacket.contentType = text_html;
+				//changes whenever scan data changes
+				responsePacket.etag = GetWifi_AP_BundleETag();
+				responsePacket.etagType = etag_weak;
+				responsePacket.cacheControl = cache_no_cache;
+
+				//render only if client's copy is stale
+				validated = true;
+				if(!httpNotModified(&httpRequest, &responsePacket)){
+					uint16 bundleSize = GetWifi_AP_BundleSize(httpRequest.acceptGzip);
+					bundle = (char*) os_zalloc(bundleSize);
+					if(bundle != NULL){
+						responsePacket.content = bundle;
+						responsePacket.contentLength = GetWifi_AP_Bundle(bundle, bundleSize, httpRequest.acceptGzip);
+						if(httpRequest.acceptGzip) responsePacket.contentEncoding = encoding_gzip;
+					}
+					else{
+						//no heap for page, an empty 200 would be cached under its etag
+						LOG_WARN(ESPCONN, "no heap for %d byte page, 503 sent", bundleSize);
+						responsePacket.httpStatusCode = HTTP_Service_Unavailable;
+						responsePacket.etagType = etag_none;
+					}
+				}
+			}
+			else if(ROUTE_IS(httpRequest, "index.html")){
+				_SetAssetResponse(&responsePacket, GetWifi_AP_HTML(), httpRequest.acceptGzip);
 			}
-			else if(os_strncmp(httpRequest.routePath, "styles.css", httpRequest.routeLength) == 0){
+#else
+			if(ROUTE_IS(httpRequest, "/")){
+				_SetAssetResponse(&responsePacket, GetWifi_AP_HTML(), httpRequest.acceptGzip);
+			}
+#endif
+			else if(ROUTE_IS(httpRequest, "styles.css")){
+				_SetAssetResponse(&responsePacket, GetWifi_AP_CSS(), httpRequest.acceptGzip);
+			}
+			else if(ROUTE_IS(httpRequest, "script.js")){
+				_SetAssetResponse(&responsePacket, GetWifi_AP_JS(), httpRequest.acceptGzip);
+			}
+			else if(ROUTE_IS(httpRequest, "api/scan")){
 				responsePacket.httpStatusCode = HTTP_OK;
-				responsePacket.content = GetWifi_AP_CSS();
-				responsePacket.contentLength = os_strlen(responsePacket.content);
-				responsePacket.contentType = text_css;
+				responsePacket.content = NULL;
+				responsePacket.contentType = application_json;
+				//written straight into send buffer
+				responsePacket.contentWriter = GetWifi_AP_ScanJSON;
+				responsePacket.contentLength = GetWifi_AP_ScanJSON(NULL, 0);
+				//changes whenever scan data changes
+				responsePacket.etag = GetWifi_AP_DataETag();
+				responsePacket.etagType = etag_weak;
+				responsePacket.cacheControl = cache_no_cache;
+			}
+			else if(ROUTE_IS(httpRequest, "events")){
+				subscriber = _FindConnection(pesp_conn);
+				if(subscriber == NULL || subscriber->subscriber || _SubscriberCount() >= SSE_MAX_SUBSCRIBERS){
+					subscriber = NULL;
+					responsePacket.httpStatusCode = HTTP_Service_Unavailable;
+					responsePacket.content = "";
+					responsePacket.contentLength = 0;
+					responsePacket.contentType = text_html;
+				}
+				else{
+					//stream stays open regardless of keep-alive request cap
+					subscriber->subscriber = true;
+					subscriber->closeAfterSent = false;
+					responsePacket.connection = Keep_Alive;
+					responsePacket.httpStatusCode = HTTP_OK;
+					responsePacket.contentType = text_event_stream;
+					responsePacket.cacheControl = cache_no_cache;
+
+					//first frames : reconnect delay and latest sample
+					uint16 length = os_sprintf(eventFrame, "retry: %d\n\n", SSE_RETRY);
+					length += _RenderSampleEvent(eventFrame + length);
+					responsePacket.content = eventFrame;
+					responsePacket.contentLength = length;
+
+					espconn_regist_time(pesp_conn, SSE_IDLE_TIMEOUT, 1);
+					if(_SubscriberCount() == 1){
+						if(sseTimer == TIMER_NONE) sseTimer = CreateTimer(_SSE_Heartbeat, NULL);
+						ArmTimer(sseTimer, SSE_HEARTBEAT*1000, true);
+					}
+					LOG_DEBUG(ESPCONN, "events subscriber added, subscribers : %d", _SubscriberCount());
+				}
 			}
-			else if(os_strncmp(httpRequest.routePath, "script.js", httpRequest.routeLength) == 0){
+			else if(ROUTE_IS(httpRequest, "api/readings")){
+				//served from sample cache, never reads sensor
 				responsePacket.httpStatusCode = HTTP_OK;
-				responsePacket.content = GetWifi_AP_JS();
-				responsePacket.contentLength = os_strlen(responsePacket.content);
-				responsePacket.contentType = application_javascript;
+				responsePacket.content = NULL;
+				responsePacket.contentType = application_json;
+				responsePacket.contentWriter = GetSamplesJSON;
+				responsePacket.contentLength = GetSamplesJSON(NULL, 0);
+				responsePacket.cacheControl = cache_no_cache;
+			}
+			else if(_IsCaptivePortalRoute(httpRequest.routePath, httpRequest.routeLength, &softAP)){
+				//portal page is served on SoftAP address
+				os_sprintf(portal, "http://" IPSTR "/", IP2STR(&softAP.ip.addr));
+
+				responsePacket.httpStatusCode = HTTP_Found;
+				responsePacket.location = portal;
+				responsePacket.content = "";
+				responsePacket.contentLength = 0;
+				responsePacket.contentType = text_html;
+				responsePacket.cacheControl = cache_no_cache;
+				LOG_DEBUG(ESPCONN, "connectivity check redirected to %s", portal);
+			}
+			else if(ROUTE_IS(httpRequest, "api/trace")){
+				responsePacket.content = "";
+				responsePacket.contentLength = 0;
+				responsePacket.cacheControl = cache_no_cache;
+				//streamed over connection's output queue, needs a connection context
+				if(_FindConnection(pesp_conn) != NULL){
+					responsePacket.httpStatusCode = HTTP_OK;
+					responsePacket.contentType = application_json;
+					responsePacket.chunkWriter = GetTraceJSON;
+				}
+				else{
+					responsePacket.httpStatusCode = HTTP_Service_Unavailable;
+					responsePacket.contentType = text_html;
+					responsePacket.connection = Closed;
+				}
+			}
+			else if(ROUTE_IS(httpRequest, "api/log")){
+				responsePacket.httpStatusCode = HTTP_OK;
+				responsePacket.content = NULL;
+				responsePacket.contentType = application_json;
+				responsePacket.contentWriter = GetLogLevelsJSON;
+				responsePacket.contentLength = GetLogLevelsJSON(NULL, 0);
+				responsePacket.cacheControl = cache_no_cache;
+			}
+			else if(ROUTE_IS(httpRequest, "metrics")){
+				responsePacket.content = "";
+				responsePacket.contentLength = 0;
+				responsePacket.cacheControl = cache_no_cache;
+				//streamed over connection's output queue, needs a connection context
+				if(_FindConnection(pesp_conn) != NULL){
+					responsePacket.httpStatusCode = HTTP_OK;
+					responsePacket.contentType = text_prometheus;
+					responsePacket.chunkWriter = RenderMetrics;
+				}
+				else{
+					responsePacket.httpStatusCode = HTTP_Service_Unavailable;
+					responsePacket.contentType = text_html;
+					responsePacket.connection = Closed;
+				}
 			}
 			else {
 				responsePacket.httpStatusCode = HTTP_Not_Found;
@@ -126,33 +709,58 @@ void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short l
 				responsePacket.contentType = text_html;
 			}
 
-			ret = sendHttpResponse(pesp_conn, &responsePacket);
-			ESPCONN_DEBUG_ARGS("HTTP response send : %d", ret);
+			//answer conditional requests with header only 304
+			if(!validated) httpNotModified(&httpRequest, &responsePacket);
+
+			ret = _SendResponse(pesp_conn, &responsePacket);
+			responded = ret;
+			LOG_DEBUG(ESPCONN, "HTTP response send : %d", ret);
+
+			if(bundle != NULL) os_free(bundle);
 		}
 		else if(httpRequest.httpMethod == HTTP_POST && httpRequest.routeLength > 0){
-			ESPCONN_DEBUG("HTTP request type : POST");
+			LOG_DEBUG(ESPCONN, "HTTP request type : POST");
 
-			#ifdef ESP_ESPCONN_LOGGER
+			if(LOG_ON(ESPCONN, DEBUG)){
 				//print route
-				char *routePath = (char*) os_zalloc(httpRequest.routeLength);
+				char *routePath = (char*) os_zalloc(httpRequest.routeLength + 1);
 				os_memcpy(routePath, httpRequest.routePath, httpRequest.routeLength);
-				ESPCONN_DEBUG_ARGS("HTTP Route path : %s", routePath);
+				LOG_DEBUG(ESPCONN, "HTTP Route path : %s", routePath);
 				os_free(routePath);
-			#endif
+			}
+
+			//wifi mode is going to change, do not keep connection
+			httpRequest.connection = Closed;
 
 			//send response based on route
 			HTTP_RESPONSE_PACKET responsePacket;
-			responsePacket.connection = Closed;
+			_SetConnectionResponse(&responsePacket, pesp_conn, &httpRequest);
 			responsePacket.contentType = text_html;
-
-			if(os_strncmp(httpRequest.routePath, "/", httpRequest.routeLength) == 0){
-
-				//send content to client
-
-				responsePacket.httpStatusCode = HTTP_OK;
+			responsePacket.contentEncoding = encoding_identity;
+			responsePacket.contentInFlash = false;
+			responsePacket.contentWriter = NULL;
+			responsePacket.chunkWriter = NULL;
+			responsePacket.location = NULL;
+			responsePacket.etagType = etag_none;
+			responsePacket.cacheControl = cache_none;
+
+			if(ROUTE_IS(httpRequest, "/")){
+				//station mode switch is posted as a task, so response goes out first
+				bool connecting = (httpRequest.data != NULL && httpRequest.dataLength > 0 &&
+						ConnectToStation(httpRequest.data, httpRequest.dataLength));
+
+				responsePacket.httpStatusCode = connecting ? HTTP_OK : HTTP_Bad_Request;
 				responsePacket.content = "";
 				responsePacket.contentLength = 0;
+			}
+			else if(ROUTE_IS(httpRequest, "api/log")){
+				//module=level pairs, e.g. wifi=debug&http=warn
+				bool set = (httpRequest.data != NULL && httpRequest.dataLength > 0 &&
+						LogSetLevels(httpRequest.data, httpRequest.dataLength));
 
+				responsePacket.httpStatusCode = set ? HTTP_OK : HTTP_Bad_Request;
+				responsePacket.content = "";
+				responsePacket.contentLength = 0;
 			}
 			else {
 				responsePacket.httpStatusCode = HTTP_Not_Found;
@@ -160,12 +768,9 @@ void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short l
 				responsePacket.contentLength = 0;
 			}
 
-			ret = sendHttpResponse(pesp_conn, &responsePacket);
-			ESPCONN_DEBUG_ARGS("HTTP response send: %d", ret);
-
-			if(httpRequest.data != NULL && httpRequest.dataLength > 0){
-				ConnectToStation(httpRequest.data, httpRequest.dataLength);
-			}
+			ret = _SendResponse(pesp_conn, &responsePacket);
+			responded = ret;
+			LOG_DEBUG(ESPCONN, "HTTP response send: %d", ret);
 		}
 	}
 	else if(iMsgType == HTTP_RESPONSE){
@@ -173,6 +778,44 @@ void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short l
 	}
 
 	SKIP_PROCESS:;
+	return responded;
+}
+
+/***************************************************************************************
+ * FunctionName	:  _ProcessReceived
+ * Description	:  Handles complete requests held in connection's receive buffer. While a
+ * 				   chunked response is streamed, following requests wait in buffer.
+ * Parameters	:  connection -- connection context
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _ProcessReceived(HTTP_CONNECTION *connection){
+	HTTP_MESSAGE_TYPE httpMsgType;
+
+	//handle every complete (possibly pipelined) request in buffer
+	uint16 offset = 0;
+	uint16 messageLength = 0;
+	while(offset < connection->rxLength && !connection->closeAfterSent && connection->chunkWriter == NULL){
+		char *message = connection->rxBuffer + offset;
+		if(!httpMessageComplete(message, connection->rxLength - offset, &messageLength)) break;
+
+		//parser expects a terminated string, terminate at message boundary
+		char next = message[messageLength];
+		message[messageLength] = '\0';
+		if(isHttp(message, messageLength, &httpMsgType)){
+			LOG_DEBUG(ESPCONN, "It is HTTP data");
+			_processHttpData(connection->pespconn, message, messageLength, httpMsgType);
+		}
+		//connection may be released while processing
+		if(!connection->inUse) return;
+		message[messageLength] = next;
+		offset += messageLength;
+	}
+
+	//keep start of next request
+	if(offset > 0){
+		connection->rxLength -= offset;
+		os_memmove(connection->rxBuffer, connection->rxBuffer + offset, connection->rxLength);
+		connection->rxBuffer[connection->rxLength] = '\0';
+	}
 }
 
 /***************************************************************************************
@@ -183,22 +826,46 @@ void ICACHE_FLASH_ATTR _processHttpData(void *arg, char *pdata, unsigned short l
  * 				   len -- received data length
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _ESPConn_recv (void *arg, char *pdata, unsigned short len){
-	ESPCONN_DEBUG("Inside espconn data recieve callback.");
+	LOG_DEBUG(ESPCONN, "Inside espconn data recieve callback.");
 
-	bool ret = false;
 	struct espconn *pesp_conn = arg;
-	if(pdata != NULL && len > 0)
-		ESPCONN_DEBUG_ARGS("Data Received: %s", pdata);
+	if(pdata == NULL || len == 0) return;
+	LOG_DEBUG(ESPCONN, "Data Received: %d bytes", len);
 
 	//********************* HTTP DATA HANDLING *********************//
 
-	//check if received data is of type HTTP and it's Message type
+	HTTP_CONNECTION *connection = _FindConnection(pesp_conn);
 	HTTP_MESSAGE_TYPE httpMsgType;
-	ret = isHttp(pdata, len, &httpMsgType);
-	if(ret){
-		ESPCONN_DEBUG("It is HTTP data");
-		_processHttpData(arg, pdata, len, httpMsgType);
+
+	//no connection context, nothing can be buffered: segment is parsed from a terminated copy,
+	//connection is dropped once response is out (sent callback) or right away if there is none
+	if(connection == NULL){
+		bool responded = false;
+		char *request = (len <= HTTP_RX_BUFFER_SIZE) ? (char*) os_malloc(len + 1) : NULL;
+		if(request != NULL){
+			os_memcpy(request, pdata, len);
+			request[len] = '\0';
+			if(isHttp(request, len, &httpMsgType)) responded = _processHttpData(arg, request, len, httpMsgType);
+			os_free(request);
+		}
+		if(!responded) _DropConnection(pesp_conn);
+		return;
 	}
+	connection->lastActivity = system_get_time();
+
+	//append to data held back from previous segments
+	if(connection->rxLength + len > HTTP_RX_BUFFER_SIZE){
+		LOG_WARN(ESPCONN, "request too large, connection closed");
+		connection->rxLength = 0;
+		connection->closeAfterSent = true;
+		BusPost(BUS_SERVER_CLOSE, connection - httpConnections);
+		return;
+	}
+	os_memcpy(connection->rxBuffer + connection->rxLength, pdata, len);
+	connection->rxLength += len;
+	connection->rxBuffer[connection->rxLength] = '\0';
+
+	_ProcessReceived(connection);
 	//**************************************************************//
 }
 
@@ -208,8 +875,26 @@ void ICACHE_FLASH_ATTR _ESPConn_recv (void *arg, char *pdata, unsigned short len
  * Parameters	:  arg -- espconn obj
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _ESPConn_sent(void *arg){
-	ESPCONN_DEBUG("Inside espconn data sent callback.");
+	LOG_DEBUG(ESPCONN, "Inside espconn data sent callback.");
 	struct espconn *pesp_conn = arg;
+
+	//response of a connection without context is out, it is not kept
+	HTTP_CONNECTION *connection = _FindConnection(pesp_conn);
+	if(connection == NULL){
+		_DropConnection(pesp_conn);
+		return;
+	}
+	_ConnectionSent(connection);
+
+	//requests that waited for a chunked response
+	if(connection->chunkWriter == NULL && connection->txCount == 0 && connection->rxLength > 0)
+		_ProcessReceived(connection);
+
+	//close connection once last response is out
+	if(connection->closeAfterSent && connection->txCount == 0){
+		bool ret = BusPost(BUS_SERVER_CLOSE, connection - httpConnections);
+		LOG_DEBUG(ESPCONN, "post disconnect to bus, ret : %d", ret);
+	}
 }
 
 /***************************************************************************************
@@ -219,22 +904,19 @@ void ICACHE_FLASH_ATTR _ESPConn_sent(void *arg){
  * Parameters	:  arg -- espconn obj
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _TCP_Connect (void *arg){
-	ESPCONN_DEBUG("Inside TCP connect callback");
+	LOG_DEBUG(ESPCONN, "Inside TCP connect callback");
 
 	struct espconn *pesp_conn = arg;
 
 	//register espconn callbacks
 	sint8 ret = 0;
 	ret = espconn_regist_recvcb(pesp_conn, _ESPConn_recv);
-	ESPCONN_DEBUG_ARGS("register espconn data receive callback, ret : %d", ret);
+	LOG_DEBUG(ESPCONN, "register espconn data receive callback, ret : %d", ret);
 
 	ret = espconn_regist_sentcb(pesp_conn, _ESPConn_sent);
-	ESPCONN_DEBUG_ARGS("register espconn data sent callback, ret : %d", ret);
+	LOG_DEBUG(ESPCONN, "register espconn data sent callback, ret : %d", ret);
 
-	if(sendData){
-		ret = espconn_send(pesp_conn, "Hello", os_strlen("Hello"));
-		ESPCONN_DEBUG_ARGS("espconn_send, ret : %d", ret);
-	}
+	_OpenConnection(pesp_conn);
 }
 
 /***************************************************************************************
@@ -244,16 +926,18 @@ void ICACHE_FLASH_ATTR _TCP_Connect (void *arg){
  * 				   err -- disconnect error type
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _TCP_Recon(void *arg, sint8 err){
-	ESPCONN_DEBUG("Inside TCP re-connect callback");
+	LOG_DEBUG(ESPCONN, "Inside TCP re-connect callback");
 
 	struct espconn *pesp_conn = arg;
 
-	ESPCONN_DEBUG_ARGS("server's reconnect error : %d", err);
-	ESPCONN_DEBUG_ARGS("server's %d.%d.%d.%d:%d disconnect", pesp_conn->proto.tcp->remote_ip[0],
+	LOG_WARN(ESPCONN, "server's reconnect error : %d", err);
+	METRIC_INC(METRIC_TCP_RECONNECTS);
+	LOG_DEBUG(ESPCONN, "server's %d.%d.%d.%d:%d disconnect", pesp_conn->proto.tcp->remote_ip[0],
 	        		pesp_conn->proto.tcp->remote_ip[1],pesp_conn->proto.tcp->remote_ip[2],
 	        		pesp_conn->proto.tcp->remote_ip[3],pesp_conn->proto.tcp->remote_port);
 
-	_TCP_Connect(arg);
+	//connection is aborted, release its state
+	_CloseConnection(pesp_conn);
 }
 
 /***************************************************************************************
@@ -262,14 +946,15 @@ void ICACHE_FLASH_ATTR _TCP_Recon(void *arg, sint8 err){
  * Parameters	:  arg -- espconn obj
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _TCP_Discon(void *arg){
-	ESPCONN_DEBUG("Inside TCP disconnect callback");
+	LOG_DEBUG(ESPCONN, "Inside TCP disconnect callback");
 
     struct espconn *pesp_conn = arg;
 
-    ESPCONN_DEBUG_ARGS("server's %d.%d.%d.%d:%d disconnect", pesp_conn->proto.tcp->remote_ip[0],
+    LOG_DEBUG(ESPCONN, "server's %d.%d.%d.%d:%d disconnect", pesp_conn->proto.tcp->remote_ip[0],
         		pesp_conn->proto.tcp->remote_ip[1],pesp_conn->proto.tcp->remote_ip[2],
         		pesp_conn->proto.tcp->remote_ip[3],pesp_conn->proto.tcp->remote_port);
 
+    _CloseConnection(pesp_conn);
 }
 
 /*******************************************************************************************
@@ -278,9 +963,7 @@ void ICACHE_FLASH_ATTR _TCP_Discon(void *arg){
  * Return		:  0 if successful, else failed
  ******************************************************************************************/
 sint8 ICACHE_FLASH_ATTR InitESPConn(void){
-	ESPCONN_DEBUG("Init ESP Connection");
-
-	os_memset(&server_ip, 0, sizeof(server_ip));
+	LOG_DEBUG(ESPCONN, "Init ESP Connection");
 
 	//initialize espconn structure
 	espconn.type = ESPCONN_TCP;
@@ -291,13 +974,33 @@ sint8 ICACHE_FLASH_ATTR InitESPConn(void){
 	//Register TCP callbacks
 	sint8 ret = false;
 	ret = espconn_regist_connectcb(&espconn, _TCP_Connect);
-	ESPCONN_DEBUG_ARGS("register TCP listen connect callback, ret : %d", ret);
+	LOG_DEBUG(ESPCONN, "register TCP listen connect callback, ret : %d", ret);
 
 	ret = espconn_regist_reconcb(&espconn, _TCP_Recon);
-	ESPCONN_DEBUG_ARGS("register TCP reconnect callback, ret : %d", ret);
+	LOG_DEBUG(ESPCONN, "register TCP reconnect callback, ret : %d", ret);
 
 	ret = espconn_regist_disconcb(&espconn, _TCP_Discon);
-	ESPCONN_DEBUG_ARGS("register TCP disconnect callback, ret : %d", ret);
+	LOG_DEBUG(ESPCONN, "register TCP disconnect callback, ret : %d", ret);
+
+	//connection pool, allocated once and kept for lifetime of firmware
+	if(httpConnections == NULL){
+		httpConnections = (HTTP_CONNECTION*) os_zalloc(HTTP_MAX_CONNECTIONS * sizeof(HTTP_CONNECTION));
+		if(httpConnections == NULL){
+			LOG_ERROR(ESPCONN, "failed to allocate connection pool");
+			return ESPCONN_MEM;
+		}
+	}
+
+	//remote server client
+	clientEspconn.type = ESPCONN_TCP;
+	clientEspconn.state = ESPCONN_NONE;
+	clientEspconn.proto.tcp = &clientTcp;
+
+	//disconnect/delete connections from bus task
+	BusSubscribe(BUS_SERVER_DELETE, _ESPConn_Event);
+	BusSubscribe(BUS_SERVER_CLOSE, _ESPConn_Event);
+	BusSubscribe(BUS_SERVER_DROP, _ESPConn_Event);
+	BusSubscribe(BUS_CLIENT_CLOSE, _ESPConn_Event);
 
 	return ret;
 }
@@ -308,7 +1011,7 @@ sint8 ICACHE_FLASH_ATTR InitESPConn(void){
  * Return		:  0 if successful, else failed
  ******************************************************************************************/
 sint8 ICACHE_FLASH_ATTR StopLocalServer(void){
-	ESPCONN_DEBUG_ARGS("Stopping Local TCP Server on port: %d", espconn.proto.tcp->local_port);
+	LOG_DEBUG(ESPCONN, "Stopping Local TCP Server on port: %d", espconn.proto.tcp->local_port);
 
 	sint8 ret = false;
 	//get connection info
@@ -326,14 +1029,13 @@ sint8 ICACHE_FLASH_ATTR StopLocalServer(void){
 				espconn.proto.tcp->remote_port = remote_info[i].remote_port;
 
 				ret = espconn_disconnect(&espconn);
-				ESPCONN_DEBUG_ARGS("esp disconnect : %d", ret);
+				LOG_DEBUG(ESPCONN, "esp disconnect : %d", ret);
 			}
 		}
 	}
-	//Register user task to delete connection
-	ret = system_os_task(_UserTasks, USER_TASK_PRIO_1,taskQueue, 1);
-	//call user task to delete connection
-	ret = system_os_post(USER_TASK_PRIO_1, 0, 0);
+	//delete connection from bus task
+	ret = BusPost(BUS_SERVER_DELETE, 0);
+	serverListening = false;
 	return ret;
 }
 
@@ -343,73 +1045,132 @@ sint8 ICACHE_FLASH_ATTR StopLocalServer(void){
  * Return		:  0 if successful, else failed
  ******************************************************************************************/
 sint8 ICACHE_FLASH_ATTR StartLocalServer(void){
+	//server is kept up across wifi mode changes
+	if(serverListening) return ESPCONN_OK;
+
 	sint8 ret = false;
 	ret = espconn_accept(&espconn);
-	ESPCONN_DEBUG_ARGS("Starting Local TCP server listening on port: %d, ret : %d", espconn.proto.tcp->local_port, ret);
+	LOG_DEBUG(ESPCONN, "Starting Local TCP server listening on port: %d, ret : %d", espconn.proto.tcp->local_port, ret);
+
+	if(ret == ESPCONN_OK){
+		//idle keep-alive connections are closed by the stack after timeout
+		espconn_regist_time(&espconn, HTTP_KEEPALIVE_TIMEOUT, 0);
+		espconn_tcp_set_max_con_allow(&espconn, HTTP_MAX_CONNECTIONS);
+		serverListening = true;
+	}
 	return ret;
 }
 
 /*******************************************************************************************
- * FunctionName	:  _DNS_cb
- * Description	:  get host by name DNS cb
- * Paramaters	:  name -- pointer to the name that was looked up
- * 				   ipaddr -- pointer to an ip_addr_t containing the IP address of the hostname
- * 				   arg -- espconn obj
+ * FunctionName	:  PublishSample
+ * Description	:  Pushes latest sample to Server-Sent Events subscribers (events)
  ******************************************************************************************/
-void ICACHE_FLASH_ATTR _DNS_cb(const char *name, ip_addr_t *ipaddr, void *arg){
-	struct espconn *pespconn = (struct espconn *)arg;
-	if (ipaddr != NULL){
-
-		server_ip = *ipaddr;
+void ICACHE_FLASH_ATTR PublishSample(void){
+	if(httpConnections == NULL || _SubscriberCount() == 0) return;
 
-		//read ip
-		ESPCONN_DEBUG_ARGS("_DNS_cb name: %s", name);
-		ESPCONN_DEBUG_ARGS("_DNS_cb ipaddr: " IPSTR, IP2STR(&ipaddr->addr));
+	char frame[SSE_FRAME_SIZE];
+	uint16 length = _RenderSampleEvent(frame);
+	if(length == 0) return;
 
-		//create tcp connection with server
-		//send http data to server
-		//close connection
+	for(uint8 i = 0; i < HTTP_MAX_CONNECTIONS; ++i){
+		if(httpConnections[i].inUse && httpConnections[i].subscriber && !httpConnections[i].closeAfterSent)
+			_SendEvent(&httpConnections[i], frame, length);
 	}
 }
 
 /*******************************************************************************************
- * FunctionName	:  SendDataToRemoteServer
- * Description	:
- * Return		:
+ * FunctionName	:  _Client_Sent
+ * Description	:  Callback when data is sent to remote server, closes connection
+ * Parameters	:  arg -- espconn obj
  ******************************************************************************************/
-sint8 ICACHE_FLASH_ATTR SendDataToRemoteServer(char *iUrl, uint16 iUrlLength, char*iData, uint16 iDataLength){
-	ESPCONN_DEBUG("Send data to remote webserver");
-	sint8 ret = false;
-	if(iUrl != NULL && iUrlLength > 0 && iData != NULL && iDataLength > 0){
-
-		/*struct espconn *pespconn = NULL;
-		ret = espconn_gethostbyname(pespconn, iUrl, &server_ip, _DNS_cb);
-		ESPCONN_DEBUG_ARGS("espconn_gethostbyname: " IPSTR " ret: %d", IP2STR(&server_ip.addr), ret);
-
-		if(ret == ESPCONN_OK){
-			//create tcp connection with server
-			//send http data to server
-			//close connection
-		}*/
+void ICACHE_FLASH_ATTR _Client_Sent(void *arg){
+	LOG_DEBUG(ESPCONN, "data sent to remote server");
+	TRACE(TRACE_TCP_SENT);
+	METRIC_INC(METRIC_UPLOAD_SUCCESS);
+	METRIC_ADD(METRIC_UPLOAD_BYTES, clientDataLength);
+
+	bool ret = BusPost(BUS_CLIENT_CLOSE, 0);
+	LOG_DEBUG(ESPCONN, "post client disconnect to bus, ret : %d", ret);
+}
 
-		/*** Test Code ***/
+/*******************************************************************************************
+ * FunctionName	:  _Client_Connect
+ * Description	:  Callback when connection to remote server is established, sends data
+ * Parameters	:  arg -- espconn obj
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Client_Connect(void *arg){
+	struct espconn *pesp_conn = arg;
 
-		uint32 ip = ipaddr_addr("192.168.0.105");
+	espconn_regist_sentcb(pesp_conn, _Client_Sent);
 
-		espconn.state = ESPCONN_NONE;
-		espconn.type = ESPCONN_TCP;
-		espconn.proto.tcp = &espTcp;
+	TRACE(TRACE_TCP_SEND);
+	sint8 ret = espconn_send(pesp_conn, (uint8*) clientData, clientDataLength);
+	LOG_DEBUG(ESPCONN, "send data to remote server, ret : %d", ret);
+	if(ret != ESPCONN_OK) BusPost(BUS_CLIENT_CLOSE, 0);
+}
 
-		os_memcpy(espconn.proto.tcp->remote_ip, &ip, 4);
-		espconn.proto.tcp->remote_port = 8080;
-		espconn.proto.tcp->local_port = espconn_port();
+/*******************************************************************************************
+ * FunctionName	:  _Client_Recon
+ * Description	:  Callback when connection to remote server failed or is aborted
+ * Parameters	:  arg -- espconn obj
+ * 				   err -- error type
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Client_Recon(void *arg, sint8 err){
+	LOG_WARN(ESPCONN, "remote server connection error : %d", err);
+	METRIC_INC(METRIC_TCP_RECONNECTS);
+	clientBusy = false;
 
-		ret = espconn_connect(&espconn);
-		ESPCONN_DEBUG_ARGS("make tcp connection to server, ret: %d:", ret);
+	//check path now rather than at next regular probe
+	LinkProbeSoon();
+}
 
-		sendData = true;
+/*******************************************************************************************
+ * FunctionName	:  _Client_Discon
+ * Description	:  Callback when connection to remote server is closed
+ * Parameters	:  arg -- espconn obj
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Client_Discon(void *arg){
+	LOG_DEBUG(ESPCONN, "remote server disconnected");
+	clientBusy = false;
+}
 
-		/****************/
+/*******************************************************************************************
+ * FunctionName	:  SendDataToRemoteServer
+ * Description	:  Sends data to collector (LinkCollector) over its own
+ * 				   client connection, local server is not affected
+ * Return		:  0 if upload started, ESPCONN_INPROGRESS if previous one is in progress
+ ******************************************************************************************/
+sint8 ICACHE_FLASH_ATTR SendDataToRemoteServer(char *iUrl, uint16 iUrlLength, char*iData, uint16 iDataLength){
+	LOG_DEBUG(ESPCONN, "Send data to remote webserver");
+	sint8 ret = false;
+	if(iUrl != NULL && iUrlLength > 0 && iData != NULL && iDataLength > 0){
+		//one upload at a time, client espconn is shared
+		if(clientBusy) return ESPCONN_INPROGRESS;
+		if(iDataLength > COLLECTOR_DATA_SIZE) return ESPCONN_ARG;
+
+		os_memcpy(clientData, iData, iDataLength);
+		clientDataLength = iDataLength;
+
+		//collector address of link probe, console may have changed it
+		uint32 ip = 0;
+		uint16 port = 0;
+		LinkCollector(&ip, &port);
+		os_memcpy(clientEspconn.proto.tcp->remote_ip, &ip, 4);
+		clientEspconn.proto.tcp->remote_port = port;
+		clientEspconn.proto.tcp->local_port = espconn_port();
+
+		espconn_regist_connectcb(&clientEspconn, _Client_Connect);
+		espconn_regist_reconcb(&clientEspconn, _Client_Recon);
+		espconn_regist_disconcb(&clientEspconn, _Client_Discon);
+
+		TRACE(TRACE_TCP_CONNECT);
+		ret = espconn_connect(&clientEspconn);
+		LOG_DEBUG(ESPCONN, "make tcp connection to server, ret: %d:", ret);
+		//attempt only once connection is underway, success is counted against it
+		if(ret == ESPCONN_OK){
+			clientBusy = true;
+			METRIC_INC(METRIC_UPLOAD_ATTEMPTS);
+		}
 	}
 
 	return ret;
@@ -0,0 +1,364 @@
+/*
+ * user_link.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_link.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+#include "espconn.h"
+
+//user includes
+#include "user_espconn.h"
+#include "user_metrics.h"
+#include "user_timer.h"
+#include "user_log.h"
+
+#define LINK_LOST				0xFFFFFFFF		//history entry of a lost probe
+
+//probe connection state, link timer does what is due in each state
+typedef enum linkState{
+	LINK_IDLE,					//timer starts next probe
+	LINK_CONNECTING,			//timer is probe timeout
+	LINK_ABANDONED,				//probe timed out, waiting for SDK to give up connection
+	LINK_CLOSING				//timer closes connection (not allowed in espconn callbacks)
+} LINK_STATE;
+
+//static placeholders
+static struct espconn linkEspconn;
+static esp_tcp linkTcp;
+static TIMER_ID linkTimer = TIMER_NONE;
+static LINK_STATE linkState = LINK_IDLE;
+static bool linkRunning = false;
+static uint32 probeStart = 0;
+static LINK_STATE_CB stateChanged = NULL;
+
+//collector address, COLLECTOR_IP:COLLECTOR_PORT until LinkSetCollector
+static uint32 collectorIp = 0;
+static uint16 collectorPort = COLLECTOR_PORT;
+
+//probe history (rtt in us or LINK_LOST), ring of last LINK_HISTORY probes
+static uint32 history[LINK_HISTORY] = {0};
+static uint8 historyHead = 0;
+static uint8 historyCount = 0;
+static uint32 failures = 0;
+static bool reachable = false;
+static uint8 uploadSkip = 0;
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _SetReachable
+ * Description	:  Updates reachability and reports changes
+ * Parameters	:  iReachable -- collector is reachable
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _SetReachable(bool iReachable){
+	if(reachable == iReachable) return;
+	reachable = iReachable;
+	LOG_INFO(LINK, "collector reachable : %d", reachable);
+	if(stateChanged != NULL) stateChanged(reachable);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _LinkRecord
+ * Description	:  Adds a probe result to history
+ * Parameters	:  iRtt -- connect time in us, LINK_LOST if probe got no answer
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _LinkRecord(uint32 iRtt){
+	history[historyHead] = iRtt;
+	historyHead = (historyHead + 1) % LINK_HISTORY;
+	if(historyCount < LINK_HISTORY) ++historyCount;
+
+	if(iRtt == LINK_LOST){
+		++failures;
+		METRIC_INC(METRIC_PROBE_FAILURES);
+		LOG_WARN(LINK, "probe lost, %u in a row", failures);
+		if(failures >= LINK_DOWN_AFTER) _SetReachable(false);
+	}
+	else{
+		failures = 0;
+		METRIC_INC(METRIC_PROBE_SUCCESS);
+		LOG_DEBUG(LINK, "probe answered in %u us", iRtt);
+		_SetReachable(true);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _LinkSchedule
+ * Description	:  Arms link timer for next probe, backs off exponentially while probes
+ * 				   are lost
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _LinkSchedule(void){
+	if(!linkRunning) return;
+
+	uint32 delay = LINK_PROBE_INTERVAL;
+	if(failures > 0){
+		delay = LINK_PROBE_RETRY_MAX;
+		if(failures <= 16 && (LINK_PROBE_RETRY << (failures - 1)) < LINK_PROBE_RETRY_MAX){
+			delay = LINK_PROBE_RETRY << (failures - 1);
+		}
+	}
+	LOG_DEBUG(LINK, "next probe in %u s", delay);
+
+	ArmTimer(linkTimer, delay * 1000, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Link_Connect
+ * Description	:  Callback when collector accepted probe connection
+ * Parameters	:  arg -- espconn obj
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Link_Connect(void *arg){
+	if(linkState == LINK_CONNECTING){
+		DisarmTimer(linkTimer);
+		_LinkRecord(system_get_time() - probeStart);
+	}
+
+	//close from link timer, answer of an abandoned probe is not counted
+	linkState = LINK_CLOSING;
+	ArmTimer(linkTimer, 0, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Link_Recon
+ * Description	:  Callback when probe connection failed (refused, timed out) or is aborted
+ * Parameters	:  arg -- espconn obj
+ * 				   err -- error type
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Link_Recon(void *arg, sint8 err){
+	LOG_WARN(LINK, "probe connection error : %d", err);
+	if(linkState == LINK_CONNECTING){
+		DisarmTimer(linkTimer);
+		_LinkRecord(LINK_LOST);
+	}
+	linkState = LINK_IDLE;
+	_LinkSchedule();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Link_Discon
+ * Description	:  Callback when probe connection is closed
+ * Parameters	:  arg -- espconn obj
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Link_Discon(void *arg){
+	linkState = LINK_IDLE;
+	_LinkSchedule();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _LinkConnect
+ * Description	:  Starts a probe, opens connection to collector
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _LinkConnect(void){
+	os_memcpy(linkEspconn.proto.tcp->remote_ip, &collectorIp, 4);
+	linkEspconn.proto.tcp->remote_port = collectorPort;
+	linkEspconn.proto.tcp->local_port = espconn_port();
+
+	espconn_regist_connectcb(&linkEspconn, _Link_Connect);
+	espconn_regist_reconcb(&linkEspconn, _Link_Recon);
+	espconn_regist_disconcb(&linkEspconn, _Link_Discon);
+
+	probeStart = system_get_time();
+	sint8 ret = espconn_connect(&linkEspconn);
+	LOG_DEBUG(LINK, "probe " IPSTR ":%d, ret : %d", IP2STR(linkEspconn.proto.tcp->remote_ip), collectorPort, ret);
+	if(ret != ESPCONN_OK){
+		_LinkRecord(LINK_LOST);
+		_LinkSchedule();
+		return;
+	}
+
+	linkState = LINK_CONNECTING;
+	ArmTimer(linkTimer, LINK_PROBE_TIMEOUT * 1000, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Link_Timer
+ * Description	:  Link timer callback, starts, times out or closes a probe
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Link_Timer(void *arg){
+	sint8 ret = 0;
+	switch(linkState){
+	case LINK_IDLE:
+		if(linkRunning) _LinkConnect();
+		break;
+	case LINK_CONNECTING:
+		//SDK keeps retrying SYN for much longer, count probe as lost now
+		_LinkRecord(LINK_LOST);
+		linkState = LINK_ABANDONED;
+		break;
+	case LINK_CLOSING:
+		ret = espconn_disconnect(&linkEspconn);
+		LOG_DEBUG(LINK, "probe disconnect, ret : %d", ret);
+		break;
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitLinkProbe
+ * Description	:  Initializes link probe
+ * Parameters	:  iStateChanged -- called on each reachability change (may be NULL)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitLinkProbe(LINK_STATE_CB iStateChanged){
+	stateChanged = iStateChanged;
+	collectorIp = ipaddr_addr(COLLECTOR_IP);
+
+	linkEspconn.type = ESPCONN_TCP;
+	linkEspconn.state = ESPCONN_NONE;
+	linkEspconn.proto.tcp = &linkTcp;
+
+	linkTimer = CreateTimer(_Link_Timer, NULL);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StartLinkProbe
+ * Description	:  Clears history and starts probing collector
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StartLinkProbe(void){
+	LOG_INFO(LINK, "start probing collector");
+	linkRunning = true;
+	historyHead = 0;
+	historyCount = 0;
+	failures = 0;
+
+	//a probe still open from before is closed first, its callback schedules next one
+	if(linkState == LINK_IDLE){
+		ArmTimer(linkTimer, 0, false);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StopLinkProbe
+ * Description	:  Stops probing, collector is reported unreachable
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StopLinkProbe(void){
+	LOG_INFO(LINK, "stop probing collector");
+	linkRunning = false;
+
+	//open probe is left to SDK, without counting it
+	if(linkState == LINK_IDLE || linkState == LINK_CONNECTING) DisarmTimer(linkTimer);
+	if(linkState == LINK_CONNECTING) linkState = LINK_ABANDONED;
+
+	_SetReachable(false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  LinkProbeSoon
+ * Description	:  Brings next probe forward to LINK_PROBE_RETRY
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR LinkProbeSoon(void){
+	//while probes are lost, backoff already decides
+	if(!linkRunning || linkState != LINK_IDLE || failures > 0) return;
+
+	ArmTimer(linkTimer, LINK_PROBE_RETRY * 1000, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  LinkReachable
+ * Description	:  Checks whether collector answered recently
+ * Return		:  bool, true if reachable
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkReachable(void){
+	return reachable;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  LinkUploadDue
+ * Description	:  Decides whether a sample should be uploaded now
+ * Return		:  bool, true if sample should be uploaded
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkUploadDue(void){
+	if(!reachable) return false;
+
+	LINK_QUALITY quality;
+	GetLinkQuality(&quality);
+	if(quality.loss < LINK_LOSSY_PERCENT){
+		uploadSkip = 0;
+		return true;
+	}
+
+	LOG_WARN(LINK, "path lossy (%d%%), upload skip : %d", quality.loss, uploadSkip);
+	bool due = (uploadSkip == 0);
+	uploadSkip = (uploadSkip + 1) % LINK_LOSSY_UPLOAD_EVERY;
+	return due;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetLinkQuality
+ * Description	:  Computes rtt mean, jitter and loss over probe history
+ * Parameters	:  oQuality -- output
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR GetLinkQuality(LINK_QUALITY *oQuality){
+	os_memset(oQuality, 0, sizeof(LINK_QUALITY));
+	oQuality->reachable = reachable;
+	oQuality->samples = historyCount;
+	oQuality->failures = failures;
+	if(historyCount == 0) return;
+
+	//oldest to newest, jitter compares answered probes in the order they were taken
+	uint8 lost = 0, answered = 0;
+	uint32 rttSum = 0, jitterSum = 0, previous = LINK_LOST;
+	uint8 index = (historyHead + LINK_HISTORY - historyCount) % LINK_HISTORY;
+	for(uint8 i = 0; i < historyCount; ++i){
+		uint32 rtt = history[index];
+		index = (index + 1) % LINK_HISTORY;
+		if(rtt == LINK_LOST){
+			++lost;
+			continue;
+		}
+
+		if(previous != LINK_LOST) jitterSum += (rtt > previous) ? rtt - previous : previous - rtt;
+		previous = rtt;
+		rttSum += rtt;
+		++answered;
+	}
+
+	oQuality->loss = (lost * 100) / historyCount;
+	if(answered > 0) oQuality->rttMean = rttSum / answered;
+	if(answered > 1) oQuality->jitter = jitterSum / (answered - 1);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  LinkSetCollector
+ * Description	:  Sets collector address, previous collector's history is cleared
+ * Parameters	:  iIp -- collector ipv4 address, dotted decimal
+ * 				   iPort -- collector tcp port
+ * Return		:  bool, true if set
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LinkSetCollector(const char *iIp, uint16 iPort){
+	//ipaddr_addr takes short forms too, only a.b.c.d is accepted
+	uint8 dots = 0;
+	for(const char *c = iIp; *c != '\0'; ++c){
+		if(*c == '.') ++dots;
+		else if(*c < '0' || *c > '9') return false;
+	}
+	uint32 ip = ipaddr_addr(iIp);
+	if(dots != 3 || ip == IPADDR_NONE || ip == 0 || iPort == 0) return false;
+
+	collectorIp = ip;
+	collectorPort = iPort;
+	LOG_INFO(LINK, "collector " IPSTR ":%d", IP2STR(&collectorIp), collectorPort);
+
+	//previous collector's answers say nothing about this one
+	if(linkRunning){
+		_SetReachable(false);
+		StartLinkProbe();
+	}
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  LinkCollector
+ * Description	:  Collector address that probes and uploads connect to
+ * Parameters	:  oIp -- output, ipv4 address
+ * 				   oPort -- output, tcp port
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR LinkCollector(uint32 *oIp, uint16 *oPort){
+	*oIp = collectorIp;
+	*oPort = collectorPort;
+}
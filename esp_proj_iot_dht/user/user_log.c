@@ -0,0 +1,118 @@
+/*
+ * user_log.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_log.h"
+
+//system includes
+#include "osapi.h"
+
+//user includes
+#include "driver/http.h"
+
+//longest level name and terminator
+#define LOG_LEVEL_NAME_SIZE			8
+
+static const char *moduleNames[LOG_MODULES] = {
+	[LOG_MODULE_ESP]			= "esp",
+	[LOG_MODULE_WIFI]			= "wifi",
+	[LOG_MODULE_WIFI_FSM]		= "wifi_fsm",
+	[LOG_MODULE_ESPCONN]		= "espconn",
+	[LOG_MODULE_HTTP]			= "http",
+	[LOG_MODULE_DHT]			= "dht",
+	[LOG_MODULE_TIMER]			= "timer",
+	[LOG_MODULE_LINK]			= "link",
+	[LOG_MODULE_DNS]			= "dns",
+	[LOG_MODULE_CREDENTIALS]	= "credentials",
+	[LOG_MODULE_METRICS]		= "metrics",
+	[LOG_MODULE_SAMPLES]		= "samples",
+	[LOG_MODULE_TRACE]			= "trace",
+	[LOG_MODULE_CONSOLE]		= "console",
+	[LOG_MODULE_STREAM]			= "stream",
+	[LOG_MODULE_BUS]			= "bus"
+};
+
+static const char *levelNames[] = {"none", "error", "warn", "info", "debug"};
+
+//runtime levels, boot defaults
+uint8 logLevels[LOG_MODULES] = {
+	[LOG_MODULE_ESP]			= LOG_LEVEL_DEBUG,
+	[LOG_MODULE_WIFI]			= LOG_LEVEL_INFO,
+	[LOG_MODULE_WIFI_FSM]		= LOG_LEVEL_INFO,
+	[LOG_MODULE_ESPCONN]		= LOG_LEVEL_DEBUG,
+	[LOG_MODULE_HTTP]			= LOG_LEVEL_WARN,
+	[LOG_MODULE_DHT]			= LOG_LEVEL_WARN,
+	[LOG_MODULE_TIMER]			= LOG_LEVEL_WARN,
+	[LOG_MODULE_LINK]			= LOG_LEVEL_INFO,
+	[LOG_MODULE_DNS]			= LOG_LEVEL_WARN,
+	[LOG_MODULE_CREDENTIALS]	= LOG_LEVEL_INFO,
+	[LOG_MODULE_METRICS]		= LOG_LEVEL_WARN,
+	[LOG_MODULE_SAMPLES]		= LOG_LEVEL_WARN,
+	[LOG_MODULE_TRACE]			= LOG_LEVEL_WARN,
+	[LOG_MODULE_CONSOLE]		= LOG_LEVEL_INFO,
+	[LOG_MODULE_STREAM]			= LOG_LEVEL_INFO,
+	[LOG_MODULE_BUS]			= LOG_LEVEL_WARN
+};
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  LogSetLevels
+ * Description	:  Sets runtime levels of modules from a form of module=level pairs
+ * Parameters	:  iData -- form data
+ * 				   iDataLength -- iData length
+ * Return		:  bool, true if at least one level is set and none is invalid
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR LogSetLevels(const char *iData, uint16 iDataLength){
+	char values[LOG_MODULES][LOG_LEVEL_NAME_SIZE];
+	FORM_FIELD fields[LOG_MODULES];
+	for(uint8 i = 0; i < LOG_MODULES; ++i){
+		fields[i].name = moduleNames[i];
+		fields[i].value = values[i];
+		fields[i].size = LOG_LEVEL_NAME_SIZE;
+	}
+	if(httpDecodeForm(iData, iDataLength, fields, LOG_MODULES) == FORM_MALFORMED) return false;
+
+	//check all before setting any
+	uint8 levels[LOG_MODULES];
+	uint8 set = 0;
+	for(uint8 i = 0; i < LOG_MODULES; ++i){
+		levels[i] = logLevels[i];
+		if(fields[i].status == FORM_MISSING) continue;
+
+		uint8 level = 0;
+		while(level <= LOG_LEVEL_DEBUG && (fields[i].status != FORM_OK || os_strcmp(values[i], levelNames[level]) != 0)) ++level;
+		if(level > LOG_LEVEL_DEBUG) return false;
+		levels[i] = level;
+		++set;
+	}
+	if(set == 0) return false;
+
+	os_memcpy(logLevels, levels, sizeof(logLevels));
+	LOG_INFO(ESP, "%d log levels set", set);
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetLogLevelsJSON
+ * Description	:  Renders runtime levels of modules as JSON object
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetLogLevelsJSON(char *oBuffer, uint16 iSize){
+	char json[LOG_JSON_SIZE];
+	uint16 length = 0;
+
+	for(uint8 i = 0; i < LOG_MODULES; ++i){
+		uint8 level = logLevels[i] <= LOG_LEVEL_DEBUG ? logLevels[i] : LOG_LEVEL_DEBUG;
+		length += os_sprintf(json + length, "%s\"%s\":\"%s\"", i == 0 ? "{" : ",", moduleNames[i], levelNames[level]);
+	}
+	length += os_sprintf(json + length, "}");
+
+	if(oBuffer != NULL) os_memcpy(oBuffer, json, length < iSize ? length : iSize);
+	return length;
+}
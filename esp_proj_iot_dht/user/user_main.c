@@ -20,6 +20,12 @@
 #include "user_espconn.h"
 #include "user_wifi.h"
 #include "user_timer.h"
+#include "user_samples.h"
+#include "user_metrics.h"
+#include "user_link.h"
+#include "user_trace.h"
+#include "user_console.h"
+#include "user_stream.h"
 
 //UART
 #define UART_BAUD								115200
@@ -56,19 +62,32 @@ void ICACHE_FLASH_ATTR _ReadTempAndUpload(void){
 
 	float humidity = 0.0, temperature = 0.0;
 	uint8 tempUnit = Celcius;
-	if(ConnectedToInternet() && DHT_OK == dht_read(&humidity, &temperature, tempUnit)){
+	TRACE(TRACE_DHT_START);
+	DHT_STATUS status = dht_read(&humidity, &temperature, tempUnit);
+	METRIC_INC(METRIC_DHT_READ_OK + status);
+	if(DHT_OK != status) return;
+	TRACE(TRACE_DHT_END);
+	MetricsDHTDecodeTime(dht_decode_time());
+
+	//keep sample for local server (api/readings), whether or not it can be uploaded
+	AddSample(humidity, temperature, tempUnit);
+	PublishSample();
+	StreamSample();
+
+	//link probe decides, no upload while collector is unreachable, fewer while path is lossy
+	if(ConnectedToInternet() && LinkUploadDue()){
 		//convert float to integers because apparently this shit can't handle float to string -_-
 		int32_t humidity_i = humidity;
 		int32_t humidity_d = (humidity-humidity_i)*10;
 		int32_t temperature_i = temperature;
 		int32_t temperature_d = (temperature-temperature_i)*10;
-		ESP_DEBUG_ARGS("Humidity : %d.%d %% and Temperature : %d.%d C", humidity_i, humidity_d, temperature_i, temperature_d);
+		LOG_DEBUG(ESP, "Humidity : %d.%d %% and Temperature : %d.%d C", humidity_i, humidity_d, temperature_i, temperature_d);
 
 		//create json of data
 		char jsonData[65] = {0};
 		os_memset(jsonData, 0, 65);
 		os_sprintf(jsonData, "{ 'Humidity' : %d.%d, 'Temperature' : %d.%d, 'Unit' : %d }", humidity_i, humidity_d, temperature_i, temperature_d, tempUnit);
-		ESP_DEBUG_ARGS("content : %s", jsonData);
+		LOG_DEBUG(ESP, "content : %s", jsonData);
 
 		SendDataToRemoteServer("esp8266.com", 3, jsonData, os_strlen(jsonData));
 
@@ -87,24 +106,43 @@ void ICACHE_FLASH_ATTR InitUART(void){
 
 	//clear screen and moves Cursor to left
 	os_printf("\033[2J");
-	ESP_DEBUG("ESP8266, User-Init");
+	LOG_DEBUG(ESP, "ESP8266, User-Init");
 }
 
 void ICACHE_FLASH_ATTR espUserInit(void){
+	TRACE(TRACE_USER_INIT);
+
 	/**** Initialize UART for logging ****/
 	InitUART();
 
+	/**** Start metrics sampling and tracepoint histograms ****/
+	InitMetrics();
+	InitTrace();
+
+#if STREAM_WIRED
+	/**** Wired station, gateway on UART0 takes readings, radio stays off ****/
+	wifi_set_opmode_current(NULL_MODE);
+#else
 	/**** Init webserver ****/
-	ESP_DEBUG("Initializing ESP Conn");
+	LOG_DEBUG(ESP, "Initializing ESP Conn");
 	InitESPConn();
 
 	/**** Init Wifi ****/
-	ESP_DEBUG("Initializing Wifi");
+	LOG_DEBUG(ESP, "Initializing Wifi");
 	InitWifi(_ReadTempAndUpload);
+#endif
 
 	/**** Init DHT ****/
-	ESP_DEBUG("Initializing DHT");
+	LOG_DEBUG(ESP, "Initializing DHT");
 	dht_init(DHT_PIN);
+
+	/**** Start UART command console ****/
+	InitConsole(_ReadTempAndUpload);
+
+#if STREAM_WIRED
+	/**** Stream readings to gateway ****/
+	StartStream(STREAM_INTERVAL, _ReadTempAndUpload);
+#endif
 }
 
 void ICACHE_FLASH_ATTR user_pre_init(void)
@@ -0,0 +1,348 @@
+/*
+ * user_metrics.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_metrics.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//user includes
+#include "user_link.h"
+#include "user_timer.h"
+#include "user_bus.h"
+#include "driver/uart.h"
+#include "user_log.h"
+
+//DHT decode latency histogram, upper bounds in us (a 40 bit frame takes ~4ms)
+#define DHT_DECODE_BUCKETS		5
+#define DHT_DECODE_BUCKET_0		3500
+#define DHT_DECODE_BUCKET_1		4000
+#define DHT_DECODE_BUCKET_2		4500
+#define DHT_DECODE_BUCKET_3		5000
+#define DHT_DECODE_BUCKET_4		6000
+
+//metric families, rendered in this order
+typedef enum metricFamily{
+	FAMILY_HEAP,
+	FAMILY_UPTIME,
+	FAMILY_DHT_READS,
+	FAMILY_DHT_DECODE,
+	FAMILY_UPLOADS,
+	FAMILY_TCP,
+	FAMILY_WIFI_DISCONNECTS,
+	FAMILY_LINK_PROBES,
+	FAMILY_LINK_QUALITY,
+	FAMILY_LOG,
+	FAMILY_STREAM,
+	FAMILY_BUS_COALESCED,
+	FAMILY_BUS_DROPPED,
+	FAMILY_BUS_QUEUE,
+	FAMILY_COUNT
+} METRIC_FAMILY;
+
+typedef struct disconnectReason{
+	uint8 reason;
+	uint32 count;
+} DISCONNECT_REASON;
+
+uint32 metricCounters[METRIC_COUNTERS] = {0};
+
+static TIMER_ID metricsTimer = TIMER_NONE;
+
+//heap
+static uint32 heapMinFree = 0xFFFFFFFF;
+
+//uptime, system_get_time() wraps every ~71 minutes so wraps are counted on each tick
+static uint32 uptimeWraps = 0;
+static uint32 uptimeLast = 0;
+
+//DHT decode latency, bucket counts are not cumulative, last one is +Inf
+static uint32 dhtDecodeBuckets[DHT_DECODE_BUCKETS + 1] = {0};
+static uint32 dhtDecodeSum = 0;		//us
+
+//wifi disconnects, reasons[0] collects reasons that found no free slot
+static DISCONNECT_REASON disconnectReasons[METRICS_DISCONNECT_REASONS] = {0};
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _UptimeSeconds
+ * Description	:  Uptime from system time and counted wraps
+ * Return		:  uptime in seconds
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR _UptimeSeconds(void){
+	uint32 now = system_get_time();
+	if(now < uptimeLast) ++uptimeWraps;
+	uptimeLast = now;
+	return (uint32)((((uint64)uptimeWraps << 32) | now) / 1000000);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Metrics_Tick
+ * Description	:  Timer callback, samples heap and keeps uptime wrap count current
+ * Parameters	:  arg -- unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Metrics_Tick(void *arg){
+	MetricsSampleHeap();
+	_UptimeSeconds();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _RenderFamily
+ * Description	:  Renders one metric family with its HELP and TYPE lines
+ * Parameters	:  iFamily -- metric family
+ * 				   oBuffer -- output buffer, at least METRICS_FAMILY_SIZE
+ * Return		:  length rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _RenderFamily(METRIC_FAMILY iFamily, char *oBuffer){
+	uint16 length = 0;
+	switch(iFamily){
+	case FAMILY_HEAP:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_heap_free_bytes Free heap.\n"
+				"# TYPE esp_heap_free_bytes gauge\n"
+				"esp_heap_free_bytes %u\n", system_get_free_heap_size());
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_heap_min_free_bytes Lowest free heap seen since boot.\n"
+				"# TYPE esp_heap_min_free_bytes gauge\n"
+				"esp_heap_min_free_bytes %u\n", heapMinFree);
+		break;
+
+	case FAMILY_UPTIME:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_uptime_seconds Time since boot.\n"
+				"# TYPE esp_uptime_seconds counter\n"
+				"esp_uptime_seconds %u\n", _UptimeSeconds());
+		break;
+
+	case FAMILY_DHT_READS:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_dht_reads_total DHT reads by status.\n"
+				"# TYPE esp_dht_reads_total counter\n"
+				"esp_dht_reads_total{status=\"ok\"} %u\n"
+				"esp_dht_reads_total{status=\"fail\"} %u\n"
+				"esp_dht_reads_total{status=\"poll_error\"} %u\n",
+				metricCounters[METRIC_DHT_READ_OK], metricCounters[METRIC_DHT_READ_FAIL],
+				metricCounters[METRIC_DHT_READ_POLL_ERROR]);
+		break;
+
+	case FAMILY_DHT_DECODE:{
+		uint32 count = 0;
+		for(uint8 i = 0; i <= DHT_DECODE_BUCKETS; ++i) count += dhtDecodeBuckets[i];
+		uint32 b0 = dhtDecodeBuckets[0];
+		uint32 b1 = b0 + dhtDecodeBuckets[1];
+		uint32 b2 = b1 + dhtDecodeBuckets[2];
+		uint32 b3 = b2 + dhtDecodeBuckets[3];
+		uint32 b4 = b3 + dhtDecodeBuckets[4];
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_dht_decode_seconds Duration of DHT bus read.\n"
+				"# TYPE esp_dht_decode_seconds histogram\n"
+				"esp_dht_decode_seconds_bucket{le=\"0.0035\"} %u\n"
+				"esp_dht_decode_seconds_bucket{le=\"0.004\"} %u\n"
+				"esp_dht_decode_seconds_bucket{le=\"0.0045\"} %u\n"
+				"esp_dht_decode_seconds_bucket{le=\"0.005\"} %u\n"
+				"esp_dht_decode_seconds_bucket{le=\"0.006\"} %u\n"
+				"esp_dht_decode_seconds_bucket{le=\"+Inf\"} %u\n"
+				"esp_dht_decode_seconds_sum %u.%06u\n"
+				"esp_dht_decode_seconds_count %u\n",
+				b0, b1, b2, b3, b4, count,
+				dhtDecodeSum / 1000000, dhtDecodeSum % 1000000, count);
+		break;
+	}
+
+	case FAMILY_UPLOADS:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_upload_attempts_total Uploads to collector started.\n"
+				"# TYPE esp_upload_attempts_total counter\n"
+				"esp_upload_attempts_total %u\n"
+				"# HELP esp_upload_success_total Uploads to collector sent.\n"
+				"# TYPE esp_upload_success_total counter\n"
+				"esp_upload_success_total %u\n"
+				"# HELP esp_upload_bytes_total Payload bytes sent to collector.\n"
+				"# TYPE esp_upload_bytes_total counter\n"
+				"esp_upload_bytes_total %u\n",
+				metricCounters[METRIC_UPLOAD_ATTEMPTS], metricCounters[METRIC_UPLOAD_SUCCESS],
+				metricCounters[METRIC_UPLOAD_BYTES]);
+		break;
+
+	case FAMILY_TCP:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_tcp_reconnects_total Aborted TCP connections.\n"
+				"# TYPE esp_tcp_reconnects_total counter\n"
+				"esp_tcp_reconnects_total %u\n", metricCounters[METRIC_TCP_RECONNECTS]);
+		break;
+
+	case FAMILY_WIFI_DISCONNECTS:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_wifi_disconnects_total Station disconnects by reason (0: other).\n"
+				"# TYPE esp_wifi_disconnects_total counter\n");
+		for(uint8 i = 0; i < METRICS_DISCONNECT_REASONS; ++i){
+			if(disconnectReasons[i].count == 0) continue;
+			length += os_sprintf(oBuffer + length, "esp_wifi_disconnects_total{reason=\"%d\"} %u\n",
+					disconnectReasons[i].reason, disconnectReasons[i].count);
+		}
+		break;
+
+	case FAMILY_LINK_PROBES:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_link_probes_total Collector probes by result.\n"
+				"# TYPE esp_link_probes_total counter\n"
+				"esp_link_probes_total{result=\"ok\"} %u\n"
+				"esp_link_probes_total{result=\"lost\"} %u\n"
+				"# HELP esp_link_up Collector reachable.\n"
+				"# TYPE esp_link_up gauge\n"
+				"esp_link_up %d\n",
+				metricCounters[METRIC_PROBE_SUCCESS], metricCounters[METRIC_PROBE_FAILURES],
+				LinkReachable());
+		break;
+
+	case FAMILY_LINK_QUALITY:{
+		LINK_QUALITY quality;
+		GetLinkQuality(&quality);
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_link_rtt_seconds Mean connect time to collector over recent probes.\n"
+				"# TYPE esp_link_rtt_seconds gauge\n"
+				"esp_link_rtt_seconds %u.%06u\n"
+				"# HELP esp_link_jitter_seconds Mean connect time difference of consecutive probes.\n"
+				"# TYPE esp_link_jitter_seconds gauge\n"
+				"esp_link_jitter_seconds %u.%06u\n"
+				"# HELP esp_link_loss_ratio Lost share of recent probes.\n"
+				"# TYPE esp_link_loss_ratio gauge\n"
+				"esp_link_loss_ratio %u.%02u\n",
+				quality.rttMean / 1000000, quality.rttMean % 1000000,
+				quality.jitter / 1000000, quality.jitter % 1000000,
+				quality.loss / 100, quality.loss % 100);
+		break;
+	}
+
+	case FAMILY_LOG:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_log_dropped_total Log messages dropped from a full UART buffer.\n"
+				"# TYPE esp_log_dropped_total counter\n"
+				"esp_log_dropped_total %u\n", uart_tx_dropped());
+		break;
+
+	case FAMILY_STREAM:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_stream_frames_total Wired mode readings by result.\n"
+				"# TYPE esp_stream_frames_total counter\n"
+				"esp_stream_frames_total{result=\"sent\"} %u\n"
+				"esp_stream_frames_total{result=\"skipped\"} %u\n"
+				"# HELP esp_stream_bytes_total Wired mode frame bytes sent.\n"
+				"# TYPE esp_stream_bytes_total counter\n"
+				"esp_stream_bytes_total %u\n",
+				metricCounters[METRIC_STREAM_FRAMES], metricCounters[METRIC_STREAM_SKIPPED],
+				metricCounters[METRIC_STREAM_BYTES]);
+		break;
+
+	case FAMILY_BUS_COALESCED:
+	case FAMILY_BUS_DROPPED:{
+		bool dropped = iFamily == FAMILY_BUS_DROPPED;
+		length += os_sprintf(oBuffer + length, dropped ?
+				"# HELP esp_bus_dropped_total Events dropped from a full bus queue.\n"
+				"# TYPE esp_bus_dropped_total counter\n" :
+				"# HELP esp_bus_coalesced_total Events merged into an equal pending one.\n"
+				"# TYPE esp_bus_coalesced_total counter\n");
+		BUS_STATS stats;
+		for(uint8 i = 0; i < BUS_EVENTS; ++i){
+			GetBusStats(i, &stats);
+			length += os_sprintf(oBuffer + length, "esp_bus_%s_total{event=\"%s\"} %u\n",
+					dropped ? "dropped" : "coalesced", BusEventName(i), dropped ? stats.dropped : stats.coalesced);
+		}
+		break;
+	}
+
+	case FAMILY_BUS_QUEUE:
+		length += os_sprintf(oBuffer + length,
+				"# HELP esp_bus_queue_high_water Most events pending on bus at once.\n"
+				"# TYPE esp_bus_queue_high_water gauge\n"
+				"esp_bus_queue_high_water %d\n"
+				"# HELP esp_bus_queue_size Bus queue slots.\n"
+				"# TYPE esp_bus_queue_size gauge\n"
+				"esp_bus_queue_size %d\n", BusHighWater(), BUS_QUEUE);
+		break;
+
+	default:
+		break;
+	}
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitMetrics
+ * Description	:  Starts sampling of heap low-water mark and uptime
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitMetrics(void){
+	MetricsSampleHeap();
+	uptimeLast = system_get_time();
+
+	metricsTimer = CreateTimer(_Metrics_Tick, NULL);
+	ArmTimer(metricsTimer, METRICS_TICK * 1000, true);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsSampleHeap
+ * Description	:  Updates heap low-water mark with current free heap
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsSampleHeap(void){
+	uint32 freeHeap = system_get_free_heap_size();
+	if(freeHeap < heapMinFree) heapMinFree = freeHeap;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsDHTDecodeTime
+ * Description	:  Records duration of a DHT bus read in decode latency histogram
+ * Parameters	:  iTime -- duration in microseconds
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsDHTDecodeTime(uint32 iTime){
+	uint8 bucket = DHT_DECODE_BUCKETS;
+	if(iTime <= DHT_DECODE_BUCKET_0) bucket = 0;
+	else if(iTime <= DHT_DECODE_BUCKET_1) bucket = 1;
+	else if(iTime <= DHT_DECODE_BUCKET_2) bucket = 2;
+	else if(iTime <= DHT_DECODE_BUCKET_3) bucket = 3;
+	else if(iTime <= DHT_DECODE_BUCKET_4) bucket = 4;
+
+	++dhtDecodeBuckets[bucket];
+	dhtDecodeSum += iTime;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  MetricsWifiDisconnect
+ * Description	:  Counts a station disconnect by its reason
+ * Parameters	:  iReason -- disconnect reason
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR MetricsWifiDisconnect(uint8 iReason){
+	//slot 0 is kept for reasons that do not fit
+	for(uint8 i = 1; i < METRICS_DISCONNECT_REASONS; ++i){
+		if(disconnectReasons[i].count == 0) disconnectReasons[i].reason = iReason;
+		if(disconnectReasons[i].reason == iReason){
+			++disconnectReasons[i].count;
+			return;
+		}
+	}
+	++disconnectReasons[0].count;
+	LOG_DEBUG(METRICS, "no slot for disconnect reason %d", iReason);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  RenderMetrics
+ * Description	:  Renders metrics in Prometheus text format, a few families per call
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (at least METRICS_FAMILY_SIZE)
+ * 				   ioCursor -- next metric family, 0 on first call
+ * Return		:  length rendered, 0 once all families are rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR RenderMetrics(char *oBuffer, uint16 iSize, uint16 *ioCursor){
+	uint16 length = 0;
+	while(*ioCursor < FAMILY_COUNT && iSize - length >= METRICS_FAMILY_SIZE){
+		length += _RenderFamily(*ioCursor, oBuffer + length);
+		++(*ioCursor);
+	}
+	LOG_DEBUG(METRICS, "rendered %d bytes, next family %d", length, *ioCursor);
+	return length;
+}
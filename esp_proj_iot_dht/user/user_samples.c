@@ -0,0 +1,164 @@
+/*
+ * user_samples.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_samples.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//driver libs
+#include "driver/http.h"
+
+//user includes
+#include "user_log.h"
+
+//sample ring buffer, samples[(sampleCount - 1) & (SAMPLE_HISTORY - 1)] is the latest
+static SAMPLE samples[SAMPLE_HISTORY];
+static uint32 sampleCount = 0;
+static uint8 sampleUnit = 0;
+
+//time ages are rendered against, fixed by measuring call so both calls render same length
+static uint32 renderTime = 0;
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _ToTenths
+ * Description	:  Rounds value to tenths
+ * Parameters	:  iValue -- value
+ * Return		:  value in tenths
+ ******************************************************************************************/
+sint16 ICACHE_FLASH_ATTR _ToTenths(float iValue){
+	return (sint16)(iValue * 10 + (iValue < 0 ? -0.5f : 0.5f));
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _PutSample
+ * Description	:  Appends a sample to writer output as JSON object
+ * Parameters	:  oBuffer -- output buffer, may be NULL (measuring)
+ * 				   iSize -- size of output buffer
+ * 				   ioLength -- length written so far
+ * 				   iSample -- sample
+ * 				   iNow -- current system time (us)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _PutSample(char *oBuffer, uint16 iSize, uint16 *ioLength, const SAMPLE *iSample, uint32 iNow){
+	char object[SAMPLE_JSON_SIZE];
+	sint16 temperature = iSample->temperature;
+	uint16 length = os_sprintf(object, "{\"t\":%s%d.%d,\"h\":%d.%d,\"age_ms\":%u}",
+			temperature < 0 ? "-" : "", (temperature < 0 ? -temperature : temperature) / 10,
+			(temperature < 0 ? -temperature : temperature) % 10,
+			iSample->humidity / 10, iSample->humidity % 10,
+			(iNow - iSample->timestamp) / 1000);		//wraps after ~71 minutes
+
+	httpPut(oBuffer, iSize, ioLength, object, length);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  AddSample
+ * Description	:  Stores a sensor reading in sample cache, overwriting oldest one when full
+ * Parameters	:  iHumidity -- humidity (percent)
+ * 				   iTemperature -- temperature
+ * 				   iTempUnit -- unit of temperature (TEMP_UNITS)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR AddSample(float iHumidity, float iTemperature, uint8 iTempUnit){
+	SAMPLE *sample = &samples[sampleCount & (SAMPLE_HISTORY - 1)];
+	sample->timestamp = system_get_time();
+	sample->temperature = _ToTenths(iTemperature);
+	sample->humidity = _ToTenths(iHumidity);
+
+	//history is only meaningful in one unit
+	if(iTempUnit != sampleUnit && sampleCount > 0){
+		LOG_DEBUG(SAMPLES, "temperature unit changed, history dropped");
+		samples[0] = *sample;
+		sampleCount = 0;
+	}
+	sampleUnit = iTempUnit;
+	++sampleCount;
+
+	LOG_DEBUG(SAMPLES, "sample %u stored, t : %d, h : %d", sampleCount, sample->temperature, sample->humidity);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetLatestSample
+ * Description	:  Used to retrieve latest sample from sample cache
+ * Parameters	:  oSample -- latest sample
+ * Return		:  bool, true if successful,
+ * 						 false if no sample is taken yet
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR GetLatestSample(SAMPLE *oSample){
+	if(sampleCount == 0 || oSample == NULL) return false;
+	*oSample = samples[(sampleCount - 1) & (SAMPLE_HISTORY - 1)];
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetSampleCount
+ * Description	:  Used to retrieve number of samples taken so far
+ * Return		:  sample count, also sequence number of latest sample
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR GetSampleCount(void){
+	return sampleCount;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetSampleUnit
+ * Description	:  Unit of temperatures in sample cache
+ * Return		:  TEMP_UNITS of latest sample
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR GetSampleUnit(void){
+	return sampleUnit;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetLatestSampleJSON
+ * Description	:  Renders latest sample as JSON object {"t":23.4,"h":45.1,"age_ms":0}
+ * Parameters	:  oBuffer -- output buffer (SAMPLE_JSON_SIZE is always enough)
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON, 0 if no sample is taken yet
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetLatestSampleJSON(char *oBuffer, uint16 iSize){
+	uint16 length = 0;
+	if(sampleCount == 0 || oBuffer == NULL) return 0;
+	_PutSample(oBuffer, iSize, &length, &samples[(sampleCount - 1) & (SAMPLE_HISTORY - 1)], system_get_time());
+	return length < iSize ? length : iSize;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetSamplesJSON
+ * Description	:  Renders latest sample and history (api/readings) as JSON, only from
+ * 				   sample cache, sensor is never read. HTTP_CONTENT_WRITER.
+ * 				   {"unit":0,"count":N,"latest":{"t":23.4,"h":45.1,"age_ms":1200},"history":[...]}
+ * 				   latest is null until first sample, history is newest first.
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure (must precede rendering)
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetSamplesJSON(char *oBuffer, uint16 iSize){
+	uint16 length = 0;
+	char header[48];
+
+	if(oBuffer == NULL) renderTime = system_get_time();
+	uint32 now = renderTime;
+
+	httpPut(oBuffer, iSize, &length, header, os_sprintf(header, "{\"unit\":%d,\"count\":%u,\"latest\":",
+			sampleUnit, sampleCount));
+	if(sampleCount == 0){
+		httpPut(oBuffer, iSize, &length, "null,\"history\":[]}", 18);
+		return length;
+	}
+	_PutSample(oBuffer, iSize, &length, &samples[(sampleCount - 1) & (SAMPLE_HISTORY - 1)], now);
+
+	httpPut(oBuffer, iSize, &length, ",\"history\":[", 12);
+	uint32 history = sampleCount < SAMPLE_HISTORY ? sampleCount : SAMPLE_HISTORY;
+	for(uint32 i = 0; i < history; ++i){
+		if(i != 0) httpPut(oBuffer, iSize, &length, ",", 1);
+		_PutSample(oBuffer, iSize, &length, &samples[(sampleCount - 1 - i) & (SAMPLE_HISTORY - 1)], now);
+	}
+	httpPut(oBuffer, iSize, &length, "]}", 2);
+	return length;
+}
@@ -0,0 +1,283 @@
+/*
+ * user_stream.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_stream.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//driver libs
+#include "driver/uart.h"
+
+//user includes
+#include "user_samples.h"
+#include "user_wifi.h"
+#include "user_timer.h"
+#include "user_metrics.h"
+#include "user_log.h"
+
+#if !UART_BUFF_EN
+	#error "stream sends through uart tx buffer, set UART_BUFF_EN in driver/uart.h"
+#endif
+
+//bytes taken from uart rx buffer at a time
+#define STREAM_DEQ_SIZE				16
+
+//static placeholders
+static bool streaming = false;
+static TIMER_ID streamTimer = TIMER_NONE;
+static STREAM_READ_CB readSample = NULL;
+static uart_rx_cb_t rxResume = NULL;				//uart rx consumer before stream (console)
+static uint8 savedLogLevels[LOG_MODULES];
+
+static uint32 seq = 0;								//readings of this stream
+static uint32 skipped = 0;							//readings not sent
+static bool paused = false;							//gateway sent XOFF
+static bool acking = false;							//gateway acks frames, window applies
+static uint32 framesAcked = 0;						//frame number (seq - skipped) acked last, or given up
+static uint32 openTime = 0;							//TimerNow() when window last had room
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _StreamCRC16
+ * Description	:  CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise so no table
+ * 				   takes RAM, records are a few bytes
+ * Parameters	:  iData -- data
+ * 				   iLength -- iData length
+ * Return		:  CRC
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _StreamCRC16(const uint8 *iData, uint16 iLength){
+	uint16 crc = 0xFFFF;
+	for(uint16 i = 0; i < iLength; ++i){
+		crc ^= (uint16)iData[i] << 8;
+		for(uint8 bit = 0; bit < 8; ++bit) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _StreamCOBS
+ * Description	:  COBS encodes data and appends 0x00 delimiter. Every 0x00 of data is
+ * 				   replaced by distance to next one, so 0x00 only ends frames.
+ * Parameters	:  iData -- data
+ * 				   iLength -- iData length
+ * 				   oFrame -- output, iLength + iLength / 254 + 2 bytes
+ * Return		:  frame length
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _StreamCOBS(const uint8 *iData, uint16 iLength, uint8 *oFrame){
+	uint16 code = 0;				//position of current block's length byte
+	uint16 length = 1;
+	uint8 run = 1;
+
+	for(uint16 i = 0; i < iLength; ++i){
+		if(iData[i] != 0){
+			oFrame[length++] = iData[i];
+			if(++run < 0xFF) continue;
+		}
+		oFrame[code] = run;
+		code = length++;
+		run = 1;
+	}
+	oFrame[code] = run;
+	oFrame[length++] = 0;
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _StreamPut
+ * Description	:  Stores a value little endian
+ * Parameters	:  oData -- output
+ * 				   iValue -- value
+ * 				   iBytes -- bytes of value
+ * Return		:  iBytes
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR _StreamPut(uint8 *oData, uint32 iValue, uint8 iBytes){
+	for(uint8 i = 0; i < iBytes; ++i) oData[i] = (uint8)(iValue >> (8 * i));
+	return iBytes;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _StreamEncode
+ * Description	:  Builds a sample record (see user_stream.h) and frames it
+ * Parameters	:  iSeq -- sequence number
+ * 				   iSample -- sample
+ * 				   iUnit -- temperature unit
+ * 				   iSkipped -- readings not sent so far
+ * 				   oFrame -- output, STREAM_FRAME_SIZE bytes
+ * Return		:  frame length
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _StreamEncode(uint32 iSeq, const SAMPLE *iSample, uint8 iUnit, uint32 iSkipped, uint8 *oFrame){
+	uint8 record[STREAM_RECORD_SIZE];
+	uint8 length = 0;
+
+	record[length++] = STREAM_RECORD_SAMPLE;
+	length += _StreamPut(record + length, iSeq, 4);
+	length += _StreamPut(record + length, iSample->timestamp, 4);
+	length += _StreamPut(record + length, (uint16)iSample->temperature, 2);
+	length += _StreamPut(record + length, iSample->humidity, 2);
+	record[length++] = iUnit;
+	length += _StreamPut(record + length, iSkipped, 4);
+	length += _StreamPut(record + length, _StreamCRC16(record, length), 2);
+
+	return _StreamCOBS(record, length, oFrame);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Stream_Timer
+ * Description	:  Reading timer callback, sample callback ends in StreamSample
+ * Parameters	:  arg -- unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Stream_Timer(void *arg){
+	if(readSample != NULL) readSample();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _StreamAck
+ * Description	:  Takes an ack, frames up to its frame number are no longer in flight.
+ * 				   Acks of frames given up or not sent are ignored.
+ * Parameters	:  iAck -- ack byte
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _StreamAck(uint8 iAck){
+	uint32 acked = ((iAck & STREAM_ACK_MASK) - framesAcked) & STREAM_ACK_MASK;
+	acking = true;
+	if(acked == 0 || acked > seq - skipped - framesAcked) return;
+	framesAcked += acked;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Stream_Rx
+ * Description	:  uart rx callback (uart task) while streaming, gateway control bytes.
+ * 				   Acks are optional, window only holds frames back once one arrived.
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Stream_Rx(void){
+	uint8 data[STREAM_DEQ_SIZE];
+	uint16 length = 0;
+
+	while((length = rx_buff_deq((char *)data, sizeof(data))) > 0){
+		for(uint16 i = 0; i < length; ++i){
+			if(data[i] & STREAM_ACK){
+				_StreamAck(data[i]);
+				continue;
+			}
+			switch(data[i]){
+			case STREAM_XOFF:
+				paused = true;
+				break;
+			case STREAM_XON:
+				paused = false;
+				break;
+			case STREAM_STOP:
+				//rest of batch was meant for stream, console starts clean
+				StopStream();
+				return;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StreamSample
+ * Description	:  Sends latest sample of sample cache as a record, call after AddSample.
+ * 				   Does nothing unless streaming.
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StreamSample(void){
+	SAMPLE sample;
+	if(!streaming || !GetLatestSample(&sample)) return;
+
+	uint8 frame[STREAM_FRAME_SIZE];
+	uint16 length = _StreamEncode(++seq, &sample, GetSampleUnit(), skipped, frame);
+
+	//window full for long: frames or acks are lost, frames in flight are given up
+	bool windowFull = acking && seq - 1 - skipped - framesAcked >= STREAM_WINDOW;
+	if(windowFull && TimerNow() - openTime >= STREAM_ACK_TIMEOUT){
+		framesAcked = seq - 1 - skipped;
+		windowFull = false;
+	}
+	if(!windowFull) openTime = TimerNow();
+
+	//frames may hold 0x0A, tx buffer must not make room by dropping up to a line end
+	if(paused || windowFull || tx_buff_free() < length){
+		++skipped;
+		METRIC_INC(METRIC_STREAM_SKIPPED);
+		return;
+	}
+
+	tx_buff_enq((char *)frame, length);
+	METRIC_INC(METRIC_STREAM_FRAMES);
+	METRIC_ADD(METRIC_STREAM_BYTES, length);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StartStream
+ * Description	:  Enters wired mode, reads every iInterval ms and streams readings
+ * Parameters	:  iInterval -- reading interval in ms (STREAM_INTERVAL_MIN to STREAM_INTERVAL_MAX)
+ * 				   iReadSample -- takes a sample, StreamSample sends it
+ * Return		:  bool, true if started (or interval changed)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR StartStream(uint32 iInterval, STREAM_READ_CB iReadSample){
+	if(iInterval < STREAM_INTERVAL_MIN || iInterval > STREAM_INTERVAL_MAX) return false;
+	readSample = iReadSample;
+
+	if(streamTimer == TIMER_NONE) streamTimer = CreateTimer(_Stream_Timer, NULL);
+	if(!ArmTimer(streamTimer, iInterval, true)) return false;
+	if(streaming) return true;
+
+	LOG_INFO(STREAM, "streaming readings every %u ms, send 0x%02x to stop", iInterval, STREAM_STOP);
+
+	//stream owns sensor and uart, sample timer would take readings stream then misses
+	SetSampling(false);
+	rxResume = uart_get_rx_cb();
+	uart_set_rx_cb(_Stream_Rx);
+
+	os_memcpy(savedLogLevels, logLevels, sizeof(savedLogLevels));
+	os_memset(logLevels, LOG_LEVEL_NONE, sizeof(logLevels));
+	system_set_os_print(0);
+
+	seq = 0;
+	skipped = 0;
+	paused = false;
+	acking = false;
+	framesAcked = 0;
+	openTime = TimerNow();
+	streaming = true;
+
+	//ends whatever text is still queued, first frame starts clean
+	tx_buff_enq((char *)"", 1);
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  StopStream
+ * Description	:  Leaves wired mode, restores logs, uart rx consumer and sample timer
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR StopStream(void){
+	if(!streaming) return;
+	streaming = false;
+	DisarmTimer(streamTimer);
+
+	tx_buff_enq((char *)"", 1);
+	system_set_os_print(1);
+	os_memcpy(logLevels, savedLogLevels, sizeof(savedLogLevels));
+	uart_set_rx_cb(rxResume);
+
+	//sample timer runs again in station mode
+	SetSampling(true);
+	LOG_INFO(STREAM, "stream stopped, %u readings, %u skipped", seq, skipped);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  Streaming
+ * Description	:  Wired mode state
+ * Return		:  bool, true while streaming
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR Streaming(void){
+	return streaming;
+}
@@ -11,56 +11,337 @@
 #include "osapi.h"
 #include "user_interface.h"
 
-//Set-Up Debugging Macros
-#ifndef ESP_TIMER_LOGGER
-	#define TIMER_DEBUG(message)					do {} while(0)
-	#define TIMER_DEBUG_ARGS(message, args...)		do {} while(0)
-#else
-	#define TIMER_DEBUG(message)					do {os_printf("[TIMER_DEBUG] %s", message); os_printf("\r\n");} while(0)
-	#define TIMER_DEBUG_ARGS(message, args...)		do {os_printf("[TIMER_DEBUG] "); os_printf(message, args); os_printf("\r\n");} while(0)
+//user includes
+#include "user_log.h"
+
+//lists entries are linked in: wheel slots (level * TIMER_WHEEL_SLOTS + slot), then run list
+#define TIMER_LISTS					(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1)
+#define TIMER_RUN_LIST				(TIMER_LISTS - 1)		//expired slot being dispatched
+#define TIMER_NO_LIST				0xFF					//disarmed
+
+#define TIMER_SLOT_MASK				(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_SPAN			((uint32)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+#if TIMER_ENTRIES >= TIMER_NONE
+	#error "TIMER_ENTRIES must be below TIMER_NONE, entries are linked by uint8 index"
 #endif
 
-// static variables
-static os_timer_t osTimer1;
+typedef struct timerEntry{
+	TIMER_CB callback;
+	void *arg;
+	uint32 expires;				//TimerNow() it is due
+	uint32 period;				//ms, 0 for one-shot
+	uint8 next;					//entries of same list, TIMER_NONE ends
+	uint8 prev;
+	uint8 list;					//TIMER_NO_LIST while disarmed
+} TIMER_ENTRY;
+
+//static placeholders
+static TIMER_ENTRY entries[TIMER_ENTRIES];
+static uint8 entryCount = 0;
+static uint8 heads[TIMER_LISTS];
+static uint32 occupied[TIMER_WHEEL_LEVELS];		//bit per slot with entries
+
+static os_timer_t wheelTimer;
+static uint32 wheelNow = 0;			//next ms wheel processes, all before it are done
+static uint32 wakeAt = 0;			//ms os timer is armed for
+static bool dispatching = false;	//wheel is advancing, os timer is armed once it is done
+
+//ms clock on system_get_time, which wraps every 71 min
+static uint32 msNow = 0;
+static uint32 lastUs = 0;
 
 /******** Function Definitions ********/
 
 /*******************************************************************************************
- * FunctionName	:  DisarmTimer1
- * Description	:  Disarms timer1.
- * Return		:  bool, true if successful,
- * 						 false if failed
+ * FunctionName	:  _TimerLink
+ * Description	:  Links an entry at head of a list
+ * Parameters	:  iEntry -- entry index
+ * 				   iList -- list
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR DisarmTimer1(void){
-	//disarm sleep timer
-	os_timer_disarm(&osTimer1);
-	return true;
+void ICACHE_FLASH_ATTR _TimerLink(uint8 iEntry, uint8 iList){
+	TIMER_ENTRY *entry = &entries[iEntry];
+	entry->list = iList;
+	entry->prev = TIMER_NONE;
+	entry->next = heads[iList];
+	if(entry->next != TIMER_NONE) entries[entry->next].prev = iEntry;
+	heads[iList] = iEntry;
+	if(iList != TIMER_RUN_LIST) occupied[iList / TIMER_WHEEL_SLOTS] |= (uint32)1 << (iList & TIMER_SLOT_MASK);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerUnlink
+ * Description	:  Unlinks an entry from its list, if it is on one
+ * Parameters	:  iEntry -- entry index
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TimerUnlink(uint8 iEntry){
+	TIMER_ENTRY *entry = &entries[iEntry];
+	uint8 list = entry->list;
+	if(list == TIMER_NO_LIST) return;
+
+	if(entry->prev != TIMER_NONE) entries[entry->prev].next = entry->next;
+	else heads[list] = entry->next;
+	if(entry->next != TIMER_NONE) entries[entry->next].prev = entry->prev;
+	entry->list = TIMER_NO_LIST;
+
+	if(list != TIMER_RUN_LIST && heads[list] == TIMER_NONE){
+		occupied[list / TIMER_WHEEL_SLOTS] &= ~((uint32)1 << (list & TIMER_SLOT_MASK));
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerInsert
+ * Description	:  Puts an armed entry into wheel slot of its expiry. Level is the lowest
+ * 				   whose span covers the time left, so the slot is reached (level 0) or
+ * 				   cascaded down before expiry, and not a round earlier.
+ * Parameters	:  iEntry -- entry index
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TimerInsert(uint8 iEntry){
+	uint32 expires = entries[iEntry].expires;
+	sint32 left = (sint32)(expires - wheelNow);
+
+	//overdue runs on next ms, too far waits in last slot and is cascaded again from there
+	if(left < 0){
+		expires = wheelNow;
+		left = 0;
+	}
+	else if((uint32)left >= TIMER_WHEEL_SPAN){
+		expires = wheelNow + TIMER_WHEEL_SPAN - 1;
+		left = TIMER_WHEEL_SPAN - 1;
+	}
+
+	uint8 level = 0;
+	while(level < TIMER_WHEEL_LEVELS - 1 && ((uint32)left >> (TIMER_WHEEL_BITS * (level + 1))) != 0) ++level;
+
+	uint8 slot = (expires >> (TIMER_WHEEL_BITS * level)) & TIMER_SLOT_MASK;
+	_TimerLink(iEntry, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerCascade
+ * Description	:  Moves entries of a higher level slot down to lower levels
+ * Parameters	:  iLevel -- level
+ * 				   iSlot -- slot
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TimerCascade(uint8 iLevel, uint8 iSlot){
+	uint8 list = iLevel * TIMER_WHEEL_SLOTS + iSlot;
+	uint8 entry = TIMER_NONE;
+	while((entry = heads[list]) != TIMER_NONE){
+		_TimerUnlink(entry);
+		_TimerInsert(entry);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerNext
+ * Description	:  Earliest ms wheel has work at: a level 0 slot with entries, or a higher
+ * 				   level slot with entries being cascaded. A bit scan per level.
+ * Parameters	:  oNext -- ms
+ * Return		:  bool, false if no timer is armed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _TimerNext(uint32 *oNext){
+	bool found = false;
+	for(uint8 level = 0; level < TIMER_WHEEL_LEVELS; ++level){
+		if(occupied[level] == 0) continue;
+
+		//slots of a level are reached on multiples of their span, in index order
+		uint8 shift = TIMER_WHEEL_BITS * level;
+		uint32 span = (uint32)1 << shift;
+		uint32 base = (wheelNow + span - 1) & ~(span - 1);
+		uint8 index = (base >> shift) & TIMER_SLOT_MASK;
+		uint32 rotated = (occupied[level] >> index) | (occupied[level] << ((TIMER_WHEEL_SLOTS - index) & TIMER_SLOT_MASK));
+		uint32 next = base + ((uint32)__builtin_ctz(rotated) << shift);
+
+		if(!found || (sint32)(next - *oNext) < 0) *oNext = next;
+		found = true;
+	}
+	return found;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerClock
+ * Description	:  Advances ms clock by whole ms passed since last call
+ * Return		:  TimerNow()
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR _TimerClock(void){
+	uint32 us = system_get_time();
+	uint32 ms = (us - lastUs) / 1000;
+	lastUs += ms * 1000;
+	msNow += ms;
+	return msNow;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerSchedule
+ * Description	:  Arms os timer for next work of wheel
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TimerSchedule(void){
+	uint32 next = 0;
+	uint32 delay = TIMER_WAKE_MAX;
+	if(_TimerNext(&next)){
+		sint32 left = (sint32)(next - msNow);
+		if(left < 0) left = 0;
+		if((uint32)left < delay) delay = left;
+	}
+
+	wakeAt = msNow + delay;
+	os_timer_disarm(&wheelTimer);
+	os_timer_arm(&wheelTimer, delay, false);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Timer_Wheel
+ * Description	:  os timer callback, advances wheel to now: cascades slots being reached,
+ * 				   runs expired entries, skips ms where nothing is due
+ * Parameters	:  arg -- unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Timer_Wheel(void *arg){
+	uint32 now = _TimerClock();
+	uint32 next = 0;
+	dispatching = true;
+
+	while((sint32)(now - wheelNow) >= 0){
+		uint32 tick = wheelNow;
+
+		//level boundaries reached at this ms, lower first
+		for(uint8 level = 1; level < TIMER_WHEEL_LEVELS; ++level){
+			uint8 shift = TIMER_WHEEL_BITS * level;
+			if((tick & (((uint32)1 << shift) - 1)) != 0) break;
+			_TimerCascade(level, (tick >> shift) & TIMER_SLOT_MASK);
+		}
+
+		//expired slot is moved aside, callbacks may arm into it again for a round later
+		uint8 entry = TIMER_NONE;
+		while((entry = heads[tick & TIMER_SLOT_MASK]) != TIMER_NONE){
+			_TimerUnlink(entry);
+			_TimerLink(entry, TIMER_RUN_LIST);
+		}
+		wheelNow = tick + 1;
+
+		//a callback may disarm entries still on run list
+		while((entry = heads[TIMER_RUN_LIST]) != TIMER_NONE){
+			TIMER_ENTRY *timer = &entries[entry];
+			_TimerUnlink(entry);
+
+			//periodic keeps its phase, periods missed entirely are skipped
+			if(timer->period > 0){
+				timer->expires += timer->period;
+				if((sint32)(timer->expires - now) < 0) timer->expires = now + timer->period;
+				_TimerInsert(entry);
+			}
+			timer->callback(timer->arg);
+		}
+
+		//ms without work are skipped, wheel slots in between are empty
+		if(!_TimerNext(&next) || (sint32)(next - now) > 0) next = now + 1;
+		if((sint32)(next - wheelNow) > 0) wheelNow = next;
+	}
+
+	dispatching = false;
+	_TimerSchedule();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TimerValid
+ * Description	:  Checks a timer id
+ * Parameters	:  iTimer -- timer
+ * Return		:  bool, true if created
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _TimerValid(TIMER_ID iTimer){
+	return iTimer < entryCount;
 }
 
 /*******************************************************************************************
- * FunctionName	:  ArmTimer1
- * Description	:  Arms timer1.
- * Parmaters	:  iTime -- time in seconds
- * 				   iRepeat -- timer repeat
+ * FunctionName	:  CreateTimer
+ * Description	:  Takes a timer from pool, it starts disarmed
+ * Parameters	:  iCallback -- called on expiry
+ * 				   iArg -- callback argument
+ * Return		:  TIMER_ID, TIMER_NONE if pool is used up (TIMER_ENTRIES)
+ ******************************************************************************************/
+TIMER_ID ICACHE_FLASH_ATTR CreateTimer(TIMER_CB iCallback, void *iArg){
+	//first timer starts wheel at current time
+	if(entryCount == 0){
+		lastUs = system_get_time();
+		msNow = lastUs / 1000;
+		lastUs = msNow * 1000;
+		wheelNow = msNow;
+		os_memset(heads, TIMER_NONE, sizeof(heads));
+		os_memset(occupied, 0, sizeof(occupied));
+
+		os_timer_disarm(&wheelTimer);
+		os_timer_setfn(&wheelTimer, (os_timer_func_t *)_Timer_Wheel, NULL);
+		_TimerSchedule();
+	}
+
+	if(entryCount >= TIMER_ENTRIES || iCallback == NULL){
+		LOG_ERROR(TIMER, "no timer left, %d in use", entryCount);
+		return TIMER_NONE;
+	}
+
+	TIMER_ENTRY *entry = &entries[entryCount];
+	entry->callback = iCallback;
+	entry->arg = iArg;
+	entry->period = 0;
+	entry->list = TIMER_NO_LIST;
+	LOG_DEBUG(TIMER, "timer %d created", entryCount);
+	return entryCount++;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  ArmTimer
+ * Description	:  Arms a timer, an armed one is re-armed. A periodic timer keeps its phase,
+ * 				   a late expiry does not shift the next one.
+ * Parameters	:  iTimer -- timer
+ * 				   iTime -- time in ms, 0 runs it on next pass
+ * 				   iRepeat -- periodic, every iTime ms (iTime must not be 0)
  * Return		:  bool, true if successful,
  * 						 false if failed
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR ArmTimer1(uint8 iTime, bool iRepeat){
-	//arm sleep timer
-	os_timer_arm(&osTimer1, iTime*1000, iRepeat);	//in seconds
+bool ICACHE_FLASH_ATTR ArmTimer(TIMER_ID iTimer, uint32 iTime, bool iRepeat){
+	if(!_TimerValid(iTimer) || (iRepeat && iTime == 0)) return false;
+
+	TIMER_ENTRY *entry = &entries[iTimer];
+	_TimerUnlink(iTimer);
+	entry->expires = _TimerClock() + iTime;
+	entry->period = iRepeat ? iTime : 0;
+	_TimerInsert(iTimer);
+
+	//os timer is re-armed only for an earlier expiry, wheel re-arms it after dispatch anyway
+	if(!dispatching && (sint32)(entry->expires - wakeAt) < 0) _TimerSchedule();
 	return true;
 }
 
 /*******************************************************************************************
- * FunctionName	:  InitTimer1
- * Description	:  Initializes timer1
- * Parameter	:  pfunction -- timer callback function
- * 				   parg -- timer callback arguments
+ * FunctionName	:  DisarmTimer
+ * Description	:  Disarms a timer, also from its own or another timer's callback
+ * Parameters	:  iTimer -- timer
  * Return		:  bool, true if successful,
  * 						 false if failed
  ******************************************************************************************/
-bool ICACHE_FLASH_ATTR InitTimer1(void *pfunction, void *parg){
-	//register timer for deep sleep
-	os_timer_setfn(&osTimer1, (os_timer_func_t*) pfunction, NULL);
+bool ICACHE_FLASH_ATTR DisarmTimer(TIMER_ID iTimer){
+	if(!_TimerValid(iTimer)) return false;
+
+	//os timer is left armed, a wake without work only re-arms it
+	_TimerUnlink(iTimer);
+	entries[iTimer].period = 0;
 	return true;
 }
+
+/*******************************************************************************************
+ * FunctionName	:  TimerArmed
+ * Description	:  Timer state
+ * Parameters	:  iTimer -- timer
+ * Return		:  bool, true if armed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR TimerArmed(TIMER_ID iTimer){
+	return _TimerValid(iTimer) && entries[iTimer].list != TIMER_NO_LIST;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  TimerNow
+ * Description	:  Clock of timers
+ * Return		:  ms since boot, wraps after 49 days
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR TimerNow(void){
+	return _TimerClock();
+}
@@ -0,0 +1,110 @@
+/*
+ * user_tlog.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_tlog.h"
+
+//system includes
+#include <stdarg.h>
+#include "osapi.h"
+
+//user includes
+#include "driver/uart.h"
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _TLogVarint
+ * Description	:  Writes a zigzag varint (small negative values stay short)
+ * Parameters	:  oBuffer -- output
+ * 				   iValue -- value
+ * Return		:  bytes written, 1 to 5
+ ******************************************************************************************/
+uint8 ICACHE_FLASH_ATTR _TLogVarint(uint8 *oBuffer, sint32 iValue){
+	uint32 value = ((uint32)iValue << 1) ^ (uint32)(iValue >> 31);
+	uint8 length = 0;
+	while(value >= 0x80){
+		oBuffer[length++] = (uint8)value | 0x80;
+		value >>= 7;
+	}
+	oBuffer[length++] = (uint8)value;
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TLogEscape
+ * Description	:  Escapes a record in place, after its start byte
+ * Parameters	:  ioRecord -- record, room for twice its length
+ * 				   iLength -- record length
+ * Return		:  escaped length
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _TLogEscape(uint8 *ioRecord, uint16 iLength){
+	uint16 escapes = 0;
+	for(uint16 i = 1; i < iLength; ++i){
+		uint8 c = ioRecord[i];
+		escapes += c == '\n' || c == TLOG_FRAME_START || c == TLOG_ESCAPE;
+	}
+
+	//from the end, each byte moves by escapes before it
+	uint16 length = iLength + escapes;
+	for(uint16 i = iLength - 1; escapes > 0; --i){
+		uint8 c = ioRecord[i];
+		if(c == '\n' || c == TLOG_FRAME_START || c == TLOG_ESCAPE){
+			ioRecord[i + escapes] = c ^ 0x20;
+			ioRecord[i + --escapes] = TLOG_ESCAPE;
+		}
+		else ioRecord[i + escapes] = c;
+	}
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  TLogWrite
+ * Description	:  Packs a tokenised log record and queues it on UART0
+ * Parameters	:  iId -- TLOG_HASH of format string
+ * 				   iCount -- number of arguments
+ * 				   iStrings -- bit i set if argument i is a string
+ * 				   ... -- arguments
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TLogWrite(uint32 iId, uint8 iCount, uint16 iStrings, ...){
+	uint8 record[2 * TLOG_RECORD_SIZE];
+	uint16 length = 0;
+
+	record[length++] = TLOG_FRAME_START;
+	record[length++] = (uint8)iId;
+	record[length++] = (uint8)(iId >> 8);
+	record[length++] = (uint8)(iId >> 16);
+	record[length++] = (uint8)(iId >> 24);
+
+	if(iCount > TLOG_ARGS_MAX) iCount = TLOG_ARGS_MAX;
+
+	va_list args;
+	va_start(args, iStrings);
+	for(uint8 i = 0; i < iCount; ++i){
+		if(iStrings & (1 << i)){
+			//keep room for the arguments after this one
+			sint16 room = TLOG_RECORD_SIZE - length - 5 * (iCount - i - 1) - 2;
+			const char *string = va_arg(args, const char *);
+			sint16 n = 0;
+			if(string != NULL){
+				for(; n < TLOG_STRING_MAX && n < room && string[n] != '\0'; ++n) record[length + n] = string[n];
+			}
+			length += n;
+			record[length++] = '\0';
+		}
+		else length += _TLogVarint(record + length, va_arg(args, sint32));
+	}
+	va_end(args);
+
+	length = _TLogEscape(record, length);
+	record[length++] = '\n';
+
+#if UART_BUFF_EN
+	tx_buff_enq((char *)record, length);
+#else
+	uart0_tx_buffer(record, length);
+#endif
+}
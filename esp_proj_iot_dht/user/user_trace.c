@@ -0,0 +1,229 @@
+/*
+ * user_trace.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_trace.h"
+
+//system includes
+#include "osapi.h"
+
+//user includes
+#include "user_timer.h"
+#include "user_log.h"
+
+typedef struct traceStageInfo{
+	const char *name;
+	TRACE_POINT from;
+	TRACE_POINT to;
+	bool once;					//measured on first occurrence only
+} TRACE_STAGE_INFO;
+
+typedef struct traceHistogram{
+	uint32 start;				//time of latest start point
+	bool started;				//start is not paired yet
+	bool done;					//once-stage measured
+	uint32 count;
+	uint32 sum;					//ms
+	uint32 min;					//ms
+	uint32 max;					//ms
+	uint32 buckets[TRACE_BUCKETS];
+} TRACE_HISTOGRAM;
+
+static const char *pointNames[TRACE_POINTS] = {
+	"user_init", "wifi_connected", "wifi_got_ip", "link_verified",
+	"dht_start", "dht_end", "tcp_connect", "tcp_send", "tcp_sent"
+};
+
+static const TRACE_STAGE_INFO stages[TRACE_STAGES] = {
+	[TRACE_STAGE_ASSOCIATE]		= {"associate", TRACE_USER_INIT, TRACE_WIFI_CONNECTED, true},
+	[TRACE_STAGE_DHCP]			= {"dhcp", TRACE_WIFI_CONNECTED, TRACE_WIFI_GOT_IP, false},
+	[TRACE_STAGE_VERIFY]		= {"verify", TRACE_WIFI_GOT_IP, TRACE_LINK_VERIFIED, false},
+	[TRACE_STAGE_DHT_READ]		= {"dht_read", TRACE_DHT_START, TRACE_DHT_END, false},
+	[TRACE_STAGE_TCP_CONNECT]	= {"tcp_connect", TRACE_TCP_CONNECT, TRACE_TCP_SEND, false},
+	[TRACE_STAGE_TCP_ACK]		= {"tcp_ack", TRACE_TCP_SEND, TRACE_TCP_SENT, false},
+	[TRACE_STAGE_UPLOAD]		= {"upload", TRACE_DHT_END, TRACE_TCP_SENT, false},
+	[TRACE_STAGE_FIRST_UPLOAD]	= {"first_upload", TRACE_USER_INIT, TRACE_TCP_SENT, true}
+};
+
+//ring, written by TRACE
+TRACE_ENTRY traceRing[TRACE_RING] = {0};
+uint32 traceHead = 0;
+
+static uint32 traceTail = 0;
+static uint32 traceLost = 0;
+static uint32 pointCounts[TRACE_POINTS] = {0};
+static uint32 pointFirst[TRACE_POINTS] = {0};		//us since boot, valid if pointCounts > 0
+static TRACE_HISTOGRAM histograms[TRACE_STAGES];
+
+static TIMER_ID traceTimer = TIMER_NONE;
+static uint32 reportCountdown = 0;
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _TraceAdd
+ * Description	:  Adds a latency to a stage histogram
+ * Parameters	:  iHistogram -- stage histogram
+ * 				   iTime -- latency in us
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TraceAdd(TRACE_HISTOGRAM *iHistogram, uint32 iTime){
+	uint32 ms = iTime / 1000;
+	uint8 bucket = 0;
+	for(uint32 bound = 1; bucket < TRACE_BUCKETS - 1 && ms > bound; bound <<= 2) ++bucket;
+
+	++iHistogram->buckets[bucket];
+	if(iHistogram->count == 0 || ms < iHistogram->min) iHistogram->min = ms;
+	if(ms > iHistogram->max) iHistogram->max = ms;
+	iHistogram->sum += ms;
+	++iHistogram->count;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TraceDrain
+ * Description	:  Moves tracepoints from ring into stage histograms
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _TraceDrain(void){
+	uint32 head = traceHead;
+	if(head - traceTail > TRACE_RING){
+		traceLost += head - traceTail - TRACE_RING;
+		LOG_WARN(TRACE, "ring overflow, %u tracepoints lost", head - traceTail - TRACE_RING);
+		traceTail = head - TRACE_RING;
+	}
+
+	for(; traceTail != head; ++traceTail){
+		TRACE_ENTRY entry = traceRing[traceTail & (TRACE_RING - 1)];
+		if(entry.point >= TRACE_POINTS) continue;
+		if(pointCounts[entry.point]++ == 0) pointFirst[entry.point] = entry.time;
+
+		for(uint8 i = 0; i < TRACE_STAGES; ++i){
+			TRACE_HISTOGRAM *histogram = &histograms[i];
+			if(histogram->done) continue;
+
+			//a point may end one stage and start the next
+			if(entry.point == stages[i].to && histogram->started){
+				_TraceAdd(histogram, entry.time - histogram->start);
+				histogram->started = false;
+				if(stages[i].once) histogram->done = true;
+			}
+			if(entry.point == stages[i].from){
+				histogram->start = entry.time;
+				histogram->started = true;
+			}
+		}
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Trace_Timer
+ * Description	:  Drain timer callback, reports on UART every TRACE_REPORT_INTERVAL
+ * Parameters	:  arg -- unused
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Trace_Timer(void *arg){
+	_TraceDrain();
+
+	if(TRACE_REPORT_INTERVAL == 0) return;
+	if(++reportCountdown * TRACE_DRAIN_INTERVAL >= TRACE_REPORT_INTERVAL){
+		reportCountdown = 0;
+		TraceReport();
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitTrace
+ * Description	:  Starts draining tracepoint ring into stage histograms
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR InitTrace(void){
+	os_memset(histograms, 0, sizeof(histograms));
+
+	traceTimer = CreateTimer(_Trace_Timer, NULL);
+	ArmTimer(traceTimer, TRACE_DRAIN_INTERVAL * 1000, true);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  TraceReport
+ * Description	:  Prints stage histograms on UART
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TraceReport(void){
+	_TraceDrain();
+
+	os_printf("[TRACE] stage: count min/mean/max ms | <=1 <=4 <=16 <=64 <=256 <=1k <=4k <=16k <=64k >64k ms, %u lost\r\n", traceLost);
+	for(uint8 i = 0; i < TRACE_STAGES; ++i){
+		TRACE_HISTOGRAM *histogram = &histograms[i];
+		if(histogram->count == 0) continue;
+
+		uint32 *b = histogram->buckets;
+		os_printf("[TRACE] %s: %u %u/%u/%u | %u %u %u %u %u %u %u %u %u %u\r\n", stages[i].name,
+				histogram->count, histogram->min, histogram->sum / histogram->count, histogram->max,
+				b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8], b[9]);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  TraceDump
+ * Description	:  Prints ring's latest tracepoints on UART, oldest first
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR TraceDump(void){
+	uint32 head = traceHead;
+	uint32 count = (head < TRACE_RING) ? head : TRACE_RING;
+
+	os_printf("[TRACE] ring: %u tracepoints since boot, latest %u:\r\n", head, count);
+	for(uint32 i = head - count; i != head; ++i){
+		TRACE_ENTRY entry = traceRing[i & (TRACE_RING - 1)];
+		if(entry.point >= TRACE_POINTS) continue;
+		os_printf("[TRACE] #%u %s at %u.%03u ms\r\n", i, pointNames[entry.point], entry.time / 1000, entry.time % 1000);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _TraceStageJSON
+ * Description	:  Renders one stage histogram as JSON object
+ * Parameters	:  iStage -- stage
+ * 				   oBuffer -- output buffer, at least TRACE_JSON_PART_SIZE
+ * Return		:  length rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR _TraceStageJSON(TRACE_STAGE iStage, char *oBuffer){
+	TRACE_HISTOGRAM *histogram = &histograms[iStage];
+	uint32 *b = histogram->buckets;
+	return os_sprintf(oBuffer,
+			"%s{\"stage\":\"%s\",\"from\":\"%s\",\"to\":\"%s\",\"count\":%u,\"min_ms\":%u,\"max_ms\":%u,\"sum_ms\":%u,"
+			"\"buckets\":[%u,%u,%u,%u,%u,%u,%u,%u,%u,%u]}",
+			iStage == 0 ? "" : ",", stages[iStage].name, pointNames[stages[iStage].from], pointNames[stages[iStage].to],
+			histogram->count, histogram->min, histogram->max, histogram->sum,
+			b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8], b[9]);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetTraceJSON
+ * Description	:  Renders tracepoints and stage histograms as JSON, a part per call.
+ * 				   Part 0 is header, then one part per tracepoint and per stage.
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (at least TRACE_JSON_PART_SIZE)
+ * 				   ioCursor -- next part, 0 on first call
+ * Return		:  length rendered, 0 once all parts are rendered
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetTraceJSON(char *oBuffer, uint16 iSize, uint16 *ioCursor){
+	uint16 length = 0;
+	while(*ioCursor <= TRACE_POINTS + TRACE_STAGES && iSize - length >= TRACE_JSON_PART_SIZE){
+		uint16 part = *ioCursor;
+		if(part == 0){
+			_TraceDrain();
+			length += os_sprintf(oBuffer + length, "{\"lost\":%u,\"bucket_le_ms\":[1,4,16,64,256,1024,4096,16384,65536,null],\"points\":[", traceLost);
+		}
+		else if(part <= TRACE_POINTS){
+			uint8 point = part - 1;
+			length += os_sprintf(oBuffer + length, "%s{\"point\":\"%s\",\"count\":%u,\"first_ms\":%u}%s",
+					point == 0 ? "" : ",", pointNames[point], pointCounts[point], pointFirst[point] / 1000,
+					part == TRACE_POINTS ? "],\"stages\":[" : "");
+		}
+		else{
+			length += _TraceStageJSON(part - TRACE_POINTS - 1, oBuffer + length);
+			if(part == TRACE_POINTS + TRACE_STAGES) length += os_sprintf(oBuffer + length, "]}");
+		}
+		++(*ioCursor);
+	}
+	LOG_DEBUG(TRACE, "rendered %d bytes, next part %d", length, *ioCursor);
+	return length;
+}
@@ -10,53 +10,269 @@
 //system includes
 #include "osapi.h"
 
+//driver libs
+#include "driver/rodata.h"
+
 //user includes
 #include "user_wifi.h"
 
+//scanned AP data, rendered as JSON (api/scan) at send time
+static struct scanned_AP_info *APData = NULL;
+static uint8 APDataSize = 0;
+static uint32 APDataETag = 0;
+
+//dynamic tail of bundle, wraps scan results JSON
+#define BUNDLE_TAIL_OPEN			"<script>var AP="
+#define BUNDLE_TAIL_CLOSE			";</script>"
+#define BUNDLE_TAIL_SIZE			(sizeof(BUNDLE_TAIL_OPEN) - 1 + GetWifi_AP_ScanJSON(NULL, 0) + sizeof(BUNDLE_TAIL_CLOSE) - 1)
+
+//final stored deflate block header (BFINAL, BTYPE, LEN, NLEN) and gzip trailer (CRC32, ISIZE)
+#define DEFLATE_STORED_HEADER_SIZE	5
+#define GZIP_TRAILER_SIZE			8
+
+/*******************************************************************************************
+ * FunctionName	:  _CRC32Update
+ * Description	:  Continues a CRC32 (IEEE 802.3, as used by gzip) over more data
+ * Parameters	:  iCRC -- CRC32 of preceding data (0 for none)
+ * 				   iData -- data
+ * 				   iLength -- length of data
+ * Return		:  CRC32 of preceding data followed by iData
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR _CRC32Update(uint32 iCRC, const uint8 *iData, uint16 iLength){
+	uint32 crc = ~iCRC;
+	for(uint16 i = 0; i < iLength; ++i){
+		crc ^= iData[i];
+		for(uint8 bit = 0; bit < 8; ++bit)
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+	return ~crc;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _PutLE
+ * Description	:  Writes little endian value
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iValue -- value
+ * 				   iBytes -- number of bytes to write
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _PutLE(char *oBuffer, uint32 iValue, uint8 iBytes){
+	for(uint8 i = 0; i < iBytes; ++i){
+		oBuffer[i] = iValue & 0xFF;
+		iValue >>= 8;
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _IsUTF8
+ * Description	:  Checks whether ssid is valid UTF-8 (ssids are raw bytes): no overlong
+ * 				   forms, surrogates or code points past U+10FFFF, which JSON parsers reject
+ * Parameters	:  iData -- ssid
+ * 				   iLength -- ssid length
+ * Return		:  bool, true if valid UTF-8
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _IsUTF8(const uint8 *iData, uint8 iLength){
+	for(uint8 i = 0; i < iLength; ){
+		uint8 c = iData[i++];
+		uint8 continuation = 0;
+		uint8 low = 0x80, high = 0xBF;			//range of first continuation byte
+		if(c < 0x80) continue;
+		else if(c >= 0xC2 && c <= 0xDF) continuation = 1;
+		else if(c >= 0xE0 && c <= 0xEF) continuation = 2;
+		else if(c >= 0xF0 && c <= 0xF4) continuation = 3;
+		else return false;
+
+		if(c == 0xE0) low = 0xA0;				//overlong
+		else if(c == 0xED) high = 0x9F;			//surrogate
+		else if(c == 0xF0) low = 0x90;			//overlong
+		else if(c == 0xF4) high = 0x8F;			//past U+10FFFF
+		for(; continuation > 0; --continuation, ++i, low = 0x80, high = 0xBF){
+			if(i >= iLength || iData[i] < low || iData[i] > high) return false;
+		}
+	}
+	return true;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _PutJSONString
+ * Description	:  Appends ssid to writer output as JSON string. Bytes of an ssid that is not
+ * 				   UTF-8 are escaped as latin-1 code points, and '<' is escaped so the
+ * 				   output can be inlined in a <script> element.
+ * Parameters	:  oBuffer -- output buffer, may be NULL
+ * 				   iSize -- size of output buffer
+ * 				   ioLength -- length written so far
+ * 				   iData -- ssid
+ * 				   iLength -- ssid length
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _PutJSONString(char *oBuffer, uint16 iSize, uint16 *ioLength, const uint8 *iData, uint8 iLength){
+	bool utf8 = _IsUTF8(iData, iLength);
+	char escaped[8];
+
+	httpPut(oBuffer, iSize, ioLength, "\"", 1);
+	for(uint8 i = 0; i < iLength; ++i){
+		uint8 c = iData[i];
+		if(c == '"' || c == '\\'){
+			escaped[0] = '\\';
+			escaped[1] = c;
+			httpPut(oBuffer, iSize, ioLength, escaped, 2);
+		}
+		else if(c < 0x20 || c == '<' || (c >= 0x80 && !utf8)){
+			httpPut(oBuffer, iSize, ioLength, escaped, os_sprintf(escaped, "\\u%04x", c));
+		}
+		else{
+			httpPut(oBuffer, iSize, ioLength, (char*) &c, 1);
+		}
+	}
+	httpPut(oBuffer, iSize, ioLength, "\"", 1);
+}
+
 /*******************************************************************************************
  * FunctionName	:  GetWifi_AP_HTML
  * Description	:  Used to retrieve HTML Page of Station Select Page
- * Return		:  HTML String
+ * Return		:  HTML asset
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_HTML(void){
-	return WIFI_AP_HTML;
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_HTML(void){
+	return &WIFI_AP_HTML;
 }
 
 /*******************************************************************************************
  * FunctionName	:  GetWifi_AP_CSS
  * Description	:  Used to retrieve CSS of HTML Page of Station Select Page
- * Return		:  CSS String
+ * Return		:  CSS asset
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_CSS(void){
-	return WIFI_AP_CSS;
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_CSS(void){
+	return &WIFI_AP_CSS;
 }
 
 /*******************************************************************************************
- * FunctionName	:  GetWifi_AP_CSS
+ * FunctionName	:  GetWifi_AP_JS
  * Description	:  Used to retrieve JS of HTML Page of Station Select Page
- * Return		:  JS String
+ * Return		:  JS asset
  ******************************************************************************************/
-char* ICACHE_FLASH_ATTR GetWifi_AP_JS(void){
-	return WIFI_AP_JS;
+const WEB_ASSET* ICACHE_FLASH_ATTR GetWifi_AP_JS(void){
+	return &WIFI_AP_JS;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_ScanJSON
+ * Description	:  Renders scan results (api/scan) as JSON array of
+ * 				   {"ssid":"..","rssi":-60,"channel":6,"authmode":3}. HTTP_CONTENT_WRITER.
+ * Parameters	:  oBuffer -- output buffer, NULL to only measure
+ * 				   iSize -- size of output buffer
+ * Return		:  length of rendered JSON (output is cut if iSize is smaller)
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_ScanJSON(char *oBuffer, uint16 iSize){
+	uint16 length = 0;
+	char fields[48];
+
+	httpPut(oBuffer, iSize, &length, "[", 1);
+	for(uint8 i = 0; i < APDataSize; ++i){
+		if(APData[i].ssid_len == 0) break;
+
+		if(i != 0) httpPut(oBuffer, iSize, &length, ",", 1);
+		httpPut(oBuffer, iSize, &length, "{\"ssid\":", 8);
+		_PutJSONString(oBuffer, iSize, &length, APData[i].ssid,
+				APData[i].ssid_len < sizeof(APData[i].ssid) ? APData[i].ssid_len : sizeof(APData[i].ssid));
+		httpPut(oBuffer, iSize, &length, fields, os_sprintf(fields, ",\"rssi\":%d,\"channel\":%d,\"authmode\":%d}",
+				APData[i].rssi, APData[i].channel, APData[i].authmode));
+	}
+	httpPut(oBuffer, iSize, &length, "]", 1);
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_BundleSize
+ * Description	:  Used to retrieve size of buffer needed to render Station Select Page bundle
+ * Parameters	:  iGzip -- true, for gzip encoded bundle
+ * Return		:  buffer size
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_BundleSize(bool iGzip){
+	if(iGzip)
+		return WIFI_AP_BUNDLE.gzipPrefixLength + DEFLATE_STORED_HEADER_SIZE + BUNDLE_TAIL_SIZE + GZIP_TRAILER_SIZE;
+	return WIFI_AP_BUNDLE.contentLength + BUNDLE_TAIL_SIZE;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_Bundle
+ * Description	:  Renders single document Station Select Page with scanned AP data
+ * Parameters	:  oBuffer -- output buffer
+ * 				   iSize -- size of output buffer (see GetWifi_AP_BundleSize)
+ * 				   iGzip -- true, to render gzip encoded bundle
+ * Return		:  length of rendered bundle, 0 if buffer is too small
+ ******************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetWifi_AP_Bundle(char *oBuffer, uint16 iSize, bool iGzip){
+	if(oBuffer == NULL || iSize < GetWifi_AP_BundleSize(iGzip)) return 0;
+
+	uint16 length = 0;
+	if(iGzip){
+		rodata_memcpy(oBuffer, WIFI_AP_BUNDLE.gzipPrefix, WIFI_AP_BUNDLE.gzipPrefixLength);
+		length = WIFI_AP_BUNDLE.gzipPrefixLength + DEFLATE_STORED_HEADER_SIZE;
+	}
+	else{
+		rodata_memcpy(oBuffer, WIFI_AP_BUNDLE.content, WIFI_AP_BUNDLE.contentLength);
+		length = WIFI_AP_BUNDLE.contentLength;
+	}
+
+	//dynamic tail, copied without terminator as buffer may end right after it
+	char *tail = oBuffer + length;
+	uint16 tailLength = sizeof(BUNDLE_TAIL_OPEN) - 1;
+	os_memcpy(tail, BUNDLE_TAIL_OPEN, tailLength);
+	tailLength += GetWifi_AP_ScanJSON(tail + tailLength, iSize - length - tailLength);
+	os_memcpy(tail + tailLength, BUNDLE_TAIL_CLOSE, sizeof(BUNDLE_TAIL_CLOSE) - 1);
+	tailLength += sizeof(BUNDLE_TAIL_CLOSE) - 1;
+	length += tailLength;
+
+	if(iGzip){
+		//prefix ends on a byte boundary (sync flush), tail goes uncompressed in the final block
+		char *blockHeader = tail - DEFLATE_STORED_HEADER_SIZE;
+		blockHeader[0] = 0x01;					//BFINAL = 1, BTYPE = 00 (stored)
+		_PutLE(blockHeader + 1, tailLength, 2);
+		_PutLE(blockHeader + 3, ~tailLength, 2);
+
+		_PutLE(oBuffer + length, _CRC32Update(WIFI_AP_BUNDLE.crc, (uint8*) tail, tailLength), 4);
+		_PutLE(oBuffer + length + 4, WIFI_AP_BUNDLE.contentLength + tailLength, 4);
+		length += GZIP_TRAILER_SIZE;
+	}
+	return length;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_BundleETag
+ * Description	:  Used to retrieve weak validator of Station Select Page bundle
+ * Return		:  hash of bundle, changes whenever page or scan data changes
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR GetWifi_AP_BundleETag(void){
+	return WIFI_AP_BUNDLE.etag ^ APDataETag;
 }
 
 /*******************************************************************************************
  * FunctionName	:  UpdateJSData
- * Description	:  Appends scanned AP data in JS Script
+ * Description	:  Updates scanned AP data served to Station Select Page
  * Parameters	:  scanned_APs -- scanned APs array
  * 				   size -- size of scanned AP's array
  ******************************************************************************************/
 void ICACHE_FLASH_ATTR UpdateJSData(struct scanned_AP_info *scanned_APs, uint8 size){
-	char ssidBuff[300];
-	os_memset(ssidBuff, 0, 300);
+	APData = scanned_APs;
+	APDataSize = size;
+
+	//FNV-1a over scan results, used as weak validator of api/scan
+	uint32 hash = 0x811C9DC5;
 	for(uint8 i = 0; i < size; ++i){
-		if(scanned_APs[i].ssid[0] != 0x00){
-			if(i != 0) os_sprintf(ssidBuff + os_strlen(ssidBuff), ",");
-			os_sprintf(ssidBuff + os_strlen(ssidBuff),"'%s'", (char*)scanned_APs[i].ssid);
+		for(uint8 j = 0; j < scanned_APs[i].ssid_len && j < sizeof(scanned_APs[i].ssid); ++j){
+			hash = (hash ^ scanned_APs[i].ssid[j]) * 0x01000193;
 		}
-		else
-			break;
+		hash = (hash ^ 0xFF) * 0x01000193;		//separator
+		hash = (hash ^ (uint8) scanned_APs[i].rssi) * 0x01000193;
+		hash = (hash ^ scanned_APs[i].channel) * 0x01000193;
+		hash = (hash ^ scanned_APs[i].authmode) * 0x01000193;
 	}
-	char *JS_End = os_strstr(WIFI_AP_JS, "});");
-	os_sprintf(JS_End + 3, "var AP=[%s];", ssidBuff);
+	APDataETag = hash;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  GetWifi_AP_DataETag
+ * Description	:  Used to retrieve weak validator of scan results (api/scan)
+ * Return		:  hash of scanned AP data, changes whenever scan data changes
+ ******************************************************************************************/
+uint32 ICACHE_FLASH_ATTR GetWifi_AP_DataETag(void){
+	return APDataETag;
 }
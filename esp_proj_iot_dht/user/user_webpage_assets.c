@@ -0,0 +1,371 @@
+/*
+ * user_webpage_assets.c
+ *
+ *  Generated by tools/webpage_gen.py from webpage/, do not edit.
+ */
+
+#include "user_webpage.h"
+
+/****************************** index.html ******************************/
+
+static const uint8 wifi_ap_html[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x3c, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x45, 0x53, 0x50, 0x38, 0x32, 0x36, 0x36, 0x3c, 0x2f,
+	0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x3c, 0x6d, 0x65, 0x74, 0x61, 0x20, 0x63, 0x6f, 0x6e, 0x74,
+	0x65, 0x6e, 0x74, 0x3d, 0x22, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3d, 0x64, 0x65, 0x76, 0x69, 0x63,
+	0x65, 0x2d, 0x77, 0x69, 0x64, 0x74, 0x68, 0x2c, 0x69, 0x6e, 0x69, 0x74, 0x69, 0x61, 0x6c, 0x2d,
+	0x73, 0x63, 0x61, 0x6c, 0x65, 0x3d, 0x31, 0x22, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x3d, 0x22, 0x76,
+	0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x22, 0x3e, 0x3c, 0x6c, 0x69, 0x6e, 0x6b, 0x20, 0x72,
+	0x65, 0x6c, 0x3d, 0x22, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x73, 0x68, 0x65, 0x65, 0x74, 0x22, 0x20,
+	0x68, 0x72, 0x65, 0x66, 0x3d, 0x22, 0x2e, 0x2f, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x73, 0x2e, 0x63,
+	0x73, 0x73, 0x22, 0x3e, 0x3c, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x20, 0x73, 0x72, 0x63, 0x3d,
+	0x22, 0x2e, 0x2f, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x2e, 0x6a, 0x73, 0x22, 0x3e, 0x3c, 0x2f,
+	0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x3e, 0x3c, 0x68, 0x32, 0x3e, 0x57, 0x69, 0x46, 0x69, 0x20,
+	0x4e, 0x65, 0x74, 0x77, 0x6f, 0x72, 0x6b, 0x73, 0x3c, 0x2f, 0x68, 0x32, 0x3e, 0x3c, 0x66, 0x6f,
+	0x72, 0x6d, 0x20, 0x69, 0x64, 0x3d, 0x22, 0x66, 0x22, 0x20, 0x6d, 0x65, 0x74, 0x68, 0x6f, 0x64,
+	0x3d, 0x22, 0x50, 0x4f, 0x53, 0x54, 0x22, 0x3e, 0x3c, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x20, 0x69,
+	0x64, 0x3d, 0x22, 0x50, 0x22, 0x20, 0x74, 0x79, 0x70, 0x65, 0x3d, 0x22, 0x70, 0x61, 0x73, 0x73,
+	0x77, 0x6f, 0x72, 0x64, 0x22, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x3d, 0x22, 0x50, 0x22, 0x20, 0x70,
+	0x6c, 0x61, 0x63, 0x65, 0x68, 0x6f, 0x6c, 0x64, 0x65, 0x72, 0x3d, 0x22, 0x45, 0x6e, 0x74, 0x65,
+	0x72, 0x20, 0x57, 0x69, 0x46, 0x69, 0x20, 0x50, 0x61, 0x73, 0x73, 0x77, 0x6f, 0x72, 0x64, 0x22,
+	0x3e, 0x3c, 0x62, 0x72, 0x3e, 0x3c, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x20, 0x69, 0x64, 0x3d, 0x22,
+	0x49, 0x22, 0x20, 0x74, 0x79, 0x70, 0x65, 0x3d, 0x22, 0x73, 0x75, 0x62, 0x6d, 0x69, 0x74, 0x22,
+	0x20, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x3d, 0x22, 0x53, 0x55, 0x42, 0x4d, 0x49, 0x54, 0x22, 0x3e,
+	0x3c, 0x2f, 0x66, 0x6f, 0x72, 0x6d, 0x3e,
+};
+
+static const uint8 wifi_ap_html_gz[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x4d, 0x8f, 0x41, 0x6b, 0xc3, 0x30,
+	0x0c, 0x85, 0xff, 0x8a, 0xf1, 0x79, 0x4d, 0x58, 0x0f, 0x65, 0x07, 0xdb, 0x87, 0x41, 0x0b, 0x3d,
+	0xac, 0x0d, 0x64, 0x63, 0x67, 0xd7, 0x51, 0xb0, 0x56, 0xc7, 0x36, 0xb6, 0x92, 0xd0, 0x7f, 0x3f,
+	0x27, 0x5d, 0x60, 0x37, 0x7d, 0x7a, 0x92, 0xde, 0x93, 0x20, 0x24, 0x07, 0xea, 0xd8, 0x36, 0x6f,
+	0xfb, 0xc3, 0x41, 0xd4, 0x4f, 0x14, 0x03, 0x90, 0x66, 0x26, 0x78, 0x02, 0x4f, 0x92, 0xcf, 0xd8,
+	0x91, 0x95, 0x1d, 0x4c, 0x68, 0x60, 0xb7, 0xc2, 0x0b, 0x7a, 0x24, 0xd4, 0x6e, 0x97, 0x8d, 0x76,
+	0x20, 0x5f, 0x39, 0xf3, 0x7a, 0x00, 0xc9, 0x27, 0x84, 0x39, 0x86, 0x44, 0x5c, 0x09, 0x87, 0xfe,
+	0xce, 0x12, 0x38, 0xc9, 0x33, 0x3d, 0x1c, 0x64, 0x0b, 0x40, 0x9c, 0xd9, 0x04, 0xbd, 0xe4, 0x55,
+	0xfd, 0xec, 0x55, 0x26, 0xe7, 0x32, 0x9a, 0x4d, 0xc2, 0x48, 0x2c, 0x27, 0xb3, 0x4a, 0x2b, 0x55,
+	0x3f, 0x8b, 0xf2, 0x07, 0x4a, 0xd8, 0xbd, 0xfa, 0xc6, 0x13, 0xb2, 0x0b, 0xd0, 0x1c, 0xd2, 0x3d,
+	0x8b, 0xba, 0x74, 0x44, 0x1f, 0xd2, 0xc0, 0xb0, 0x93, 0xbc, 0xe7, 0xac, 0x44, 0xb6, 0xa1, 0x94,
+	0xcd, 0xb5, 0xfd, 0x2c, 0x9b, 0xe8, 0xe3, 0x48, 0xab, 0xd6, 0x70, 0x46, 0x8f, 0x58, 0xc2, 0x45,
+	0x9d, 0x73, 0x59, 0xee, 0xb6, 0xb0, 0x45, 0x88, 0x4e, 0x1b, 0xb0, 0xc1, 0x75, 0x90, 0x24, 0x3f,
+	0x96, 0x77, 0x13, 0x5b, 0x6d, 0x9a, 0x6d, 0x54, 0x89, 0x5b, 0xfa, 0x7f, 0xec, 0xbc, 0x1d, 0xcb,
+	0xe3, 0x6d, 0xc0, 0xf2, 0xd0, 0xa4, 0xdd, 0x58, 0xb0, 0xfd, 0x7a, 0xff, 0x38, 0x2f, 0xbe, 0xf5,
+	0x92, 0x49, 0xfd, 0x02, 0x23, 0x2b, 0x05, 0x51, 0x57, 0x01, 0x00, 0x00,
+};
+
+const WEB_ASSET WIFI_AP_HTML = {
+	wifi_ap_html, 343,
+	wifi_ap_html_gz, 252,
+	0xb9190427,
+	text_html
+};
+
+/****************************** styles.css ******************************/
+
+static const uint8 wifi_ap_css[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x68, 0x32, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f,
+	0x6c, 0x6f, 0x72, 0x3a, 0x23, 0x66, 0x66, 0x39, 0x38, 0x30, 0x30, 0x3b, 0x70, 0x61, 0x64, 0x64,
+	0x69, 0x6e, 0x67, 0x3a, 0x32, 0x25, 0x3b, 0x66, 0x6f, 0x6e, 0x74, 0x2d, 0x73, 0x74, 0x79, 0x6c,
+	0x65, 0x3a, 0x6f, 0x62, 0x6c, 0x69, 0x71, 0x75, 0x65, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72,
+	0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x35, 0x70, 0x78, 0x3b, 0x63, 0x6f, 0x6c, 0x6f,
+	0x72, 0x3a, 0x23, 0x66, 0x30, 0x66, 0x38, 0x66, 0x66, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e,
+	0x3a, 0x2e, 0x35, 0x25, 0x7d, 0x66, 0x6f, 0x72, 0x6d, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72,
+	0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x23, 0x66, 0x32, 0x66, 0x32,
+	0x66, 0x32, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x3a,
+	0x67, 0x72, 0x6f, 0x6f, 0x76, 0x65, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x72, 0x61,
+	0x64, 0x69, 0x75, 0x73, 0x3a, 0x35, 0x70, 0x78, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a,
+	0x2e, 0x35, 0x25, 0x7d, 0x64, 0x69, 0x76, 0x7b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x31,
+	0x30, 0x70, 0x78, 0x7d, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x7b, 0x66, 0x6f, 0x6e, 0x74, 0x2d, 0x73,
+	0x69, 0x7a, 0x65, 0x3a, 0x6c, 0x61, 0x72, 0x67, 0x65, 0x72, 0x3b, 0x66, 0x6f, 0x6e, 0x74, 0x2d,
+	0x66, 0x61, 0x6d, 0x69, 0x6c, 0x79, 0x3a, 0x73, 0x61, 0x6e, 0x73, 0x2d, 0x73, 0x65, 0x72, 0x69,
+	0x66, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x32, 0x70, 0x78, 0x7d, 0x23, 0x49, 0x2c,
+	0x23, 0x50, 0x7b, 0x70, 0x61, 0x64, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x2e, 0x37, 0x35, 0x25, 0x3b,
+	0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x31, 0x30, 0x70, 0x78, 0x3b, 0x62, 0x6f, 0x78, 0x2d,
+	0x73, 0x68, 0x61, 0x64, 0x6f, 0x77, 0x3a, 0x69, 0x6e, 0x73, 0x65, 0x74, 0x20, 0x30, 0x20, 0x31,
+	0x70, 0x78, 0x20, 0x33, 0x70, 0x78, 0x20, 0x23, 0x64, 0x64, 0x64, 0x3b, 0x62, 0x6f, 0x72, 0x64,
+	0x65, 0x72, 0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x34, 0x70, 0x78, 0x3b, 0x62, 0x6f,
+	0x72, 0x64, 0x65, 0x72, 0x3a, 0x31, 0x70, 0x78, 0x20, 0x73, 0x6f, 0x6c, 0x69, 0x64, 0x20, 0x23,
+	0x63, 0x63, 0x63, 0x7d,
+};
+
+static const uint8 wifi_ap_css_gz[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x8f, 0x51, 0x4e, 0xc4, 0x20,
+	0x10, 0x86, 0xaf, 0xd2, 0x84, 0xf4, 0x4d, 0x36, 0x6c, 0xb5, 0x71, 0x85, 0x13, 0xf8, 0xe6, 0x15,
+	0x28, 0x03, 0xdd, 0x89, 0x94, 0xa9, 0xd0, 0xae, 0x5d, 0x9b, 0xde, 0x5d, 0x6a, 0xad, 0xd9, 0x98,
+	0x0d, 0x99, 0x87, 0x81, 0xf9, 0xbf, 0xf9, 0x38, 0x57, 0x73, 0xa3, 0xcd, 0x7b, 0x1b, 0x69, 0x0c,
+	0xc0, 0x0d, 0x79, 0x8a, 0x92, 0x39, 0xf7, 0x72, 0x12, 0x42, 0xf5, 0x1a, 0x00, 0x43, 0x2b, 0xab,
+	0x52, 0x39, 0x0a, 0x03, 0x4f, 0xc3, 0xd5, 0x5b, 0x49, 0x8d, 0xc7, 0x8f, 0xd1, 0xaa, 0x86, 0x22,
+	0xd8, 0xc8, 0xa3, 0x06, 0x1c, 0x93, 0xac, 0xfb, 0x49, 0xed, 0x69, 0xe1, 0x4e, 0xce, 0xa9, 0x4e,
+	0xc7, 0x16, 0x83, 0x3c, 0xd4, 0xe5, 0xe2, 0x28, 0x76, 0xf7, 0xd6, 0x54, 0xeb, 0xd9, 0x41, 0x1b,
+	0x3d, 0x4f, 0xd0, 0xe5, 0x1e, 0xfc, 0x06, 0x07, 0x78, 0x99, 0x7f, 0xdb, 0xa3, 0xe8, 0xa7, 0xc5,
+	0xeb, 0xc6, 0xfa, 0x79, 0x53, 0xc4, 0x2f, 0x2b, 0x7d, 0x7e, 0xb3, 0x71, 0x73, 0x76, 0xba, 0x43,
+	0x7f, 0x95, 0x49, 0x87, 0xc4, 0x93, 0x8d, 0xf8, 0xe7, 0x55, 0xe5, 0x20, 0x7b, 0x7d, 0x60, 0x6f,
+	0xf3, 0xfe, 0xcd, 0xc3, 0x73, 0x5d, 0xaa, 0x1b, 0x6e, 0x96, 0x98, 0x78, 0x3a, 0x6b, 0xa0, 0x4f,
+	0x89, 0x21, 0xd9, 0xa1, 0x10, 0xc5, 0xb1, 0x9f, 0x8a, 0xc7, 0x5c, 0x0c, 0x00, 0xfe, 0x49, 0x3e,
+	0xfd, 0x24, 0xd6, 0x1b, 0xb9, 0x4e, 0x25, 0xf2, 0x08, 0x05, 0x33, 0xc6, 0x2c, 0xdf, 0xc1, 0xcd,
+	0x61, 0xad, 0x64, 0x01, 0x00, 0x00,
+};
+
+const WEB_ASSET WIFI_AP_CSS = {
+	wifi_ap_css, 356,
+	wifi_ap_css_gz, 230,
+	0x76d66152,
+	text_css
+};
+
+/****************************** script.js ******************************/
+
+static const uint8 wifi_ap_js[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x72, 0x65, 0x6e, 0x64, 0x65, 0x72, 0x28,
+	0x6c, 0x69, 0x73, 0x74, 0x29, 0x7b, 0x6c, 0x65, 0x74, 0x20, 0x66, 0x6f, 0x72, 0x6d, 0x3d, 0x64,
+	0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x67, 0x65, 0x74, 0x45, 0x6c, 0x65, 0x6d, 0x65,
+	0x6e, 0x74, 0x42, 0x79, 0x49, 0x64, 0x28, 0x27, 0x66, 0x27, 0x29, 0x3b, 0x66, 0x6f, 0x72, 0x28,
+	0x6c, 0x65, 0x74, 0x20, 0x74, 0x3d, 0x6c, 0x69, 0x73, 0x74, 0x2e, 0x6c, 0x65, 0x6e, 0x67, 0x74,
+	0x68, 0x2d, 0x31, 0x3b, 0x74, 0x3e, 0x3d, 0x30, 0x3b, 0x2d, 0x2d, 0x74, 0x29, 0x7b, 0x6c, 0x65,
+	0x74, 0x20, 0x73, 0x73, 0x69, 0x64, 0x3d, 0x6c, 0x69, 0x73, 0x74, 0x5b, 0x74, 0x5d, 0x2e, 0x73,
+	0x73, 0x69, 0x64, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x66, 0x69, 0x72, 0x73, 0x74, 0x3d, 0x66, 0x6f,
+	0x72, 0x6d, 0x2e, 0x63, 0x68, 0x69, 0x6c, 0x64, 0x4e, 0x6f, 0x64, 0x65, 0x73, 0x5b, 0x30, 0x5d,
+	0x3b, 0x6c, 0x65, 0x74, 0x20, 0x64, 0x69, 0x76, 0x3d, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e,
+	0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28,
+	0x27, 0x64, 0x69, 0x76, 0x27, 0x29, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x72, 0x61, 0x64, 0x69, 0x6f,
+	0x3d, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65,
+	0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x27, 0x29,
+	0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62,
+	0x75, 0x74, 0x65, 0x28, 0x27, 0x74, 0x79, 0x70, 0x65, 0x27, 0x2c, 0x27, 0x72, 0x61, 0x64, 0x69,
+	0x6f, 0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74,
+	0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x6e, 0x61, 0x6d, 0x65, 0x27, 0x2c, 0x27, 0x53,
+	0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72,
+	0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x63, 0x68, 0x65, 0x63, 0x6b, 0x65, 0x64, 0x27, 0x2c,
+	0x27, 0x63, 0x68, 0x65, 0x63, 0x6b, 0x65, 0x64, 0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f,
+	0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x76,
+	0x61, 0x6c, 0x75, 0x65, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69,
+	0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27,
+	0x69, 0x64, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b, 0x64, 0x69, 0x76, 0x2e, 0x61, 0x70,
+	0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64, 0x28, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x29,
+	0x3b, 0x6c, 0x65, 0x74, 0x20, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x3d, 0x64, 0x6f, 0x63, 0x75, 0x6d,
+	0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e,
+	0x74, 0x28, 0x27, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x27, 0x29, 0x3b, 0x6c, 0x61, 0x62, 0x65, 0x6c,
+	0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x66,
+	0x6f, 0x72, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x2e,
+	0x74, 0x65, 0x78, 0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x3d, 0x73, 0x73, 0x69, 0x64,
+	0x2b, 0x27, 0x20, 0x28, 0x27, 0x2b, 0x6c, 0x69, 0x73, 0x74, 0x5b, 0x74, 0x5d, 0x2e, 0x72, 0x73,
+	0x73, 0x69, 0x2b, 0x27, 0x20, 0x64, 0x42, 0x6d, 0x27, 0x2b, 0x28, 0x6c, 0x69, 0x73, 0x74, 0x5b,
+	0x74, 0x5d, 0x2e, 0x61, 0x75, 0x74, 0x68, 0x6d, 0x6f, 0x64, 0x65, 0x3f, 0x27, 0x27, 0x3a, 0x27,
+	0x2c, 0x20, 0x6f, 0x70, 0x65, 0x6e, 0x27, 0x29, 0x2b, 0x27, 0x29, 0x27, 0x3b, 0x64, 0x69, 0x76,
+	0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64, 0x28, 0x6c, 0x61, 0x62,
+	0x65, 0x6c, 0x29, 0x3b, 0x64, 0x69, 0x76, 0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68,
+	0x69, 0x6c, 0x64, 0x28, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65,
+	0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x62, 0x72, 0x27, 0x29,
+	0x29, 0x3b, 0x66, 0x6f, 0x72, 0x6d, 0x2e, 0x69, 0x6e, 0x73, 0x65, 0x72, 0x74, 0x42, 0x65, 0x66,
+	0x6f, 0x72, 0x65, 0x28, 0x64, 0x69, 0x76, 0x2c, 0x66, 0x69, 0x72, 0x73, 0x74, 0x29, 0x3b, 0x7d,
+	0x7d, 0x0a, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x61, 0x64, 0x64, 0x45, 0x76,
+	0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x65, 0x6e, 0x65, 0x72, 0x28, 0x27, 0x44, 0x4f, 0x4d,
+	0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x4c, 0x6f, 0x61, 0x64, 0x65, 0x64, 0x27, 0x2c, 0x66,
+	0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x28, 0x29, 0x7b, 0x69, 0x66, 0x28, 0x74, 0x79, 0x70,
+	0x65, 0x6f, 0x66, 0x20, 0x41, 0x50, 0x21, 0x3d, 0x3d, 0x27, 0x75, 0x6e, 0x64, 0x65, 0x66, 0x69,
+	0x6e, 0x65, 0x64, 0x27, 0x29, 0x7b, 0x72, 0x65, 0x6e, 0x64, 0x65, 0x72, 0x28, 0x41, 0x50, 0x29,
+	0x3b, 0x7d, 0x65, 0x6c, 0x73, 0x65, 0x7b, 0x66, 0x65, 0x74, 0x63, 0x68, 0x28, 0x27, 0x2e, 0x2f,
+	0x61, 0x70, 0x69, 0x2f, 0x73, 0x63, 0x61, 0x6e, 0x27, 0x29, 0x2e, 0x74, 0x68, 0x65, 0x6e, 0x28,
+	0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x28, 0x72, 0x65, 0x73, 0x70, 0x6f, 0x6e, 0x73,
+	0x65, 0x29, 0x7b, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x72, 0x65, 0x73, 0x70, 0x6f, 0x6e,
+	0x73, 0x65, 0x2e, 0x6a, 0x73, 0x6f, 0x6e, 0x28, 0x29, 0x3b, 0x7d, 0x29, 0x2e, 0x74, 0x68, 0x65,
+	0x6e, 0x28, 0x72, 0x65, 0x6e, 0x64, 0x65, 0x72, 0x29, 0x3b, 0x7d, 0x7d, 0x29, 0x3b,
+};
+
+static const uint8 wifi_ap_js_gz[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x53, 0xc1, 0x6e, 0xdb, 0x30,
+	0x0c, 0xbd, 0xef, 0x2b, 0xb2, 0x13, 0x65, 0x24, 0x51, 0xbb, 0xeb, 0x0c, 0x6f, 0x48, 0xba, 0x1e,
+	0x06, 0x74, 0x5b, 0x81, 0x1d, 0x8b, 0x1e, 0x14, 0x8b, 0xae, 0xb5, 0xd9, 0x92, 0x21, 0xd1, 0xc1,
+	0x8a, 0x20, 0xff, 0x3e, 0x52, 0xb1, 0x3b, 0x60, 0xad, 0x4f, 0x96, 0xc8, 0xc7, 0xf7, 0xf8, 0x44,
+	0xba, 0x19, 0x7d, 0x4d, 0x2e, 0xf8, 0x55, 0x44, 0x6f, 0x31, 0xaa, 0xce, 0x25, 0x2a, 0x4e, 0x1d,
+	0xd2, 0xaa, 0x09, 0xb1, 0xaf, 0x6c, 0xa8, 0xc7, 0x1e, 0x3d, 0xe9, 0x27, 0xa4, 0xdb, 0x0e, 0xe5,
+	0xb8, 0x7f, 0xfe, 0x6a, 0x15, 0x34, 0x50, 0x94, 0x8c, 0x50, 0x82, 0xa4, 0x4a, 0xaa, 0x74, 0x87,
+	0xfe, 0x89, 0xda, 0xed, 0x87, 0x92, 0x3e, 0x55, 0xd7, 0xe5, 0x76, 0x3b, 0xf1, 0xa4, 0xe4, 0x6c,
+	0x06, 0x3c, 0xd0, 0xa3, 0x96, 0x4b, 0x99, 0xd9, 0x5d, 0x4c, 0x54, 0x89, 0x86, 0xae, 0x5b, 0xd7,
+	0xd9, 0xef, 0xc1, 0x62, 0x7a, 0xb8, 0x7e, 0xcc, 0x49, 0xeb, 0x8e, 0xff, 0x94, 0xeb, 0x88, 0x86,
+	0x70, 0x12, 0x57, 0xc0, 0x39, 0x96, 0x16, 0x54, 0x34, 0xd6, 0x85, 0x45, 0x9c, 0xf3, 0xc3, 0x48,
+	0x8c, 0xcc, 0x28, 0x9d, 0x90, 0x76, 0x44, 0xd1, 0x1d, 0x46, 0x42, 0x05, 0xf4, 0x3c, 0x20, 0x6c,
+	0x20, 0xa7, 0x16, 0x20, 0xde, 0xf4, 0x02, 0xf9, 0xb9, 0x90, 0xae, 0x5b, 0xac, 0x7f, 0xa3, 0x65,
+	0xc4, 0x7c, 0x7a, 0x1b, 0x77, 0x34, 0xdd, 0xc8, 0x3c, 0x62, 0xfb, 0x6d, 0x80, 0xb3, 0x73, 0x96,
+	0x8d, 0x69, 0x33, 0x0c, 0x3c, 0x86, 0x1b, 0x79, 0x10, 0x95, 0xd1, 0x17, 0xa7, 0x9d, 0x39, 0x60,
+	0xb7, 0xe8, 0x34, 0x67, 0xe5, 0x4d, 0xe4, 0xfb, 0x1f, 0x3d, 0x3f, 0xf0, 0xcc, 0x7f, 0x49, 0x13,
+	0xfe, 0xa1, 0x9b, 0xe0, 0x89, 0x2b, 0x2b, 0x89, 0xaf, 0x61, 0xa5, 0x60, 0x3d, 0x8f, 0x27, 0x72,
+	0x88, 0x23, 0x76, 0xdf, 0xc3, 0x5a, 0xcd, 0x41, 0x33, 0x52, 0xdb, 0xf3, 0x78, 0x3e, 0x03, 0x7c,
+	0x84, 0xcd, 0x2a, 0x70, 0x8b, 0x50, 0xac, 0xa1, 0x80, 0x57, 0x2d, 0x67, 0x89, 0xd7, 0x4e, 0x96,
+	0x1a, 0x3f, 0x44, 0x28, 0xf2, 0x16, 0xf5, 0xda, 0xf9, 0x84, 0x91, 0xf6, 0xc8, 0x17, 0x54, 0x5c,
+	0xbf, 0xc9, 0xfb, 0x51, 0x94, 0xe7, 0xf3, 0xbb, 0x97, 0x6a, 0x63, 0xed, 0xed, 0x91, 0x0f, 0x77,
+	0xdc, 0x17, 0x7a, 0xde, 0x55, 0xf8, 0xf2, 0xe3, 0xdb, 0xe4, 0xe5, 0x2e, 0x18, 0x2b, 0xe3, 0x68,
+	0xa6, 0x75, 0x56, 0xc5, 0xc9, 0x35, 0x4a, 0xe6, 0x1c, 0x9a, 0xd5, 0xee, 0xfe, 0x7d, 0x55, 0xc1,
+	0xc8, 0xfb, 0xdd, 0x38, 0x2f, 0xa3, 0x3a, 0x4d, 0xcb, 0xbe, 0xbb, 0x67, 0x05, 0xec, 0x12, 0x9e,
+	0x1a, 0xa4, 0xba, 0x55, 0xa0, 0xaf, 0xcc, 0xe0, 0xae, 0x52, 0x6d, 0xd8, 0xa1, 0xa6, 0x16, 0xbd,
+	0x7a, 0x21, 0x8c, 0x98, 0x86, 0xc0, 0x5d, 0x4a, 0x31, 0x8d, 0x51, 0x7e, 0x98, 0x4b, 0x40, 0xff,
+	0x4a, 0xa2, 0x57, 0x9e, 0xa7, 0x8a, 0x0b, 0xb7, 0xb4, 0x5e, 0x94, 0x7f, 0x01, 0xfa, 0x2e, 0x49,
+	0x10, 0x5e, 0x03, 0x00, 0x00,
+};
+
+const WEB_ASSET WIFI_AP_JS = {
+	wifi_ap_js, 862,
+	wifi_ap_js_gz, 437,
+	0xcbb9edd2,
+	application_javascript
+};
+
+/****************************** bundle ******************************/
+
+static const uint8 wifi_ap_bundle[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x3c, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x45, 0x53, 0x50, 0x38, 0x32, 0x36, 0x36, 0x3c, 0x2f,
+	0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x3c, 0x6d, 0x65, 0x74, 0x61, 0x20, 0x63, 0x6f, 0x6e, 0x74,
+	0x65, 0x6e, 0x74, 0x3d, 0x22, 0x77, 0x69, 0x64, 0x74, 0x68, 0x3d, 0x64, 0x65, 0x76, 0x69, 0x63,
+	0x65, 0x2d, 0x77, 0x69, 0x64, 0x74, 0x68, 0x2c, 0x69, 0x6e, 0x69, 0x74, 0x69, 0x61, 0x6c, 0x2d,
+	0x73, 0x63, 0x61, 0x6c, 0x65, 0x3d, 0x31, 0x22, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x3d, 0x22, 0x76,
+	0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x22, 0x3e, 0x3c, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x3e,
+	0x68, 0x32, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f,
+	0x6c, 0x6f, 0x72, 0x3a, 0x23, 0x66, 0x66, 0x39, 0x38, 0x30, 0x30, 0x3b, 0x70, 0x61, 0x64, 0x64,
+	0x69, 0x6e, 0x67, 0x3a, 0x32, 0x25, 0x3b, 0x66, 0x6f, 0x6e, 0x74, 0x2d, 0x73, 0x74, 0x79, 0x6c,
+	0x65, 0x3a, 0x6f, 0x62, 0x6c, 0x69, 0x71, 0x75, 0x65, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72,
+	0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x35, 0x70, 0x78, 0x3b, 0x63, 0x6f, 0x6c, 0x6f,
+	0x72, 0x3a, 0x23, 0x66, 0x30, 0x66, 0x38, 0x66, 0x66, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e,
+	0x3a, 0x2e, 0x35, 0x25, 0x7d, 0x66, 0x6f, 0x72, 0x6d, 0x7b, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72,
+	0x6f, 0x75, 0x6e, 0x64, 0x2d, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3a, 0x23, 0x66, 0x32, 0x66, 0x32,
+	0x66, 0x32, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x3a,
+	0x67, 0x72, 0x6f, 0x6f, 0x76, 0x65, 0x3b, 0x62, 0x6f, 0x72, 0x64, 0x65, 0x72, 0x2d, 0x72, 0x61,
+	0x64, 0x69, 0x75, 0x73, 0x3a, 0x35, 0x70, 0x78, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a,
+	0x2e, 0x35, 0x25, 0x7d, 0x64, 0x69, 0x76, 0x7b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x31,
+	0x30, 0x70, 0x78, 0x7d, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x7b, 0x66, 0x6f, 0x6e, 0x74, 0x2d, 0x73,
+	0x69, 0x7a, 0x65, 0x3a, 0x6c, 0x61, 0x72, 0x67, 0x65, 0x72, 0x3b, 0x66, 0x6f, 0x6e, 0x74, 0x2d,
+	0x66, 0x61, 0x6d, 0x69, 0x6c, 0x79, 0x3a, 0x73, 0x61, 0x6e, 0x73, 0x2d, 0x73, 0x65, 0x72, 0x69,
+	0x66, 0x3b, 0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x32, 0x70, 0x78, 0x7d, 0x23, 0x49, 0x2c,
+	0x23, 0x50, 0x7b, 0x70, 0x61, 0x64, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x2e, 0x37, 0x35, 0x25, 0x3b,
+	0x6d, 0x61, 0x72, 0x67, 0x69, 0x6e, 0x3a, 0x31, 0x30, 0x70, 0x78, 0x3b, 0x62, 0x6f, 0x78, 0x2d,
+	0x73, 0x68, 0x61, 0x64, 0x6f, 0x77, 0x3a, 0x69, 0x6e, 0x73, 0x65, 0x74, 0x20, 0x30, 0x20, 0x31,
+	0x70, 0x78, 0x20, 0x33, 0x70, 0x78, 0x20, 0x23, 0x64, 0x64, 0x64, 0x3b, 0x62, 0x6f, 0x72, 0x64,
+	0x65, 0x72, 0x2d, 0x72, 0x61, 0x64, 0x69, 0x75, 0x73, 0x3a, 0x34, 0x70, 0x78, 0x3b, 0x62, 0x6f,
+	0x72, 0x64, 0x65, 0x72, 0x3a, 0x31, 0x70, 0x78, 0x20, 0x73, 0x6f, 0x6c, 0x69, 0x64, 0x20, 0x23,
+	0x63, 0x63, 0x63, 0x7d, 0x3c, 0x2f, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x3e, 0x3c, 0x73, 0x63, 0x72,
+	0x69, 0x70, 0x74, 0x3e, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x72, 0x65, 0x6e,
+	0x64, 0x65, 0x72, 0x28, 0x6c, 0x69, 0x73, 0x74, 0x29, 0x7b, 0x6c, 0x65, 0x74, 0x20, 0x66, 0x6f,
+	0x72, 0x6d, 0x3d, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x67, 0x65, 0x74, 0x45,
+	0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x42, 0x79, 0x49, 0x64, 0x28, 0x27, 0x66, 0x27, 0x29, 0x3b,
+	0x66, 0x6f, 0x72, 0x28, 0x6c, 0x65, 0x74, 0x20, 0x74, 0x3d, 0x6c, 0x69, 0x73, 0x74, 0x2e, 0x6c,
+	0x65, 0x6e, 0x67, 0x74, 0x68, 0x2d, 0x31, 0x3b, 0x74, 0x3e, 0x3d, 0x30, 0x3b, 0x2d, 0x2d, 0x74,
+	0x29, 0x7b, 0x6c, 0x65, 0x74, 0x20, 0x73, 0x73, 0x69, 0x64, 0x3d, 0x6c, 0x69, 0x73, 0x74, 0x5b,
+	0x74, 0x5d, 0x2e, 0x73, 0x73, 0x69, 0x64, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x66, 0x69, 0x72, 0x73,
+	0x74, 0x3d, 0x66, 0x6f, 0x72, 0x6d, 0x2e, 0x63, 0x68, 0x69, 0x6c, 0x64, 0x4e, 0x6f, 0x64, 0x65,
+	0x73, 0x5b, 0x30, 0x5d, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x64, 0x69, 0x76, 0x3d, 0x64, 0x6f, 0x63,
+	0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d,
+	0x65, 0x6e, 0x74, 0x28, 0x27, 0x64, 0x69, 0x76, 0x27, 0x29, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x72,
+	0x61, 0x64, 0x69, 0x6f, 0x3d, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72,
+	0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x69, 0x6e, 0x70,
+	0x75, 0x74, 0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74,
+	0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x74, 0x79, 0x70, 0x65, 0x27, 0x2c, 0x27,
+	0x72, 0x61, 0x64, 0x69, 0x6f, 0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65,
+	0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x6e, 0x61, 0x6d, 0x65,
+	0x27, 0x2c, 0x27, 0x53, 0x27, 0x29, 0x3b, 0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74,
+	0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x28, 0x27, 0x63, 0x68, 0x65, 0x63, 0x6b,
+	0x65, 0x64, 0x27, 0x2c, 0x27, 0x63, 0x68, 0x65, 0x63, 0x6b, 0x65, 0x64, 0x27, 0x29, 0x3b, 0x72,
+	0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74,
+	0x65, 0x28, 0x27, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b,
+	0x72, 0x61, 0x64, 0x69, 0x6f, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75,
+	0x74, 0x65, 0x28, 0x27, 0x69, 0x64, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b, 0x64, 0x69,
+	0x76, 0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64, 0x28, 0x72, 0x61,
+	0x64, 0x69, 0x6f, 0x29, 0x3b, 0x6c, 0x65, 0x74, 0x20, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x3d, 0x64,
+	0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c,
+	0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x27, 0x29, 0x3b, 0x6c,
+	0x61, 0x62, 0x65, 0x6c, 0x2e, 0x73, 0x65, 0x74, 0x41, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74,
+	0x65, 0x28, 0x27, 0x66, 0x6f, 0x72, 0x27, 0x2c, 0x73, 0x73, 0x69, 0x64, 0x29, 0x3b, 0x6c, 0x61,
+	0x62, 0x65, 0x6c, 0x2e, 0x74, 0x65, 0x78, 0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x3d,
+	0x73, 0x73, 0x69, 0x64, 0x2b, 0x27, 0x20, 0x28, 0x27, 0x2b, 0x6c, 0x69, 0x73, 0x74, 0x5b, 0x74,
+	0x5d, 0x2e, 0x72, 0x73, 0x73, 0x69, 0x2b, 0x27, 0x20, 0x64, 0x42, 0x6d, 0x27, 0x2b, 0x28, 0x6c,
+	0x69, 0x73, 0x74, 0x5b, 0x74, 0x5d, 0x2e, 0x61, 0x75, 0x74, 0x68, 0x6d, 0x6f, 0x64, 0x65, 0x3f,
+	0x27, 0x27, 0x3a, 0x27, 0x2c, 0x20, 0x6f, 0x70, 0x65, 0x6e, 0x27, 0x29, 0x2b, 0x27, 0x29, 0x27,
+	0x3b, 0x64, 0x69, 0x76, 0x2e, 0x61, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64,
+	0x28, 0x6c, 0x61, 0x62, 0x65, 0x6c, 0x29, 0x3b, 0x64, 0x69, 0x76, 0x2e, 0x61, 0x70, 0x70, 0x65,
+	0x6e, 0x64, 0x43, 0x68, 0x69, 0x6c, 0x64, 0x28, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74,
+	0x2e, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27,
+	0x62, 0x72, 0x27, 0x29, 0x29, 0x3b, 0x66, 0x6f, 0x72, 0x6d, 0x2e, 0x69, 0x6e, 0x73, 0x65, 0x72,
+	0x74, 0x42, 0x65, 0x66, 0x6f, 0x72, 0x65, 0x28, 0x64, 0x69, 0x76, 0x2c, 0x66, 0x69, 0x72, 0x73,
+	0x74, 0x29, 0x3b, 0x7d, 0x7d, 0x0a, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x61,
+	0x64, 0x64, 0x45, 0x76, 0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x65, 0x6e, 0x65, 0x72, 0x28,
+	0x27, 0x44, 0x4f, 0x4d, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x4c, 0x6f, 0x61, 0x64, 0x65,
+	0x64, 0x27, 0x2c, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x28, 0x29, 0x7b, 0x69, 0x66,
+	0x28, 0x74, 0x79, 0x70, 0x65, 0x6f, 0x66, 0x20, 0x41, 0x50, 0x21, 0x3d, 0x3d, 0x27, 0x75, 0x6e,
+	0x64, 0x65, 0x66, 0x69, 0x6e, 0x65, 0x64, 0x27, 0x29, 0x7b, 0x72, 0x65, 0x6e, 0x64, 0x65, 0x72,
+	0x28, 0x41, 0x50, 0x29, 0x3b, 0x7d, 0x65, 0x6c, 0x73, 0x65, 0x7b, 0x66, 0x65, 0x74, 0x63, 0x68,
+	0x28, 0x27, 0x2e, 0x2f, 0x61, 0x70, 0x69, 0x2f, 0x73, 0x63, 0x61, 0x6e, 0x27, 0x29, 0x2e, 0x74,
+	0x68, 0x65, 0x6e, 0x28, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x28, 0x72, 0x65, 0x73,
+	0x70, 0x6f, 0x6e, 0x73, 0x65, 0x29, 0x7b, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x72, 0x65,
+	0x73, 0x70, 0x6f, 0x6e, 0x73, 0x65, 0x2e, 0x6a, 0x73, 0x6f, 0x6e, 0x28, 0x29, 0x3b, 0x7d, 0x29,
+	0x2e, 0x74, 0x68, 0x65, 0x6e, 0x28, 0x72, 0x65, 0x6e, 0x64, 0x65, 0x72, 0x29, 0x3b, 0x7d, 0x7d,
+	0x29, 0x3b, 0x3c, 0x2f, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x3e, 0x3c, 0x68, 0x32, 0x3e, 0x57,
+	0x69, 0x46, 0x69, 0x20, 0x4e, 0x65, 0x74, 0x77, 0x6f, 0x72, 0x6b, 0x73, 0x3c, 0x2f, 0x68, 0x32,
+	0x3e, 0x3c, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x69, 0x64, 0x3d, 0x22, 0x66, 0x22, 0x20, 0x6d, 0x65,
+	0x74, 0x68, 0x6f, 0x64, 0x3d, 0x22, 0x50, 0x4f, 0x53, 0x54, 0x22, 0x3e, 0x3c, 0x69, 0x6e, 0x70,
+	0x75, 0x74, 0x20, 0x69, 0x64, 0x3d, 0x22, 0x50, 0x22, 0x20, 0x74, 0x79, 0x70, 0x65, 0x3d, 0x22,
+	0x70, 0x61, 0x73, 0x73, 0x77, 0x6f, 0x72, 0x64, 0x22, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x3d, 0x22,
+	0x50, 0x22, 0x20, 0x70, 0x6c, 0x61, 0x63, 0x65, 0x68, 0x6f, 0x6c, 0x64, 0x65, 0x72, 0x3d, 0x22,
+	0x45, 0x6e, 0x74, 0x65, 0x72, 0x20, 0x57, 0x69, 0x46, 0x69, 0x20, 0x50, 0x61, 0x73, 0x73, 0x77,
+	0x6f, 0x72, 0x64, 0x22, 0x3e, 0x3c, 0x62, 0x72, 0x3e, 0x3c, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x20,
+	0x69, 0x64, 0x3d, 0x22, 0x49, 0x22, 0x20, 0x74, 0x79, 0x70, 0x65, 0x3d, 0x22, 0x73, 0x75, 0x62,
+	0x6d, 0x69, 0x74, 0x22, 0x20, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x3d, 0x22, 0x53, 0x55, 0x42, 0x4d,
+	0x49, 0x54, 0x22, 0x3e, 0x3c, 0x2f, 0x66, 0x6f, 0x72, 0x6d, 0x3e,
+};
+
+static const uint8 wifi_ap_bundle_gz[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x74, 0x54, 0xdb, 0x6e, 0xdb, 0x38,
+	0x10, 0x7d, 0xef, 0x57, 0xa8, 0x32, 0x02, 0xca, 0x88, 0x25, 0x3b, 0xee, 0xa6, 0x9b, 0xd5, 0xc5,
+	0x45, 0x92, 0xa6, 0x40, 0x80, 0x5e, 0x0c, 0x64, 0x17, 0xfb, 0x50, 0xf4, 0x81, 0x26, 0x47, 0x16,
+	0x1b, 0x4a, 0x54, 0x49, 0xca, 0x71, 0x6a, 0xf8, 0xdf, 0x77, 0x48, 0x59, 0xd9, 0xa0, 0x8d, 0x61,
+	0x08, 0x26, 0x67, 0xce, 0x9c, 0xb9, 0x33, 0xb7, 0xc2, 0x4a, 0x58, 0xdc, 0xdc, 0x2d, 0x2f, 0xe6,
+	0x6f, 0xdf, 0xe6, 0xd3, 0xfe, 0x9a, 0xd7, 0x60, 0x69, 0xc0, 0x54, 0x63, 0xa1, 0xb1, 0x45, 0xf8,
+	0x20, 0xb8, 0xad, 0x0a, 0x0e, 0x1b, 0xc1, 0x20, 0xf6, 0x97, 0x89, 0x68, 0x84, 0x15, 0x54, 0xc6,
+	0x86, 0x51, 0x09, 0xc5, 0x59, 0x18, 0x34, 0xb4, 0x86, 0x22, 0xdc, 0x08, 0x78, 0x68, 0x95, 0xb6,
+	0xe1, 0x22, 0x37, 0xf6, 0x11, 0x99, 0xaa, 0xf9, 0x6e, 0x45, 0xd9, 0xfd, 0x5a, 0xab, 0xae, 0xe1,
+	0x31, 0x53, 0x52, 0xe9, 0x74, 0x54, 0x96, 0x7f, 0x5d, 0xcc, 0x66, 0x59, 0x4b, 0x39, 0x17, 0xcd,
+	0x3a, 0x9d, 0x9f, 0x64, 0x25, 0xba, 0x8a, 0xbd, 0x45, 0xaa, 0x56, 0x52, 0xfc, 0xe8, 0x20, 0x5b,
+	0x29, 0xcd, 0x41, 0xc7, 0x9a, 0x72, 0xd1, 0x99, 0xf4, 0xbc, 0xdd, 0x66, 0x83, 0xf5, 0xac, 0xbc,
+	0x28, 0xcb, 0xac, 0xa6, 0x7a, 0x2d, 0x9a, 0x34, 0x39, 0x3f, 0xd9, 0x97, 0x4a, 0xd7, 0x2f, 0xb9,
+	0x99, 0xbb, 0xdf, 0x40, 0xd4, 0xb3, 0x23, 0x42, 0x6d, 0x5e, 0x22, 0x7f, 0x46, 0xc7, 0xc5, 0x66,
+	0x77, 0xb8, 0x9e, 0xcd, 0xda, 0xed, 0x5e, 0xd2, 0x15, 0xc8, 0x5d, 0x1f, 0xa2, 0xf8, 0x09, 0xa9,
+	0x44, 0x1d, 0xe8, 0x3e, 0xe6, 0x92, 0xd6, 0x42, 0x3e, 0xa6, 0x86, 0x36, 0x26, 0x36, 0xa0, 0xc5,
+	0x53, 0x5c, 0x73, 0x34, 0x1c, 0xdd, 0x4e, 0x46, 0xcb, 0xdd, 0x90, 0x66, 0xf2, 0xe7, 0xf9, 0x49,
+	0xf6, 0x8c, 0x17, 0x83, 0xd8, 0xc6, 0xa6, 0xa2, 0x5c, 0x3d, 0xa4, 0xa2, 0x31, 0x60, 0x83, 0x59,
+	0x70, 0xd6, 0x6e, 0x83, 0x37, 0xf8, 0x8d, 0x38, 0xe7, 0xbf, 0x04, 0xf9, 0x87, 0xb7, 0x70, 0x92,
+	0xd4, 0xa1, 0x8c, 0x92, 0x82, 0x07, 0x23, 0xc6, 0xd8, 0x3e, 0x9f, 0xf6, 0xb5, 0xce, 0x0d, 0xd3,
+	0xa2, 0xb5, 0x8b, 0xb2, 0x6b, 0x98, 0x15, 0xaa, 0x09, 0x34, 0x34, 0x08, 0x8f, 0xa4, 0x30, 0x76,
+	0xbc, 0x93, 0xe8, 0xc0, 0x15, 0xaa, 0xe0, 0x8a, 0x75, 0x35, 0xf6, 0x35, 0x59, 0x83, 0xbd, 0x91,
+	0xe0, 0x8e, 0x57, 0x8f, 0xb7, 0x3c, 0x22, 0x25, 0x19, 0x63, 0x52, 0x88, 0x47, 0xa4, 0x2d, 0x9c,
+	0x55, 0x22, 0xa1, 0x59, 0xdb, 0x2a, 0x3e, 0xcb, 0xec, 0xa2, 0x98, 0x65, 0x71, 0x7c, 0xe0, 0x31,
+	0x46, 0x70, 0x0f, 0xf8, 0x6a, 0xbf, 0x25, 0xee, 0x92, 0x79, 0x76, 0xa1, 0x8d, 0x2d, 0x9c, 0x8f,
+	0x84, 0x55, 0x42, 0xf2, 0xcf, 0x8a, 0x83, 0xf9, 0x3a, 0xfb, 0xe6, 0x95, 0x58, 0xd4, 0xff, 0x3d,
+	0x33, 0x0d, 0xd4, 0xc2, 0xc1, 0x79, 0x44, 0x50, 0x87, 0xae, 0x1d, 0xca, 0xe5, 0xaa, 0x8e, 0xe2,
+	0x44, 0xd3, 0x76, 0x16, 0x91, 0x1e, 0x95, 0x60, 0xc5, 0x2e, 0xad, 0xd5, 0x62, 0xd5, 0x59, 0x88,
+	0x88, 0x7d, 0x6c, 0x81, 0x4c, 0x88, 0x57, 0x1d, 0x81, 0xb8, 0x11, 0x45, 0xc8, 0xdd, 0x11, 0x35,
+	0xab, 0x80, 0xdd, 0x03, 0x47, 0xc4, 0x70, 0x7a, 0x19, 0xb7, 0xa1, 0xb2, 0x43, 0x1e, 0x97, 0xf6,
+	0xcb, 0x00, 0xc1, 0x07, 0x2d, 0x26, 0x96, 0xd0, 0xb6, 0xc5, 0x36, 0x5c, 0xbb, 0x82, 0x44, 0x1e,
+	0xdd, 0x67, 0xea, 0x87, 0xea, 0x68, 0xa6, 0x5e, 0xeb, 0x6a, 0xe2, 0xfe, 0x7f, 0xa1, 0xc7, 0x02,
+	0x0f, 0xfc, 0xbd, 0xda, 0xc2, 0xd6, 0x5e, 0x1f, 0x76, 0xd5, 0xc9, 0x4f, 0x49, 0x10, 0x91, 0xd3,
+	0xa1, 0x3d, 0x1a, 0x45, 0x28, 0xe1, 0x57, 0x35, 0x39, 0x8d, 0x06, 0x21, 0xed, 0x6c, 0x55, 0x63,
+	0x7b, 0xde, 0x11, 0x92, 0x92, 0x49, 0xa0, 0x30, 0x44, 0x32, 0x3e, 0x25, 0x63, 0xf2, 0x5b, 0xc8,
+	0xde, 0xc5, 0xef, 0x99, 0x1c, 0x0b, 0x7c, 0xa5, 0xc9, 0xd8, 0x4f, 0x51, 0x9d, 0xb8, 0x99, 0xd6,
+	0xf6, 0x0a, 0xf0, 0x02, 0x11, 0xda, 0x4f, 0xfc, 0x7c, 0x8c, 0xb3, 0xfd, 0xfe, 0xd5, 0x93, 0x35,
+	0xae, 0xc6, 0xcd, 0x06, 0x0f, 0x1f, 0x31, 0x2e, 0x68, 0x70, 0x56, 0xc9, 0xfb, 0x2f, 0x9f, 0x0e,
+	0xb9, 0x7c, 0x54, 0x94, 0xbb, 0x76, 0x0c, 0xe3, 0x1c, 0x8d, 0x77, 0xa2, 0x8c, 0x5c, 0x9f, 0x55,
+	0x19, 0x5c, 0x2e, 0x5f, 0x17, 0x05, 0xc1, 0x65, 0x87, 0x52, 0x34, 0xae, 0x55, 0xbb, 0xc3, 0xb0,
+	0x5f, 0x2e, 0xd1, 0x03, 0x48, 0x03, 0xbb, 0x12, 0x2c, 0xab, 0x22, 0x92, 0x4c, 0x69, 0x2b, 0xa6,
+	0xf8, 0x4e, 0x61, 0x86, 0x89, 0xad, 0xa0, 0x89, 0x9e, 0x08, 0x35, 0x98, 0x56, 0x61, 0x94, 0xce,
+	0xd8, 0x76, 0xda, 0x2d, 0x4c, 0x2f, 0x48, 0xbe, 0x1b, 0xe7, 0x2f, 0xdb, 0x1f, 0x2c, 0x7a, 0x6e,
+	0x17, 0xfa, 0x38, 0xc3, 0x6d, 0xeb, 0xd7, 0x2c, 0xaf, 0xe6, 0x8b, 0x7f, 0xc5, 0x07, 0x11, 0x7c,
+	0x06, 0xfb, 0xa0, 0xf4, 0xbd, 0xc9, 0xa7, 0x28, 0xc9, 0x5d, 0xee, 0x01, 0xae, 0x47, 0x58, 0x86,
+	0x01, 0x3e, 0xa3, 0x95, 0xc2, 0xe3, 0xf2, 0xcb, 0xdd, 0xdf, 0xf8, 0x24, 0xfa, 0xf9, 0xf5, 0xba,
+	0x65, 0x18, 0xb8, 0x44, 0x8a, 0xb0, 0xa5, 0xc6, 0xa0, 0x31, 0x1f, 0x1e, 0x50, 0x54, 0xb4, 0x92,
+	0x32, 0xa8, 0x94, 0x44, 0x8f, 0x45, 0x78, 0x83, 0xa5, 0xd0, 0x81, 0x77, 0xb3, 0x1c, 0xa0, 0x8b,
+	0x7c, 0xa5, 0x9f, 0x93, 0xdd, 0x0e, 0x64, 0xa6, 0x5b, 0xd5, 0xc2, 0x86, 0x81, 0x9f, 0xd0, 0x22,
+	0xbc, 0xfb, 0xe7, 0xea, 0xd3, 0xad, 0xf3, 0x3b, 0x75, 0x31, 0x2d, 0xfe, 0x03, 0x00, 0x00, 0xff,
+	0xff,
+};
+
+const WEB_BUNDLE WIFI_AP_BUNDLE = {
+	wifi_ap_bundle, 1515,
+	wifi_ap_bundle_gz, 801,
+	0x4980e20a,
+	0x89742a50
+};
@@ -8,51 +8,40 @@
 //system includes
 #include "osapi.h"
 #include "user_interface.h"
-#include "ping.h"
 
 //user includes
 #include "user_wifi.h"
 #include "user_espconn.h"
 #include "user_webpage.h"
 #include "user_timer.h"
-
-//Set-Up Debugging Macros
-#ifndef ESP_WIFI_LOGGER
-	#define WIFI_DEBUG(message)					do {} while(0)
-	#define WIFI_DEBUG_ARGS(message, args...)	do {} while(0)
-#else
-	#define WIFI_DEBUG(message)					do {os_printf("[WIFI-DEBUG] %s", message); os_printf("\r\n");} while(0)
-	#define WIFI_DEBUG_ARGS(message, args...)	do {os_printf("[WIFI-DEBUG] "); os_printf(message, args); os_printf("\r\n");} while(0)
-#endif
+#include "user_metrics.h"
+#include "user_dns.h"
+#include "user_link.h"
+#include "user_wifi_fsm.h"
+#include "user_trace.h"
+#include "user_stream.h"
+#include "user_log.h"
+#include "driver/rodata.h"
+#include "driver/http.h"
 
 #define WIFI_ASSERT_AND_RET(ret, value)			if(ret != value) return ret;
 
 /******************* GPIO_PIN PARAMETERS *******************/
 
 #define NUMBER_VALID_GPIOS	12
-static const uint8_t gpio_num[NUMBER_VALID_GPIOS] = {0,1,2,3,4,5,9,10,12,13,14,15};
-static const uint32_t gpio_mux[NUMBER_VALID_GPIOS] = {PERIPHS_IO_MUX_GPIO0_U, PERIPHS_IO_MUX_U0TXD_U,PERIPHS_IO_MUX_GPIO2_U, PERIPHS_IO_MUX_U0RXD_U, PERIPHS_IO_MUX_GPIO4_U, PERIPHS_IO_MUX_GPIO5_U,
+static const uint8_t gpio_num[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {0,1,2,3,4,5,9,10,12,13,14,15};
+static const uint32_t gpio_mux[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {PERIPHS_IO_MUX_GPIO0_U, PERIPHS_IO_MUX_U0TXD_U,PERIPHS_IO_MUX_GPIO2_U, PERIPHS_IO_MUX_U0RXD_U, PERIPHS_IO_MUX_GPIO4_U, PERIPHS_IO_MUX_GPIO5_U,
 										PERIPHS_IO_MUX_SD_DATA2_U, PERIPHS_IO_MUX_SD_DATA3_U, PERIPHS_IO_MUX_MTDI_U, PERIPHS_IO_MUX_MTCK_U, PERIPHS_IO_MUX_MTMS_U, PERIPHS_IO_MUX_MTDO_U};
-static const uint8_t gpio_func[NUMBER_VALID_GPIOS] = {FUNC_GPIO0, FUNC_GPIO1, FUNC_GPIO2, FUNC_GPIO3, FUNC_GPIO4, FUNC_GPIO5, FUNC_GPIO9, FUNC_GPIO10, FUNC_GPIO12, FUNC_GPIO13, FUNC_GPIO14, FUNC_GPIO15};
+static const uint8_t gpio_func[NUMBER_VALID_GPIOS] ICACHE_RODATA_ATTR STORE_ATTR = {FUNC_GPIO0, FUNC_GPIO1, FUNC_GPIO2, FUNC_GPIO3, FUNC_GPIO4, FUNC_GPIO5, FUNC_GPIO9, FUNC_GPIO10, FUNC_GPIO12, FUNC_GPIO13, FUNC_GPIO14, FUNC_GPIO15};
 
 /**********************************************************/
 
-// user task queue
-static os_event_t taskQueue[3] = {0};
-
-// placeholder to save scanned AP's info and placeholder pointing to AP to connect
-static AP_Info scanned_APs[SCAN_LIST] = {0};
-static AP_Info AP;
-
-//ping params
-struct ping_option ping_option;
-static uint8 pingNo = 1;
-static uint32 total_payload = 0;
-
 //LOS Status
 static bool LOS = true;
 
-static bool scanButtonPressed = false;
+//sample timer, runs in station mode
+static TIMER_ID sampleTimer = TIMER_NONE;
+static uint16 sampleInterval = STATION_TIMER;		//seconds
 
 /******** Function Definitions ********/
 
@@ -66,25 +55,59 @@ void ICACHE_FLASH_ATTR _SetLOS(bool iValue){
 	LOS = iValue;
 }
 
+/***************************************************************************************
+ * FunctionName	:  _LinkStateChanged
+ * Description	:  Link probe callback, collector reachability is a wifi machine input
+ * Parameter	:  iReachable -- collector is reachable
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _LinkStateChanged(bool iReachable){
+	WifiFsmInput(iReachable ? WIFI_IN_LINK_UP : WIFI_IN_LINK_DOWN);
+}
+
+/***************************************************************************************
+ * FunctionName	:  _WifiStateChanged
+ * Description	:  Wifi machine callback. Link probe runs while station has ip, LOS LED
+ * 				   is off only once collector is verified.
+ * Parameter	:  iOld -- state left
+ * 				   iNew -- state entered
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR _WifiStateChanged(WIFI_STATE iOld, WIFI_STATE iNew){
+	if(iOld == iNew) return;
+	LOG_INFO(WIFI, "wifi state %s -> %s", WifiStateName(iOld), WifiStateName(iNew));
+
+	bool wasConnected = (iOld == WIFI_GOT_IP || iOld == WIFI_VERIFIED);
+	bool connected = (iNew == WIFI_GOT_IP || iNew == WIFI_VERIFIED);
+	if(connected && !wasConnected) StartLinkProbe();
+	else if(!connected && wasConnected) StopLinkProbe();
+
+	_SetLOS(iNew != WIFI_VERIFIED);
+	if(iNew == WIFI_VERIFIED) TRACE(TRACE_LINK_VERIFIED);
+
+	//no sampling while station select page is served
+	if(iNew == WIFI_PROVISIONING) DisarmTimer(sampleTimer);
+}
+
 /***************************************************************************************
  * FunctionName	:  _wifiEventHandler
  * Description	:  wifi event handler funcntion
  * Parameters	:  event -- wifi event type input parameter
  **************************************************************************************/
 void ICACHE_FLASH_ATTR _wifiEventHandler(System_Event_t *event){
-	WIFI_DEBUG_ARGS("wifi event occurred : %d", event->event);
+	LOG_DEBUG(WIFI, "wifi event occurred : %d", event->event);
 
-	bool ret = false;
 	switch (event->event) {
 	case EVENT_STAMODE_CONNECTED:
-		WIFI_DEBUG_ARGS("Connected to ssid %s, channel %d",event->event_info.connected.ssid, event->event_info.connected.channel);
+		LOG_INFO(WIFI, "Connected to ssid %s, channel %d",event->event_info.connected.ssid, event->event_info.connected.channel);
+		TRACE(TRACE_WIFI_CONNECTED);
 
 		// Switch ON Station LED
 		GPIO_OUTPUT_SET(GPIO_ID_PIN(STATION_LED), 1);
 
 		break;
 	case EVENT_STAMODE_DISCONNECTED:
-		WIFI_DEBUG_ARGS("Disconnected from ssid %s, reason %d",event->event_info.disconnected.ssid, event->event_info.disconnected.reason);
+		LOG_INFO(WIFI, "Disconnected from ssid %s, reason %d",event->event_info.disconnected.ssid, event->event_info.disconnected.reason);
+
+		MetricsWifiDisconnect(event->event_info.disconnected.reason);
 
 		// Switch OFF STATION LED and ON LOS LED
 		GPIO_OUTPUT_SET(GPIO_ID_PIN(STATION_LED), 0);
@@ -92,39 +115,35 @@ void ICACHE_FLASH_ATTR _wifiEventHandler(System_Event_t *event){
 
 		break;
 	case EVENT_STAMODE_AUTHMODE_CHANGE:
-		WIFI_DEBUG_ARGS("Authmode changed from %d to %d",event->event_info.auth_change.old_mode, event->event_info.auth_change.new_mode);
+		LOG_DEBUG(WIFI, "Authmode changed from %d to %d",event->event_info.auth_change.old_mode, event->event_info.auth_change.new_mode);
 		break;
 	case EVENT_STAMODE_GOT_IP:
-		WIFI_DEBUG_ARGS("Got IP, ip:" IPSTR ",mask:" IPSTR ",gw:" IPSTR,
+		LOG_INFO(WIFI, "Got IP, ip:" IPSTR ",mask:" IPSTR ",gw:" IPSTR,
 		IP2STR(&event->event_info.got_ip.ip),
 		IP2STR(&event->event_info.got_ip.mask),
 		IP2STR(&event->event_info.got_ip.gw));
-
-		//PING Internet and Handle LOS LED
-		ret = system_os_post(USER_TASK_PRIO_2, PING_INTERNET_TASK_EVENT, 0);
-		WIFI_DEBUG_ARGS("call user task to ping internet, ret : %d", ret);
-
+		TRACE(TRACE_WIFI_GOT_IP);
 		break;
 	case EVENT_STAMODE_DHCP_TIMEOUT:
-		WIFI_DEBUG("DHCP Timeout occurred");
+		LOG_WARN(WIFI, "DHCP Timeout occurred");
 		break;
 	case EVENT_SOFTAPMODE_STACONNECTED:
-		WIFI_DEBUG_ARGS("Station mac: " MACSTR "join, AID = %d",
+		LOG_INFO(WIFI, "Station mac: " MACSTR "join, AID = %d",
 		MAC2STR(event->event_info.sta_connected.mac),
 		event->event_info.sta_connected.aid);
 		break;
 	case EVENT_SOFTAPMODE_STADISCONNECTED:
-		WIFI_DEBUG_ARGS("Station mac: " MACSTR "left, AID = %d",
+		LOG_INFO(WIFI, "Station mac: " MACSTR "left, AID = %d",
 		MAC2STR(event->event_info.sta_disconnected.mac),
 		event->event_info.sta_disconnected.aid);
 		break;
 	case EVENT_SOFTAPMODE_PROBEREQRECVED:
-		WIFI_DEBUG_ARGS("Probe, rssi: %d , mac: " MACSTR,
+		LOG_DEBUG(WIFI, "Probe, rssi: %d , mac: " MACSTR,
 		event->event_info.ap_probereqrecved.rssi,
 		MAC2STR(event->event_info.ap_probereqrecved.mac));
 		break;
 	case EVENT_OPMODE_CHANGED:
-		WIFI_DEBUG_ARGS("Operation mode changed from %d to %d", event->event_info.opmode_changed.old_opmode, event->event_info.opmode_changed.new_opmode);
+		LOG_DEBUG(WIFI, "Operation mode changed from %d to %d", event->event_info.opmode_changed.old_opmode, event->event_info.opmode_changed.new_opmode);
 		if(event->event_info.opmode_changed.new_opmode == STATION_MODE){
 
 			// Switch Switch ON STATION LED, Switch OFF SOFTAP LED and Switch ON LOS LED
@@ -132,13 +151,14 @@ void ICACHE_FLASH_ATTR _wifiEventHandler(System_Event_t *event){
 			GPIO_OUTPUT_SET(GPIO_ID_PIN(SOFTAP_LED), 0);
 			_SetLOS(1);
 
-			// stop esp8266 webserver
-			WIFI_DEBUG("Stopping WebServer");
-			StopLocalServer();
+			// keep esp8266 webserver up for live readings, captive portal is over
+			LOG_DEBUG(WIFI, "Starting WebServer");
+			StartLocalServer();
+			StopCaptiveDNS();
 
-			//arm timer
-			DisarmTimer1();
-			ArmTimer1(STATION_TIMER, false);
+			//arm sampling timer, wired mode stream keeps sensor to itself
+			DisarmTimer(sampleTimer);
+			if(!Streaming()) ArmTimer(sampleTimer, sampleInterval * 1000, true);
 		}
 		else if(event->event_info.opmode_changed.new_opmode == SOFTAP_MODE){
 
@@ -147,205 +167,30 @@ void ICACHE_FLASH_ATTR _wifiEventHandler(System_Event_t *event){
 			GPIO_OUTPUT_SET(GPIO_ID_PIN(SOFTAP_LED), 1);
 			_SetLOS(1);
 
-			//start esp8266 webserver
-			WIFI_DEBUG("Starting WebServer");
+			//start esp8266 webserver, every name resolves to it so phones open it on their own
+			LOG_DEBUG(WIFI, "Starting WebServer");
 			StartLocalServer();
+			StartCaptiveDNS();
 
-			//arm timer
-			DisarmTimer1();
-			ArmTimer1(SOFTAP_TIMER, false);
+			//no sampling while provisioning, wifi machine times SoftAP out
+			DisarmTimer(sampleTimer);
 		}
 		break;
 	case EVENT_SOFTAPMODE_DISTRIBUTE_STA_IP:
-		WIFI_DEBUG_ARGS("Distribute sta ip, mac: " MACSTR ",ip: " IPSTR " ,AID = %d",
+		LOG_DEBUG(WIFI, "Distribute sta ip, mac: " MACSTR ",ip: " IPSTR " ,AID = %d",
 		MAC2STR(event->event_info.distribute_sta_ip.mac),
 		IP2STR(&event->event_info.distribute_sta_ip.ip),
 		event->event_info.distribute_sta_ip.aid);
 		break;
 	case EVENT_MAX:
-		WIFI_DEBUG("Max Events occurred");
+		LOG_DEBUG(WIFI, "Max Events occurred");
 		break;
 	default:
 		break;
 	}
-}
-
-/***************************************************************************************
- * FunctionName	:  _Ping_recv_cb
- * Description	:  callback function for receiving ping response.
- * Paramters	:  arg -- ping options
- *				   pdata -- ping response
- **************************************************************************************/
-void ICACHE_FLASH_ATTR _Ping_recv_cb (void* arg, void *pdata){
-	WIFI_DEBUG("Ping response recieve");
-
-	//read ping response
-	struct ping_resp *ping_resp = (struct ping_resp*) pdata;
-	if(ping_resp != NULL){
-		uint32 data_bytes = ping_resp->bytes;
-		sint8 ping_error = ping_resp->ping_err;
-		if(ping_error == 0){
-			total_payload += data_bytes;
-		}
-	}
-	WIFI_DEBUG_ARGS("Ping total_payload : %d and ping no : %d", total_payload, pingNo);
-	if(pingNo >= PING_COUNT){
-		if(total_payload >= (32 * PING_COUNT)){
-			// Switch OFF LOS LED
-			_SetLOS(0);
-		}
-		else{
-			// Switch ON LOS LED
-			GPIO_OUTPUT_SET(GPIO_ID_PIN(LOS_LED), 1);
-		}
-		pingNo = 0;
-		total_payload = 0;
-	}
-
-	pingNo++;
-}
-
-/***************************************************************************************
- * FunctionName	:  _PingInternet
- * Description	:  Pings Google DNS (8.8.8.8) to check internet connectivity.
- * Returns		:  bool, true if Successful
- * 						 false if failed
- **************************************************************************************/
-bool ICACHE_FLASH_ATTR _PingInternet(void){
-	WIFI_DEBUG("Pinging google DNS at 8.8.8.8 ");
-
-	bool ret = false;
-
-	ping_option.count = PING_COUNT;
-	ping_option.ip = ipaddr_addr(GOOGLE_DNS);
-	ping_option.coarse_time = PING_COARSE;
-	ping_option.sent_function = NULL;
-
-	//Register ping recv function
-	ret = ping_regist_recv(&ping_option, _Ping_recv_cb);
-	WIFI_DEBUG_ARGS("register ping recv callback, ret : %d", ret);
-
-	ret = ping_start(&ping_option);
-	WIFI_DEBUG_ARGS("Pinging google DNS at 8.8.8.8, ret: %d", ret);
-
-	return ret;
-}
-
-/***************************************************************************************
- * FunctionName	:  _Scan_done_cb
- * Description	:  callback function for wifi available AP scan.
- *				   Scans Available APs and stores it in a placeholder [array] as well as
- *				   update JS object
- * Parameters	:  arg -- list of scanned APs (bss_info)
- * 				   status -- scan status
- **************************************************************************************/
-void ICACHE_FLASH_ATTR _Scan_done_cb(void *arg, STATUS status){
-	WIFI_DEBUG_ARGS("inside scan done cb, status : %d", status);
-	if(status == OK){
-		struct bss_info *bss_link = (struct bss_info *)arg;
-		os_memset(scanned_APs, 0, SCAN_LIST*sizeof(AP_Info));
-		for(uint8 i = 0; i < SCAN_LIST; i++){
-			if(bss_link != NULL){
-				WIFI_DEBUG_ARGS("AP ssid : %s, ssid length : %d", bss_link->ssid, bss_link->ssid_len);
-
-				os_memcpy(scanned_APs[i].ssid, bss_link->ssid, bss_link->ssid_len);
-				scanned_APs[i].ssid_len = bss_link->ssid_len;
-				//scanned_APs[i].authmode = bss_link->authmode;
-
-				bss_link = STAILQ_NEXT(bss_link, next);
-			}
-			else break;
-		}
-		//modify scan AP js
-		UpdateJSData(scanned_APs, SCAN_LIST);
-
-		//set wifi in Soft-AP mode
-		bool ret = false;
-		ret = system_os_post(USER_TASK_PRIO_2, SOFTAP_MODE, 0);
-		WIFI_DEBUG_ARGS("call user task to change op mode to SoftAP, ret : %d", ret);
-	}
-}
-
-/***************************************************************************************
- * FunctionName	:  _WifiUserTasks
- * Description	:  User Task callback function for changing wifi operation mode
- * 				   and pinging google DNS for checking internet connectivity.
- * Parameters	:  event -- event type input parameter
- **************************************************************************************/
-void ICACHE_FLASH_ATTR _WifiUserTasks(os_event_t *event){
-	WIFI_DEBUG_ARGS("Inside Wifi user task, event : %d", event->sig);
-
-	bool ret = false;
-	bool doScan = event->par;
-	switch (event->sig) {
-	case STATION_MODE:
-		//set wifi to station mode
-		ret = wifi_set_opmode_current(STATION_MODE);
-		WIFI_DEBUG_ARGS("set current opmode, ret : %d", ret);
-
-		struct station_config station_config;
-		ret = wifi_station_get_config_default(&station_config);
-		WIFI_DEBUG_ARGS("get station flash config, ret : %d", ret);
-
-		if(!doScan){
-			os_memset(station_config.ssid, 0, sizeof(station_config.ssid));
-			os_memcpy(station_config.ssid, AP.ssid, sizeof(AP.ssid));
-			WIFI_DEBUG_ARGS("wifi Station ssid : %s", station_config.ssid);
-
-			os_memset(station_config.password, 0, sizeof(station_config.password));
-			os_memcpy(station_config.password, AP.password, sizeof(AP.password));
-			WIFI_DEBUG_ARGS("wifi Station password : %s", station_config.password);
-
-			//ret = wifi_station_set_config_current(&station_config);
-			ret = wifi_station_set_config(&station_config);
-			WIFI_DEBUG_ARGS("set Station config, ret : %d", ret);
-
-			ret = wifi_station_connect();
-			WIFI_DEBUG_ARGS("Connect to Station, ret : %d", ret);
-		}
-		else{
-			//scan wifi networks (AP's)
-			ret = wifi_station_scan(NULL, _Scan_done_cb);
-			WIFI_DEBUG_ARGS("station scan, ret : %d", ret);
-		}
-		break;
-	case SOFTAP_MODE:
-		//set wifi to soft ap mode
-		ret = wifi_set_opmode_current(SOFTAP_MODE);
-		WIFI_DEBUG_ARGS("set current opmode, ret : %d", ret);
 
-		struct softap_config softAP_config;
-		ret = wifi_softap_get_config(&softAP_config);
-		WIFI_DEBUG_ARGS("get station config, ret : %d", ret);
-
-		//set Soft AP mode configuration
-		if(os_strcmp(softAP_config.ssid, SOFTAP_SSID) != 0 &&
-			os_strcmp(softAP_config.password, SOFTAP_PASSWORD) != 0){
-
-			softAP_config.authmode = SOFTAP_AUTHMODE;
-			softAP_config.max_connection = SOFTAP_MAXCONNECTIONS;
-
-			os_memset(softAP_config.ssid, 0, sizeof(softAP_config.ssid));
-			os_memcpy(softAP_config.ssid, SOFTAP_SSID, os_strlen(SOFTAP_SSID));
-			softAP_config.ssid_len = os_strlen(SOFTAP_SSID);
-			WIFI_DEBUG_ARGS("SoftAP ssid : %s", softAP_config.ssid);
-
-			os_memset(softAP_config.password, 0, sizeof(softAP_config.password));
-			os_memcpy(softAP_config.password, SOFTAP_PASSWORD, os_strlen(SOFTAP_PASSWORD));
-			WIFI_DEBUG_ARGS("SoftAP password : %s", softAP_config.password);
-
-			ret = wifi_softap_set_config(&softAP_config);
-			WIFI_DEBUG_ARGS("set SoftAP config, ret : %d", ret);
-		}
-		break;
-	case PING_INTERNET_TASK_EVENT:
-		//Ping Google DNS for checking internet connectivity
-		ret = _PingInternet();
-		WIFI_DEBUG_ARGS("ping internet, ret : %d", ret);
-		break;
-	default:
-		break;
-	}
+	//station events drive wifi machine
+	WifiFsmSdkEvent(event);
 }
 
 /*******************************************************************************************
@@ -362,23 +207,23 @@ bool ICACHE_FLASH_ATTR _InitGPIO(uint8 iPin, bool iAsOutput, bool iEnablePullUp)
 	int8 _pin = -1;
 	//get pin
 	for(uint8_t index = 0; index < NUMBER_VALID_GPIOS; ++index){
-		if(gpio_num[index] == iGPIO_Pin){
+		if(rodata_read_byte(&gpio_num[index]) == iGPIO_Pin){
 			_pin = index;
-			WIFI_DEBUG_ARGS("%d will be configured as GPIO", iGPIO_Pin);
+			LOG_DEBUG(WIFI, "%d will be configured as GPIO", iGPIO_Pin);
 			break;
 		}
 	}
 	if (_pin == -1){
-		WIFI_DEBUG_ARGS("%d cannot be configured as GPIO", iGPIO_Pin);
+		LOG_ERROR(WIFI, "%d cannot be configured as GPIO", iGPIO_Pin);
 		return false;
 	}
 	//set GPIO Function Selection Register
-	PIN_FUNC_SELECT(gpio_mux[_pin], gpio_func[_pin]);
-	WIFI_DEBUG("Pin function select register is set");
+	PIN_FUNC_SELECT(gpio_mux[_pin], rodata_read_byte(&gpio_func[_pin]));
+	LOG_DEBUG(WIFI, "Pin function select register is set");
 
 	if(!iAsOutput){
 		//set pin as input
-		GPIO_DIS_OUTPUT(GPIO_ID_PIN(gpio_num[_pin]));
+		GPIO_DIS_OUTPUT(GPIO_ID_PIN(iGPIO_Pin));
 		if(iEnablePullUp)
 			PIN_PULLUP_EN(gpio_mux[_pin]);
 		else
@@ -386,7 +231,7 @@ bool ICACHE_FLASH_ATTR _InitGPIO(uint8 iPin, bool iAsOutput, bool iEnablePullUp)
 	}
 	else{
 		//set pin as output
-		GPIO_OUTPUT_SET(GPIO_ID_PIN(gpio_num[_pin]), iEnablePullUp);
+		GPIO_OUTPUT_SET(GPIO_ID_PIN(iGPIO_Pin), iEnablePullUp);
 	}
 	return true;
 }
@@ -398,7 +243,7 @@ bool ICACHE_FLASH_ATTR _InitGPIO(uint8 iPin, bool iAsOutput, bool iEnablePullUp)
  * 						 false if failed
  ******************************************************************************************/
 bool ICACHE_FLASH_ATTR _InitWifiStatusLEDs(){
-	WIFI_DEBUG("Initializing Wifi LED GPIO.");
+	LOG_DEBUG(WIFI, "Initializing Wifi LED GPIO.");
 
 	bool ret = false;
 	//init Station LED
@@ -412,25 +257,17 @@ bool ICACHE_FLASH_ATTR _InitWifiStatusLEDs(){
 
 /*******************************************************************************************
  * FunctionName	:  _InterruptHandler
- * Description	:  Scan Button ISR. Puts the wifi in Station Mode and then scan AP's
+ * Description	:  Scan Button ISR. Wifi machine scans AP's and switches to SoftAP
  ******************************************************************************************/
 void _InterruptHandler(){
-	WIFI_DEBUG("Inside ISR");
-
 	uint32 gpio_status;
 	gpio_status = GPIO_REG_READ(GPIO_STATUS_ADDRESS);
 	GPIO_REG_WRITE(GPIO_STATUS_W1TC_ADDRESS, gpio_status);
 
 	uint8 iGPIO_Pin = SCAN_BUTTON;
 	if(!GPIO_INPUT_GET(iGPIO_Pin)){
-		scanButtonPressed = true;
-
-		//Disable esp8266 timer1
-		DisarmTimer1();
-
-		//set wifi in Station mode and force it to scan
-		bool ret = false;
-		ret = system_os_post(USER_TASK_PRIO_2, STATION_MODE, 1);
+		//scan and serve station select page over SoftAP
+		WifiFsmInput(WIFI_IN_SCAN_BUTTON);
 	}
 }
 
@@ -441,8 +278,7 @@ void _InterruptHandler(){
  * 						 false if failed
  ******************************************************************************************/
 bool ICACHE_FLASH_ATTR _InitScanButton(){
-	WIFI_DEBUG("Initializing Scan GPIO.");
-	scanButtonPressed = false;
+	LOG_DEBUG(WIFI, "Initializing Scan GPIO.");
 
 	bool ret = false;
 	ret = _InitGPIO(SCAN_BUTTON, 0, 1);
@@ -469,48 +305,53 @@ bool ICACHE_FLASH_ATTR _InitScanButton(){
 bool ICACHE_FLASH_ATTR InitWifi(void* Timer_cb){
 	bool ret = false;
 
-	// Init Station and SoftAP Timer
-	ret = InitTimer1(Timer_cb, NULL);
-	WIFI_DEBUG_ARGS("Initialized Timer, ret : %d", ret);
-	DisarmTimer1();
+	// Init sample timer, armed once station mode is set
+	sampleTimer = CreateTimer((TIMER_CB)Timer_cb, NULL);
+	LOG_DEBUG(WIFI, "Initialized Timer, id : %d", sampleTimer);
 
 	//Initialize scan button
 	ret = _InitScanButton();
 	WIFI_ASSERT_AND_RET(ret, true);
-	WIFI_DEBUG_ARGS("Initialized scan button, ret : %d", ret);
+	LOG_DEBUG(WIFI, "Initialized scan button, ret : %d", ret);
 
 	//Initialize STATION, SOFT_AP and LOS LED
 	ret = _InitWifiStatusLEDs();
 	WIFI_ASSERT_AND_RET(ret, true);
-	WIFI_DEBUG_ARGS("Initialized LOS LED, ret : %d", ret);
+	LOG_DEBUG(WIFI, "Initialized LOS LED, ret : %d", ret);
 	//wifi_status_led_install (GPIO_ID_PIN(14), gpio_mux[10], gpio_func[10]);
 
-	//Register user task to init function for changing wifi mode and for ping
-	ret = system_os_task(_WifiUserTasks, USER_TASK_PRIO_2,taskQueue, 3);
+	//Register wifi machine (bus events, known AP's), it decides on reconnects instead of SDK
+	ret = InitWifiFsm(_WifiStateChanged);
 	WIFI_ASSERT_AND_RET(ret, true);
-	WIFI_DEBUG_ARGS("registered user task for changing OP mode and ping, ret : %d", ret);
+	LOG_DEBUG(WIFI, "registered wifi machine, ret : %d", ret);
+
+	//collector probe reports reachability to wifi machine once station got ip
+	InitLinkProbe(_LinkStateChanged);
 
 	//Register wifi event handler
 	wifi_set_event_handler_cb(_wifiEventHandler);
-	WIFI_DEBUG("registered wifi event handler");
+	LOG_DEBUG(WIFI, "registered wifi event handler");
 
 	//set wifi to station mode (it will be saved in flash)
 	ret = wifi_set_opmode(STATION_MODE);
 	WIFI_ASSERT_AND_RET(ret, true);
-	WIFI_DEBUG_ARGS("set opmode to Station, ret : %d", ret);
+	LOG_DEBUG(WIFI, "set opmode to Station, ret : %d", ret);
 
 	//check flash memory for any saved station config
 	struct station_config station_config;
 	ret = wifi_station_get_config_default(&station_config);
 	WIFI_ASSERT_AND_RET(ret, true);
-	WIFI_DEBUG_ARGS("get station flash config, ret : %d", ret);
+	LOG_DEBUG(WIFI, "get station flash config, ret : %d", ret);
 
 	//if no station ssid info is saved in flash
 	if(station_config.ssid[0] == 0x00){
 		// Light up LOS LED
 		_SetLOS(1);
-		WIFI_DEBUG("LOS LED ON");
+		LOG_DEBUG(WIFI, "LOS LED ON");
 	}
+
+	//join saved AP, or best known one of a scan
+	ret = WifiFsmInput(WIFI_IN_START);
 	return ret;
 }
 
@@ -523,42 +364,32 @@ bool ICACHE_FLASH_ATTR InitWifi(void* Timer_cb){
  * 						 false if failed
  ******************************************************************************************/
 bool ICACHE_FLASH_ATTR ConnectToStation(char *iData, uint16 iDataLength){
-	WIFI_DEBUG("Inside Connect To Station method.");
-
-	bool ret = false;
-	if(iData != NULL && iDataLength > 0){
-		char *ssid = os_strstr(iData, "S=");
-		char *password = os_strstr(iData, "&P=");
-		if(ssid != NULL && password != NULL){
-			ssid += 2;
-			uint16 ssidLength = password - ssid;
-
-			//replace + with space (comes like this from form data)
-			char *space = ssid;
-			do{
-				space = os_strstr(space, "+");
-				if(space != NULL && space < space + ssidLength) space = os_memset(space, 32, 1);
-			}
-			while(space != NULL && space < space + ssidLength );
-
-			password += 3;
-			uint16 passwordLength = iDataLength - (ssidLength + 2 + 3);
-
-			os_memset(&AP, 0, sizeof(AP_Info));
-			for(uint8 i = 0; i < SCAN_LIST; ++i){
-				if(os_strncmp(scanned_APs[i].ssid, ssid, ssidLength) == 0){
-					os_memcpy(AP.ssid, scanned_APs[i].ssid, scanned_APs[i].ssid_len);
-					os_memcpy(AP.password, password, passwordLength);
-					AP.ssid_len = scanned_APs[i].ssid_len;
-					break;
-				}
-			}
-
-			//set wifi in Station mode
-			ret = system_os_post(USER_TASK_PRIO_2, STATION_MODE, 0);
-			WIFI_DEBUG_ARGS("Station Mode system_os_post, ret : %d", ret);
-		}
-	}
+	LOG_DEBUG(WIFI, "Inside Connect To Station method.");
+
+	AP_Info ap;
+	os_memset(&ap, 0, sizeof(AP_Info));
+
+	//form fields of station select page (S: ssid, P: password)
+	char ssid[sizeof(ap.ssid) + 1];
+	char password[sizeof(ap.password) + 1];
+	FORM_FIELD fields[] = {
+			{"S", ssid, sizeof(ssid)},
+			{"P", password, sizeof(password)}
+	};
+
+	//SSID must be exact, a cut or undecodable one would join a wrong network
+	FORM_STATUS status = httpDecodeForm(iData, iDataLength, fields, 2);
+	LOG_DEBUG(WIFI, "form status : %d, ssid : %d, password : %d", status, fields[0].status, fields[1].status);
+	if(fields[0].status != FORM_OK || fields[0].length == 0) return false;
+	if(fields[1].status != FORM_OK && fields[1].status != FORM_MISSING) return false;
+
+	os_memcpy(ap.ssid, ssid, fields[0].length);
+	ap.ssid_len = fields[0].length;
+	os_memcpy(ap.password, password, fields[1].length);
+
+	//join from wifi machine, which leaves SoftAP
+	bool ret = WifiFsmProvision(&ap);
+	LOG_DEBUG(WIFI, "provision wifi machine, ret : %d", ret);
 	return ret;
 }
 
@@ -571,11 +402,47 @@ bool ICACHE_FLASH_ATTR ConnectToStation(char *iData, uint16 iDataLength){
 bool ICACHE_FLASH_ATTR ConnectedToInternet(void){
 	bool ret = false;
 
-	uint8 status = wifi_station_get_connect_status();
-	WIFI_DEBUG_ARGS("station status : %d and LOS Status : %d", status, LOS);
-	if(status == STATION_GOT_IP && !LOS){
+	WIFI_STATE state = WifiFsmState();
+	LOG_DEBUG(WIFI, "wifi state : %s and LOS Status : %d", WifiStateName(state), LOS);
+	if(state == WIFI_VERIFIED){
 		ret = true;
 	}
 
 	return ret;
 }
+
+/***************************************************************************************
+ * FunctionName	:  SetSampleInterval
+ * Description	:  Sets sample timer interval, re-arms timer if it runs
+ * Parameters	:  iSeconds -- interval in seconds
+ * Return		:  bool, true if set
+ **************************************************************************************/
+bool ICACHE_FLASH_ATTR SetSampleInterval(uint16 iSeconds){
+	if(iSeconds == 0) return false;
+	sampleInterval = iSeconds;
+	LOG_INFO(WIFI, "sample interval %d s", sampleInterval);
+
+	//a stopped timer gets new interval when it is started again
+	if(TimerArmed(sampleTimer)) SetSampling(true);
+	return true;
+}
+
+/***************************************************************************************
+ * FunctionName	:  GetSampleInterval
+ * Description	:  Sample timer interval
+ * Return		:  interval in seconds
+ **************************************************************************************/
+uint16 ICACHE_FLASH_ATTR GetSampleInterval(void){
+	return sampleInterval;
+}
+
+/***************************************************************************************
+ * FunctionName	:  SetSampling
+ * Description	:  Starts or stops sample timer, it only runs in station mode and not
+ * 				   while readings are streamed
+ * Parameters	:  iOn -- true to start
+ **************************************************************************************/
+void ICACHE_FLASH_ATTR SetSampling(bool iOn){
+	DisarmTimer(sampleTimer);
+	if(iOn && wifi_get_opmode() == STATION_MODE && !Streaming()) ArmTimer(sampleTimer, sampleInterval * 1000, true);
+}
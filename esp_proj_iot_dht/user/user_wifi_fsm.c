@@ -0,0 +1,608 @@
+/*
+ * user_wifi_fsm.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: harsh
+ */
+
+#include "user_wifi_fsm.h"
+
+//system includes
+#include "osapi.h"
+#include "user_interface.h"
+
+//user includes
+#include "user_credentials.h"
+#include "user_webpage.h"
+#include "user_timer.h"
+#include "user_bus.h"
+#include "user_log.h"
+
+#define RSSI_READ_ERROR			31			//wifi_station_get_rssi failure
+
+typedef struct wifiStateInfo{
+	const char *name;
+	uint32 timeout;					//seconds, 0 if state does not time out
+	void (*enter)(void);			//called on every entry, NULL if none
+} WIFI_STATE_INFO;
+
+//first row matching state (or WIFI_ANY), input and guard wins
+typedef struct wifiTransition{
+	WIFI_STATE state;
+	WIFI_INPUT input;
+	bool (*guard)(void);			//NULL: always
+	void (*action)(void);			//NULL: none, may queue inputs that are handled in next state
+	WIFI_STATE next;				//WIFI_SAME keeps state and its timeout
+} WIFI_TRANSITION;
+
+//machine
+static WIFI_STATE wifiState = WIFI_IDLE;
+static uint32 generation = 0;				//bumped on each entry, stale timeouts carry an older one
+static TIMER_ID stateTimer = TIMER_NONE;
+static WIFI_STATE_CB stateChanged = NULL;
+static uint8 failures = 0;					//failed joins since last ip, drives backoff
+
+// placeholder to save scanned AP's info and placeholder pointing to AP to connect
+// scan list holds one entry per ssid (strongest BSS), sorted by rssi, strongest first
+static AP_Info scanned_APs[SCAN_LIST] = {0};
+static uint8 scannedCount = 0;
+static uint32 scanTime = 0;				//TimerNow() of last successful scan
+static AP_Info AP;
+
+//BSS joined last (from connected event)
+static uint8 connectedBssid[6] = {0};
+static uint8 connectedChannel = 0;
+
+/******** Function Definitions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _AddScannedAP
+ * Description	:  Adds a BSS to scan list, keeping one entry per ssid (strongest BSS
+ * 				   wins) sorted by rssi. Once list is full, weakest entry makes room.
+ * 				   Hidden networks (no ssid) are skipped.
+ * Parameters	:  iBss -- scanned BSS
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _AddScannedAP(struct bss_info *iBss){
+	uint8 ssidLength = iBss->ssid_len < sizeof(scanned_APs[0].ssid) ? iBss->ssid_len : sizeof(scanned_APs[0].ssid);
+	if(ssidLength == 0) return;
+
+	//slot to (re)fill: same ssid, else a free one, else the weakest
+	uint8 slot = scannedCount;
+	for(uint8 i = 0; i < scannedCount; ++i){
+		if(scanned_APs[i].ssid_len == ssidLength && os_memcmp(scanned_APs[i].ssid, iBss->ssid, ssidLength) == 0){
+			slot = i;
+			break;
+		}
+	}
+	if(slot < scannedCount){
+		if(iBss->rssi <= scanned_APs[slot].rssi) return;
+	}
+	else if(scannedCount < SCAN_LIST){
+		++scannedCount;
+	}
+	else{
+		slot = SCAN_LIST - 1;
+		if(iBss->rssi <= scanned_APs[slot].rssi) return;
+	}
+
+	AP_Info entry;
+	os_memset(&entry, 0, sizeof(AP_Info));
+	os_memcpy(entry.ssid, iBss->ssid, ssidLength);
+	entry.ssid_len = ssidLength;
+	entry.rssi = iBss->rssi;
+	entry.channel = iBss->channel;
+	entry.authmode = iBss->authmode;
+	os_memcpy(entry.bssid, iBss->bssid, sizeof(entry.bssid));
+	entry.bssid_set = true;
+
+	//entry only gets stronger, so it moves towards the front
+	while(slot > 0 && scanned_APs[slot - 1].rssi < entry.rssi){
+		scanned_APs[slot] = scanned_APs[slot - 1];
+		--slot;
+	}
+	scanned_APs[slot] = entry;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _Scan_done_cb
+ * Description	:  callback function for wifi available AP scan. Replaces scan list,
+ * 				   updates JS object and reports scan to machine.
+ * Parameters	:  arg -- list of scanned APs (bss_info)
+ * 				   status -- scan status
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _Scan_done_cb(void *arg, STATUS status){
+	LOG_DEBUG(WIFI_FSM, "inside scan done cb, status : %d", status);
+	if(status != OK){
+		WifiFsmInput(WIFI_IN_SCAN_FAILED);
+		return;
+	}
+
+	struct bss_info *bss_link = (struct bss_info *)arg;
+	os_memset(scanned_APs, 0, SCAN_LIST*sizeof(AP_Info));
+	scannedCount = 0;
+	for(; bss_link != NULL; bss_link = STAILQ_NEXT(bss_link, next)){
+		LOG_DEBUG(WIFI_FSM, "AP ssid : %s, ssid length : %d, rssi : %d", bss_link->ssid, bss_link->ssid_len, bss_link->rssi);
+		_AddScannedAP(bss_link);
+	}
+	scanTime = TimerNow();
+	LOG_DEBUG(WIFI_FSM, "%d networks in scan list", scannedCount);
+
+	//update scan results served to station select page
+	UpdateJSData(scanned_APs, SCAN_LIST);
+
+	WifiFsmInput(WIFI_IN_SCAN_DONE);
+}
+
+/******** Guards ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardSaved
+ * Description	:  SDK has a station config saved in flash (last joined AP)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardSaved(void){
+	struct station_config station_config;
+	return wifi_station_get_config_default(&station_config) && station_config.ssid[0] != 0;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardSeveralKnown
+ * Description	:  More than one AP is known, joining has to choose
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardSeveralKnown(void){
+	return CredentialCount() > 1;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardKnown
+ * Description	:  Some AP is known, station can be tried again
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardKnown(void){
+	return CredentialCount() > 0 || _GuardSaved();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardCandidate
+ * Description	:  Scan list has a known AP, it is made AP to join
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardCandidate(void){
+	return SelectCredential(scanned_APs, scannedCount, NULL, &AP) >= 0;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardRoam
+ * Description	:  Scan list has a known BSS clearly stronger than joined one, it is made
+ * 				   AP to join
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardRoam(void){
+	AP_Info current;
+	os_memset(&current, 0, sizeof(AP_Info));
+	os_memcpy(current.bssid, connectedBssid, sizeof(current.bssid));
+	current.rssi = wifi_station_get_rssi();
+	if(current.rssi == RSSI_READ_ERROR) return false;
+
+	return SelectCredential(scanned_APs, scannedCount, &current, &AP) >= 0;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardWeakSignal
+ * Description	:  Joined BSS is below ROAM_RSSI
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardWeakSignal(void){
+	sint8 rssi = wifi_station_get_rssi();
+	LOG_DEBUG(WIFI_FSM, "station rssi : %d", rssi);
+	return rssi != RSSI_READ_ERROR && rssi < ROAM_RSSI;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _GuardSoftAPClients
+ * Description	:  Somebody is connected to SoftAP (likely on station select page)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR _GuardSoftAPClients(void){
+	return wifi_softap_get_station_num() > 0;
+}
+
+/******** Actions ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _ActScan
+ * Description	:  Starts a scan, result comes as WIFI_IN_SCAN_DONE
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActScan(void){
+	bool ret = wifi_station_scan(NULL, _Scan_done_cb);
+	LOG_DEBUG(WIFI_FSM, "station scan, ret : %d", ret);
+	if(!ret) WifiFsmInput(WIFI_IN_SCAN_FAILED);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActBootSelect
+ * Description	:  Stops SDK auto connect to last AP and scans for best known one
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActBootSelect(void){
+	wifi_station_disconnect();
+	_ActScan();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActConnectSaved
+ * Description	:  Joins AP saved by SDK (last joined, may be hidden)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActConnectSaved(void){
+	bool ret = wifi_station_connect();
+	LOG_DEBUG(WIFI_FSM, "Connect to saved Station, ret : %d", ret);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActJoinAP
+ * Description	:  Leaves current AP and joins AP (selected, roamed to or provisioned)
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActJoinAP(void){
+	bool ret = false;
+	wifi_station_disconnect();
+
+	//set wifi to station mode
+	ret = wifi_set_opmode_current(STATION_MODE);
+	LOG_DEBUG(WIFI_FSM, "set current opmode, ret : %d", ret);
+
+	struct station_config station_config;
+	ret = wifi_station_get_config_default(&station_config);
+	LOG_DEBUG(WIFI_FSM, "get station flash config, ret : %d", ret);
+
+	os_memset(station_config.ssid, 0, sizeof(station_config.ssid));
+	os_memcpy(station_config.ssid, AP.ssid, sizeof(AP.ssid));
+	LOG_DEBUG(WIFI_FSM, "wifi Station ssid : %s", station_config.ssid);
+
+	os_memset(station_config.password, 0, sizeof(station_config.password));
+	os_memcpy(station_config.password, AP.password, sizeof(AP.password));
+
+	//saved config is ssid only, so reconnects after reboot still roam between BSSs
+	station_config.bssid_set = 0;
+	station_config.channel = 0;
+	ret = wifi_station_set_config(&station_config);
+	LOG_DEBUG(WIFI_FSM, "set Station config, ret : %d", ret);
+
+	//join scanned BSS directly instead of scanning all channels for ssid again
+	if(AP.bssid_set){
+		station_config.bssid_set = 1;
+		os_memcpy(station_config.bssid, AP.bssid, sizeof(station_config.bssid));
+		station_config.channel = AP.channel;
+		station_config.all_channel_scan = false;
+		ret = wifi_station_set_config_current(&station_config);
+		LOG_DEBUG(WIFI_FSM, "set Station bssid " MACSTR ", channel %d, ret : %d",
+				MAC2STR(station_config.bssid), station_config.channel, ret);
+	}
+
+	ret = wifi_station_connect();
+	LOG_DEBUG(WIFI_FSM, "Connect to Station, ret : %d", ret);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActJoined
+ * Description	:  Clears backoff and remembers joined AP in flash
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActJoined(void){
+	failures = 0;
+
+	//joined AP with credentials in use, bssid and channel of connected event
+	struct station_config station_config;
+	if(!wifi_station_get_config(&station_config)) return;
+
+	AP_Info joined;
+	os_memset(&joined, 0, sizeof(AP_Info));
+	while(joined.ssid_len < sizeof(joined.ssid) && station_config.ssid[joined.ssid_len] != 0) ++joined.ssid_len;
+	os_memcpy(joined.ssid, station_config.ssid, joined.ssid_len);
+	os_memcpy(joined.password, station_config.password, sizeof(joined.password));
+	os_memcpy(joined.bssid, connectedBssid, sizeof(joined.bssid));
+	joined.channel = connectedChannel;
+	joined.bssid_set = true;
+
+	bool ret = SaveCredential(&joined);
+	LOG_DEBUG(WIFI_FSM, "save known AP, ret : %d", ret);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActFailed
+ * Description	:  Counts a failed join and stops SDK from trying on its own
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActFailed(void){
+	if(failures < 16) ++failures;
+	wifi_station_disconnect();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActProvision
+ * Description	:  Scans for station select page (needs station mode), a recent scan
+ * 				   is served instead
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActProvision(void){
+	bool ret = wifi_set_opmode_current(STATION_MODE);
+	LOG_DEBUG(WIFI_FSM, "set current opmode, ret : %d", ret);
+
+	//ms clock, system_get_time() wraps every 71.6 min and would make an old scan look recent
+	uint32 scanAge = TimerNow() - scanTime;
+	if(scannedCount > 0 && scanAge < SCAN_FRESHNESS * 1000UL){
+		LOG_DEBUG(WIFI_FSM, "reusing scan from %u ms ago", scanAge);
+		WifiFsmInput(WIFI_IN_SCAN_DONE);
+		return;
+	}
+	_ActScan();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActSoftAP
+ * Description	:  Switches to SoftAP mode, configuring SoftAP if needed
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActSoftAP(void){
+	//set wifi to soft ap mode
+	bool ret = wifi_set_opmode_current(SOFTAP_MODE);
+	LOG_DEBUG(WIFI_FSM, "set current opmode, ret : %d", ret);
+
+	struct softap_config softAP_config;
+	ret = wifi_softap_get_config(&softAP_config);
+	LOG_DEBUG(WIFI_FSM, "get station config, ret : %d", ret);
+
+	//set Soft AP mode configuration
+	if(os_strcmp(softAP_config.ssid, SOFTAP_SSID) != 0 &&
+		os_strcmp(softAP_config.password, SOFTAP_PASSWORD) != 0){
+
+		softAP_config.authmode = SOFTAP_AUTHMODE;
+		softAP_config.max_connection = SOFTAP_MAXCONNECTIONS;
+
+		os_memset(softAP_config.ssid, 0, sizeof(softAP_config.ssid));
+		os_memcpy(softAP_config.ssid, SOFTAP_SSID, os_strlen(SOFTAP_SSID));
+		softAP_config.ssid_len = os_strlen(SOFTAP_SSID);
+		LOG_DEBUG(WIFI_FSM, "SoftAP ssid : %s", softAP_config.ssid);
+
+		os_memset(softAP_config.password, 0, sizeof(softAP_config.password));
+		os_memcpy(softAP_config.password, SOFTAP_PASSWORD, os_strlen(SOFTAP_PASSWORD));
+
+		ret = wifi_softap_set_config(&softAP_config);
+		LOG_DEBUG(WIFI_FSM, "set SoftAP config, ret : %d", ret);
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _ActLeaveProvisioning
+ * Description	:  Gives up SoftAP and scans for a known AP
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _ActLeaveProvisioning(void){
+	bool ret = wifi_set_opmode_current(STATION_MODE);
+	LOG_DEBUG(WIFI_FSM, "set current opmode, ret : %d", ret);
+	_ActScan();
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _EnterBackoff
+ * Description	:  Arms state timer with WIFI_BACKOFF_MIN doubled on each failed join
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _EnterBackoff(void){
+	uint32 delay = WIFI_BACKOFF_MAX;
+	if(failures < 16 && (WIFI_BACKOFF_MIN << failures) < WIFI_BACKOFF_MAX) delay = WIFI_BACKOFF_MIN << failures;
+	LOG_WARN(WIFI_FSM, "backoff %u s after %d failures", delay, failures);
+	ArmTimer(stateTimer, delay * 1000, false);
+}
+
+/******** Tables ********/
+
+static const WIFI_STATE_INFO states[WIFI_STATES] ICACHE_RODATA_ATTR STORE_ATTR = {
+	[WIFI_IDLE]			= {"IDLE", 0, NULL},
+	[WIFI_SELECTING]	= {"SELECTING", WIFI_SCAN_TIMEOUT, NULL},
+	[WIFI_CONNECTING]	= {"CONNECTING", WIFI_CONNECT_TIMEOUT, NULL},
+	[WIFI_GOT_IP]		= {"GOT_IP", ROAM_CHECK_INTERVAL, NULL},
+	[WIFI_VERIFIED]		= {"VERIFIED", ROAM_CHECK_INTERVAL, NULL},
+	[WIFI_BACKOFF]		= {"BACKOFF", 0, _EnterBackoff},
+	[WIFI_PROVISIONING]	= {"PROVISIONING", SOFTAP_TIMER, NULL}
+};
+
+static const WIFI_TRANSITION transitions[] ICACHE_RODATA_ATTR STORE_ATTR = {
+	//boot, SDK joins last AP on its own unless a scan has to choose
+	{WIFI_IDLE,			WIFI_IN_START,			_GuardSeveralKnown,		_ActBootSelect,			WIFI_SELECTING},
+	{WIFI_IDLE,			WIFI_IN_START,			_GuardSaved,			_ActConnectSaved,		WIFI_CONNECTING},
+
+	{WIFI_SELECTING,	WIFI_IN_SCAN_DONE,		_GuardCandidate,		_ActJoinAP,				WIFI_CONNECTING},
+	{WIFI_SELECTING,	WIFI_IN_SCAN_DONE,		_GuardSaved,			_ActConnectSaved,		WIFI_CONNECTING},
+	{WIFI_SELECTING,	WIFI_IN_SCAN_DONE,		NULL,					_ActFailed,				WIFI_BACKOFF},
+	{WIFI_SELECTING,	WIFI_IN_SCAN_FAILED,	NULL,					_ActFailed,				WIFI_BACKOFF},
+	{WIFI_SELECTING,	WIFI_IN_TIMEOUT,		NULL,					_ActFailed,				WIFI_BACKOFF},
+	{WIFI_SELECTING,	WIFI_IN_GOT_IP,			NULL,					_ActJoined,				WIFI_GOT_IP},
+
+	{WIFI_CONNECTING,	WIFI_IN_GOT_IP,			NULL,					_ActJoined,				WIFI_GOT_IP},
+	{WIFI_CONNECTING,	WIFI_IN_DISCONNECTED,	NULL,					_ActFailed,				WIFI_BACKOFF},
+	{WIFI_CONNECTING,	WIFI_IN_TIMEOUT,		NULL,					_ActFailed,				WIFI_BACKOFF},
+
+	//connected, timeout is periodic roam check, a weak signal scans and scan result decides
+	{WIFI_GOT_IP,		WIFI_IN_LINK_UP,		NULL,					NULL,					WIFI_VERIFIED},
+	{WIFI_GOT_IP,		WIFI_IN_DISCONNECTED,	NULL,					NULL,					WIFI_BACKOFF},
+	{WIFI_GOT_IP,		WIFI_IN_TIMEOUT,		_GuardWeakSignal,		_ActScan,				WIFI_SAME},
+	{WIFI_GOT_IP,		WIFI_IN_TIMEOUT,		NULL,					NULL,					WIFI_GOT_IP},
+	{WIFI_GOT_IP,		WIFI_IN_SCAN_DONE,		_GuardRoam,				_ActJoinAP,				WIFI_CONNECTING},
+	{WIFI_GOT_IP,		WIFI_IN_SCAN_DONE,		NULL,					NULL,					WIFI_GOT_IP},
+	{WIFI_GOT_IP,		WIFI_IN_SCAN_FAILED,	NULL,					NULL,					WIFI_GOT_IP},
+
+	{WIFI_VERIFIED,		WIFI_IN_LINK_DOWN,		NULL,					NULL,					WIFI_GOT_IP},
+	{WIFI_VERIFIED,		WIFI_IN_DISCONNECTED,	NULL,					NULL,					WIFI_BACKOFF},
+	{WIFI_VERIFIED,		WIFI_IN_TIMEOUT,		_GuardWeakSignal,		_ActScan,				WIFI_SAME},
+	{WIFI_VERIFIED,		WIFI_IN_TIMEOUT,		NULL,					NULL,					WIFI_VERIFIED},
+	{WIFI_VERIFIED,		WIFI_IN_SCAN_DONE,		_GuardRoam,				_ActJoinAP,				WIFI_CONNECTING},
+	{WIFI_VERIFIED,		WIFI_IN_SCAN_DONE,		NULL,					NULL,					WIFI_VERIFIED},
+	{WIFI_VERIFIED,		WIFI_IN_SCAN_FAILED,	NULL,					NULL,					WIFI_VERIFIED},
+
+	{WIFI_BACKOFF,		WIFI_IN_TIMEOUT,		NULL,					_ActScan,				WIFI_SELECTING},
+
+	//SoftAP stays while somebody is connected to it, or while no AP is known
+	{WIFI_PROVISIONING,	WIFI_IN_SCAN_DONE,		NULL,					_ActSoftAP,				WIFI_SAME},
+	{WIFI_PROVISIONING,	WIFI_IN_SCAN_FAILED,	NULL,					_ActSoftAP,				WIFI_SAME},
+	{WIFI_PROVISIONING,	WIFI_IN_TIMEOUT,		_GuardSoftAPClients,	NULL,					WIFI_PROVISIONING},
+	{WIFI_PROVISIONING,	WIFI_IN_TIMEOUT,		_GuardKnown,			_ActLeaveProvisioning,	WIFI_SELECTING},
+	{WIFI_PROVISIONING,	WIFI_IN_TIMEOUT,		NULL,					NULL,					WIFI_PROVISIONING},
+
+	{WIFI_ANY,			WIFI_IN_SCAN_BUTTON,	NULL,					_ActProvision,			WIFI_PROVISIONING},
+	{WIFI_ANY,			WIFI_IN_PROVISIONED,	NULL,					_ActJoinAP,				WIFI_CONNECTING}
+};
+
+#define TRANSITIONS			(sizeof(transitions) / sizeof(transitions[0]))
+
+/******** Machine ********/
+
+/*******************************************************************************************
+ * FunctionName	:  _State_Timer
+ * Description	:  State timer callback, queues timeout of state it was armed in
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _State_Timer(void *arg){
+	BusPost(BUS_WIFI_TIMEOUT, generation);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _WifiFsmEnter
+ * Description	:  Enters a state (again), arms its timeout
+ * Parameters	:  iState -- state
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _WifiFsmEnter(WIFI_STATE iState){
+	WIFI_STATE old = wifiState;
+	wifiState = iState;
+	++generation;
+
+	DisarmTimer(stateTimer);
+	if(states[iState].enter != NULL) states[iState].enter();
+	if(states[iState].timeout > 0) ArmTimer(stateTimer, states[iState].timeout * 1000, false);
+
+	LOG_DEBUG(WIFI_FSM, "%s -> %s", states[old].name, states[iState].name);
+	if(stateChanged != NULL) stateChanged(old, iState);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _WifiFsmDispatch
+ * Description	:  Runs first matching transition of an input
+ * Parameters	:  iInput -- input
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _WifiFsmDispatch(WIFI_INPUT iInput){
+	for(uint8 i = 0; i < TRANSITIONS; ++i){
+		const WIFI_TRANSITION *row = &transitions[i];
+		if(row->input != iInput || (row->state != wifiState && row->state != WIFI_ANY)) continue;
+		if(row->guard != NULL && !row->guard()) continue;
+
+		LOG_DEBUG(WIFI_FSM, "%s : input %d, row %d", states[wifiState].name, iInput, i);
+		if(row->action != NULL) row->action();
+		if(row->next != WIFI_SAME) _WifiFsmEnter(row->next);
+		return;
+	}
+	LOG_DEBUG(WIFI_FSM, "%s : input %d ignored", states[wifiState].name, iInput);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  _WifiFsmEvent
+ * Description	:  Bus callback, one input per event
+ * Parameters	:  iEvent -- BUS_WIFI_INPUT or BUS_WIFI_TIMEOUT
+ * 				   iParam -- input, or generation of a timeout
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR _WifiFsmEvent(BUS_EVENT iEvent, uint32 iParam){
+	if(iEvent == BUS_WIFI_INPUT && iParam < WIFI_INPUTS) _WifiFsmDispatch(iParam);
+
+	//timer was re-armed or state left after this timeout was queued
+	else if(iEvent == BUS_WIFI_TIMEOUT && iParam == generation) _WifiFsmDispatch(WIFI_IN_TIMEOUT);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  InitWifiFsm
+ * Description	:  Subscribes machine to its bus events and loads known AP's
+ * Parameters	:  iStateChanged -- transition callback (may be NULL)
+ * Return		:  bool, true if successful,
+ * 						 false if failed
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR InitWifiFsm(WIFI_STATE_CB iStateChanged){
+	stateChanged = iStateChanged;
+	wifiState = WIFI_IDLE;
+	failures = 0;
+
+	if(stateTimer == TIMER_NONE) stateTimer = CreateTimer(_State_Timer, NULL);
+	DisarmTimer(stateTimer);
+
+	uint8 known = InitCredentials();
+	LOG_DEBUG(WIFI_FSM, "known AP's : %d", known);
+
+	//SDK must not retry one AP on its own, machine decides
+	wifi_station_set_reconnect_policy(false);
+
+	return BusSubscribe(BUS_WIFI_INPUT, _WifiFsmEvent) && BusSubscribe(BUS_WIFI_TIMEOUT, _WifiFsmEvent);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmInput
+ * Description	:  Queues an input, safe from ISR
+ * Parameters	:  iInput -- input
+ * Return		:  bool, true if queued (or merged into same pending input)
+ ******************************************************************************************/
+bool WifiFsmInput(WIFI_INPUT iInput){
+	return BusPost(BUS_WIFI_INPUT, iInput);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmSdkEvent
+ * Description	:  Turns station events of SDK wifi event handler into inputs
+ * Parameters	:  event -- SDK wifi event
+ ******************************************************************************************/
+void ICACHE_FLASH_ATTR WifiFsmSdkEvent(System_Event_t *event){
+	switch(event->event){
+	case EVENT_STAMODE_CONNECTED:
+		os_memcpy(connectedBssid, event->event_info.connected.bssid, sizeof(connectedBssid));
+		connectedChannel = event->event_info.connected.channel;
+		break;
+	case EVENT_STAMODE_DISCONNECTED:
+		//leave is ours: roaming, provisioning or a backoff
+		if(event->event_info.disconnected.reason != REASON_ASSOC_LEAVE) WifiFsmInput(WIFI_IN_DISCONNECTED);
+		break;
+	case EVENT_STAMODE_DHCP_TIMEOUT:
+		WifiFsmInput(WIFI_IN_DISCONNECTED);
+		break;
+	case EVENT_STAMODE_GOT_IP:
+		WifiFsmInput(WIFI_IN_GOT_IP);
+		break;
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmProvision
+ * Description	:  Joins an AP given through station select page, from any state
+ * Parameters	:  iAP -- ssid and password
+ * Return		:  bool, true if queued (or merged into same pending input)
+ ******************************************************************************************/
+bool ICACHE_FLASH_ATTR WifiFsmProvision(const AP_Info *iAP){
+	os_memset(&AP, 0, sizeof(AP_Info));
+	os_memcpy(AP.ssid, iAP->ssid, iAP->ssid_len);
+	AP.ssid_len = iAP->ssid_len;
+	os_memcpy(AP.password, iAP->password, sizeof(AP.password));
+
+	//strongest BSS of ssid from scan list, unknown (e.g. hidden) ssids are searched by SDK
+	for(uint8 i = 0; i < scannedCount; ++i){
+		if(scanned_APs[i].ssid_len == AP.ssid_len && os_memcmp(scanned_APs[i].ssid, AP.ssid, AP.ssid_len) == 0){
+			LOG_DEBUG(WIFI_FSM, "ssid found in scan list at %d", i);
+			os_memcpy(AP.bssid, scanned_APs[i].bssid, sizeof(AP.bssid));
+			AP.channel = scanned_APs[i].channel;
+			AP.authmode = scanned_APs[i].authmode;
+			AP.bssid_set = true;
+			break;
+		}
+	}
+
+	return WifiFsmInput(WIFI_IN_PROVISIONED);
+}
+
+/*******************************************************************************************
+ * FunctionName	:  WifiFsmState
+ * Description	:  Current state
+ * Return		:  WIFI_STATE
+ ******************************************************************************************/
+WIFI_STATE ICACHE_FLASH_ATTR WifiFsmState(void){
+	return wifiState;
+}
+
+/*******************************************************************************************
+ * FunctionName	:  WifiStateName
+ * Description	:  Name of a state, for logs
+ * Parameters	:  iState -- state
+ * Return		:  name
+ ******************************************************************************************/
+const char* ICACHE_FLASH_ATTR WifiStateName(WIFI_STATE iState){
+	return iState < WIFI_STATES ? states[iState].name : "?";
+}
@@ -0,0 +1,38 @@
+// Station select page script.
+// Scan results come from api/scan as [{ssid, rssi, channel, authmode}, ...]. The bundled page
+// carries them inline as AP, the plain page fetches them.
+function render(list) {
+	let form = document.getElementById('f');
+	for (let t = list.length - 1; t >= 0; --t) {
+		let ssid = list[t].ssid;
+		let first = form.childNodes[0];
+		let div = document.createElement('div');
+
+		let radio = document.createElement('input');
+		radio.setAttribute('type', 'radio');
+		radio.setAttribute('name', 'S');
+		radio.setAttribute('checked', 'checked');
+		radio.setAttribute('value', ssid);
+		radio.setAttribute('id', ssid);
+		div.appendChild(radio);
+
+		let label = document.createElement('label');
+		label.setAttribute('for', ssid);
+		// authmode 0 is an open network
+		label.textContent = ssid + ' (' + list[t].rssi + ' dBm' + (list[t].authmode ? '' : ', open') + ')';
+		div.appendChild(label);
+
+		div.appendChild(document.createElement('br'));
+		form.insertBefore(div, first);
+	}
+}
+
+document.addEventListener('DOMContentLoaded', function () {
+	if (typeof AP !== 'undefined') {
+		render(AP);
+	} else {
+		fetch('./api/scan').then(function (response) {
+			return response.json();
+		}).then(render);
+	}
+});